@@ -90,7 +90,7 @@ extension AutoFillCoordinator {
         _quickTypeRequiredRecord = record
         self._autoFillMode = mode
 
-        var dbStatus = DatabaseFile.Status([.readOnly, .useStreams])
+        var dbStatus = DatabaseFile.Status([.readOnly])
         guard let dbRef = _findDatabase(for: record) else {
             log.warning("Failed to find the record, switching to UI")
             QuickTypeAutoFillStorage.removeAll()
@@ -152,6 +152,7 @@ extension EntryFinderCoordinator {
         DatabaseSettingsManager.shared.updateSettings(for: _databaseFile.originalReference) {
             $0.clearMasterKey()
         }
+        KeyDerivationCache.removeAll()
         _router.pop(viewController: _entryFinderVC, animated: true)
         Diag.info("Database locked")
     }
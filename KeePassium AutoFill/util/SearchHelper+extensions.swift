@@ -53,9 +53,8 @@ extension SearchHelper {
         guard let url = URL.from(malformedString: url) else { return [] }
         let parsedHost = DomainNameHelper.shared.parse(url: url) 
 
-        var allEntries = [Entry]()
-        guard let rootGroup = database.root else { return [] }
-        rootGroup.collectAllEntries(to: &allEntries)
+        guard database.root != nil else { return [] }
+        let allEntries = database.getAutoFillCandidates(url: url, parsedHost: parsedHost)
 
         let options = Settings.current.autoFillInclusionOptions
         let relevantEntries = allEntries
@@ -75,16 +74,14 @@ extension SearchHelper {
             }
             .filter { $0.similarityScore > 0.0 }
             .sorted { $0.similarityScore > $1.similarityScore }
-        Diag.verbose("Found \(relevantEntries.count) relevant entries [among \(allEntries.count)]")
+        Diag.verbose("Found \(relevantEntries.count) relevant entries [among \(allEntries.count) candidates]")
         return relevantEntries
     }
 
     private func performSearch(in database: Database, domain: String) -> [ScoredItem] {
-        var allEntries = [Entry]()
-        guard let rootGroup = database.root else { return [] }
-        rootGroup.collectAllEntries(to: &allEntries)
-
+        guard database.root != nil else { return [] }
         let mainDomain = DomainNameHelper.shared.getMainDomain(host: domain) ?? domain
+        let allEntries = database.getAutoFillCandidates(mainDomain: mainDomain)
         let compareOptions: String.CompareOptions = [.caseInsensitive]
         let options = Settings.current.autoFillInclusionOptions
 
@@ -109,7 +106,7 @@ extension SearchHelper {
             }
             .filter { $0.similarityScore > 0.0 }
             .sorted { $0.similarityScore > $1.similarityScore }
-        Diag.verbose("Found \(relevantEntries.count) relevant entries [among \(allEntries.count)]")
+        Diag.verbose("Found \(relevantEntries.count) relevant entries [among \(allEntries.count) candidates]")
         return relevantEntries
     }
 
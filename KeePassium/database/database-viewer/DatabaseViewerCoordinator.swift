@@ -204,6 +204,7 @@ final class DatabaseViewerCoordinator: BaseCoordinator {
             DatabaseSettingsManager.shared.updateSettings(for: _databaseFile.originalReference) {
                 $0.clearMasterKey()
             }
+            KeyDerivationCache.removeAll()
         }
         Diag.debug("Database closed [locked: \(shouldLock), reason: \(reason)]")
         stop(animated: animated, completion: completion)
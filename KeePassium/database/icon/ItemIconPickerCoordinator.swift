@@ -171,9 +171,7 @@ class ItemIconPickerCoordinator: BaseCoordinator {
             return
         }
 
-        unusedIconUUIDs.forEach {
-            db2.deleteCustomIcon(uuid: $0)
-        }
+        db2.deleteCustomIcons(uuids: unusedIconUUIDs)
         refresh()
         saveDatabase(databaseFile)
     }
@@ -183,9 +181,7 @@ class ItemIconPickerCoordinator: BaseCoordinator {
             assertionFailure()
             return
         }
-        iconUUIDs.forEach {
-            db2.deleteCustomIcon(uuid: $0)
-        }
+        db2.deleteCustomIcons(uuids: iconUUIDs)
         refresh()
         switch item {
         case let entry as Entry2 where iconUUIDs.contains(entry.customIconUUID):
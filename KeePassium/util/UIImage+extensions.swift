@@ -244,7 +244,7 @@ extension UIImage {
     static func kpIcon(forEntry entry: Entry, iconSet: DatabaseIconSet? = nil) -> UIImage? {
         if let entry2 = entry as? Entry2,
             let db2 = entry2.database as? Database2,
-            let customIcon2 = db2.customIcons.first(where: { $0.uuid == entry2.customIconUUID }),
+            let customIcon2 = db2.getCustomIcon(with: entry2.customIconUUID),
             let image = UIImage(data: customIcon2.data.asData)
         {
             return image.withGradientUnderlay()
@@ -256,7 +256,7 @@ extension UIImage {
     static func kpIcon(forGroup group: Group, iconSet: DatabaseIconSet? = nil) -> UIImage? {
         if let group2 = group as? Group2,
             let db2 = group2.database as? Database2,
-            let customIcon2 = db2.customIcons.first(where: { $0.uuid == group2.customIconUUID }),
+            let customIcon2 = db2.getCustomIcon(with: group2.customIconUUID),
             let image = UIImage(data: customIcon2.data.asData)
         {
             return image.withGradientUnderlay()
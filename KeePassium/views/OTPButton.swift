@@ -14,10 +14,9 @@ final class OTPButton: UIButton {
     private let normalColor: UIColor = .actionTint
     private let expiringColor: UIColor = .warningMessage
 
-    private let generator: TOTPGenerator
+    fileprivate let generator: TOTPGenerator
     private let protected: Bool
     private let tapHandler: ((_ otpCode: String) -> Void)?
-    private var refreshTimer: DispatchSourceTimer!
 
     init(generator: TOTPGenerator, protected: Bool, onTap: ((_ otpCode: String) -> Void)?) {
         self.generator = generator
@@ -31,27 +30,22 @@ final class OTPButton: UIButton {
             UIAction { [unowned self] _ in tapHandler?(generator.generate()) },
             for: .touchUpInside)
 
-        refreshTimer = DispatchSource.makeTimerSource(queue: .main)
-        refreshTimer.schedule(deadline: .now(), repeating: refreshInterval)
-        refreshTimer.setEventHandler { [weak self] in
-            self?.refresh()
-        }
-        refreshTimer.resume()
-
-        refresh()
+        refresh(otpValue: generator.generate())
+        OTPRefreshTicker.shared.register(self, interval: refreshInterval)
     }
 
     required init?(coder: NSCoder) {
         fatalError("init(coder:) has not been implemented")
     }
 
-    deinit {
-        refreshTimer.cancel()
-        refreshTimer = nil
+    override func didMoveToWindow() {
+        super.didMoveToWindow()
+        if window != nil {
+            refresh(otpValue: generator.generate())
+        }
     }
 
-    private func refresh() {
-        let otpValue = generator.generate()
+    fileprivate func refresh(otpValue: String) {
         let remainingTime = generator.remainingTime
 
         var config = UIButton.Configuration.plain()
@@ -103,3 +97,40 @@ final class OTPButton: UIButton {
         )
     }
 }
+
+/// Refreshes all the OTP buttons on screen with a single timer,
+/// and computes their codes in one batch instead of one by one.
+private final class OTPRefreshTicker {
+    static let shared = OTPRefreshTicker()
+
+    private let buttons = NSHashTable<OTPButton>.weakObjects()
+    private var timer: DispatchSourceTimer?
+
+    func register(_ button: OTPButton, interval: TimeInterval) {
+        buttons.add(button)
+        guard timer == nil else {
+            return
+        }
+        let timer = DispatchSource.makeTimerSource(queue: .main)
+        timer.schedule(deadline: .now() + interval, repeating: interval)
+        timer.setEventHandler { [weak self] in
+            self?.refresh()
+        }
+        timer.resume()
+        self.timer = timer
+    }
+
+    private func refresh() {
+        let allButtons = buttons.allObjects
+        guard !allButtons.isEmpty else {
+            timer?.cancel()
+            timer = nil
+            return
+        }
+        let visibleButtons = allButtons.filter { $0.window != nil }
+        let otpValues = TOTPBatchGenerator.generate(visibleButtons.map { $0.generator })
+        zip(visibleButtons, otpValues).forEach { button, otpValue in
+            button.refresh(otpValue: otpValue)
+        }
+    }
+}
@@ -211,6 +211,8 @@ public class DatabaseLoader: ProgressObserver {
 
     private var currentDataSource: DataSource?
 
+    private var speculativeKeyDerivation: SpeculativeKeyDerivation?
+
     public init(
         originalDBRef: URLReference,
         actualDBRef: URLReference,
@@ -239,6 +241,9 @@ public class DatabaseLoader: ProgressObserver {
             if let remoteDataSource = self?.currentDataSource as? any RemoteDataSource {
                 remoteDataSource.cancelAllOperations()
             }
+            self?.operationQueue.addOperation {
+                self?.speculativeKeyDerivation?.cancel()
+            }
         }
     }
 
@@ -303,6 +308,7 @@ public class DatabaseLoader: ProgressObserver {
         Diag.info("Will load database [location: \(dbRef.location), fileProvider: \(dbRef.fileProvider?.rawValue ?? "nil")]")
         startBackgroundTask()
         startObservingProgress()
+        CryptoInstrumentation.isTracingEnabled = Diag.isDeepDebugMode()
         notifyWillLoadDatabase()
         progress.status = LString.Progress.contactingStorageProvider
         dbRef.resolveAsync(timeout: timeout, callbackQueue: operationQueue) { result in 
@@ -328,12 +334,20 @@ public class DatabaseLoader: ProgressObserver {
 
         currentDataSource = DataSourceFactory.getDataSource(for: url)
 
+        var prefixHandler: FilePrefixHandler?
+        if SpeculativeKeyDerivation.isApplicable(to: compositeKey) {
+            prefixHandler = { [weak self] headerData in
+                self?.onDatabaseHeaderReceived(headerData)
+            }
+        }
         FileDataProvider.read(
             url,
             fileProvider: fileProvider,
             queue: operationQueue,
             timeout: timeout,
             completionQueue: operationQueue,
+            prefixLength: SpeculativeKeyDerivation.headerPrefixLength,
+            prefixHandler: prefixHandler,
             completion: { [weak self] result in
                 guard let self else { return }
                 self.currentDataSource = nil
@@ -342,6 +356,8 @@ public class DatabaseLoader: ProgressObserver {
                     self.onDatabaseDocumentReadComplete(data: docData, fileURL: url, fileProvider: fileProvider)
                 case .failure(let fileAccessError):
                     Diag.error("Failed to open database document [error: \(fileAccessError.localizedDescription)]")
+                    self.speculativeKeyDerivation?.cancel()
+                    self.speculativeKeyDerivation = nil
                     self.stopAndNotify(
                         .databaseUnreachable(.cannotOpenDatabaseFile(reason: fileAccessError))
                     )
@@ -350,6 +366,15 @@ public class DatabaseLoader: ProgressObserver {
         )
     }
 
+    private func onDatabaseHeaderReceived(_ headerData: ByteArray) {
+        assert(operationQueue.isCurrent)
+        guard speculativeKeyDerivation == nil else { return }
+        Diag.debug("Received database header, deriving the key while downloading the rest")
+        let speculation = SpeculativeKeyDerivation(compositeKey: compositeKey)
+        speculation.start(headerData: headerData)
+        speculativeKeyDerivation = speculation
+    }
+
     private func onDatabaseDocumentReadComplete(
         data: ByteArray,
         fileURL: URL,
@@ -379,6 +404,24 @@ public class DatabaseLoader: ProgressObserver {
             originalReference: originalDatabaseRef,
             status: status
         )
+        if let speculation = speculativeKeyDerivation {
+            speculation.notify(fileData: data, queue: operationQueue) { [self] derivedKey in
+                speculativeKeyDerivation = nil
+                guard let derivedKey else {
+                    processKeyComponents(dbFile: dbFile)
+                    return
+                }
+                progress.completedUnitCount = ProgressSteps.didReadKeyFile
+                Diag.info("Using the key derived during download")
+                onCompositeKeyComponentsProcessed(dbFile: dbFile, compositeKey: derivedKey)
+            }
+            return
+        }
+        processKeyComponents(dbFile: dbFile)
+    }
+
+    private func processKeyComponents(dbFile: DatabaseFile) {
+        assert(operationQueue.isCurrent)
         guard compositeKey.state == .rawComponents else {
 
             progress.completedUnitCount = ProgressSteps.didReadKeyFile
@@ -417,7 +460,7 @@ public class DatabaseLoader: ProgressObserver {
 
         currentDataSource = DataSourceFactory.getDataSource(for: url)
 
-        FileDataProvider.read(
+        FileDataProvider.readKeyFile(
             url,
             fileProvider: fileProvider,
             queue: operationQueue,
@@ -427,8 +470,8 @@ public class DatabaseLoader: ProgressObserver {
                 guard let self else { return }
                 self.currentDataSource = nil
                 switch result {
-                case .success(let docData):
-                    self.onKeyFileDataReady(dbFile: dbFile, keyFileData: SecureBytes.from(docData))
+                case .success(let keyFileData):
+                    self.onKeyFileDataReady(dbFile: dbFile, keyFileData: keyFileData)
                 case .failure(let fileAccessError):
                     Diag.error("Failed to open key file [error: \(fileAccessError.localizedDescription)]")
                     self.stopAndNotify(
@@ -489,9 +532,11 @@ public class DatabaseLoader: ProgressObserver {
                 dbFileName: dbFile.visibleFileName,
                 dbFileData: dbFile.data,
                 compositeKey: compositeKey,
-                useStreams: dbFile.status.contains(.useStreams),
                 warnings: warnings)
             Diag.info("Database loaded OK")
+            if CryptoInstrumentation.isTracingEnabled {
+                CryptoInstrumentation.dumpTrace()
+            }
 
             addFileLocationWarnings(to: warnings)
             applyPendingOperations(dbFile, warnings: warnings)
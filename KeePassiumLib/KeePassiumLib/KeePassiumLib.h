@@ -19,7 +19,26 @@ FOUNDATION_EXPORT const unsigned char KeePassiumLibVersionString[];
 #import <CommonCrypto/CommonCrypto.h>
 #import "salsa20.h"
 #import "chacha20.h"
+#import "drbg.h"
+#import "crypto_stats.h"
 #import "argon2.h"
+#import "argon2_batch.h"
+#import "argon2_job.h"
 #import "twofish.h"
 #import "aeskdf.h"
+#import "aes_cbc.h"
+#import "kdfcache.h"
+#import "memprotect.h"
+#import "sha256.h"
+#import "base64.h"
+#import "kdb_parser.h"
+#import "kdbx_time.h"
+#import "kdbx_writer.h"
+#import "kdbx_xml.h"
+#import "keyfile.h"
+#import "domain_index.h"
+#import "search_arena.h"
+#import "search_index.h"
+#import "totp.h"
+#import "wordlist.h"
 
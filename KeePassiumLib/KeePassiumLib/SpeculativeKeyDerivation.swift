@@ -0,0 +1,90 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+/// Derives the master key from the KDBX header while the rest of the database file is still downloading.
+final class SpeculativeKeyDerivation {
+    /// How many leading bytes of the file to wait for; enough for any reasonable header.
+    static let headerPrefixLength = 64 * 1024
+
+    private let compositeKey: CompositeKey
+    private let database = Database2()
+    private let group = DispatchGroup()
+    private var headerData: ByteArray?
+    private var derivedKey: CompositeKey?
+    private var kdfProgress: ProgressEx?
+
+    /// Whether the key can be derived without user interaction or further file access.
+    static func isApplicable(to compositeKey: CompositeKey) -> Bool {
+        guard compositeKey.challengeHandler == nil else {
+            return false
+        }
+        switch compositeKey.state {
+        case .rawComponents:
+            return compositeKey.keyFileRef == nil && !compositeKey.password.isEmpty
+        case .processedComponents, .combinedComponents:
+            return true
+        case .empty, .final:
+            return false
+        }
+    }
+
+    init(compositeKey: CompositeKey) {
+        self.compositeKey = compositeKey.clone()
+    }
+
+    /// Starts the KDF in background, unless the data does not look like a KDBX header.
+    func start(headerData: ByteArray) {
+        assert(self.headerData == nil, "Already started")
+        guard Database2.isSignatureMatches(data: headerData) else {
+            Diag.debug("Not a KDBX header, skipping early key derivation")
+            return
+        }
+        self.headerData = headerData
+        kdfProgress = database.initProgress()
+        group.enter()
+        DispatchQueue.global(qos: .userInitiated).async { [self] in
+            defer { group.leave() }
+            do {
+                if compositeKey.state == .rawComponents {
+                    let passwordData = database.keyHelper.getPasswordData(password: compositeKey.password)
+                    compositeKey.setProcessedComponents(passwordData: passwordData, keyFileData: SecureBytes.empty())
+                }
+                try database.deriveMasterKey(headerData: headerData, compositeKey: compositeKey)
+                derivedKey = compositeKey
+                Diag.debug("Derived the key while downloading")
+            } catch {
+                Diag.debug("Early key derivation failed, will derive after download [message: \(error.localizedDescription)]")
+            }
+        }
+    }
+
+    /// Stops the KDF, if it is still running.
+    func cancel() {
+        kdfProgress?.cancel(reason: .userRequest)
+    }
+
+    /// Once the KDF is done, calls the handler with the derived key,
+    /// or with `nil` if it failed or was computed for a different header than the one in `fileData`.
+    func notify(
+        fileData: ByteArray,
+        queue: OperationQueue,
+        handler: @escaping (CompositeKey?) -> Void
+    ) {
+        group.notify(queue: .global(qos: .userInitiated)) { [self] in
+            var result: CompositeKey?
+            if let headerData, fileData.prefix(headerData.count) == headerData {
+                result = derivedKey
+            }
+            queue.addOperation {
+                handler(result)
+            }
+        }
+    }
+}
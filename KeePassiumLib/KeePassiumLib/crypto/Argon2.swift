@@ -35,83 +35,240 @@ public final class Argon2 {
         }
     }
 
+    /// Resource limits for memory-constrained processes. They do not affect the hash value.
+    public struct Limits {
+        /// Maximum peak memory footprint, in bytes; `nil` for no budget.
+        public let memoryBudget: Int?
+        /// Maximum number of worker threads; `nil` for one thread per lane.
+        public let maxThreads: UInt32?
+        /// Stack size of worker threads, in bytes; `nil` for the system default.
+        public let threadStackSize: UInt32?
+
+        public static let none = Limits(memoryBudget: nil, maxThreads: nil, threadStackSize: nil)
+
+        /// Small worker stacks and few workers, within the given memory budget.
+        public static func constrained(memoryBudget: Int?) -> Limits {
+            return Limits(
+                memoryBudget: memoryBudget,
+                maxThreads: 2,
+                threadStackSize: UInt32(ARGON2_CONSTRAINED_STACK_SIZE)
+            )
+        }
+
+        fileprivate var rawValue: argon2_limits {
+            var budget: UInt64 = 0 // no budget
+            if let memoryBudget {
+                budget = UInt64(max(1, memoryBudget))
+            }
+            return argon2_limits(
+                memory_budget: budget,
+                max_threads: maxThreads ?? 0,
+                thread_stack_size: threadStackSize ?? 0
+            )
+        }
+    }
+
+    /// Handle of a hash being computed in the background.
+    public final class Job {
+        private let handle: OpaquePointer
+
+        fileprivate init(handle: OpaquePointer) {
+            self.handle = handle
+        }
+
+        deinit {
+            argon2_job_release(handle)
+        }
+
+        /// Stops the hashing, at the next block of any lane.
+        /// Unless the hash was already finished, the completion receives `ProgressInterruption.cancelled`.
+        public func cancel() {
+            argon2_job_cancel(handle)
+        }
+    }
+
+    private final class JobCallbacks {
+        let queue: DispatchQueue
+        let progress: ((UInt32) -> Void)?
+        let completion: (Result<SecureBytes, Error>) -> Void
+
+        init(
+            queue: DispatchQueue,
+            progress: ((UInt32) -> Void)?,
+            completion: @escaping (Result<SecureBytes, Error>) -> Void
+        ) {
+            self.queue = queue
+            self.progress = progress
+            self.completion = completion
+        }
+    }
+
+    private static let callbackQueue = DispatchQueue(label: "com.KeePassium.argon2")
+
     private init() {
     }
 
+    private static let hashLength = 32
+
+    /// Peak memory footprint of hashing with the given parameters, in bytes.
+    /// The memory budget of `limits` is not enforced here.
+    /// - Returns: the footprint, or `nil` if the parameters are invalid.
+    public static func estimatePeakMemoryFootprint(params: Params, limits: Limits = .none) -> Int? {
+        var rawLimits = limits.rawValue
+        var footprint = argon2_footprint()
+        let status = argon2_preflight(
+            params.memoryKiB,
+            params.parallelism,
+            hashLength,
+            &rawLimits,
+            &footprint
+        )
+        guard status == ARGON2_OK.rawValue || status == ARGON2_MEMORY_BUDGET_EXCEEDED.rawValue else {
+            return nil
+        }
+        return Int(clamping: footprint.total_bytes)
+    }
+
+    /// Starts hashing on a native worker thread and returns right away.
+    /// - Parameters:
+    ///   - limits: resource limits; exceeding the memory budget
+    ///       throws `CryptoError.argon2MemoryBudgetExceeded` before anything is allocated
+    ///   - queue: where the callbacks are called
+    ///   - progress: called with the number of completed iterations
+    ///   - completion: called once, with the hash or the error
+    /// - Returns: the job handle; releasing it does not cancel the job.
+    public static func hashAsync(
+        data pwd: SecureBytes,
+        params: Params,
+        type: PrimitiveType,
+        limits: Limits = .none,
+        queue: DispatchQueue,
+        progress: ((_ completedIterations: UInt32) -> Void)? = nil,
+        completion: @escaping (Result<SecureBytes, Error>) -> Void
+    ) throws -> Job {
+        try checkMemoryBudget(params: params, limits: limits)
+
+        let callbacks = JobCallbacks(queue: queue, progress: progress, completion: completion)
+        let userObject = Unmanaged.passRetained(callbacks).toOpaque()
+
+        let progressCallback: argon2_job_progress_fptr = { pass, userObject in
+            guard let userObject else { return }
+            let callbacks = Unmanaged<JobCallbacks>.fromOpaque(userObject).takeUnretainedValue()
+            guard let progress = callbacks.progress else { return }
+            callbacks.queue.async {
+                progress(pass + 1)
+            }
+        }
+        let completionCallback: argon2_job_completion_fptr = { status, hashBytes, hashLength, stats, userObject in
+            guard let userObject else { return }
+            let callbacks = Unmanaged<JobCallbacks>.fromOpaque(userObject).takeRetainedValue()
+            let result: Result<SecureBytes, Error>
+            if status == ARGON2_OK.rawValue, let hashBytes {
+                if let stats {
+                    Diag.debug("Argon2 done [\(CryptoInstrumentation.describe(stats.pointee))]")
+                }
+                var outBytes = Array(UnsafeBufferPointer(start: hashBytes, count: hashLength))
+                result = .success(SecureBytes.from(outBytes))
+                outBytes.erase()
+            } else if status == ARGON2_INTERRUPTED.rawValue {
+                result = .failure(ProgressInterruption.cancelled(reason: .userRequest))
+            } else {
+                result = .failure(CryptoError.argon2Error(code: Int(status)))
+            }
+            callbacks.queue.async {
+                callbacks.completion(result)
+            }
+        }
+
+        var jobParams = argon2_job_params(
+            t_cost: params.iterations,
+            m_cost: params.memoryKiB,
+            parallelism: params.parallelism,
+            type: type.rawValue,
+            version: params.version,
+            hashlen: hashLength,
+            limits: limits.rawValue
+        )
+        let handle = pwd.withDecryptedBytes { pwdBytes in
+            return params.salt.withBytes { saltBytes in
+                return argon2_job_submit(
+                    &jobParams,
+                    pwdBytes, pwdBytes.count,
+                    saltBytes, saltBytes.count,
+                    progress != nil ? progressCallback : nil,
+                    completionCallback,
+                    userObject
+                )
+            }
+        }
+        guard let handle else {
+            Unmanaged<JobCallbacks>.fromOpaque(userObject).release()
+            throw CryptoError.argon2Error(code: Int(ARGON2_THREAD_FAIL.rawValue))
+        }
+        return Job(handle: handle)
+    }
+
     public static func hash(
         data pwd: SecureBytes,
         params: Params,
         type: PrimitiveType,
+        limits: Limits = .none,
         progress: ProgressEx?
     ) throws -> SecureBytes {
-
-        var isAbortProcessing: UInt8 = 0
-
         progress?.totalUnitCount = Int64(params.iterations)
         progress?.completedUnitCount = 0
+
+        FLAG_clear_internal_memory = 1
+        var outcome: Result<SecureBytes, Error>?
+        let finished = DispatchSemaphore(value: 0)
+        let job = try hashAsync(
+            data: pwd,
+            params: params,
+            type: type,
+            limits: limits,
+            queue: callbackQueue,
+            progress: { completedIterations in
+                progress?.completedUnitCount = Int64(completedIterations)
+            },
+            completion: { result in
+                outcome = result
+                finished.signal()
+            }
+        )
         let progressKVO = progress?.observe(
             \.isCancelled,
-            options: [.new],
+            options: [.initial, .new],
             changeHandler: { progress, _ in
+                guard progress.isCancelled else { return }
                 if progress.cancellationReason == .lowMemoryWarning {
                     FLAG_clear_internal_memory = 0
                 }
-                isAbortProcessing = 1
+                job.cancel()
             }
         )
-
-        let progressCallback: progress_fptr!   
-        let progressObject: UnsafeRawPointer?  
-
-        if let progress {
-            progressObject = UnsafeRawPointer(Unmanaged.passUnretained(progress).toOpaque())
-            progressCallback = { (pass: UInt32, observer: Optional<UnsafeRawPointer>) -> Int32 in
-                guard let observer else { return 0 /* continue hashing */ }
-                let progress = Unmanaged<Progress>.fromOpaque(observer).takeUnretainedValue()
-                progress.completedUnitCount = Int64(pass)
-                let isShouldStop: Int32 = progress.isCancelled ? 1 : 0
-                return isShouldStop
-            }
-        } else {
-            progressObject = nil
-            progressCallback = nil
-        }
-
-        FLAG_clear_internal_memory = 1
-        var outBytes = [UInt8](repeating: 0, count: 32)
-        defer {
-            outBytes.erase()
-        }
-        let statusCode = pwd.withDecryptedBytes { pwdBytes in
-            return params.salt.withBytes { saltBytes -> Int32 in
-                return argon2_hash(
-                    params.iterations,  
-                    params.memoryKiB,   
-                    params.parallelism, 
-                    pwdBytes, pwdBytes.count,   
-                    saltBytes, saltBytes.count, 
-                    &outBytes, outBytes.count,  
-                    nil, 0,             
-                    type.rawValue,      
-                    params.version,     
-                    progressCallback,   
-                    progressObject,     
-                    &isAbortProcessing  
-                )
-            }
-        }
-
+        finished.wait()
         progressKVO?.invalidate()
+
         if let progress {
             progress.completedUnitCount = Int64(params.iterations)
             if progress.isCancelled {
                 throw ProgressInterruption.cancelled(reason: progress.cancellationReason)
             }
         }
+        guard let outcome else {
+            preconditionFailure("Argon2 job finished without a result")
+        }
+        return try outcome.get()
+    }
 
-        if statusCode != ARGON2_OK.rawValue {
-            throw CryptoError.argon2Error(code: Int(statusCode))
+    private static func checkMemoryBudget(params: Params, limits: Limits) throws {
+        guard let memoryBudget = limits.memoryBudget,
+              let footprint = estimatePeakMemoryFootprint(params: params, limits: limits),
+              footprint > memoryBudget
+        else {
+            return
         }
-        return SecureBytes.from(outBytes)
+        Diag.error("Argon2 would exceed the memory budget [needs: \(footprint), budget: \(memoryBudget)]")
+        throw CryptoError.argon2MemoryBudgetExceeded(requiredBytes: footprint, budgetBytes: memoryBudget)
     }
 }
@@ -15,6 +15,7 @@ public enum CryptoError: LocalizedError {
     case aesEncryptError(code: Int)
     case aesDecryptError(code: Int)
     case argon2Error(code: Int)
+    case argon2MemoryBudgetExceeded(requiredBytes: Int, budgetBytes: Int)
     case twofishError(code: Int)
     case rngError(code: Int)
 
@@ -70,6 +71,15 @@ public enum CryptoError: LocalizedError {
                     value: "Argon2 hashing error (code %d)",
                     comment: "Error message about Argon2 hashing function. [errorCode: Int]"),
                 code)
+        case let .argon2MemoryBudgetExceeded(requiredBytes, budgetBytes):
+            return String.localizedStringWithFormat(
+                NSLocalizedString(
+                    "[CryptoError] Not enough memory for Argon2: needs %@, available %@",
+                    bundle: Bundle.framework,
+                    value: "Not enough memory to process the master key: Argon2 needs %@, but only %@ is available. Try opening the database in the main app, or reduce its Argon2 memory parameter.",
+                    comment: "Error message about Argon2 hashing function. [requiredSize: String, availableSize: String]"),
+                ByteCountFormatter.string(fromByteCount: Int64(requiredBytes), countStyle: .memory),
+                ByteCountFormatter.string(fromByteCount: Int64(budgetBytes), countStyle: .memory))
         case .twofishError(let code):
             return String.localizedStringWithFormat(
                 NSLocalizedString(
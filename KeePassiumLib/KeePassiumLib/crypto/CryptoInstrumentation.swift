@@ -0,0 +1,54 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+public enum CryptoInstrumentation {
+    public static var isTracingEnabled: Bool {
+        get { crypto_trace_is_enabled() != 0 }
+        set { crypto_trace_set_enabled(newValue ? 1 : 0) }
+    }
+
+    static func describe(_ stats: crypto_stats) -> String {
+        var phases = [String]()
+        withUnsafeBytes(of: stats.phase_ns) { rawBuffer in
+            let phaseNanoseconds = rawBuffer.bindMemory(to: UInt64.self)
+            for index in 0..<Int(CRYPTO_PHASE_COUNT.rawValue) where phaseNanoseconds[index] > 0 {
+                let phase = crypto_phase(rawValue: UInt32(index))
+                let name = String(cString: crypto_phase_name(phase))
+                phases.append("\(name): \(formatDuration(phaseNanoseconds[index]))")
+            }
+        }
+        phases.append("bytes: \(stats.bytes_processed)")
+        phases.append("blocks: \(stats.blocks_processed)")
+        if stats.threads_spawned > 0 {
+            phases.append("threads: \(stats.threads_spawned)")
+        }
+        phases.append("faults: \(stats.minor_faults)/\(stats.major_faults)")
+        return phases.joined(separator: ", ")
+    }
+
+    public static func dumpTrace() {
+        var events = [crypto_trace_event](repeating: crypto_trace_event(), count: Int(CRYPTO_TRACE_CAPACITY))
+        let count = crypto_trace_copy(&events, events.count)
+        guard count > 0 else {
+            return
+        }
+        Diag.debug("Crypto trace [events: \(count)]")
+        for event in events.prefix(count) {
+            let operation = String(cString: crypto_operation_name(crypto_operation(rawValue: UInt32(event.operation))))
+            let phase = String(cString: crypto_phase_name(crypto_phase(rawValue: UInt32(event.phase))))
+            Diag.debug("  \(operation).\(phase): \(formatDuration(event.duration_ns)), \(event.bytes) bytes")
+        }
+        crypto_trace_clear()
+    }
+
+    private static func formatDuration(_ nanoseconds: UInt64) -> String {
+        return String(format: "%.3f ms", Double(nanoseconds) / 1_000_000)
+    }
+}
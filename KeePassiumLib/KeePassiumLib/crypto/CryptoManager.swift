@@ -32,9 +32,9 @@ public final class CryptoManager {
     public static func getRandomBytes(count: Int) throws -> ByteArray {
         let output = ByteArray(count: count)
         let status = output.withMutableBytes { (outBytes: inout [UInt8]) in
-            return SecRandomCopyBytes(kSecRandomDefault, outBytes.count, &outBytes)
+            return drbg_shared_fill(&outBytes, outBytes.count)
         }
-        if status != errSecSuccess {
+        if status != DRBG_OK {
             Diag.warning("Failed to generate random bytes [count: \(count), status: \(status)]")
             throw CryptoError.rngError(code: Int(status))
         }
@@ -6,11 +6,15 @@
 //  by the Free Software Foundation: https://www.gnu.org/licenses/).
 //  For commercial licensing, please contact the author.
 
+/// Cryptographically secure generator, backed by the shared native DRBG (see `drbg.h`),
+/// which is seeded and periodically reseeded by the OS.
 public struct SecureRandomNumberGenerator: RandomNumberGenerator {
     public func next() -> UInt64 {
         var random: UInt64 = 0
-        let status = SecRandomCopyBytes(kSecRandomDefault, MemoryLayout<UInt64>.size, &random)
-        guard status == errSecSuccess else {
+        let status = withUnsafeMutableBytes(of: &random) { buffer in
+            drbg_shared_fill(buffer.baseAddress?.assumingMemoryBound(to: UInt8.self), buffer.count)
+        }
+        guard status == DRBG_OK else {
             Diag.warning("Failed to generate random bytes [status: \(status)]")
             __failed_to_generate_random_bytes()
             fatalError()
@@ -18,6 +22,22 @@ public struct SecureRandomNumberGenerator: RandomNumberGenerator {
         return random
     }
 
+    /// Returns `count` uniformly distributed indices in `0..<upperBound`, generated in one go.
+    public func nextIndices(count: Int, upperBound: Int) -> [Int] {
+        precondition(upperBound > 0 && upperBound <= UInt32.max, "Upper bound out of range")
+        guard count > 0 else {
+            return []
+        }
+        var values = [UInt32](repeating: 0, count: count)
+        let status = drbg_shared_uniform(UInt32(upperBound), &values, count)
+        guard status == DRBG_OK else {
+            Diag.warning("Failed to generate random indices [status: \(status)]")
+            __failed_to_generate_random_bytes()
+            fatalError()
+        }
+        return values.map { Int($0) }
+    }
+
     private func __failed_to_generate_random_bytes() {
         fatalError()
     }
@@ -0,0 +1,820 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "aes_cbc.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AES_CBC_HAVE_AESNI 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#define AES_CBC_HAVE_ARMV8_CE 1
+#include <arm_neon.h>
+#endif
+
+#define AES_CBC_ROUNDS 14
+#define AES_CBC_ROUND_KEYS_SIZE ((AES_CBC_ROUNDS + 1) * AES_CBC_BLOCK_SIZE)
+
+/// Block processing kernels. Encryption takes the expanded key, decryption the key
+/// of the equivalent inverse cipher (FIPS-197, 5.3.5), which suits both AES-NI and ARMv8-CE.
+/// Both update `iv` to the last ciphertext block and allow `out == in`.
+typedef struct {
+    const char *name;
+    void (*encrypt_cbc)(const uint8_t *round_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks);
+    void (*decrypt_cbc)(const uint8_t *round_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks);
+} aes_cbc_kernel;
+
+static uint8_t aes_sbox[256];
+static uint8_t aes_inv_sbox[256];
+
+static pthread_once_t aes_cbc_once = PTHREAD_ONCE_INIT;
+static const aes_cbc_kernel *aes_cbc_active_kernel = NULL;
+
+static void aes_cbc_wipe(void *buffer, size_t length) {
+    volatile uint8_t *bytes = buffer;
+    while (length--) {
+        *bytes++ = 0;
+    }
+}
+
+static inline uint8_t aes_xtime(uint8_t x) {
+    return (uint8_t)((x << 1) ^ (((x >> 7) & 1) * 0x1B));
+}
+
+static inline uint8_t aes_rotl8(uint8_t x, int shift) {
+    return (uint8_t)((x << shift) | (x >> (8 - shift)));
+}
+
+/// Builds the S-boxes by walking GF(2^8) with generator 3 and its inverse.
+static void aes_make_sboxes(void) {
+    uint8_t p = 1;
+    uint8_t q = 1;
+    do {
+        p = p ^ (uint8_t)(p << 1) ^ ((p & 0x80) ? 0x1B : 0);
+        q ^= (uint8_t)(q << 1);
+        q ^= (uint8_t)(q << 2);
+        q ^= (uint8_t)(q << 4);
+        if (q & 0x80) {
+            q ^= 0x09;
+        }
+        // q is now the multiplicative inverse of p
+        const uint8_t x = q ^ aes_rotl8(q, 1) ^ aes_rotl8(q, 2) ^ aes_rotl8(q, 3) ^ aes_rotl8(q, 4);
+        aes_sbox[p] = x ^ 0x63;
+    } while (p != 1);
+    aes_sbox[0] = 0x63;
+    for (int i = 0; i < 256; i++) {
+        aes_inv_sbox[aes_sbox[i]] = (uint8_t)i;
+    }
+}
+
+static void aes_expand_key(const uint8_t *key, uint8_t *round_keys) {
+    memcpy(round_keys, key, AES_CBC_KEY_SIZE);
+    uint8_t rcon = 1;
+    for (int i = 8; i < 4 * (AES_CBC_ROUNDS + 1); i++) {
+        uint8_t t[4];
+        memcpy(t, round_keys + 4 * (i - 1), 4);
+        if (i % 8 == 0) {
+            const uint8_t t0 = t[0];
+            t[0] = aes_sbox[t[1]] ^ rcon;
+            t[1] = aes_sbox[t[2]];
+            t[2] = aes_sbox[t[3]];
+            t[3] = aes_sbox[t0];
+            rcon = aes_xtime(rcon);
+        } else if (i % 8 == 4) {
+            for (int j = 0; j < 4; j++) {
+                t[j] = aes_sbox[t[j]];
+            }
+        }
+        for (int j = 0; j < 4; j++) {
+            round_keys[4 * i + j] = round_keys[4 * (i - 8) + j] ^ t[j];
+        }
+    }
+}
+
+static void aes_mix_columns(uint8_t *s) {
+    for (int c = 0; c < 4; c++) {
+        uint8_t *a = s + 4 * c;
+        const uint8_t all = a[0] ^ a[1] ^ a[2] ^ a[3];
+        const uint8_t a0 = a[0];
+        a[0] ^= all ^ aes_xtime(a[0] ^ a[1]);
+        a[1] ^= all ^ aes_xtime(a[1] ^ a[2]);
+        a[2] ^= all ^ aes_xtime(a[2] ^ a[3]);
+        a[3] ^= all ^ aes_xtime(a[3] ^ a0);
+    }
+}
+
+static void aes_inv_mix_columns(uint8_t *s) {
+    for (int c = 0; c < 4; c++) {
+        uint8_t *a = s + 4 * c;
+        const uint8_t u = aes_xtime(aes_xtime(a[0] ^ a[2]));
+        const uint8_t v = aes_xtime(aes_xtime(a[1] ^ a[3]));
+        a[0] ^= u;
+        a[1] ^= v;
+        a[2] ^= u;
+        a[3] ^= v;
+    }
+    aes_mix_columns(s);
+}
+
+/// Converts an expanded key to the key of the equivalent inverse cipher:
+/// reversed round order, with InvMixColumns applied to all but the outer round keys.
+static void aes_make_decryption_key(const uint8_t *round_keys, uint8_t *inverse_keys) {
+    for (int r = 0; r <= AES_CBC_ROUNDS; r++) {
+        uint8_t *target = inverse_keys + AES_CBC_BLOCK_SIZE * r;
+        memcpy(target, round_keys + AES_CBC_BLOCK_SIZE * (AES_CBC_ROUNDS - r), AES_CBC_BLOCK_SIZE);
+        if (r != 0 && r != AES_CBC_ROUNDS) {
+            aes_inv_mix_columns(target);
+        }
+    }
+}
+
+// Portable kernel
+
+static inline void aes_add_round_key(uint8_t *s, const uint8_t *round_key) {
+    for (int i = 0; i < AES_CBC_BLOCK_SIZE; i++) {
+        s[i] ^= round_key[i];
+    }
+}
+
+/// SubBytes and ShiftRows in one pass; the state is column-major.
+static inline void aes_sub_shift(uint8_t *s) {
+    uint8_t t[AES_CBC_BLOCK_SIZE];
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            t[r + 4 * c] = aes_sbox[s[r + 4 * ((c + r) & 3)]];
+        }
+    }
+    memcpy(s, t, sizeof(t));
+}
+
+static inline void aes_inv_sub_shift(uint8_t *s) {
+    uint8_t t[AES_CBC_BLOCK_SIZE];
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            t[r + 4 * c] = aes_inv_sbox[s[r + 4 * ((c - r) & 3)]];
+        }
+    }
+    memcpy(s, t, sizeof(t));
+}
+
+static void portable_encrypt_block(const uint8_t *round_keys, uint8_t *s) {
+    aes_add_round_key(s, round_keys);
+    for (int r = 1; r < AES_CBC_ROUNDS; r++) {
+        aes_sub_shift(s);
+        aes_mix_columns(s);
+        aes_add_round_key(s, round_keys + AES_CBC_BLOCK_SIZE * r);
+    }
+    aes_sub_shift(s);
+    aes_add_round_key(s, round_keys + AES_CBC_BLOCK_SIZE * AES_CBC_ROUNDS);
+}
+
+static void portable_decrypt_block(const uint8_t *inverse_keys, uint8_t *s) {
+    aes_add_round_key(s, inverse_keys);
+    for (int r = 1; r < AES_CBC_ROUNDS; r++) {
+        aes_inv_sub_shift(s);
+        aes_inv_mix_columns(s);
+        aes_add_round_key(s, inverse_keys + AES_CBC_BLOCK_SIZE * r);
+    }
+    aes_inv_sub_shift(s);
+    aes_add_round_key(s, inverse_keys + AES_CBC_BLOCK_SIZE * AES_CBC_ROUNDS);
+}
+
+static void portable_encrypt_cbc(
+    const uint8_t *round_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    uint8_t state[AES_CBC_BLOCK_SIZE];
+    memcpy(state, iv, AES_CBC_BLOCK_SIZE);
+    for (size_t i = 0; i < blocks; i++) {
+        for (int j = 0; j < AES_CBC_BLOCK_SIZE; j++) {
+            state[j] ^= in[j];
+        }
+        portable_encrypt_block(round_keys, state);
+        memcpy(out, state, AES_CBC_BLOCK_SIZE);
+        in += AES_CBC_BLOCK_SIZE;
+        out += AES_CBC_BLOCK_SIZE;
+    }
+    memcpy(iv, state, AES_CBC_BLOCK_SIZE);
+}
+
+static void portable_decrypt_cbc(
+    const uint8_t *inverse_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    uint8_t state[AES_CBC_BLOCK_SIZE];
+    uint8_t previous[AES_CBC_BLOCK_SIZE];
+    memcpy(previous, iv, AES_CBC_BLOCK_SIZE);
+    for (size_t i = 0; i < blocks; i++) {
+        memcpy(state, in, AES_CBC_BLOCK_SIZE);
+        portable_decrypt_block(inverse_keys, state);
+        for (int j = 0; j < AES_CBC_BLOCK_SIZE; j++) {
+            state[j] ^= previous[j];
+        }
+        memcpy(previous, in, AES_CBC_BLOCK_SIZE);
+        memcpy(out, state, AES_CBC_BLOCK_SIZE);
+        in += AES_CBC_BLOCK_SIZE;
+        out += AES_CBC_BLOCK_SIZE;
+    }
+    memcpy(iv, previous, AES_CBC_BLOCK_SIZE);
+    aes_cbc_wipe(state, sizeof(state));
+}
+
+static const aes_cbc_kernel aes_cbc_portable_kernel = {
+    "portable", portable_encrypt_cbc, portable_decrypt_cbc
+};
+
+// Applies `step(i)` to each of the 8 blocks decrypted in parallel.
+#define AES_CBC_X8(step) step(0) step(1) step(2) step(3) step(4) step(5) step(6) step(7)
+
+// AES-NI kernel
+
+#if AES_CBC_HAVE_AESNI
+
+#define AES_CBC_TARGET_AESNI __attribute__((target("aes,sse2")))
+
+AES_CBC_TARGET_AESNI
+static void aesni_encrypt_cbc(
+    const uint8_t *round_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    __m128i k[AES_CBC_ROUNDS + 1];
+    for (int r = 0; r <= AES_CBC_ROUNDS; r++) {
+        k[r] = _mm_loadu_si128((const __m128i *)(round_keys + AES_CBC_BLOCK_SIZE * r));
+    }
+    __m128i state = _mm_loadu_si128((const __m128i *)iv);
+    for (size_t i = 0; i < blocks; i++) {
+        state = _mm_xor_si128(state, _mm_loadu_si128((const __m128i *)in));
+        state = _mm_xor_si128(state, k[0]);
+        for (int r = 1; r < AES_CBC_ROUNDS; r++) {
+            state = _mm_aesenc_si128(state, k[r]);
+        }
+        state = _mm_aesenclast_si128(state, k[AES_CBC_ROUNDS]);
+        _mm_storeu_si128((__m128i *)out, state);
+        in += AES_CBC_BLOCK_SIZE;
+        out += AES_CBC_BLOCK_SIZE;
+    }
+    _mm_storeu_si128((__m128i *)iv, state);
+}
+
+/// Decrypts 8 blocks at a time: unlike encryption, CBC decryption has no dependency
+/// between blocks, so this hides the latency of AESDEC.
+AES_CBC_TARGET_AESNI
+static void aesni_decrypt_cbc(
+    const uint8_t *inverse_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    __m128i k[AES_CBC_ROUNDS + 1];
+    for (int r = 0; r <= AES_CBC_ROUNDS; r++) {
+        k[r] = _mm_loadu_si128((const __m128i *)(inverse_keys + AES_CBC_BLOCK_SIZE * r));
+    }
+    __m128i previous = _mm_loadu_si128((const __m128i *)iv);
+    while (blocks >= 8) {
+#define AESNI_LOAD(i) \
+        const __m128i c##i = _mm_loadu_si128((const __m128i *)(in + AES_CBC_BLOCK_SIZE * i)); \
+        __m128i b##i = _mm_xor_si128(c##i, k[0]);
+        AES_CBC_X8(AESNI_LOAD)
+        for (int r = 1; r < AES_CBC_ROUNDS; r++) {
+            const __m128i round_key = k[r];
+#define AESNI_ROUND(i) b##i = _mm_aesdec_si128(b##i, round_key);
+            AES_CBC_X8(AESNI_ROUND)
+        }
+#define AESNI_LAST_ROUND(i) b##i = _mm_aesdeclast_si128(b##i, k[AES_CBC_ROUNDS]);
+        AES_CBC_X8(AESNI_LAST_ROUND)
+        b0 = _mm_xor_si128(b0, previous);
+        b1 = _mm_xor_si128(b1, c0);
+        b2 = _mm_xor_si128(b2, c1);
+        b3 = _mm_xor_si128(b3, c2);
+        b4 = _mm_xor_si128(b4, c3);
+        b5 = _mm_xor_si128(b5, c4);
+        b6 = _mm_xor_si128(b6, c5);
+        b7 = _mm_xor_si128(b7, c6);
+        previous = c7;
+#define AESNI_STORE(i) _mm_storeu_si128((__m128i *)(out + AES_CBC_BLOCK_SIZE * i), b##i);
+        AES_CBC_X8(AESNI_STORE)
+#undef AESNI_LOAD
+#undef AESNI_ROUND
+#undef AESNI_LAST_ROUND
+#undef AESNI_STORE
+        in += 8 * AES_CBC_BLOCK_SIZE;
+        out += 8 * AES_CBC_BLOCK_SIZE;
+        blocks -= 8;
+    }
+    for (; blocks > 0; blocks--) {
+        const __m128i c = _mm_loadu_si128((const __m128i *)in);
+        __m128i b = _mm_xor_si128(c, k[0]);
+        for (int r = 1; r < AES_CBC_ROUNDS; r++) {
+            b = _mm_aesdec_si128(b, k[r]);
+        }
+        b = _mm_aesdeclast_si128(b, k[AES_CBC_ROUNDS]);
+        _mm_storeu_si128((__m128i *)out, _mm_xor_si128(b, previous));
+        previous = c;
+        in += AES_CBC_BLOCK_SIZE;
+        out += AES_CBC_BLOCK_SIZE;
+    }
+    _mm_storeu_si128((__m128i *)iv, previous);
+}
+
+static const aes_cbc_kernel aes_cbc_aesni_kernel = {
+    "aes-ni", aesni_encrypt_cbc, aesni_decrypt_cbc
+};
+
+#endif /* AES_CBC_HAVE_AESNI */
+
+// ARMv8 Crypto Extensions kernel
+
+#if AES_CBC_HAVE_ARMV8_CE
+
+static void armce_encrypt_cbc(
+    const uint8_t *round_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    uint8x16_t k[AES_CBC_ROUNDS + 1];
+    for (int r = 0; r <= AES_CBC_ROUNDS; r++) {
+        k[r] = vld1q_u8(round_keys + AES_CBC_BLOCK_SIZE * r);
+    }
+    uint8x16_t state = vld1q_u8(iv);
+    for (size_t i = 0; i < blocks; i++) {
+        state = veorq_u8(state, vld1q_u8(in));
+        for (int r = 0; r < AES_CBC_ROUNDS - 1; r++) {
+            state = vaesmcq_u8(vaeseq_u8(state, k[r]));
+        }
+        state = veorq_u8(vaeseq_u8(state, k[AES_CBC_ROUNDS - 1]), k[AES_CBC_ROUNDS]);
+        vst1q_u8(out, state);
+        in += AES_CBC_BLOCK_SIZE;
+        out += AES_CBC_BLOCK_SIZE;
+    }
+    vst1q_u8(iv, state);
+}
+
+/// Decrypts 8 blocks at a time, to keep the AESD/AESIMC pipeline full.
+static void armce_decrypt_cbc(
+    const uint8_t *inverse_keys, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    uint8x16_t k[AES_CBC_ROUNDS + 1];
+    for (int r = 0; r <= AES_CBC_ROUNDS; r++) {
+        k[r] = vld1q_u8(inverse_keys + AES_CBC_BLOCK_SIZE * r);
+    }
+    uint8x16_t previous = vld1q_u8(iv);
+    while (blocks >= 8) {
+#define ARMCE_LOAD(i) \
+        const uint8x16_t c##i = vld1q_u8(in + AES_CBC_BLOCK_SIZE * i); \
+        uint8x16_t b##i = c##i;
+        AES_CBC_X8(ARMCE_LOAD)
+        for (int r = 0; r < AES_CBC_ROUNDS - 1; r++) {
+            const uint8x16_t round_key = k[r];
+#define ARMCE_ROUND(i) b##i = vaesimcq_u8(vaesdq_u8(b##i, round_key));
+            AES_CBC_X8(ARMCE_ROUND)
+        }
+#define ARMCE_LAST_ROUND(i) \
+        b##i = veorq_u8(vaesdq_u8(b##i, k[AES_CBC_ROUNDS - 1]), k[AES_CBC_ROUNDS]);
+        AES_CBC_X8(ARMCE_LAST_ROUND)
+        b0 = veorq_u8(b0, previous);
+        b1 = veorq_u8(b1, c0);
+        b2 = veorq_u8(b2, c1);
+        b3 = veorq_u8(b3, c2);
+        b4 = veorq_u8(b4, c3);
+        b5 = veorq_u8(b5, c4);
+        b6 = veorq_u8(b6, c5);
+        b7 = veorq_u8(b7, c6);
+        previous = c7;
+#define ARMCE_STORE(i) vst1q_u8(out + AES_CBC_BLOCK_SIZE * i, b##i);
+        AES_CBC_X8(ARMCE_STORE)
+#undef ARMCE_LOAD
+#undef ARMCE_ROUND
+#undef ARMCE_LAST_ROUND
+#undef ARMCE_STORE
+        in += 8 * AES_CBC_BLOCK_SIZE;
+        out += 8 * AES_CBC_BLOCK_SIZE;
+        blocks -= 8;
+    }
+    for (; blocks > 0; blocks--) {
+        const uint8x16_t c = vld1q_u8(in);
+        uint8x16_t b = c;
+        for (int r = 0; r < AES_CBC_ROUNDS - 1; r++) {
+            b = vaesimcq_u8(vaesdq_u8(b, k[r]));
+        }
+        b = veorq_u8(vaesdq_u8(b, k[AES_CBC_ROUNDS - 1]), k[AES_CBC_ROUNDS]);
+        vst1q_u8(out, veorq_u8(b, previous));
+        previous = c;
+        in += AES_CBC_BLOCK_SIZE;
+        out += AES_CBC_BLOCK_SIZE;
+    }
+    vst1q_u8(iv, previous);
+}
+
+static const aes_cbc_kernel aes_cbc_armce_kernel = {
+    "armv8-ce", armce_encrypt_cbc, armce_decrypt_cbc
+};
+
+#endif /* AES_CBC_HAVE_ARMV8_CE */
+
+// Common
+
+static void aes_cbc_setup(void) {
+    aes_make_sboxes();
+    aes_cbc_active_kernel = &aes_cbc_portable_kernel;
+#if AES_CBC_HAVE_AESNI
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("aes")) {
+        aes_cbc_active_kernel = &aes_cbc_aesni_kernel;
+    }
+#elif AES_CBC_HAVE_ARMV8_CE
+    aes_cbc_active_kernel = &aes_cbc_armce_kernel;
+#endif
+}
+
+static const aes_cbc_kernel *aes_cbc_get_kernel(void) {
+    pthread_once(&aes_cbc_once, aes_cbc_setup);
+    return aes_cbc_active_kernel;
+}
+
+const char *aes_cbc_implementation(void) {
+    return aes_cbc_get_kernel()->name;
+}
+
+/// Returns the PKCS7 padding length of the last block, or 0 if the padding is invalid.
+/// Looks at all bytes regardless of the padding value.
+static size_t aes_cbc_padding_length(const uint8_t *last_block) {
+    const uint32_t pad = last_block[AES_CBC_BLOCK_SIZE - 1];
+    uint32_t bad = ((pad - 1) >> 8) | ((AES_CBC_BLOCK_SIZE - pad) >> 8); // pad == 0 or pad > 16
+    for (uint32_t i = 0; i < AES_CBC_BLOCK_SIZE; i++) {
+        const uint32_t in_padding = 0 - ((AES_CBC_BLOCK_SIZE - 1 - i - pad) >> 31); // i >= 16 - pad
+        bad |= in_padding & (last_block[i] ^ pad);
+    }
+    return bad == 0 ? pad : 0;
+}
+
+int aes_cbc_encrypt(
+    const uint8_t *key, const uint8_t *iv,
+    const uint8_t *in, size_t in_length,
+    uint8_t *out, size_t out_capacity, size_t *out_length,
+    aes_cbc_progress_fptr progress_callback, const void *user_object,
+    crypto_stats *stats)
+{
+    if (key == NULL || iv == NULL || out == NULL || out_length == NULL || (in == NULL && in_length > 0)) {
+        return AES_CBC_INVALID_PARAMETER;
+    }
+    *out_length = 0;
+    const size_t whole_length = in_length - in_length % AES_CBC_BLOCK_SIZE;
+    if (out_capacity < whole_length + AES_CBC_BLOCK_SIZE) {
+        return AES_CBC_BUFFER_TOO_SMALL;
+    }
+    const aes_cbc_kernel *kernel = aes_cbc_get_kernel();
+
+    uint64_t phase_start = crypto_phase_begin(stats);
+    uint8_t round_keys[AES_CBC_ROUND_KEYS_SIZE];
+    aes_expand_key(key, round_keys);
+    crypto_phase_end(stats, CRYPTO_OPERATION_CIPHER, CRYPTO_PHASE_INITIALIZE, phase_start, 0);
+
+    phase_start = crypto_phase_begin(stats);
+    int status = AES_CBC_OK;
+    uint8_t chain[AES_CBC_BLOCK_SIZE];
+    memcpy(chain, iv, AES_CBC_BLOCK_SIZE);
+    size_t offset = 0;
+    while (offset < whole_length) {
+        const size_t length = (whole_length - offset < AES_CBC_CHUNK_SIZE) ? whole_length - offset : AES_CBC_CHUNK_SIZE;
+        kernel->encrypt_cbc(round_keys, chain, in + offset, out + offset, length / AES_CBC_BLOCK_SIZE);
+        offset += length;
+        if (progress_callback && progress_callback(offset, user_object)) {
+            status = AES_CBC_INTERRUPTED;
+            break;
+        }
+    }
+    if (status == AES_CBC_OK) {
+        const size_t tail_length = in_length - whole_length;
+        const uint8_t pad = (uint8_t)(AES_CBC_BLOCK_SIZE - tail_length);
+        uint8_t last_block[AES_CBC_BLOCK_SIZE];
+        if (tail_length > 0) {
+            memcpy(last_block, in + whole_length, tail_length);
+        }
+        memset(last_block + tail_length, pad, pad);
+        kernel->encrypt_cbc(round_keys, chain, last_block, out + whole_length, 1);
+        aes_cbc_wipe(last_block, sizeof(last_block));
+        *out_length = whole_length + AES_CBC_BLOCK_SIZE;
+    }
+    crypto_phase_end(stats, CRYPTO_OPERATION_CIPHER, CRYPTO_PHASE_TRANSFORM, phase_start, offset);
+    if (stats) {
+        stats->bytes_processed += offset;
+        stats->blocks_processed += offset / AES_CBC_BLOCK_SIZE;
+    }
+    aes_cbc_wipe(round_keys, sizeof(round_keys));
+    return status;
+}
+
+/// Shared state of a (possibly multi-threaded) decryption.
+typedef struct {
+    const aes_cbc_kernel *kernel;
+    const uint8_t *inverse_keys;
+    const uint8_t *in;
+    uint8_t *out;
+    size_t length;
+    size_t chunk_count;
+    const uint8_t *chunk_ivs;   // the block preceding each chunk, taken before any output is written
+    size_t next_chunk;          // atomic
+    uint64_t bytes_done;        // atomic
+    int stop;                   // atomic
+} aes_cbc_decrypt_job;
+
+/// Decrypts chunks until none is left. Every thread runs this loop,
+/// but only the calling thread reports progress.
+static void aes_cbc_decrypt_chunks(
+    aes_cbc_decrypt_job *job,
+    aes_cbc_progress_fptr progress_callback, const void *user_object)
+{
+    uint8_t chain[AES_CBC_BLOCK_SIZE];
+    while (!__atomic_load_n(&job->stop, __ATOMIC_RELAXED)) {
+        const size_t chunk = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (chunk >= job->chunk_count) {
+            break;
+        }
+        const size_t offset = chunk * AES_CBC_CHUNK_SIZE;
+        const size_t length = (job->length - offset < AES_CBC_CHUNK_SIZE) ? job->length - offset : AES_CBC_CHUNK_SIZE;
+        memcpy(chain, job->chunk_ivs + AES_CBC_BLOCK_SIZE * chunk, AES_CBC_BLOCK_SIZE);
+        job->kernel->decrypt_cbc(job->inverse_keys, chain, job->in + offset, job->out + offset,
+                                 length / AES_CBC_BLOCK_SIZE);
+        const uint64_t bytes_done = __atomic_add_fetch(&job->bytes_done, length, __ATOMIC_RELAXED);
+        if (progress_callback && progress_callback(bytes_done, user_object)) {
+            __atomic_store_n(&job->stop, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void *aes_cbc_decrypt_worker(void *arg) {
+    aes_cbc_decrypt_chunks((aes_cbc_decrypt_job *)arg, NULL, NULL);
+    return NULL;
+}
+
+#define AES_CBC_MAX_THREADS 64
+
+static uint32_t aes_cbc_thread_count(uint32_t threads, size_t in_length, size_t chunk_count) {
+    if (in_length < AES_CBC_PARALLEL_MIN_SIZE) {
+        return 1;
+    }
+    if (threads == 0) {
+        const long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpu_count > 0) ? (uint32_t)cpu_count : 1;
+    }
+    if (threads > AES_CBC_MAX_THREADS) {
+        threads = AES_CBC_MAX_THREADS;
+    }
+    return (threads < chunk_count) ? threads : (uint32_t)chunk_count;
+}
+
+int aes_cbc_decrypt(
+    const uint8_t *key, const uint8_t *iv,
+    const uint8_t *in, size_t in_length,
+    uint8_t *out, size_t out_capacity, size_t *out_length,
+    uint32_t threads,
+    aes_cbc_progress_fptr progress_callback, const void *user_object,
+    crypto_stats *stats)
+{
+    if (key == NULL || iv == NULL || in == NULL || out == NULL || out_length == NULL) {
+        return AES_CBC_INVALID_PARAMETER;
+    }
+    *out_length = 0;
+    if (in_length == 0 || in_length % AES_CBC_BLOCK_SIZE != 0) {
+        return AES_CBC_LENGTH_ERROR;
+    }
+    if (out_capacity < in_length) {
+        return AES_CBC_BUFFER_TOO_SMALL;
+    }
+    const aes_cbc_kernel *kernel = aes_cbc_get_kernel();
+
+    const size_t chunk_count = (in_length + AES_CBC_CHUNK_SIZE - 1) / AES_CBC_CHUNK_SIZE;
+    uint8_t *chunk_ivs = malloc(chunk_count * AES_CBC_BLOCK_SIZE);
+    if (chunk_ivs == NULL) {
+        return AES_CBC_MEMORY_ERROR;
+    }
+    memcpy(chunk_ivs, iv, AES_CBC_BLOCK_SIZE);
+    for (size_t chunk = 1; chunk < chunk_count; chunk++) {
+        memcpy(chunk_ivs + AES_CBC_BLOCK_SIZE * chunk,
+               in + chunk * AES_CBC_CHUNK_SIZE - AES_CBC_BLOCK_SIZE,
+               AES_CBC_BLOCK_SIZE);
+    }
+
+    uint64_t phase_start = crypto_phase_begin(stats);
+    uint8_t round_keys[AES_CBC_ROUND_KEYS_SIZE];
+    uint8_t inverse_keys[AES_CBC_ROUND_KEYS_SIZE];
+    aes_expand_key(key, round_keys);
+    aes_make_decryption_key(round_keys, inverse_keys);
+    aes_cbc_wipe(round_keys, sizeof(round_keys));
+    crypto_phase_end(stats, CRYPTO_OPERATION_CIPHER, CRYPTO_PHASE_INITIALIZE, phase_start, 0);
+
+    aes_cbc_decrypt_job job = {
+        .kernel = kernel,
+        .inverse_keys = inverse_keys,
+        .in = in,
+        .out = out,
+        .length = in_length,
+        .chunk_count = chunk_count,
+        .chunk_ivs = chunk_ivs,
+        .next_chunk = 0,
+        .bytes_done = 0,
+        .stop = 0
+    };
+
+    phase_start = crypto_phase_begin(stats);
+    const uint32_t thread_count = aes_cbc_thread_count(threads, in_length, chunk_count);
+    pthread_t workers[AES_CBC_MAX_THREADS];
+    uint32_t worker_count = 0;
+    for (uint32_t i = 0; i + 1 < thread_count; i++) {
+        if (pthread_create(&workers[worker_count], NULL, aes_cbc_decrypt_worker, &job) != 0) {
+            break; // the remaining threads take over its share
+        }
+        worker_count++;
+    }
+    aes_cbc_decrypt_chunks(&job, progress_callback, user_object);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    if (worker_count > 0 && progress_callback && !job.stop && progress_callback(job.bytes_done, user_object)) {
+        job.stop = 1; // the workers might have taken the last chunks, so report the final state too
+    }
+    crypto_phase_end(stats, CRYPTO_OPERATION_CIPHER, CRYPTO_PHASE_TRANSFORM, phase_start, job.bytes_done);
+    if (stats) {
+        stats->bytes_processed += job.bytes_done;
+        stats->blocks_processed += job.bytes_done / AES_CBC_BLOCK_SIZE;
+        stats->threads_spawned += worker_count;
+    }
+    aes_cbc_wipe(inverse_keys, sizeof(inverse_keys));
+    free(chunk_ivs);
+
+    int status = AES_CBC_OK;
+    size_t padding_length = 0;
+    if (job.stop) {
+        status = AES_CBC_INTERRUPTED;
+    } else {
+        padding_length = aes_cbc_padding_length(out + in_length - AES_CBC_BLOCK_SIZE);
+        if (padding_length == 0) {
+            status = AES_CBC_PADDING_ERROR;
+        }
+    }
+    if (status != AES_CBC_OK) {
+        memset(out, 0, in_length);
+        return status;
+    }
+    *out_length = in_length - padding_length;
+    return AES_CBC_OK;
+}
+
+// Incremental interface
+
+struct aes_cbc_context {
+    const aes_cbc_kernel *kernel;
+    uint8_t round_keys[AES_CBC_ROUND_KEYS_SIZE]; // inverse cipher keys when decrypting
+    uint8_t chain[AES_CBC_BLOCK_SIZE];
+    uint8_t pending[AES_CBC_BLOCK_SIZE];
+    size_t pending_length;
+    aes_cbc_direction direction;
+    int padding;
+    int is_finished;
+};
+
+aes_cbc_context *aes_cbc_create(aes_cbc_direction direction, const uint8_t *key, const uint8_t *iv, int padding) {
+    if (key == NULL || iv == NULL || (direction != AES_CBC_ENCRYPT && direction != AES_CBC_DECRYPT)) {
+        return NULL;
+    }
+    aes_cbc_context *ctx = calloc(1, sizeof(aes_cbc_context));
+    if (ctx == NULL) {
+        return NULL;
+    }
+    ctx->kernel = aes_cbc_get_kernel();
+    ctx->direction = direction;
+    ctx->padding = padding ? 1 : 0;
+    aes_expand_key(key, ctx->round_keys);
+    if (direction == AES_CBC_DECRYPT) {
+        uint8_t round_keys[AES_CBC_ROUND_KEYS_SIZE];
+        memcpy(round_keys, ctx->round_keys, sizeof(round_keys));
+        aes_make_decryption_key(round_keys, ctx->round_keys);
+        aes_cbc_wipe(round_keys, sizeof(round_keys));
+    }
+    memcpy(ctx->chain, iv, AES_CBC_BLOCK_SIZE);
+    return ctx;
+}
+
+/// Number of bytes aes_cbc_update() would process now, out of `total` available ones.
+static size_t aes_cbc_update_length(const aes_cbc_context *ctx, size_t total) {
+    if (ctx->direction == AES_CBC_DECRYPT && ctx->padding) {
+        // keep the last whole block for aes_cbc_final()
+        return (total > AES_CBC_BLOCK_SIZE) ? (total - 1) / AES_CBC_BLOCK_SIZE * AES_CBC_BLOCK_SIZE : 0;
+    }
+    return total / AES_CBC_BLOCK_SIZE * AES_CBC_BLOCK_SIZE;
+}
+
+size_t aes_cbc_output_size(const aes_cbc_context *ctx, size_t in_length, int is_final) {
+    if (ctx == NULL || ctx->is_finished) {
+        return 0;
+    }
+    const size_t total = ctx->pending_length + in_length;
+    if (!is_final) {
+        return aes_cbc_update_length(ctx, total);
+    }
+    const size_t whole_length = total / AES_CBC_BLOCK_SIZE * AES_CBC_BLOCK_SIZE;
+    if (ctx->direction == AES_CBC_ENCRYPT && ctx->padding) {
+        return whole_length + AES_CBC_BLOCK_SIZE;
+    }
+    return whole_length;
+}
+
+static void aes_cbc_process(aes_cbc_context *ctx, const uint8_t *in, uint8_t *out, size_t blocks) {
+    if (ctx->direction == AES_CBC_ENCRYPT) {
+        ctx->kernel->encrypt_cbc(ctx->round_keys, ctx->chain, in, out, blocks);
+    } else {
+        ctx->kernel->decrypt_cbc(ctx->round_keys, ctx->chain, in, out, blocks);
+    }
+}
+
+int aes_cbc_update(
+    aes_cbc_context *ctx,
+    const uint8_t *in, size_t in_length,
+    uint8_t *out, size_t out_capacity, size_t *out_length)
+{
+    if (ctx == NULL || out_length == NULL || ctx->is_finished || (in == NULL && in_length > 0)) {
+        return AES_CBC_INVALID_PARAMETER;
+    }
+    *out_length = 0;
+    size_t process_length = aes_cbc_update_length(ctx, ctx->pending_length + in_length);
+    if (out_capacity < process_length || (out == NULL && process_length > 0)) {
+        return AES_CBC_BUFFER_TOO_SMALL;
+    }
+    *out_length = process_length;
+    if (ctx->pending_length > 0 && process_length > 0) {
+        const size_t fill_length = AES_CBC_BLOCK_SIZE - ctx->pending_length;
+        memcpy(ctx->pending + ctx->pending_length, in, fill_length);
+        in += fill_length;
+        in_length -= fill_length;
+        aes_cbc_process(ctx, ctx->pending, out, 1);
+        ctx->pending_length = 0;
+        out += AES_CBC_BLOCK_SIZE;
+        process_length -= AES_CBC_BLOCK_SIZE;
+    }
+    if (process_length > 0) {
+        aes_cbc_process(ctx, in, out, process_length / AES_CBC_BLOCK_SIZE);
+        in += process_length;
+        in_length -= process_length;
+    }
+    if (in_length > 0) {
+        memcpy(ctx->pending + ctx->pending_length, in, in_length);
+        ctx->pending_length += in_length;
+    }
+    return AES_CBC_OK;
+}
+
+int aes_cbc_final(aes_cbc_context *ctx, uint8_t *out, size_t out_capacity, size_t *out_length) {
+    if (ctx == NULL || out_length == NULL || ctx->is_finished) {
+        return AES_CBC_INVALID_PARAMETER;
+    }
+    *out_length = 0;
+    if (!ctx->padding) {
+        if (ctx->pending_length != 0) {
+            return AES_CBC_LENGTH_ERROR;
+        }
+        ctx->is_finished = 1;
+        return AES_CBC_OK;
+    }
+
+    uint8_t block[AES_CBC_BLOCK_SIZE];
+    int status = AES_CBC_OK;
+    if (ctx->direction == AES_CBC_ENCRYPT) {
+        if (out == NULL || out_capacity < AES_CBC_BLOCK_SIZE) {
+            return AES_CBC_BUFFER_TOO_SMALL;
+        }
+        const uint8_t pad = (uint8_t)(AES_CBC_BLOCK_SIZE - ctx->pending_length);
+        memcpy(block, ctx->pending, ctx->pending_length);
+        memset(block + ctx->pending_length, pad, pad);
+        aes_cbc_process(ctx, block, out, 1);
+        *out_length = AES_CBC_BLOCK_SIZE;
+    } else {
+        if (ctx->pending_length != AES_CBC_BLOCK_SIZE) {
+            return AES_CBC_LENGTH_ERROR;
+        }
+        aes_cbc_process(ctx, ctx->pending, block, 1);
+        const size_t padding_length = aes_cbc_padding_length(block);
+        const size_t data_length = AES_CBC_BLOCK_SIZE - padding_length;
+        if (padding_length == 0) {
+            status = AES_CBC_PADDING_ERROR;
+        } else if (data_length > 0 && (out == NULL || out_capacity < data_length)) {
+            status = AES_CBC_BUFFER_TOO_SMALL;
+        } else {
+            memcpy(out, block, data_length);
+            *out_length = data_length;
+        }
+    }
+    aes_cbc_wipe(block, sizeof(block));
+    aes_cbc_wipe(ctx->pending, sizeof(ctx->pending));
+    ctx->pending_length = 0;
+    ctx->is_finished = 1;
+    return status;
+}
+
+void aes_cbc_free(aes_cbc_context *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    aes_cbc_wipe(ctx, sizeof(aes_cbc_context));
+    free(ctx);
+}
@@ -0,0 +1,122 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef aes_cbc_h
+#define aes_cbc_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto_stats.h"
+
+/// AES-256 in CBC mode, without platform crypto frameworks.
+/// Uses AES instructions where available (AES-NI on x86, Crypto Extensions on ARMv8),
+/// with a portable table-based fallback for CPUs without them.
+/// The fallback is not hardened against cache-timing attacks.
+
+#define AES_CBC_BLOCK_SIZE 16
+#define AES_CBC_KEY_SIZE 32
+
+#define AES_CBC_OK 0
+#define AES_CBC_INVALID_PARAMETER (-1)
+#define AES_CBC_BUFFER_TOO_SMALL (-2)
+#define AES_CBC_LENGTH_ERROR (-3)     // input is not a whole number of blocks
+#define AES_CBC_PADDING_ERROR (-4)    // invalid PKCS7 padding, usually a wrong key
+#define AES_CBC_INTERRUPTED (-5)      // stopped by the progress callback
+#define AES_CBC_MEMORY_ERROR (-6)
+
+/// One-shot functions process data in chunks of this size,
+/// calling the progress callback after each chunk.
+#define AES_CBC_CHUNK_SIZE (1024 * 1024)
+
+/// Decryption of shorter inputs always runs on the calling thread.
+#define AES_CBC_PARALLEL_MIN_SIZE (4 * AES_CBC_CHUNK_SIZE)
+
+typedef enum {
+    AES_CBC_ENCRYPT = 0,
+    AES_CBC_DECRYPT = 1
+} aes_cbc_direction;
+
+/// Type for Swift progress callback
+/// @param  bytes_done  input bytes processed so far
+/// @param  user_object  any object passed to the one-shot functions
+/// @return zero to continue, anything else to stop
+typedef int (*aes_cbc_progress_fptr)(uint64_t bytes_done, const void *user_object);
+
+/// Name of the AES implementation in use: "aes-ni", "armv8-ce" or "portable".
+const char *aes_cbc_implementation(void);
+
+/// Encrypts the whole input with PKCS7 padding.
+/// `out` may be the same buffer as `in`.
+/// @param  out_capacity  at least `in_length` rounded up to the next whole block
+///                       (a full extra block if `in_length` is a multiple of the block size)
+/// @param  out_length    receives the size of the ciphertext
+/// @return AES_CBC_OK or an error code
+int aes_cbc_encrypt(
+    const uint8_t *key, const uint8_t *iv,
+    const uint8_t *in, size_t in_length,
+    uint8_t *out, size_t out_capacity, size_t *out_length,
+    aes_cbc_progress_fptr progress_callback, const void *user_object,
+    crypto_stats *stats);
+
+/// Decrypts the whole input and removes PKCS7 padding.
+/// Since CBC blocks decrypt independently, inputs of at least AES_CBC_PARALLEL_MIN_SIZE
+/// are split into chunks decrypted by up to `threads` threads (including the caller's).
+/// `out` may be the same buffer as `in`. On any error, the output is wiped.
+/// @param  out_capacity  at least `in_length`
+/// @param  out_length    receives the size of the plaintext
+/// @param  threads       1 to stay on the calling thread, 0 for one thread per CPU core
+/// @return AES_CBC_OK or an error code
+int aes_cbc_decrypt(
+    const uint8_t *key, const uint8_t *iv,
+    const uint8_t *in, size_t in_length,
+    uint8_t *out, size_t out_capacity, size_t *out_length,
+    uint32_t threads,
+    aes_cbc_progress_fptr progress_callback, const void *user_object,
+    crypto_stats *stats);
+
+/// Incremental interface, for data that arrives in pieces.
+typedef struct aes_cbc_context aes_cbc_context;
+
+/// @param  padding  non-zero to add (or check and remove) PKCS7 padding in aes_cbc_final()
+/// @return a new context, or NULL if out of memory
+aes_cbc_context *aes_cbc_create(aes_cbc_direction direction, const uint8_t *key, const uint8_t *iv, int padding);
+
+/// Max number of bytes that the next aes_cbc_update() (or, if `is_final`, aes_cbc_final())
+/// call can output for `in_length` more input bytes.
+size_t aes_cbc_output_size(const aes_cbc_context *ctx, size_t in_length, int is_final);
+
+/// Processes as many whole blocks as possible, keeping the rest for the next call.
+/// When decrypting with padding, the last whole block is also kept, for aes_cbc_final().
+/// The output must not overlap the input, except that it may be the same buffer
+/// when no bytes are kept from previous calls (for example, when all inputs are whole blocks).
+/// @param  out_length  receives the number of written bytes
+/// @return AES_CBC_OK, AES_CBC_BUFFER_TOO_SMALL (nothing is consumed) or AES_CBC_INVALID_PARAMETER
+int aes_cbc_update(
+    aes_cbc_context *ctx,
+    const uint8_t *in, size_t in_length,
+    uint8_t *out, size_t out_capacity, size_t *out_length);
+
+/// Processes the kept bytes: adds padding when encrypting, checks and removes it when decrypting.
+/// The context cannot be updated afterwards.
+/// @return AES_CBC_OK, AES_CBC_LENGTH_ERROR, AES_CBC_PADDING_ERROR, AES_CBC_BUFFER_TOO_SMALL
+///         or AES_CBC_INVALID_PARAMETER
+int aes_cbc_final(aes_cbc_context *ctx, uint8_t *out, size_t out_capacity, size_t *out_length);
+
+/// Wipes and releases the context. Accepts NULL.
+void aes_cbc_free(aes_cbc_context *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* aes_cbc_h */
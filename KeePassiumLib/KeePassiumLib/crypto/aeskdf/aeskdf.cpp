@@ -12,16 +12,21 @@
 
 
 int32_t aeskdf_rounds(const unsigned char *seed, unsigned char *key, const uint64_t nRounds,
-                      const aeskdf_progress_fptr progress_callback, const void* user_object) {
+                      const aeskdf_progress_fptr progress_callback, const void* user_object,
+                      crypto_stats *stats) {
     int keySize = kCCKeySizeAES256;
     CCCryptorRef cryptorRef;
+    uint64_t phaseStart = crypto_phase_begin(stats);
     int32_t status = CCCryptorCreate(kCCEncrypt, kCCAlgorithmAES128, kCCOptionECBMode, seed, keySize, NULL, &cryptorRef);
+    crypto_phase_end(stats, CRYPTO_OPERATION_AESKDF, CRYPTO_PHASE_INITIALIZE, phaseStart, 0);
     if (status != kCCSuccess) {
         return status;
     }
     
+    phaseStart = crypto_phase_begin(stats);
     size_t nMoved;
-    for (uint64_t round = 0; round < nRounds; round++) {
+    uint64_t round;
+    for (round = 0; round < nRounds; round++) {
         status = CCCryptorUpdate(cryptorRef, key, keySize, key, keySize, &nMoved);
         if (status != kCCSuccess) {
             break;
@@ -29,10 +34,15 @@ int32_t aeskdf_rounds(const unsigned char *seed, unsigned char *key, const uint6
         if ((round % 100000 == 0) && progress_callback) {
             int should_stop = progress_callback(round, user_object);
             if (should_stop) {
-                return kCCSuccess;
+                break;
             }
         }
     }
+    crypto_phase_end(stats, CRYPTO_OPERATION_AESKDF, CRYPTO_PHASE_TRANSFORM, phaseStart, round * keySize);
+    if (stats) {
+        stats->blocks_processed += round;
+        stats->bytes_processed += round * keySize;
+    }
     CCCryptorRelease(cryptorRef);
     return status;
 }
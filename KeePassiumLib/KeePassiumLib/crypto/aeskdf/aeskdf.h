@@ -15,7 +15,7 @@ extern "C" {
 
 #include <stdint.h>
 
-    
+#include "crypto_stats.h"
 
 /// [AP] type for Swift progress callback
 /// @param  round  transformation rounds done so far
@@ -26,8 +26,10 @@ typedef int (*aeskdf_progress_fptr)(uint64_t round, const void *swift_obj);
 /// Native implementation of AES KDF rounds, for higher performance.
 /// Performs `nRounds` of AES KDF rounds on the `key`, starting from `seed`.
 /// Periodically calls `progress_callback` with `user_object` as a parameter.
+/// Phase timings are added to `stats`, unless it is NULL.
 int32_t aeskdf_rounds(const unsigned char *seed, unsigned char *key, const uint64_t nRounds,
-                      const aeskdf_progress_fptr progress_callback, const void* user_object);
+                      const aeskdf_progress_fptr progress_callback, const void* user_object,
+                      crypto_stats *stats);
 
 #ifdef __cplusplus
 }
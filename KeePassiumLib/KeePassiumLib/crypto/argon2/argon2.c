@@ -37,6 +37,57 @@ const char *argon2_type2string(argon2_type type, int uppercase) {
     return NULL;
 }
 
+/* [AP] Caps the thread count and checks the memory budget */
+static int apply_limits(const argon2_limits *limits, uint32_t memory_blocks,
+                        uint32_t lanes, uint32_t *threads, size_t outlen,
+                        size_t *thread_stack_size, argon2_footprint *footprint) {
+    *thread_stack_size = 0;
+    if (limits != NULL) {
+        if (limits->max_threads > 0 && *threads > limits->max_threads) {
+            *threads = limits->max_threads;
+        }
+        *thread_stack_size = limits->thread_stack_size;
+    }
+    estimate_footprint(memory_blocks, lanes, *threads, outlen,
+                       *thread_stack_size, footprint);
+    if (limits != NULL && limits->memory_budget > 0 &&
+        footprint->total_bytes > limits->memory_budget) {
+        return ARGON2_MEMORY_BUDGET_EXCEEDED;
+    }
+    return ARGON2_OK;
+}
+
+int argon2_preflight(const uint32_t m_cost, const uint32_t parallelism,
+                     const size_t hashlen, const argon2_limits *limits,
+                     argon2_footprint *footprint) {
+    if (footprint == NULL) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+    if (parallelism < ARGON2_MIN_LANES) {
+        return ARGON2_LANES_TOO_FEW;
+    }
+    if (parallelism > ARGON2_MAX_LANES) {
+        return ARGON2_LANES_TOO_MANY;
+    }
+    if (m_cost < ARGON2_MIN_MEMORY) {
+        return ARGON2_MEMORY_TOO_LITTLE;
+    }
+    if (m_cost < 8 * parallelism) {
+        return ARGON2_MEMORY_TOO_LITTLE;
+    }
+    if (hashlen < ARGON2_MIN_OUTLEN) {
+        return ARGON2_OUTPUT_TOO_SHORT;
+    }
+    if (hashlen > ARGON2_MAX_OUTLEN) {
+        return ARGON2_OUTPUT_TOO_LONG;
+    }
+    uint32_t threads = parallelism;
+    size_t thread_stack_size;
+    return apply_limits(limits, aligned_memory_blocks(m_cost, parallelism),
+                        parallelism, &threads, hashlen, &thread_stack_size,
+                        footprint);
+}
+
 int argon2_ctx(argon2_context *context, argon2_type type) {
     /* 1. Validate all inputs */
     int result = validate_inputs(context);
@@ -52,19 +103,11 @@ int argon2_ctx(argon2_context *context, argon2_type type) {
     }
 
     /* 2. Align memory size */
-    /* Minimum memory_blocks = 8L blocks, where L is the number of lanes */
-    memory_blocks = context->m_cost;
-
-    if (memory_blocks < 2 * ARGON2_SYNC_POINTS * context->lanes) {
-        memory_blocks = 2 * ARGON2_SYNC_POINTS * context->lanes;
-    }
-
+    memory_blocks = aligned_memory_blocks(context->m_cost, context->lanes);
     segment_length = memory_blocks / (context->lanes * ARGON2_SYNC_POINTS);
-    /* Ensure that all segments have equal length */
-    memory_blocks = segment_length * (context->lanes * ARGON2_SYNC_POINTS);
 
     instance.version = context->version;
-    instance.memory = NULL;
+    instance.segments = NULL;
     instance.passes = context->t_cost;
     instance.memory_blocks = memory_blocks;
     instance.segment_length = segment_length;
@@ -77,24 +120,44 @@ int argon2_ctx(argon2_context *context, argon2_type type) {
         instance.threads = instance.lanes;
     }
 
+    /* [AP] Fail fast, before allocating anything, if over the budget */
+    argon2_footprint footprint;
+    result = apply_limits(context->limits, instance.memory_blocks,
+                          instance.lanes, &instance.threads, context->outlen,
+                          &instance.thread_stack_size, &footprint);
+    if (ARGON2_OK != result) {
+        return result;
+    }
+
     /* 3. Initialization: Hashing inputs, allocating memory, filling first
      * blocks
      */
+    crypto_faults_begin(context->stats);
     result = initialize(&instance, context);
 
     if (ARGON2_OK != result) {
+        crypto_faults_end(context->stats);
         return result;
     }
 
     /* 4. Filling memory */
+    uint64_t phase_start = crypto_phase_begin(context->stats);
     result = fill_memory_blocks(&instance);
+    crypto_phase_end(context->stats, CRYPTO_OPERATION_ARGON2, CRYPTO_PHASE_FILL, phase_start,
+                     (uint64_t)instance.memory_blocks * ARGON2_BLOCK_SIZE);
+    if (context->stats) {
+        context->stats->bytes_processed += (uint64_t)instance.memory_blocks * ARGON2_BLOCK_SIZE;
+        context->stats->blocks_processed += (uint64_t)instance.memory_blocks * instance.passes;
+    }
 
     // [AP] Externally interrupted processing is not OK, but still need to free up the memory.
     if (ARGON2_OK != result && ARGON2_INTERRUPTED != result) {
+        crypto_faults_end(context->stats);
         return result;
     }
     /* 5. Finalization */
     finalize(context, &instance);
+    crypto_faults_end(context->stats);
 
     return result;
 }
@@ -106,7 +169,23 @@ int argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
                 const size_t encodedlen, argon2_type type,
                 const uint32_t version,
                 const progress_fptr progress_cbk, const void* progress_user_obj,
-                const uint8_t *flag_abort){
+                const uint8_t *flag_abort, crypto_stats *stats){
+    return argon2_hash_limited(t_cost, m_cost, parallelism, pwd, pwdlen,
+                               salt, saltlen, hash, hashlen, encoded,
+                               encodedlen, type, version, progress_cbk,
+                               progress_user_obj, flag_abort, stats, NULL);
+}
+
+int argon2_hash_limited(const uint32_t t_cost, const uint32_t m_cost,
+                        const uint32_t parallelism, const void *pwd,
+                        const size_t pwdlen, const void *salt,
+                        const size_t saltlen, void *hash, const size_t hashlen,
+                        char *encoded, const size_t encodedlen,
+                        argon2_type type, const uint32_t version,
+                        const progress_fptr progress_cbk,
+                        const void* progress_user_obj,
+                        const uint8_t *flag_abort, crypto_stats *stats,
+                        const argon2_limits *limits) {
 
     argon2_context context;
     int result;
@@ -154,6 +233,8 @@ int argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
     context.progress_cbk = progress_cbk;
     context.progress_user_obj = progress_user_obj;
     context.flag_abort = flag_abort;
+    context.stats = stats;
+    context.limits = limits;
 
     result = argon2_ctx(&context, type);
 
@@ -194,7 +275,7 @@ int argon2i_hash_encoded(const uint32_t t_cost, const uint32_t m_cost,
     return argon2_hash(t_cost, m_cost, parallelism, pwd, pwdlen, salt, saltlen,
                        NULL, hashlen, encoded, encodedlen, Argon2_i,
                        ARGON2_VERSION_NUMBER, progress_cbk, progress_user_obj,
-                       flag_abort);
+                       flag_abort, NULL);
 }
 
 int argon2i_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
@@ -206,7 +287,7 @@ int argon2i_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
 
     return argon2_hash(t_cost, m_cost, parallelism, pwd, pwdlen, salt, saltlen,
                        hash, hashlen, NULL, 0, Argon2_i, ARGON2_VERSION_NUMBER,
-                       progress_cbk, progress_user_obj, flag_abort);
+                       progress_cbk, progress_user_obj, flag_abort, NULL);
 }
 
 int argon2d_hash_encoded(const uint32_t t_cost, const uint32_t m_cost,
@@ -220,7 +301,7 @@ int argon2d_hash_encoded(const uint32_t t_cost, const uint32_t m_cost,
     return argon2_hash(t_cost, m_cost, parallelism, pwd, pwdlen, salt, saltlen,
                        NULL, hashlen, encoded, encodedlen, Argon2_d,
                        ARGON2_VERSION_NUMBER, progress_cbk, progress_user_obj,
-                       flag_abort);
+                       flag_abort, NULL);
 }
 
 int argon2d_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
@@ -232,7 +313,7 @@ int argon2d_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
 
     return argon2_hash(t_cost, m_cost, parallelism, pwd, pwdlen, salt, saltlen,
                        hash, hashlen, NULL, 0, Argon2_d, ARGON2_VERSION_NUMBER,
-                       progress_cbk, progress_user_obj, flag_abort);
+                       progress_cbk, progress_user_obj, flag_abort, NULL);
 }
 
 int argon2id_hash_encoded(const uint32_t t_cost, const uint32_t m_cost,
@@ -246,7 +327,7 @@ int argon2id_hash_encoded(const uint32_t t_cost, const uint32_t m_cost,
     return argon2_hash(t_cost, m_cost, parallelism, pwd, pwdlen, salt, saltlen,
                        NULL, hashlen, encoded, encodedlen, Argon2_id,
                        ARGON2_VERSION_NUMBER, progress_cbk, progress_user_obj,
-                       flag_abort);
+                       flag_abort, NULL);
 }
 
 int argon2id_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
@@ -258,7 +339,7 @@ int argon2id_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
     return argon2_hash(t_cost, m_cost, parallelism, pwd, pwdlen, salt, saltlen,
                        hash, hashlen, NULL, 0, Argon2_id,
                        ARGON2_VERSION_NUMBER, progress_cbk, progress_user_obj,
-                       flag_abort);
+                       flag_abort, NULL);
 }
 
 static int argon2_compare(const uint8_t *b1, const uint8_t *b2, size_t len) {
@@ -276,6 +357,8 @@ int argon2_verify(const char *encoded, const void *pwd, const size_t pwdlen,
 
     argon2_context ctx;
     uint8_t *desired_result = NULL;
+    ctx.stats = NULL;
+    ctx.limits = NULL;
 
     int ret = ARGON2_OK;
 
@@ -464,6 +547,10 @@ const char *argon2_error_message(int error_code) {
         return "Some of encoded parameters are too long or too short";
     case ARGON2_VERIFY_MISMATCH:
         return "The password does not match the supplied hash";
+    case ARGON2_INTERRUPTED:
+        return "Hashing has been interrupted";
+    case ARGON2_MEMORY_BUDGET_EXCEEDED:
+        return "Hashing would exceed the memory budget";
     default:
         return "Unknown error code";
     }
@@ -22,6 +22,8 @@
 #include <stddef.h>
 #include <limits.h>
 
+#include "crypto_stats.h"
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -156,7 +158,8 @@ typedef enum Argon2_ErrorCodes {
 
     ARGON2_VERIFY_MISMATCH = -35,
     
-    ARGON2_INTERRUPTED = -100 // [AP] hashing has been interrupted by the progress callback
+    ARGON2_INTERRUPTED = -100, // [AP] hashing has been interrupted by the progress callback
+    ARGON2_MEMORY_BUDGET_EXCEEDED = -101 // [AP] peak footprint would exceed argon2_limits.memory_budget
 } argon2_error_codes;
 
 /* Memory allocator types --- for external allocation */
@@ -171,6 +174,30 @@ typedef void (*deallocate_fptr)(uint8_t *memory, size_t bytes_to_allocate);
  */
 typedef int (*progress_fptr)(uint32_t t, const void *swift_obj);
 
+/**
+ * [AP] Resource limits for memory-constrained processes (such as app extensions).
+ * Limits do not affect the hash value. Zero fields mean "no limit" / "system default".
+ */
+typedef struct Argon2_limits {
+    uint64_t memory_budget;     /* max peak footprint in bytes; exceeding it fails with ARGON2_MEMORY_BUDGET_EXCEEDED */
+    uint32_t max_threads;       /* max worker threads; lanes are then processed in batches */
+    uint32_t thread_stack_size; /* stack size of worker threads in bytes */
+} argon2_limits;
+
+/* [AP] Stack size sufficient for the worker threads, much smaller than the system default */
+#define ARGON2_CONSTRAINED_STACK_SIZE (64 * 1024)
+
+/**
+ * [AP] Peak memory footprint of a hashing run, as estimated by argon2_preflight()
+ */
+typedef struct Argon2_footprint {
+    uint64_t matrix_bytes;       /* memory blocks, after alignment to lanes and sync points */
+    uint64_t thread_stack_bytes; /* stacks of the worker threads (none if single-threaded) */
+    uint64_t overhead_bytes;     /* thread bookkeeping, BLAKE2 state, pre-hash seed and output buffer */
+    uint64_t total_bytes;        /* sum of the above */
+    uint32_t threads;            /* number of worker threads that would be used */
+} argon2_footprint;
+
 /* Argon2 external data structures */
 
 /*
@@ -221,12 +248,14 @@ typedef struct Argon2_Context {
 
     uint32_t version; /* version number */
 
-    allocate_fptr allocate_cbk; /* pointer to memory allocator */
+    allocate_fptr allocate_cbk; /* pointer to memory allocator, [AP] called per segment */
     deallocate_fptr free_cbk;   /* pointer to memory deallocator */
     progress_fptr progress_cbk; //[AP] progress callback to Swift
     const void *progress_user_obj; // [AP] a Swift object to be passed to progress callback
     const uint8_t *flag_abort; // [AP] whenever the pointed value is set to TRUE,
                                // aborts any processing and returns with ARGON2_INTERRUPTED
+    crypto_stats *stats; // [AP] optional per-phase timings and counters, NULL to skip
+    const argon2_limits *limits; // [AP] optional resource limits, NULL for none
 
     uint32_t flags; /* array of bool options */
 } argon2_context;
@@ -364,7 +393,37 @@ ARGON2_PUBLIC int argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
                               const uint32_t version,
                               const progress_fptr progress_cbk,
                               const void* progress_user_obj,
-                              const uint8_t *flag_abort);
+                              const uint8_t *flag_abort,
+                              crypto_stats *stats);
+
+/* [AP] argon2_hash() within the given resource limits (NULL for none) */
+ARGON2_PUBLIC int argon2_hash_limited(const uint32_t t_cost, const uint32_t m_cost,
+                                      const uint32_t parallelism, const void *pwd,
+                                      const size_t pwdlen, const void *salt,
+                                      const size_t saltlen, void *hash,
+                                      const size_t hashlen, char *encoded,
+                                      const size_t encodedlen, argon2_type type,
+                                      const uint32_t version,
+                                      const progress_fptr progress_cbk,
+                                      const void* progress_user_obj,
+                                      const uint8_t *flag_abort,
+                                      crypto_stats *stats,
+                                      const argon2_limits *limits);
+
+/**
+ * [AP] Computes the peak memory footprint of argon2_hash_limited() without running it.
+ * @param m_cost Memory usage in kibibytes
+ * @param parallelism Number of lanes
+ * @param hashlen Length of the hash in bytes
+ * @param limits Resource limits to apply, or NULL for none
+ * @param footprint Receives the estimate
+ * @return ARGON2_OK if the run fits the budget, ARGON2_MEMORY_BUDGET_EXCEEDED
+ *         (with the footprint still filled in) if it does not,
+ *         or another error code for invalid parameters
+ */
+ARGON2_PUBLIC int argon2_preflight(const uint32_t m_cost, const uint32_t parallelism,
+                                   const size_t hashlen, const argon2_limits *limits,
+                                   argon2_footprint *footprint);
 
 /**
  * Verifies a password against an encoded string
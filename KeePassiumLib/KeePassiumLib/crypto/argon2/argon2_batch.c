@@ -0,0 +1,447 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "argon2_batch.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "core.h"
+
+typedef enum {
+    ENTRY_PENDING,      // waiting for memory
+    ENTRY_READY,        // has memory, the first blocks are not computed yet
+    ENTRY_INITIALIZING,
+    ENTRY_FILLING,      // segments of the current slice are being handed out
+    ENTRY_FILLED,       // all passes done, the tag is not computed yet
+    ENTRY_FINISHING,
+    ENTRY_DONE
+} batch_entry_state;
+
+typedef struct {
+    argon2_context context;
+    argon2_instance_t instance;
+    batch_entry_state state;
+    uint32_t pass;
+    uint32_t slice;
+    uint32_t next_lane;   // next lane of the current slice to hand out
+    uint32_t lanes_done;  // finished lanes of the current slice
+} batch_entry;
+
+typedef struct {
+    block *memory;  // wiped
+    uint32_t segment_length;
+} pooled_segment;
+
+typedef struct {
+    argon2_batch_item *items;
+    batch_entry *entries;
+    size_t count;
+    size_t first_active;  // entries before it are done
+    size_t next_pending;  // entries from it on have not been given memory yet
+    uint32_t threads;
+    uint32_t active_lanes;
+    uint64_t memory_budget;
+    uint64_t allocated_bytes;  // segments in use and pooled
+    pooled_segment *pool;
+    size_t pool_count;
+    size_t pool_capacity;
+    const uint8_t *flag_abort;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+} argon2_batch;
+
+typedef enum {
+    TASK_NONE,
+    TASK_INITIALIZE,
+    TASK_FILL,
+    TASK_FINISH
+} batch_task_kind;
+
+typedef struct {
+    batch_task_kind kind;
+    batch_entry *entry;
+    argon2_position_t position;
+} batch_task;
+
+enum { ACQUIRE_WAIT = 1 };
+
+static uint64_t segment_bytes(const argon2_instance_t *instance) {
+    return (uint64_t)instance->segment_length * sizeof(block);
+}
+
+static uint32_t segment_count(const argon2_instance_t *instance) {
+    return instance->lanes * ARGON2_SYNC_POINTS;
+}
+
+/* Sets up the context and instance as argon2_hash() and argon2_ctx() do */
+static int batch_entry_setup(batch_entry *entry, argon2_batch_item *item, const uint8_t *flag_abort) {
+    if (item->pwdlen > ARGON2_MAX_PWD_LENGTH) {
+        return ARGON2_PWD_TOO_LONG;
+    }
+    if (item->saltlen > ARGON2_MAX_SALT_LENGTH) {
+        return ARGON2_SALT_TOO_LONG;
+    }
+    if (item->hashlen > ARGON2_MAX_OUTLEN) {
+        return ARGON2_OUTPUT_TOO_LONG;
+    }
+    if (item->type != Argon2_d && item->type != Argon2_i && item->type != Argon2_id) {
+        return ARGON2_INCORRECT_TYPE;
+    }
+    argon2_context *context = &entry->context;
+    context->out = item->hash;
+    context->outlen = (uint32_t)item->hashlen;
+    context->pwd = CONST_CAST(uint8_t *)item->pwd;
+    context->pwdlen = (uint32_t)item->pwdlen;
+    context->salt = CONST_CAST(uint8_t *)item->salt;
+    context->saltlen = (uint32_t)item->saltlen;
+    context->t_cost = item->t_cost;
+    context->m_cost = item->m_cost;
+    context->lanes = item->parallelism;
+    context->threads = item->parallelism;
+    context->version = item->version;
+    context->flags = ARGON2_DEFAULT_FLAGS;
+    context->flag_abort = flag_abort;
+    const int result = validate_inputs(context);
+    if (result != ARGON2_OK) {
+        return result;
+    }
+
+    argon2_instance_t *instance = &entry->instance;
+    instance->version = context->version;
+    instance->passes = context->t_cost;
+    instance->memory_blocks = aligned_memory_blocks(context->m_cost, context->lanes);
+    instance->segment_length = instance->memory_blocks / (context->lanes * ARGON2_SYNC_POINTS);
+    instance->lane_length = instance->segment_length * ARGON2_SYNC_POINTS;
+    instance->lanes = context->lanes;
+    instance->threads = 1;
+    instance->type = item->type;
+    instance->context_ptr = context;
+    return ARGON2_OK;
+}
+
+static void batch_free_pooled(argon2_batch *batch, size_t index) {
+    const pooled_segment segment = batch->pool[index];
+    batch->allocated_bytes -= (uint64_t)segment.segment_length * sizeof(block);
+    free(segment.memory);
+    batch->pool[index] = batch->pool[--batch->pool_count];
+}
+
+/* Takes wiped segments back, keeping them for entries of the same shape */
+static void batch_recycle_segments(argon2_batch *batch, argon2_instance_t *instance) {
+    const uint32_t count = segment_count(instance);
+    for (uint32_t i = 0; i < count; i++) {
+        block *memory = instance->segments[i];
+        if (memory == NULL) {
+            continue;
+        }
+        if (batch->pool_count == batch->pool_capacity) {
+            const size_t capacity = batch->pool_capacity ? 2 * batch->pool_capacity : 64;
+            pooled_segment *pool = realloc(batch->pool, capacity * sizeof(pooled_segment));
+            if (pool == NULL) {
+                batch->allocated_bytes -= segment_bytes(instance);
+                free(memory);
+                continue;
+            }
+            batch->pool = pool;
+            batch->pool_capacity = capacity;
+        }
+        batch->pool[batch->pool_count].memory = memory;
+        batch->pool[batch->pool_count].segment_length = instance->segment_length;
+        batch->pool_count++;
+    }
+    free(instance->segments);
+    instance->segments = NULL;
+}
+
+static void batch_wipe_segments(const argon2_instance_t *instance) {
+    const uint32_t count = segment_count(instance);
+    for (uint32_t i = 0; i < count; i++) {
+        clear_internal_memory(instance->segments[i], segment_bytes(instance));
+    }
+}
+
+/* Gives the entry its segments, reusing pooled ones first.
+ * Returns ACQUIRE_WAIT if the budget is taken by other entries for now. */
+static int batch_acquire_segments(argon2_batch *batch, batch_entry *entry) {
+    argon2_instance_t *instance = &entry->instance;
+    const uint32_t count = segment_count(instance);
+    const uint64_t bytes = segment_bytes(instance);
+    if (batch->memory_budget > 0 && (uint64_t)count * bytes > batch->memory_budget) {
+        return ARGON2_MEMORY_BUDGET_EXCEEDED;
+    }
+    instance->segments = calloc(count, sizeof(block *));
+    if (instance->segments == NULL) {
+        return ARGON2_MEMORY_ALLOCATION_ERROR;
+    }
+
+    uint32_t reused = 0;
+    for (size_t i = batch->pool_count; i-- > 0 && reused < count;) {
+        if (batch->pool[i].segment_length == instance->segment_length) {
+            instance->segments[reused++] = batch->pool[i].memory;
+            batch->pool[i] = batch->pool[--batch->pool_count];
+        }
+    }
+    const uint64_t new_bytes = (uint64_t)(count - reused) * bytes;
+    if (batch->memory_budget > 0) {
+        while (batch->allocated_bytes + new_bytes > batch->memory_budget && batch->pool_count > 0) {
+            batch_free_pooled(batch, batch->pool_count - 1);
+        }
+        if (batch->allocated_bytes + new_bytes > batch->memory_budget) {
+            batch_recycle_segments(batch, instance);
+            return ACQUIRE_WAIT;
+        }
+    }
+    for (uint32_t i = reused; i < count; i++) {
+        instance->segments[i] = malloc((size_t)bytes);
+        if (instance->segments[i] == NULL) {
+            batch_recycle_segments(batch, instance);
+            return ARGON2_MEMORY_ALLOCATION_ERROR;
+        }
+        batch->allocated_bytes += bytes;
+    }
+    return ARGON2_OK;
+}
+
+static void batch_entry_finish(argon2_batch *batch, size_t index, int status) {
+    batch_entry *entry = &batch->entries[index];
+    argon2_batch_item *item = &batch->items[index];
+    if (status != ARGON2_OK && item->hash != NULL) {
+        clear_internal_memory(item->hash, item->hashlen);
+    }
+    item->status = status;
+    entry->state = ENTRY_DONE;
+    while (batch->first_active < batch->next_pending &&
+           batch->entries[batch->first_active].state == ENTRY_DONE) {
+        batch->first_active++;
+    }
+}
+
+/* Gives memory to pending entries, in order, while there are idle threads to keep busy */
+static void batch_admit(argon2_batch *batch) {
+    while (batch->next_pending < batch->count &&
+           (batch->active_lanes == 0 || batch->active_lanes < batch->threads)) {
+        const size_t index = batch->next_pending;
+        batch_entry *entry = &batch->entries[index];
+        if (entry->state == ENTRY_DONE) {
+            batch->next_pending++;
+            batch_entry_finish(batch, index, batch->items[index].status);
+            continue;
+        }
+        const int result = batch_acquire_segments(batch, entry);
+        if (result == ACQUIRE_WAIT) {
+            return;
+        }
+        batch->next_pending++;
+        if (result != ARGON2_OK) {
+            batch_entry_finish(batch, index, result);
+            continue;
+        }
+        entry->state = ENTRY_READY;
+        batch->active_lanes += entry->instance.lanes;
+    }
+}
+
+static batch_task batch_next_task(argon2_batch *batch) {
+    batch_task task = { TASK_NONE, NULL, { 0, 0, 0, 0 } };
+    for (size_t i = batch->first_active; i < batch->next_pending; i++) {
+        batch_entry *entry = &batch->entries[i];
+        switch (entry->state) {
+        case ENTRY_READY:
+            entry->state = ENTRY_INITIALIZING;
+            task.kind = TASK_INITIALIZE;
+            task.entry = entry;
+            return task;
+        case ENTRY_FILLING:
+            if (entry->next_lane == entry->instance.lanes) {
+                break; /* the rest of the slice is in progress */
+            }
+            task.kind = TASK_FILL;
+            task.entry = entry;
+            task.position.pass = entry->pass;
+            task.position.lane = entry->next_lane++;
+            task.position.slice = (uint8_t)entry->slice;
+            return task;
+        case ENTRY_FILLED:
+            entry->state = ENTRY_FINISHING;
+            task.kind = TASK_FINISH;
+            task.entry = entry;
+            return task;
+        default:
+            break;
+        }
+    }
+    return task;
+}
+
+/* Runs outside the lock */
+static void batch_run_task(const batch_task *task) {
+    batch_entry *entry = task->entry;
+    switch (task->kind) {
+    case TASK_INITIALIZE: {
+        uint8_t blockhash[ARGON2_PREHASH_SEED_LENGTH];
+        initial_hash(blockhash, &entry->context, entry->instance.type);
+        clear_internal_memory(blockhash + ARGON2_PREHASH_DIGEST_LENGTH,
+                              ARGON2_PREHASH_SEED_LENGTH - ARGON2_PREHASH_DIGEST_LENGTH);
+        fill_first_blocks(blockhash, &entry->instance);
+        clear_internal_memory(blockhash, ARGON2_PREHASH_SEED_LENGTH);
+        break;
+    }
+    case TASK_FILL:
+        fill_segment(&entry->instance, task->position);
+        break;
+    case TASK_FINISH:
+        compute_tag(&entry->context, &entry->instance);
+        batch_wipe_segments(&entry->instance);
+        break;
+    case TASK_NONE:
+        break;
+    }
+}
+
+static void batch_complete_task(argon2_batch *batch, const batch_task *task) {
+    batch_entry *entry = task->entry;
+    switch (task->kind) {
+    case TASK_INITIALIZE:
+        entry->state = ENTRY_FILLING;
+        break;
+    case TASK_FILL:
+        if (++entry->lanes_done < entry->instance.lanes) {
+            break;
+        }
+        entry->next_lane = 0;
+        entry->lanes_done = 0;
+        if (++entry->slice == ARGON2_SYNC_POINTS) {
+            entry->slice = 0;
+            if (++entry->pass == entry->instance.passes) {
+                entry->state = ENTRY_FILLED;
+            }
+        }
+        break;
+    case TASK_FINISH:
+        batch_recycle_segments(batch, &entry->instance);
+        batch->active_lanes -= entry->instance.lanes;
+        batch_entry_finish(batch, (size_t)(entry - batch->entries), ARGON2_OK);
+        break;
+    case TASK_NONE:
+        break;
+    }
+}
+
+static void *batch_worker(void *arg) {
+    argon2_batch *batch = arg;
+    pthread_mutex_lock(&batch->mutex);
+    while (!is_aborted(batch->flag_abort)) {
+        batch_admit(batch);
+        const batch_task task = batch_next_task(batch);
+        if (task.kind != TASK_NONE) {
+            pthread_mutex_unlock(&batch->mutex);
+            batch_run_task(&task);
+            pthread_mutex_lock(&batch->mutex);
+            batch_complete_task(batch, &task);
+            pthread_cond_broadcast(&batch->changed);
+            continue;
+        }
+        if (batch->first_active == batch->count) {
+            break;
+        }
+        /* Whatever is left is in progress on other threads */
+        pthread_cond_wait(&batch->changed, &batch->mutex);
+    }
+    pthread_cond_broadcast(&batch->changed);
+    pthread_mutex_unlock(&batch->mutex);
+    return NULL;
+}
+
+static uint32_t batch_thread_count(const argon2_batch_options *options, uint64_t total_lanes) {
+    uint32_t threads = options ? options->threads : 0;
+    if (threads == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > total_lanes) {
+        threads = (uint32_t)total_lanes;
+    }
+    return threads > 0 ? threads : 1;
+}
+
+int argon2_batch_hash(
+    argon2_batch_item *items,
+    size_t count,
+    const argon2_batch_options *options,
+    const uint8_t *flag_abort)
+{
+    if (items == NULL && count > 0) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+    argon2_batch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.entries = calloc(count > 0 ? count : 1, sizeof(batch_entry));
+    if (batch.entries == NULL) {
+        for (size_t i = 0; i < count; i++) {
+            items[i].status = ARGON2_MEMORY_ALLOCATION_ERROR;
+        }
+        return ARGON2_MEMORY_ALLOCATION_ERROR;
+    }
+    batch.items = items;
+    batch.count = count;
+    batch.memory_budget = options ? options->memory_budget : 0;
+    batch.flag_abort = flag_abort;
+
+    uint64_t total_lanes = 0;
+    for (size_t i = 0; i < count; i++) {
+        items[i].status = batch_entry_setup(&batch.entries[i], &items[i], flag_abort);
+        if (items[i].status == ARGON2_OK) {
+            total_lanes += items[i].parallelism;
+        } else {
+            batch.entries[i].state = ENTRY_DONE;
+        }
+    }
+    batch.threads = batch_thread_count(options, total_lanes);
+
+    pthread_mutex_init(&batch.mutex, NULL);
+    pthread_cond_init(&batch.changed, NULL);
+    pthread_t *workers = calloc(batch.threads, sizeof(pthread_t));
+    uint32_t worker_count = 0;
+    if (workers != NULL) {
+        /* The caller's thread is one of the workers */
+        while (worker_count + 1 < batch.threads &&
+               pthread_create(&workers[worker_count], NULL, batch_worker, &batch) == 0) {
+            worker_count++;
+        }
+    }
+    batch_worker(&batch);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    /* Leftovers of an interrupted batch */
+    for (size_t i = 0; i < count; i++) {
+        batch_entry *entry = &batch.entries[i];
+        if (entry->state == ENTRY_DONE) {
+            continue;
+        }
+        if (entry->instance.segments != NULL) {
+            batch_wipe_segments(&entry->instance);
+            batch_recycle_segments(&batch, &entry->instance);
+        }
+        clear_internal_memory(items[i].hash, items[i].hashlen);
+        items[i].status = ARGON2_INTERRUPTED;
+    }
+    while (batch.pool_count > 0) {
+        batch_free_pooled(&batch, batch.pool_count - 1);
+    }
+    free(batch.pool);
+    free(batch.entries);
+    pthread_cond_destroy(&batch.changed);
+    pthread_mutex_destroy(&batch.mutex);
+    return ARGON2_OK;
+}
@@ -0,0 +1,62 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef argon2_batch_h
+#define argon2_batch_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "argon2.h"
+
+/// One hash of a batch.
+typedef struct {
+    uint32_t t_cost;
+    uint32_t m_cost;
+    uint32_t parallelism;
+    argon2_type type;
+    uint32_t version;
+    const void *pwd;
+    size_t pwdlen;
+    const void *salt;
+    size_t saltlen;
+    uint8_t *hash;   // receives hashlen bytes; wiped unless the status is ARGON2_OK
+    size_t hashlen;
+    int status;      // set by argon2_batch_hash(): ARGON2_OK or an argon2 error code
+} argon2_batch_item;
+
+typedef struct {
+    uint32_t threads;        // worker threads, including the caller's; 0 for one per CPU core
+    uint64_t memory_budget;  // max bytes of block matrices at any time, 0 for no limit
+} argon2_batch_options;
+
+/// Computes many independent hashes on one shared pool of threads.
+/// Lanes of several hashes run side by side, so the pool stays busy regardless
+/// of each hash's parallelism. Block matrices are wiped and reused between hashes
+/// of the same shape, and their total stays within the memory budget.
+/// Hashes that could never fit the budget fail with ARGON2_MEMORY_BUDGET_EXCEEDED.
+/// @param  items       hashes to compute; each gets its own status
+/// @param  options     NULL for defaults
+/// @param  flag_abort  optional; once set (atomically), unfinished items end with ARGON2_INTERRUPTED
+/// @return ARGON2_OK if the batch has run (see the per-item status),
+///         or ARGON2_INCORRECT_PARAMETER / ARGON2_MEMORY_ALLOCATION_ERROR if it could not start
+int argon2_batch_hash(
+    argon2_batch_item *items,
+    size_t count,
+    const argon2_batch_options *options,
+    const uint8_t *flag_abort);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* argon2_batch_h */
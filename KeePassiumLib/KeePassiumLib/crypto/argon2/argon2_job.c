@@ -0,0 +1,135 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "argon2_job.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+
+struct argon2_job {
+    argon2_job_params params;
+    uint8_t *pwd;   // followed by the salt and the hash, in one allocation
+    uint8_t *salt;
+    uint8_t *hash;
+    size_t pwdlen;
+    size_t saltlen;
+    argon2_job_progress_fptr progress;
+    argon2_job_completion_fptr completion;
+    void *user_obj;
+    crypto_stats stats;
+    uint8_t flag_abort;  // accessed atomically
+    int references;      // accessed atomically; one for the caller, one for the worker
+};
+
+static void argon2_job_destroy(argon2_job *job) {
+    secure_wipe_memory(job->pwd, job->pwdlen + job->saltlen + job->params.hashlen);
+    free(job->pwd);
+    free(job);
+}
+
+static int argon2_job_on_pass(uint32_t pass, const void *user_obj) {
+    const argon2_job *job = user_obj;
+    job->progress(pass, job->user_obj);
+    return 0; /* cancellation goes through the abort flag */
+}
+
+static void *argon2_job_run(void *arg) {
+    argon2_job *job = arg;
+    const argon2_job_params *params = &job->params;
+    const int status = argon2_hash_limited(
+        params->t_cost, params->m_cost, params->parallelism,
+        job->pwd, job->pwdlen,
+        job->salt, job->saltlen,
+        job->hash, params->hashlen,
+        NULL, 0,
+        params->type, params->version,
+        job->progress ? argon2_job_on_pass : NULL, job,
+        &job->flag_abort,
+        &job->stats,
+        &params->limits);
+    secure_wipe_memory(job->pwd, job->pwdlen);
+    job->completion(status, status == ARGON2_OK ? job->hash : NULL, params->hashlen, &job->stats, job->user_obj);
+    secure_wipe_memory(job->hash, params->hashlen);
+    argon2_job_release(job);
+    return NULL;
+}
+
+argon2_job *argon2_job_submit(
+    const argon2_job_params *params,
+    const void *pwd,
+    size_t pwdlen,
+    const void *salt,
+    size_t saltlen,
+    argon2_job_progress_fptr progress,
+    argon2_job_completion_fptr completion,
+    void *user_obj)
+{
+    if (params == NULL || completion == NULL || (pwd == NULL && pwdlen > 0) || (salt == NULL && saltlen > 0)) {
+        return NULL;
+    }
+    if (pwdlen > ARGON2_MAX_PWD_LENGTH || saltlen > ARGON2_MAX_SALT_LENGTH || params->hashlen > ARGON2_MAX_OUTLEN) {
+        return NULL;
+    }
+    argon2_job *job = calloc(1, sizeof(argon2_job));
+    if (job == NULL) {
+        return NULL;
+    }
+    job->pwd = malloc(pwdlen + saltlen + params->hashlen + 1);
+    if (job->pwd == NULL) {
+        free(job);
+        return NULL;
+    }
+    job->salt = job->pwd + pwdlen;
+    job->hash = job->salt + saltlen;
+    if (pwdlen > 0) {
+        memcpy(job->pwd, pwd, pwdlen);
+    }
+    if (saltlen > 0) {
+        memcpy(job->salt, salt, saltlen);
+    }
+    job->params = *params;
+    job->pwdlen = pwdlen;
+    job->saltlen = saltlen;
+    job->progress = progress;
+    job->completion = completion;
+    job->user_obj = user_obj;
+    job->references = 2;
+
+    pthread_attr_t attributes;
+    pthread_t thread;
+    int result = pthread_attr_init(&attributes);
+    if (result == 0) {
+        pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+        result = pthread_create(&thread, &attributes, argon2_job_run, job);
+        pthread_attr_destroy(&attributes);
+    }
+    if (result != 0) {
+        argon2_job_destroy(job);
+        return NULL;
+    }
+    return job;
+}
+
+void argon2_job_cancel(argon2_job *job) {
+    if (job == NULL) {
+        return;
+    }
+    __atomic_store_n(&job->flag_abort, 1, __ATOMIC_RELAXED);
+}
+
+void argon2_job_release(argon2_job *job) {
+    if (job == NULL) {
+        return;
+    }
+    if (__atomic_sub_fetch(&job->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        argon2_job_destroy(job);
+    }
+}
@@ -0,0 +1,77 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef argon2_job_h
+#define argon2_job_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "argon2.h"
+#include "crypto_stats.h"
+
+/// Argon2 hash running on its own worker thread.
+typedef struct argon2_job argon2_job;
+
+/// Called on the worker thread after each completed pass (numbered from 0).
+typedef void (*argon2_job_progress_fptr)(uint32_t pass, void *user_obj);
+
+/// Called once on the worker thread when the job ends.
+/// @param  status  ARGON2_OK, ARGON2_INTERRUPTED if cancelled, or another argon2 error code
+/// @param  hash    the result (NULL unless the status is ARGON2_OK); wiped after the call returns
+/// @param  stats   timing and memory statistics of the run
+typedef void (*argon2_job_completion_fptr)(
+    int status,
+    const uint8_t *hash,
+    size_t hashlen,
+    const crypto_stats *stats,
+    void *user_obj);
+
+typedef struct {
+    uint32_t t_cost;
+    uint32_t m_cost;
+    uint32_t parallelism;
+    argon2_type type;
+    uint32_t version;
+    size_t hashlen;
+    argon2_limits limits; // all zeros for no limits; the job's own thread keeps the default stack
+} argon2_job_params;
+
+/// Starts hashing in the background. The password and salt are copied, so the caller
+/// can release them right away; the copy of the password is wiped when the job ends.
+/// @param  progress    optional per-pass callback
+/// @param  completion  required; called exactly once if the job has been submitted
+/// @return the job handle, to be released with argon2_job_release(),
+///         or NULL if the job could not be started (no callbacks are made then)
+argon2_job *argon2_job_submit(
+    const argon2_job_params *params,
+    const void *pwd,
+    size_t pwdlen,
+    const void *salt,
+    size_t saltlen,
+    argon2_job_progress_fptr progress,
+    argon2_job_completion_fptr completion,
+    void *user_obj);
+
+/// Asks the job to stop. Thread-safe; the lanes notice it within one block.
+/// The completion callback is still called, with ARGON2_INTERRUPTED
+/// unless the hash had already been finished.
+void argon2_job_cancel(argon2_job *job);
+
+/// Gives up the caller's reference. Does not cancel the job.
+void argon2_job_release(argon2_job *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* argon2_job_h */
@@ -120,6 +120,45 @@ void free_memory(const argon2_context *context, uint8_t *memory,
     }
 }
 
+/* [AP] Wipes and releases the segments in order, so memory returns to the
+ * system progressively rather than all at once at the end */
+static void free_segments(const argon2_context *context,
+                          argon2_instance_t *instance) {
+    if (instance->segments == NULL) {
+        return;
+    }
+    const uint32_t segment_count = instance->lanes * ARGON2_SYNC_POINTS;
+    for (uint32_t i = 0; i < segment_count; ++i) {
+        if (instance->segments[i] != NULL) {
+            free_memory(context, (uint8_t *)instance->segments[i],
+                        instance->segment_length, sizeof(block));
+        }
+    }
+    free(instance->segments);
+    instance->segments = NULL;
+}
+
+/* [AP] Allocates each segment separately, so no contiguous address range
+ * of the whole matrix size is needed */
+static int allocate_segments(const argon2_context *context,
+                             argon2_instance_t *instance) {
+    const uint32_t segment_count = instance->lanes * ARGON2_SYNC_POINTS;
+    instance->segments = calloc(segment_count, sizeof(block *));
+    if (instance->segments == NULL) {
+        return ARGON2_MEMORY_ALLOCATION_ERROR;
+    }
+    for (uint32_t i = 0; i < segment_count; ++i) {
+        int result = allocate_memory(context, (uint8_t **)&instance->segments[i],
+                                     instance->segment_length, sizeof(block));
+        if (result != ARGON2_OK) {
+            instance->segments[i] = NULL;
+            free_segments(context, instance);
+            return result;
+        }
+    }
+    return ARGON2_OK;
+}
+
 void NOT_OPTIMIZED secure_wipe_memory(void *v, size_t n) {
 #if defined(_MSC_VER) && VC_GE_2005(_MSC_VER)
     SecureZeroMemory(v, n);
@@ -141,37 +180,47 @@ void clear_internal_memory(void *v, size_t n) {
   }
 }
 
-void finalize(const argon2_context *context, argon2_instance_t *instance) {
-    if (context != NULL && instance != NULL) {
-        block blockhash;
-        uint32_t l;
+void compute_tag(const argon2_context *context,
+                 const argon2_instance_t *instance) {
+    block blockhash;
+    uint32_t l;
 
-        copy_block(&blockhash, instance->memory + instance->lane_length - 1);
+    copy_block(&blockhash,
+               instance_block(instance, 0, instance->lane_length - 1));
 
-        /* XOR the last blocks */
-        for (l = 1; l < instance->lanes; ++l) {
-            uint32_t last_block_in_lane =
-                l * instance->lane_length + (instance->lane_length - 1);
-            xor_block(&blockhash, instance->memory + last_block_in_lane);
-        }
+    /* XOR the last blocks */
+    for (l = 1; l < instance->lanes; ++l) {
+        xor_block(&blockhash,
+                  instance_block(instance, l, instance->lane_length - 1));
+    }
 
-        /* Hash the result */
-        {
-            uint8_t blockhash_bytes[ARGON2_BLOCK_SIZE];
-            store_block(blockhash_bytes, &blockhash);
-            blake2b_long(context->out, context->outlen, blockhash_bytes,
-                         ARGON2_BLOCK_SIZE);
-            /* clear blockhash and blockhash_bytes */
-            clear_internal_memory(blockhash.v, ARGON2_BLOCK_SIZE);
-            clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
-        }
+    /* Hash the result */
+    {
+        uint8_t blockhash_bytes[ARGON2_BLOCK_SIZE];
+        store_block(blockhash_bytes, &blockhash);
+        blake2b_long(context->out, context->outlen, blockhash_bytes,
+                     ARGON2_BLOCK_SIZE);
+        /* clear blockhash and blockhash_bytes */
+        clear_internal_memory(blockhash.v, ARGON2_BLOCK_SIZE);
+        clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
+    }
+}
+
+void finalize(const argon2_context *context, argon2_instance_t *instance) {
+    if (context != NULL && instance != NULL) {
+        uint64_t phase_start = crypto_phase_begin(context->stats);
+        compute_tag(context, instance);
+        crypto_phase_end(context->stats, CRYPTO_OPERATION_ARGON2, CRYPTO_PHASE_FINALIZE,
+                         phase_start, 0);
 
 #ifdef GENKAT
         print_tag(context->out, context->outlen);
 #endif
 
-        free_memory(context, (uint8_t *)instance->memory,
-                    instance->memory_blocks, sizeof(block));
+        phase_start = crypto_phase_begin(context->stats);
+        free_segments(context, instance);
+        crypto_phase_end(context->stats, CRYPTO_OPERATION_ARGON2, CRYPTO_PHASE_WIPE,
+                         phase_start, (uint64_t)instance->memory_blocks * sizeof(block));
     }
 }
 
@@ -251,9 +300,9 @@ static int fill_memory_blocks_st(argon2_instance_t *instance) {
     progress_fptr progress_cbk = instance->context_ptr->progress_cbk;
     
     const uint8_t *flag_abort = instance->context_ptr->flag_abort;
-    for (r = 0; r < instance->passes && !(*flag_abort); ++r) {
-        for (s = 0; s < ARGON2_SYNC_POINTS && !(*flag_abort); ++s) {
-            for (l = 0; l < instance->lanes && !(*flag_abort); ++l) {
+    for (r = 0; r < instance->passes && !is_aborted(flag_abort); ++r) {
+        for (s = 0; s < ARGON2_SYNC_POINTS && !is_aborted(flag_abort); ++s) {
+            for (l = 0; l < instance->lanes && !is_aborted(flag_abort); ++l) {
                 argon2_position_t position = {r, l, (uint8_t)s, 0};
                 fill_segment(instance, position);
             }
@@ -261,7 +310,7 @@ static int fill_memory_blocks_st(argon2_instance_t *instance) {
 #ifdef GENKAT
         internal_kat(instance, r); /* Print all memory blocks */
 #endif
-        if (*instance->context_ptr->flag_abort) {
+        if (is_aborted(flag_abort)) {
             return ARGON2_INTERRUPTED;
         }
         if (progress_cbk) {
@@ -309,8 +358,9 @@ static int fill_memory_blocks_mt(argon2_instance_t *instance) {
 
     const uint8_t *flag_abort = instance->context_ptr->flag_abort;
     progress_fptr progress_cbk = instance->context_ptr->progress_cbk;
-    for (r = 0; r < instance->passes && !(*flag_abort); ++r) {
-        for (s = 0; s < ARGON2_SYNC_POINTS && !(*flag_abort); ++s) {
+    crypto_stats *stats = instance->context_ptr->stats;
+    for (r = 0; r < instance->passes && !is_aborted(flag_abort); ++r) {
+        for (s = 0; s < ARGON2_SYNC_POINTS && !is_aborted(flag_abort); ++s) {
             uint32_t l;
 
             /* 2. Calling threads */
@@ -334,11 +384,18 @@ static int fill_memory_blocks_mt(argon2_instance_t *instance) {
                     instance; /* preparing the thread input */
                 memcpy(&(thr_data[l].pos), &position,
                        sizeof(argon2_position_t));
-                if (argon2_thread_create(&thread[l], &fill_segment_thr,
-                                         (void *)&thr_data[l])) {
+                uint64_t spawn_start = crypto_phase_begin(stats);
+                if (argon2_thread_create_with_stack(&thread[l], &fill_segment_thr,
+                                                    (void *)&thr_data[l],
+                                                    instance->thread_stack_size)) {
                     rc = ARGON2_THREAD_FAIL;
                     goto fail;
                 }
+                crypto_phase_end(stats, CRYPTO_OPERATION_ARGON2, CRYPTO_PHASE_THREAD_SPAWN,
+                                 spawn_start, 0);
+                if (stats) {
+                    stats->threads_spawned++;
+                }
 
                 /* fill_segment(instance, position); */
                 /*Non-thread equivalent of the lines above */
@@ -354,7 +411,7 @@ static int fill_memory_blocks_mt(argon2_instance_t *instance) {
             }
         }
 
-        if (*instance->context_ptr->flag_abort) {
+        if (is_aborted(flag_abort)) {
             // processing has been aborted by the caller
             rc = ARGON2_INTERRUPTED;
             goto fail;
@@ -396,6 +453,49 @@ int fill_memory_blocks(argon2_instance_t *instance) {
 #endif
 }
 
+uint32_t aligned_memory_blocks(uint32_t m_cost, uint32_t lanes) {
+    /* Minimum memory_blocks = 8L blocks, where L is the number of lanes */
+    uint32_t memory_blocks = m_cost;
+    if (memory_blocks < 2 * ARGON2_SYNC_POINTS * lanes) {
+        memory_blocks = 2 * ARGON2_SYNC_POINTS * lanes;
+    }
+    /* Ensure that all segments have equal length */
+    const uint32_t segment_length = memory_blocks / (lanes * ARGON2_SYNC_POINTS);
+    return segment_length * (lanes * ARGON2_SYNC_POINTS);
+}
+
+void estimate_footprint(uint32_t memory_blocks, uint32_t lanes,
+                        uint32_t threads, size_t outlen,
+                        size_t thread_stack_size,
+                        argon2_footprint *footprint) {
+    footprint->matrix_bytes = (uint64_t)memory_blocks * sizeof(block);
+    footprint->thread_stack_bytes = 0;
+    /* Output buffer, H_0 with its BLAKE2 state, and the block-sized
+     * buffers of blake2b_long() in the first and final blocks */
+    footprint->overhead_bytes = outlen + sizeof(blake2b_state) +
+                                ARGON2_PREHASH_SEED_LENGTH +
+                                2 * ARGON2_BLOCK_SIZE;
+    /* Segment table */
+    footprint->overhead_bytes +=
+        (uint64_t)lanes * ARGON2_SYNC_POINTS * sizeof(block *);
+#if defined(ARGON2_NO_THREADS)
+    (void)thread_stack_size;
+    threads = 1;
+#else
+    if (threads > 1) {
+        footprint->thread_stack_bytes =
+            (uint64_t)threads * argon2_thread_stack_size(thread_stack_size);
+        footprint->overhead_bytes +=
+            (uint64_t)lanes *
+            (sizeof(argon2_thread_handle_t) + sizeof(argon2_thread_data));
+    }
+#endif
+    footprint->threads = threads;
+    footprint->total_bytes = footprint->matrix_bytes +
+                             footprint->thread_stack_bytes +
+                             footprint->overhead_bytes;
+}
+
 int validate_inputs(const argon2_context *context) {
     if (NULL == context) {
         return ARGON2_INCORRECT_PARAMETER;
@@ -534,14 +634,12 @@ void fill_first_blocks(uint8_t *blockhash, const argon2_instance_t *instance) {
         store32(blockhash + ARGON2_PREHASH_DIGEST_LENGTH + 4, l);
         blake2b_long(blockhash_bytes, ARGON2_BLOCK_SIZE, blockhash,
                      ARGON2_PREHASH_SEED_LENGTH);
-        load_block(&instance->memory[l * instance->lane_length + 0],
-                   blockhash_bytes);
+        load_block(instance_block(instance, l, 0), blockhash_bytes);
 
         store32(blockhash + ARGON2_PREHASH_DIGEST_LENGTH, 1);
         blake2b_long(blockhash_bytes, ARGON2_BLOCK_SIZE, blockhash,
                      ARGON2_PREHASH_SEED_LENGTH);
-        load_block(&instance->memory[l * instance->lane_length + 1],
-                   blockhash_bytes);
+        load_block(instance_block(instance, l, 1), blockhash_bytes);
     }
     clear_internal_memory(blockhash_bytes, ARGON2_BLOCK_SIZE);
 }
@@ -629,11 +727,14 @@ int initialize(argon2_instance_t *instance, argon2_context *context) {
     instance->context_ptr = context;
 
     /* 1. Memory allocation */
-    result = allocate_memory(context, (uint8_t **)&(instance->memory),
-                             instance->memory_blocks, sizeof(block));
+    uint64_t phase_start = crypto_phase_begin(context->stats);
+    result = allocate_segments(context, instance);
+    crypto_phase_end(context->stats, CRYPTO_OPERATION_ARGON2, CRYPTO_PHASE_ALLOCATE,
+                     phase_start, (uint64_t)instance->memory_blocks * sizeof(block));
     if (result != ARGON2_OK) {
         return result;
     }
+    phase_start = crypto_phase_begin(context->stats);
 
     /* 2. Initial hashing */
     /* H_0 + 8 extra bytes to produce the first blocks */
@@ -654,6 +755,8 @@ int initialize(argon2_instance_t *instance, argon2_context *context) {
     fill_first_blocks(blockhash, instance);
     /* Clearing the hash */
     clear_internal_memory(blockhash, ARGON2_PREHASH_SEED_LENGTH);
+    crypto_phase_end(context->stats, CRYPTO_OPERATION_ARGON2, CRYPTO_PHASE_INITIALIZE,
+                     phase_start, 0);
 
     return ARGON2_OK;
 }
@@ -20,6 +20,10 @@
 
 #include "argon2.h"
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 #define CONST_CAST(x) (x)(uintptr_t)
 
 /**********************Argon2 internal constants*******************************/
@@ -69,7 +73,8 @@ void xor_block(block *dst, const block *src);
  * thread
  */
 typedef struct Argon2_instance_t {
-    block *memory;          /* Memory pointer */
+    block **segments;       /* [AP] Memory, as lanes * ARGON2_SYNC_POINTS
+                               separately allocated segments */
     uint32_t version;
     uint32_t passes;        /* Number of passes */
     uint32_t memory_blocks; /* Number of blocks in memory */
@@ -77,6 +82,7 @@ typedef struct Argon2_instance_t {
     uint32_t lane_length;
     uint32_t lanes;
     uint32_t threads;
+    size_t thread_stack_size; /* [AP] stack size of worker threads, 0 for default */
     argon2_type type;
     int print_internals; /* whether to print the memory blocks */
     argon2_context *context_ptr; /* points back to original context */
@@ -93,6 +99,21 @@ typedef struct Argon2_position_t {
     uint32_t index;
 } argon2_position_t;
 
+/*
+ * [AP] The block at @index of @lane. Segments are allocated separately,
+ * so the matrix needs no contiguous address range.
+ */
+static inline block *instance_block(const argon2_instance_t *instance,
+                                    uint32_t lane, uint32_t index) {
+    const uint32_t segment_length = instance->segment_length;
+    /* Branchless index / segment_length, for ARGON2_SYNC_POINTS == 4 */
+    const uint32_t slice = (uint32_t)(index >= segment_length) +
+                           (uint32_t)(index >= 2 * segment_length) +
+                           (uint32_t)(index >= 3 * segment_length);
+    return instance->segments[lane * ARGON2_SYNC_POINTS + slice] +
+           (index - slice * segment_length);
+}
+
 /*Struct that holds the inputs for thread handling FillSegment*/
 typedef struct Argon2_thread_data {
     argon2_instance_t *instance_ptr;
@@ -184,7 +205,8 @@ void fill_first_blocks(uint8_t *blockhash, const argon2_instance_t *instance);
 /*
  * Function allocates memory, hashes the inputs with Blake,  and creates first
  * two blocks. Returns the pointer to the main memory with 2 blocks per lane
- * initialized
+ * initialized. [AP] Memory is allocated per segment; if any allocation fails,
+ * the already allocated segments are released.
  * @param  context  Pointer to the Argon2 internal structure containing memory
  * pointer, and parameters for time and space requirements.
  * @param  instance Current Argon2 instance
@@ -195,7 +217,7 @@ int initialize(argon2_instance_t *instance, argon2_context *context);
 
 /*
  * XORing the last block of each lane, hashing it, making the tag. Deallocates
- * the memory.
+ * the memory, [AP] wiping and releasing one segment at a time.
  * @param context Pointer to current Argon2 context (use only the out parameters
  * from it)
  * @param instance Pointer to current instance of Argon2
@@ -206,6 +228,22 @@ int initialize(argon2_instance_t *instance, argon2_context *context);
  */
 void finalize(const argon2_context *context, argon2_instance_t *instance);
 
+/*
+ * [AP] XORs the last block of each lane and hashes it into @context->out,
+ * without releasing the memory
+ */
+void compute_tag(const argon2_context *context,
+                 const argon2_instance_t *instance);
+
+/*
+ * Whether the caller has asked to stop. The flag can be set from any thread
+ * while the lanes are being filled, so it is read atomically.
+ * @param flag_abort Pointer to the abort flag, may be NULL
+ */
+static inline int is_aborted(const uint8_t *flag_abort) {
+    return flag_abort != NULL && __atomic_load_n(flag_abort, __ATOMIC_RELAXED) != 0;
+}
+
 /*
  * Function that fills the segment using previous segments also from other
  * threads
@@ -225,4 +263,28 @@ void fill_segment(const argon2_instance_t *instance,
  */
 int fill_memory_blocks(argon2_instance_t *instance);
 
+/*
+ * [AP] Number of memory blocks for @m_cost KiB: at least 8 blocks per lane,
+ * rounded down to whole segments
+ */
+uint32_t aligned_memory_blocks(uint32_t m_cost, uint32_t lanes);
+
+/*
+ * [AP] Estimates the peak memory footprint of a run
+ * @param memory_blocks Number of memory blocks, after alignment
+ * @param lanes Number of lanes
+ * @param threads Number of worker threads, after applying the limits
+ * @param outlen Length of the output hash
+ * @param thread_stack_size Stack size of worker threads, 0 for default
+ * @param footprint Receives the estimate
+ */
+void estimate_footprint(uint32_t memory_blocks, uint32_t lanes,
+                        uint32_t threads, size_t outlen,
+                        size_t thread_stack_size,
+                        argon2_footprint *footprint);
+
+#if defined(__cplusplus)
+}
+#endif
+
 #endif
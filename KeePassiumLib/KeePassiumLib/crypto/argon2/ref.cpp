@@ -0,0 +1,258 @@
+/*
+ * Argon2 reference source code package - reference C implementations
+ *
+ * Copyright 2015
+ * Daniel Dinu, Dmitry Khovratovich, Jean-Philippe Aumasson, and Samuel Neves
+ *
+ * You may use this work under the terms of a Creative Commons CC0 1.0
+ * License/Waiver or the Apache Public License 2.0, at your option. The terms of
+ * these licenses can be found at:
+ *
+ * - CC0 1.0 Universal : http://creativecommons.org/publicdomain/zero/1.0
+ * - Apache 2.0        : http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * You should have received a copy of both of these licenses along with this
+ * software. If not, they may be obtained at the above URLs.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "argon2.h"
+#include "core.h"
+
+#include "blake2/blamka-round-ref.h"
+#include "blake2/blake2-impl.h"
+#include "blake2/blake2.h"
+
+
+/*
+ * Function fills a new memory block and optionally XORs the old block over the new one.
+ * @next_block must be initialized.
+ * @param prev_block Pointer to the previous block
+ * @param ref_block Pointer to the reference block
+ * @param next_block Pointer to the block to be constructed
+ * @tparam WithXor Whether to XOR into the new block (true) or just overwrite (false)
+ * @pre all block pointers must be valid
+ */
+template <bool WithXor>
+static void fill_block(const block *prev_block, const block *ref_block,
+                       block *next_block) {
+    block blockR, block_tmp;
+    unsigned i;
+
+    copy_block(&blockR, ref_block);
+    xor_block(&blockR, prev_block);
+    copy_block(&block_tmp, &blockR);
+    /* Now blockR = ref_block + prev_block and block_tmp = ref_block + prev_block */
+    if (WithXor) {
+        /* Saving the next block contents for XOR over: */
+        xor_block(&block_tmp, next_block);
+        /* Now blockR = ref_block + prev_block and
+           block_tmp = ref_block + prev_block + next_block */
+    }
+
+    /* Apply Blake2 on columns of 64-bit words: (0,1,...,15) , then
+       (16,17,..31)... finally (112,113,...127) */
+    for (i = 0; i < 8; ++i) {
+        BLAKE2_ROUND_NOMSG(
+            blockR.v[16 * i], blockR.v[16 * i + 1], blockR.v[16 * i + 2],
+            blockR.v[16 * i + 3], blockR.v[16 * i + 4], blockR.v[16 * i + 5],
+            blockR.v[16 * i + 6], blockR.v[16 * i + 7], blockR.v[16 * i + 8],
+            blockR.v[16 * i + 9], blockR.v[16 * i + 10], blockR.v[16 * i + 11],
+            blockR.v[16 * i + 12], blockR.v[16 * i + 13], blockR.v[16 * i + 14],
+            blockR.v[16 * i + 15]);
+    }
+
+    /* Apply Blake2 on rows of 64-bit words: (0,1,16,17,...112,113), then
+       (2,3,18,19,...,114,115).. finally (14,15,30,31,...,126,127) */
+    for (i = 0; i < 8; i++) {
+        BLAKE2_ROUND_NOMSG(
+            blockR.v[2 * i], blockR.v[2 * i + 1], blockR.v[2 * i + 16],
+            blockR.v[2 * i + 17], blockR.v[2 * i + 32], blockR.v[2 * i + 33],
+            blockR.v[2 * i + 48], blockR.v[2 * i + 49], blockR.v[2 * i + 64],
+            blockR.v[2 * i + 65], blockR.v[2 * i + 80], blockR.v[2 * i + 81],
+            blockR.v[2 * i + 96], blockR.v[2 * i + 97], blockR.v[2 * i + 112],
+            blockR.v[2 * i + 113]);
+    }
+
+    copy_block(next_block, &block_tmp);
+    xor_block(next_block, &blockR);
+}
+
+static void next_addresses(block *address_block, block *input_block,
+                           const block *zero_block) {
+    input_block->v[6]++;
+    fill_block<false>(zero_block, input_block, address_block);
+    fill_block<false>(zero_block, address_block, address_block);
+}
+
+/*
+ * Remainder of division by a fixed 32-bit divisor, without a division instruction
+ * (Lemire et al., "Faster Remainder by Direct Computation", 2019).
+ */
+class fast_modulo {
+public:
+    explicit fast_modulo(uint32_t divisor)
+        : multiplier_(UINT64_MAX / divisor + 1), divisor_(divisor) {}
+
+    uint32_t operator()(uint32_t value) const {
+        const uint64_t fraction = multiplier_ * value;
+        return (uint32_t)(((__uint128_t)fraction * divisor_) >> 64);
+    }
+
+private:
+    const uint64_t multiplier_;
+    const uint32_t divisor_;
+};
+
+/*
+ * Segment filler specialized for one combination of modes, so the block loop has no mode branches:
+ * @tparam DataIndependent Argon2i addressing (true), or Argon2d addressing (false)
+ * @tparam WithXor Whether new blocks are XORed over the old ones (passes after the first, v1.3)
+ * @tparam FirstPass Whether this is pass 0, when only the finished segments can be referenced
+ * @tparam FirstSlice Whether this is slice 0 of pass 0, which starts after the two initial
+ *         blocks and references only its own lane
+ * The reference index is computed as in index_alpha(), with the per-segment parts hoisted.
+ */
+template <bool DataIndependent, bool WithXor, bool FirstPass, bool FirstSlice>
+static void fill_segment_specialized(const argon2_instance_t *instance,
+                                     argon2_position_t position) {
+    static_assert(FirstPass || !FirstSlice, "Slice 0 is special only in the first pass");
+    static_assert(!FirstPass || !WithXor, "The first pass never XORs");
+
+    block address_block, input_block, zero_block;
+    block *const segment = instance->segments[position.lane * ARGON2_SYNC_POINTS + position.slice];
+    const uint32_t lane_length = instance->lane_length;
+    const uint32_t segment_length = instance->segment_length;
+    const fast_modulo lanes_modulo(instance->lanes);
+
+    if (DataIndependent) {
+        init_block_value(&zero_block, 0);
+        init_block_value(&input_block, 0);
+
+        input_block.v[0] = position.pass;
+        input_block.v[1] = position.lane;
+        input_block.v[2] = position.slice;
+        input_block.v[3] = instance->memory_blocks;
+        input_block.v[4] = instance->passes;
+        input_block.v[5] = instance->type;
+    }
+
+    uint32_t starting_index = 0;
+    if (FirstSlice) {
+        starting_index = 2; /* we have already generated the first two blocks */
+
+        /* Don't forget to generate the first block of addresses: */
+        if (DataIndependent) {
+            next_addresses(&address_block, &input_block, &zero_block);
+        }
+    }
+
+    /* Block before the current one; at the start of a segment it is the last block of the previous
+     * segment, and only the first block of a lane wraps to the last one */
+    const block *prev_block;
+    if (starting_index > 0) {
+        prev_block = segment + starting_index - 1;
+    } else {
+        const uint32_t segment_start = position.slice * segment_length;
+        prev_block = instance_block(instance, position.lane,
+                                    (segment_start == 0 ? lane_length : segment_start) - 1);
+    }
+
+    /* Reference area of the block at index 0 in other lanes, and where the area starts */
+    const uint32_t area_base = FirstPass
+        ? position.slice * segment_length
+        : lane_length - segment_length;
+    const uint32_t start_position = (FirstPass || position.slice == ARGON2_SYNC_POINTS - 1)
+        ? 0
+        : (position.slice + 1) * segment_length;
+
+    const uint8_t *flag_abort = instance->context_ptr->flag_abort;
+    for (uint32_t i = starting_index; i < segment_length && !is_aborted(flag_abort); ++i) {
+        block *const curr_block = segment + i;
+
+        /* Taking pseudo-random value from the previous block */
+        uint64_t pseudo_rand;
+        if (DataIndependent) {
+            const uint32_t address_index = i & (ARGON2_ADDRESSES_IN_BLOCK - 1);
+            if (address_index == 0) {
+                next_addresses(&address_block, &input_block, &zero_block);
+            }
+            pseudo_rand = address_block.v[address_index];
+        } else {
+            pseudo_rand = prev_block->v[0];
+        }
+
+        /* Computing the lane of the reference block */
+        uint32_t ref_lane = position.lane;
+        if (!FirstSlice) {
+            /* Can reference other lanes after the first slice */
+            ref_lane = lanes_modulo((uint32_t)(pseudo_rand >> 32));
+        }
+
+        /* Computing the number of possible reference blocks within the lane */
+        const uint32_t reference_area_size = (ref_lane == position.lane)
+            ? area_base + i - 1
+            : area_base - (i == 0);
+
+        /* Mapping pseudo_rand to 0..<reference_area_size-1> */
+        uint64_t relative_position = pseudo_rand & 0xFFFFFFFF;
+        relative_position = relative_position * relative_position >> 32;
+        relative_position = reference_area_size - 1 -
+                            (reference_area_size * relative_position >> 32);
+
+        /* Absolute position; start + relative < 2 * lane_length, so one subtraction wraps it */
+        uint32_t ref_index = start_position + (uint32_t)relative_position;
+        if (!FirstPass) {
+            ref_index = (ref_index >= lane_length) ? ref_index - lane_length : ref_index;
+        }
+
+        /* Creating a new block */
+        const block *ref_block = instance_block(instance, ref_lane, ref_index);
+        fill_block<WithXor>(prev_block, ref_block, curr_block);
+        prev_block = curr_block;
+    }
+}
+
+void fill_segment(const argon2_instance_t *instance,
+                  argon2_position_t position) {
+    if (instance == NULL) {
+        return;
+    }
+
+    const bool data_independent_addressing =
+        (instance->type == Argon2_i) ||
+        (instance->type == Argon2_id && (position.pass == 0) &&
+         (position.slice < ARGON2_SYNC_POINTS / 2));
+    /* version 1.2.1 and earlier: overwrite, not XOR */
+    const bool with_xor =
+        (position.pass != 0) && (instance->version != ARGON2_VERSION_10);
+
+    if (position.pass == 0 && position.slice == 0) {
+        if (data_independent_addressing) {
+            fill_segment_specialized<true, false, true, true>(instance, position);
+        } else {
+            fill_segment_specialized<false, false, true, true>(instance, position);
+        }
+    } else if (position.pass == 0) {
+        if (data_independent_addressing) {
+            fill_segment_specialized<true, false, true, false>(instance, position);
+        } else {
+            fill_segment_specialized<false, false, true, false>(instance, position);
+        }
+    } else if (with_xor) {
+        if (data_independent_addressing) {
+            fill_segment_specialized<true, true, false, false>(instance, position);
+        } else {
+            fill_segment_specialized<false, true, false, false>(instance, position);
+        }
+    } else {
+        if (data_independent_addressing) {
+            fill_segment_specialized<true, false, false, false>(instance, position);
+        } else {
+            fill_segment_specialized<false, false, false, false>(instance, position);
+        }
+    }
+}
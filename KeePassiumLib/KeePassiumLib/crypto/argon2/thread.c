@@ -20,6 +20,9 @@
 #include "thread.h"
 #if defined(_WIN32)
 #include <windows.h>
+#else
+#include <limits.h>
+#include <unistd.h>
 #endif
 
 int argon2_thread_create(argon2_thread_handle_t *handle,
@@ -35,6 +38,61 @@ int argon2_thread_create(argon2_thread_handle_t *handle,
 #endif
 }
 
+int argon2_thread_create_with_stack(argon2_thread_handle_t *handle,
+                                    argon2_thread_func_t func, void *args,
+                                    size_t stack_size) {
+    if (stack_size == 0) {
+        return argon2_thread_create(handle, func, args);
+    }
+    if (NULL == handle || func == NULL) {
+        return -1;
+    }
+    stack_size = argon2_thread_stack_size(stack_size);
+#if defined(_WIN32)
+    *handle = _beginthreadex(NULL, (unsigned)stack_size, func, args,
+                             STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+    return *handle != 0 ? 0 : -1;
+#else
+    pthread_attr_t attributes;
+    int result = pthread_attr_init(&attributes);
+    if (result != 0) {
+        return result;
+    }
+    result = pthread_attr_setstacksize(&attributes, stack_size);
+    if (result == 0) {
+        result = pthread_create(handle, &attributes, func, args);
+    }
+    pthread_attr_destroy(&attributes);
+    return result;
+#endif
+}
+
+size_t argon2_thread_stack_size(size_t requested_size) {
+#if defined(_WIN32)
+    const size_t default_size = 1024 * 1024;
+    return requested_size == 0 ? default_size : requested_size;
+#else
+    if (requested_size == 0) {
+        pthread_attr_t attributes;
+        size_t default_size = 0;
+        if (pthread_attr_init(&attributes) == 0) {
+            pthread_attr_getstacksize(&attributes, &default_size);
+            pthread_attr_destroy(&attributes);
+        }
+        return default_size;
+    }
+    if (requested_size < (size_t)PTHREAD_STACK_MIN) {
+        requested_size = (size_t)PTHREAD_STACK_MIN;
+    }
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size > 0) {
+        const size_t page = (size_t)page_size;
+        requested_size = (requested_size + page - 1) / page * page;
+    }
+    return requested_size;
+#endif
+}
+
 int argon2_thread_join(argon2_thread_handle_t handle) {
 #if defined(_WIN32)
     if (WaitForSingleObject((HANDLE)handle, INFINITE) == WAIT_OBJECT_0) {
@@ -52,6 +52,21 @@ typedef pthread_t argon2_thread_handle_t;
 int argon2_thread_create(argon2_thread_handle_t *handle,
                          argon2_thread_func_t func, void *args);
 
+/* [AP] Creates a thread with the given stack size
+ * @param stack_size Requested stack size in bytes, adjusted as by
+ * argon2_thread_stack_size(). Zero for the system default.
+ * @return 0 if the thread is successfully created.
+ */
+int argon2_thread_create_with_stack(argon2_thread_handle_t *handle,
+                                    argon2_thread_func_t func, void *args,
+                                    size_t stack_size);
+
+/* [AP] Stack size that a thread created with the requested size would get:
+ * the system default for zero, otherwise at least the system minimum,
+ * rounded up to whole pages.
+ */
+size_t argon2_thread_stack_size(size_t requested_size);
+
 /* Waits for a thread to terminate
  * @param handle Handle to a thread created with argon2_thread_create.
  * @return 0 if @handle is a valid handle, and joining completed successfully.
@@ -0,0 +1,159 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "drbg.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/random.h>
+
+#include "../chacha20/chacha20.h"
+
+#define DRBG_KEY_SIZE 32
+#define DRBG_BLOCK_SIZE 64
+#define DRBG_BLOCKS_PER_REFILL 16
+#define DRBG_BUFFER_SIZE (DRBG_BLOCK_SIZE * DRBG_BLOCKS_PER_REFILL)
+#define DRBG_UNIFORM_BATCH 64
+
+struct drbg {
+    uint8_t key[DRBG_KEY_SIZE];
+    uint8_t buffer[DRBG_BUFFER_SIZE];
+    size_t available;       // unused bytes at the end of the buffer
+    size_t since_reseed;    // bytes handed out since the last reseed
+};
+
+static pthread_mutex_t drbg_shared_lock = PTHREAD_MUTEX_INITIALIZER;
+static drbg *drbg_shared = NULL;
+
+/* Plain memset, which the compiler may not drop as a dead store. */
+static inline void drbg_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+static int drbg_reseed(drbg *rng) {
+    uint8_t seed[DRBG_KEY_SIZE];
+    if (getentropy(seed, sizeof(seed)) != 0) {
+        return DRBG_ERROR;
+    }
+    for (size_t i = 0; i < DRBG_KEY_SIZE; i++) {
+        rng->key[i] ^= seed[i];
+    }
+    drbg_wipe(seed, sizeof(seed));
+    rng->since_reseed = 0;
+    return DRBG_OK;
+}
+
+/* Generates a new batch of output and replaces the key with its first bytes. */
+static int drbg_refill(drbg *rng) {
+    if (rng->since_reseed >= DRBG_RESEED_INTERVAL && drbg_reseed(rng) != DRBG_OK) {
+        return DRBG_ERROR;
+    }
+    static const uint8_t nonce[12] = { 0 }; // the key is never reused, so a fixed nonce is fine
+    for (uint32_t i = 0; i < DRBG_BLOCKS_PER_REFILL; i++) {
+        const uint8_t counter[4] = { (uint8_t)i, 0, 0, 0 };
+        chacha20_make_block(rng->key, nonce, counter, rng->buffer + i * DRBG_BLOCK_SIZE);
+    }
+    memcpy(rng->key, rng->buffer, DRBG_KEY_SIZE);
+    drbg_wipe(rng->buffer, DRBG_KEY_SIZE);
+    rng->available = DRBG_BUFFER_SIZE - DRBG_KEY_SIZE;
+    return DRBG_OK;
+}
+
+drbg *drbg_create(void) {
+    drbg *rng = calloc(1, sizeof(drbg));
+    if (!rng) {
+        return NULL;
+    }
+    if (getentropy(rng->key, DRBG_KEY_SIZE) != 0) {
+        drbg_destroy(rng);
+        return NULL;
+    }
+    return rng;
+}
+
+void drbg_destroy(drbg *rng) {
+    if (!rng) {
+        return;
+    }
+    drbg_wipe(rng, sizeof(drbg));
+    free(rng);
+}
+
+int drbg_fill(drbg *rng, uint8_t *out, size_t length) {
+    while (length > 0) {
+        if (rng->available == 0 && drbg_refill(rng) != DRBG_OK) {
+            return DRBG_ERROR;
+        }
+        const size_t chunk = (length < rng->available) ? length : rng->available;
+        uint8_t *src = rng->buffer + DRBG_BUFFER_SIZE - rng->available;
+        memcpy(out, src, chunk);
+        drbg_wipe(src, chunk);
+        rng->available -= chunk;
+        rng->since_reseed += chunk;
+        out += chunk;
+        length -= chunk;
+    }
+    return DRBG_OK;
+}
+
+/*
+ * Lemire's multiply-and-reject: the high half of random * upper_bound is uniform
+ * once the low half falls outside the small biased range [0, 2^32 mod upper_bound).
+ */
+int drbg_uniform(drbg *rng, uint32_t upper_bound, uint32_t *out, size_t count) {
+    if (upper_bound == 0) {
+        return DRBG_ERROR;
+    }
+    const uint32_t threshold = (uint32_t)(-upper_bound) % upper_bound;
+    uint32_t batch[DRBG_UNIFORM_BATCH];
+    size_t batch_pos = DRBG_UNIFORM_BATCH;
+    int status = DRBG_OK;
+    for (size_t i = 0; i < count; ) {
+        if (batch_pos == DRBG_UNIFORM_BATCH) {
+            if (drbg_fill(rng, (uint8_t *)batch, sizeof(batch)) != DRBG_OK) {
+                status = DRBG_ERROR;
+                break;
+            }
+            batch_pos = 0;
+        }
+        const uint64_t product = (uint64_t)batch[batch_pos++] * upper_bound;
+        if ((uint32_t)product >= threshold) {
+            out[i++] = (uint32_t)(product >> 32);
+        }
+    }
+    drbg_wipe(batch, sizeof(batch));
+    return status;
+}
+
+/***************Shared generator*****************/
+
+static drbg *drbg_shared_get(void) {
+    if (!drbg_shared) {
+        drbg_shared = drbg_create();
+    }
+    return drbg_shared;
+}
+
+int drbg_shared_fill(uint8_t *out, size_t length) {
+    pthread_mutex_lock(&drbg_shared_lock);
+    drbg *rng = drbg_shared_get();
+    const int status = rng ? drbg_fill(rng, out, length) : DRBG_ERROR;
+    pthread_mutex_unlock(&drbg_shared_lock);
+    return status;
+}
+
+int drbg_shared_uniform(uint32_t upper_bound, uint32_t *out, size_t count) {
+    pthread_mutex_lock(&drbg_shared_lock);
+    drbg *rng = drbg_shared_get();
+    const int status = rng ? drbg_uniform(rng, upper_bound, out, count) : DRBG_ERROR;
+    pthread_mutex_unlock(&drbg_shared_lock);
+    return status;
+}
@@ -0,0 +1,59 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef drbg_h
+#define drbg_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Buffered random generator based on ChaCha20, with fast key erasure:
+/// each refill produces a batch of ChaCha20 blocks, the first 32 bytes of which
+/// immediately replace the key, and every byte is wiped once handed out.
+/// So a captured state reveals neither past nor buffered-and-used output.
+///
+/// The key is seeded from the OS (getentropy) and reseeded from it
+/// after every DRBG_RESEED_INTERVAL bytes of output.
+typedef struct drbg drbg;
+
+#define DRBG_OK 0
+#define DRBG_ERROR (-1)
+
+/// Output bytes between reseeds from the OS.
+#define DRBG_RESEED_INTERVAL (1024 * 1024)
+
+/// Creates a generator seeded from the OS; NULL on failure.
+/// A generator is not thread-safe, use the drbg_shared_* functions for a shared one.
+drbg *drbg_create(void);
+
+/// Wipes and releases the generator.
+void drbg_destroy(drbg *rng);
+
+/// Fills the buffer with random bytes.
+/// @return DRBG_OK, or DRBG_ERROR if the OS could not provide entropy for a reseed
+int drbg_fill(drbg *rng, uint8_t *out, size_t length);
+
+/// Generates `count` uniformly distributed values in [0, upper_bound), without modulo bias.
+/// @return DRBG_OK, or DRBG_ERROR if upper_bound is 0 or reseeding failed
+int drbg_uniform(drbg *rng, uint32_t upper_bound, uint32_t *out, size_t count);
+
+/// Same as drbg_fill(), using a process-wide generator. Thread-safe.
+int drbg_shared_fill(uint8_t *out, size_t length);
+
+/// Same as drbg_uniform(), using a process-wide generator. Thread-safe.
+int drbg_shared_uniform(uint32_t upper_bound, uint32_t *out, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* drbg_h */
@@ -0,0 +1,183 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "crypto_stats.h"
+
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#define CRYPTO_TRACE_EVENT_WORDS (sizeof(crypto_trace_event) / sizeof(uint64_t))
+
+/*
+ * Ring buffer slot, guarded by a sequence number (seqlock):
+ * odd while the event is being written, 2 * (ticket + 1) once it is complete.
+ * Readers skip slots that change while being copied.
+ */
+typedef struct {
+    uint64_t sequence;
+    uint64_t words[CRYPTO_TRACE_EVENT_WORDS];
+} crypto_trace_slot;
+
+static crypto_trace_slot crypto_trace_slots[CRYPTO_TRACE_CAPACITY];
+static uint64_t crypto_trace_next_ticket = 0;
+static uint64_t crypto_trace_first_ticket = 0; /* events before this one are cleared */
+static int crypto_trace_enabled = 0;
+
+static uint64_t crypto_time_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    return ns | (ns == 0); /* zero means "not measuring" */
+}
+
+/***************Trace ring buffer*****************/
+
+void crypto_trace_set_enabled(int enabled) {
+    __atomic_store_n(&crypto_trace_enabled, enabled ? 1 : 0, __ATOMIC_RELAXED);
+}
+
+int crypto_trace_is_enabled(void) {
+    return __atomic_load_n(&crypto_trace_enabled, __ATOMIC_RELAXED);
+}
+
+static void crypto_trace_record(const crypto_trace_event *event) {
+    const uint64_t ticket = __atomic_fetch_add(&crypto_trace_next_ticket, 1, __ATOMIC_RELAXED);
+    crypto_trace_slot *slot = &crypto_trace_slots[ticket % CRYPTO_TRACE_CAPACITY];
+    uint64_t words[CRYPTO_TRACE_EVENT_WORDS];
+    memcpy(words, event, sizeof(words));
+
+    __atomic_store_n(&slot->sequence, 2 * ticket + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (size_t i = 0; i < CRYPTO_TRACE_EVENT_WORDS; i++) {
+        __atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&slot->sequence, 2 * ticket + 2, __ATOMIC_RELEASE);
+}
+
+size_t crypto_trace_copy(crypto_trace_event *events, size_t max_count) {
+    if (!events || max_count == 0) {
+        return 0;
+    }
+    const uint64_t end = __atomic_load_n(&crypto_trace_next_ticket, __ATOMIC_ACQUIRE);
+    uint64_t start = end > CRYPTO_TRACE_CAPACITY ? end - CRYPTO_TRACE_CAPACITY : 0;
+    const uint64_t first = __atomic_load_n(&crypto_trace_first_ticket, __ATOMIC_RELAXED);
+    if (start < first) {
+        start = first;
+    }
+    if (end - start > max_count) {
+        start = end - max_count;
+    }
+
+    size_t count = 0;
+    for (uint64_t ticket = start; ticket < end; ticket++) {
+        crypto_trace_slot *slot = &crypto_trace_slots[ticket % CRYPTO_TRACE_CAPACITY];
+        const uint64_t expected = 2 * ticket + 2;
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != expected) {
+            continue; /* still being written, or already overwritten */
+        }
+        uint64_t words[CRYPTO_TRACE_EVENT_WORDS];
+        for (size_t i = 0; i < CRYPTO_TRACE_EVENT_WORDS; i++) {
+            words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != expected) {
+            continue;
+        }
+        memcpy(&events[count++], words, sizeof(words));
+    }
+    return count;
+}
+
+void crypto_trace_clear(void) {
+    const uint64_t end = __atomic_load_n(&crypto_trace_next_ticket, __ATOMIC_RELAXED);
+    __atomic_store_n(&crypto_trace_first_ticket, end, __ATOMIC_RELAXED);
+}
+
+/***************Names*****************/
+
+const char *crypto_phase_name(crypto_phase phase) {
+    switch (phase) {
+    case CRYPTO_PHASE_ALLOCATE: return "allocate";
+    case CRYPTO_PHASE_INITIALIZE: return "initialize";
+    case CRYPTO_PHASE_FILL: return "fill";
+    case CRYPTO_PHASE_THREAD_SPAWN: return "thread_spawn";
+    case CRYPTO_PHASE_FINALIZE: return "finalize";
+    case CRYPTO_PHASE_WIPE: return "wipe";
+    case CRYPTO_PHASE_TRANSFORM: return "transform";
+    case CRYPTO_PHASE_COMPRESS: return "compress";
+    case CRYPTO_PHASE_AUTHENTICATE: return "authenticate";
+    case CRYPTO_PHASE_COUNT: break;
+    }
+    return "unknown";
+}
+
+const char *crypto_operation_name(crypto_operation operation) {
+    switch (operation) {
+    case CRYPTO_OPERATION_ARGON2: return "argon2";
+    case CRYPTO_OPERATION_AESKDF: return "aeskdf";
+    case CRYPTO_OPERATION_CIPHER: return "cipher";
+    case CRYPTO_OPERATION_KDBX_WRITER: return "kdbx_writer";
+    }
+    return "unknown";
+}
+
+/***************Hooks*****************/
+
+uint64_t crypto_phase_begin(const crypto_stats *stats) {
+    if (!stats && !crypto_trace_is_enabled()) {
+        return 0;
+    }
+    return crypto_time_now_ns();
+}
+
+void crypto_phase_end(crypto_stats *stats, crypto_operation operation, crypto_phase phase,
+                      uint64_t start, uint64_t bytes)
+{
+    if (start == 0 || phase >= CRYPTO_PHASE_COUNT) {
+        return;
+    }
+    const uint64_t now = crypto_time_now_ns();
+    const uint64_t duration = now - start;
+    if (stats) {
+        stats->phase_ns[phase] += duration;
+    }
+    if (crypto_trace_is_enabled()) {
+        crypto_trace_event event = {
+            .timestamp_ns = now,
+            .duration_ns = duration,
+            .bytes = bytes,
+            .operation = (uint16_t)operation,
+            .phase = (uint16_t)phase,
+            .reserved = 0
+        };
+        crypto_trace_record(&event);
+    }
+}
+
+/*
+ * The counters are subtracted at the beginning and added at the end,
+ * so that the struct accumulates the difference without extra storage.
+ */
+void crypto_faults_begin(crypto_stats *stats) {
+    struct rusage usage;
+    if (!stats || getrusage(RUSAGE_SELF, &usage) != 0) {
+        return;
+    }
+    stats->minor_faults -= (uint64_t)usage.ru_minflt;
+    stats->major_faults -= (uint64_t)usage.ru_majflt;
+}
+
+void crypto_faults_end(crypto_stats *stats) {
+    struct rusage usage;
+    if (!stats || getrusage(RUSAGE_SELF, &usage) != 0) {
+        return;
+    }
+    stats->minor_faults += (uint64_t)usage.ru_minflt;
+    stats->major_faults += (uint64_t)usage.ru_majflt;
+}
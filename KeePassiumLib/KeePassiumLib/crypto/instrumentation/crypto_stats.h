@@ -0,0 +1,96 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef crypto_stats_h
+#define crypto_stats_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Phases of native crypto operations.
+typedef enum {
+    CRYPTO_PHASE_ALLOCATE = 0,      // working memory allocation
+    CRYPTO_PHASE_INITIALIZE = 1,    // input hashing, key schedule
+    CRYPTO_PHASE_FILL = 2,          // Argon2 memory filling (includes thread spawning)
+    CRYPTO_PHASE_THREAD_SPAWN = 3,  // creating worker threads
+    CRYPTO_PHASE_FINALIZE = 4,      // output hashing
+    CRYPTO_PHASE_WIPE = 5,          // clearing and releasing working memory
+    CRYPTO_PHASE_TRANSFORM = 6,     // AES-KDF rounds, bulk encryption/decryption
+    CRYPTO_PHASE_COMPRESS = 7,      // gzip in the KDBX writer
+    CRYPTO_PHASE_AUTHENTICATE = 8,  // HMAC of KDBX blocks
+    CRYPTO_PHASE_COUNT = 9
+} crypto_phase;
+
+typedef enum {
+    CRYPTO_OPERATION_ARGON2 = 0,
+    CRYPTO_OPERATION_AESKDF = 1,
+    CRYPTO_OPERATION_CIPHER = 2,
+    CRYPTO_OPERATION_KDBX_WRITER = 3
+} crypto_operation;
+
+/// Per-call statistics, filled in by the primitives that accept a `crypto_stats *`.
+/// Values are accumulated, so zero the struct before the call.
+/// Passing NULL disables collection entirely.
+typedef struct {
+    uint64_t phase_ns[CRYPTO_PHASE_COUNT]; // time spent in each phase
+    uint64_t bytes_processed;   // cipher input, or KDF working memory
+    uint64_t blocks_processed;  // Argon2 blocks, AES-KDF rounds, cipher blocks
+    uint64_t threads_spawned;
+    uint64_t minor_faults;      // page faults during the call (process-wide)
+    uint64_t major_faults;
+} crypto_stats;
+
+/// An entry of the global trace ring buffer.
+typedef struct {
+    uint64_t timestamp_ns;  // monotonic clock, at the end of the phase
+    uint64_t duration_ns;
+    uint64_t bytes;
+    uint16_t operation;     // crypto_operation
+    uint16_t phase;         // crypto_phase
+    uint32_t reserved;
+} crypto_trace_event;
+
+/// Number of most recent events kept by the trace ring buffer.
+#define CRYPTO_TRACE_CAPACITY 256
+
+/// Turns the global trace ring buffer on or off (off by default).
+void crypto_trace_set_enabled(int enabled);
+
+int crypto_trace_is_enabled(void);
+
+/// Copies up to `max_count` most recent events, oldest first.
+/// @return number of copied events
+size_t crypto_trace_copy(crypto_trace_event *events, size_t max_count);
+
+/// Drops all the recorded events.
+void crypto_trace_clear(void);
+
+const char *crypto_phase_name(crypto_phase phase);
+
+const char *crypto_operation_name(crypto_operation operation);
+
+/// Instrumentation hooks for the primitives.
+/// crypto_phase_begin() returns 0 when neither `stats` nor tracing is active,
+/// and crypto_phase_end() returns immediately for such a start value.
+uint64_t crypto_phase_begin(const crypto_stats *stats);
+void crypto_phase_end(crypto_stats *stats, crypto_operation operation, crypto_phase phase,
+                      uint64_t start, uint64_t bytes);
+
+/// Adds the page faults that happen between the two calls to `stats` (if any).
+void crypto_faults_begin(crypto_stats *stats);
+void crypto_faults_end(crypto_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* crypto_stats_h */
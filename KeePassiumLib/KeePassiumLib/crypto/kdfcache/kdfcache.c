@@ -0,0 +1,197 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "kdfcache.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+
+#include "../sha256/sha256.h"
+
+typedef struct {
+    uint8_t tag[SHA256_DIGEST_SIZE];
+    uint8_t value[KDFCACHE_MAX_VALUE_SIZE];
+    size_t value_length;
+    uint64_t expires_at;  // seconds of kdfcache_now(); 0 if the slot is free
+    uint64_t last_used;   // use counter, for LRU eviction
+} kdfcache_entry;
+
+typedef struct {
+    uint8_t salt[SHA256_DIGEST_SIZE];
+    uint64_t use_counter;
+    kdfcache_entry entries[KDFCACHE_CAPACITY];
+} kdfcache_storage;
+
+static pthread_once_t kdfcache_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t kdfcache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static kdfcache_storage *kdfcache = NULL;
+
+static void kdfcache_wipe(void *buffer, size_t length) {
+    volatile uint8_t *bytes = buffer;
+    while (length--) {
+        *bytes++ = 0;
+    }
+}
+
+static void kdfcache_setup(void) {
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t size = (sizeof(kdfcache_storage) + page_size - 1) / page_size * page_size;
+    kdfcache_storage *storage = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (storage == MAP_FAILED) {
+        return;
+    }
+    mlock(storage, size); // best effort, keeps the keys out of swap
+#ifdef MADV_DONTDUMP
+    madvise(storage, size, MADV_DONTDUMP);
+#endif
+    if (getentropy(storage->salt, sizeof(storage->salt)) != 0) {
+        munmap(storage, size);
+        return;
+    }
+    kdfcache = storage;
+}
+
+/// Seconds since boot, including sleep.
+static uint64_t kdfcache_now(void) {
+    struct timespec now;
+#if defined(CLOCK_BOOTTIME)
+    clock_gettime(CLOCK_BOOTTIME, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now); // on Darwin, keeps counting during sleep
+#endif
+    return (uint64_t)now.tv_sec;
+}
+
+static void kdfcache_make_tag(
+    const uint8_t *key, size_t key_length,
+    const uint8_t *params, size_t params_length,
+    uint8_t tag[SHA256_DIGEST_SIZE])
+{
+    uint8_t length_bytes[8];
+    for (int i = 0; i < 8; i++) {
+        length_bytes[i] = (uint8_t)((uint64_t)key_length >> (8 * i));
+    }
+    sha256_context hasher;
+    sha256_init(&hasher);
+    sha256_update(&hasher, kdfcache->salt, sizeof(kdfcache->salt));
+    sha256_update(&hasher, length_bytes, sizeof(length_bytes));
+    sha256_update(&hasher, key, key_length);
+    sha256_update(&hasher, params, params_length);
+    sha256_final(&hasher, tag);
+}
+
+static int kdfcache_tags_equal(const uint8_t *a, const uint8_t *b) {
+    uint8_t difference = 0;
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0;
+}
+
+static void kdfcache_evict(kdfcache_entry *entry) {
+    kdfcache_wipe(entry, sizeof(kdfcache_entry));
+}
+
+int kdfcache_lookup(
+    const uint8_t *key, size_t key_length,
+    const uint8_t *params, size_t params_length,
+    uint8_t *value, size_t value_length)
+{
+    pthread_once(&kdfcache_once, kdfcache_setup);
+    if (kdfcache == NULL) {
+        return KDFCACHE_ERROR;
+    }
+    uint8_t tag[SHA256_DIGEST_SIZE];
+    kdfcache_make_tag(key, key_length, params, params_length, tag);
+
+    int status = KDFCACHE_MISS;
+    const uint64_t now = kdfcache_now();
+    pthread_mutex_lock(&kdfcache_mutex);
+    for (size_t i = 0; i < KDFCACHE_CAPACITY; i++) {
+        kdfcache_entry *entry = &kdfcache->entries[i];
+        if (entry->expires_at == 0) {
+            continue;
+        }
+        if (entry->expires_at <= now) {
+            kdfcache_evict(entry);
+            continue;
+        }
+        if (status == KDFCACHE_MISS && kdfcache_tags_equal(entry->tag, tag) && entry->value_length == value_length) {
+            memcpy(value, entry->value, value_length);
+            entry->last_used = ++kdfcache->use_counter;
+            status = KDFCACHE_OK;
+        }
+    }
+    pthread_mutex_unlock(&kdfcache_mutex);
+    kdfcache_wipe(tag, sizeof(tag));
+    return status;
+}
+
+int kdfcache_store(
+    const uint8_t *key, size_t key_length,
+    const uint8_t *params, size_t params_length,
+    const uint8_t *value, size_t value_length,
+    uint32_t ttl_seconds)
+{
+    if (value_length > KDFCACHE_MAX_VALUE_SIZE) {
+        return KDFCACHE_ERROR;
+    }
+    pthread_once(&kdfcache_once, kdfcache_setup);
+    if (kdfcache == NULL) {
+        return KDFCACHE_ERROR;
+    }
+    if (ttl_seconds == 0) {
+        return KDFCACHE_OK;
+    }
+    uint8_t tag[SHA256_DIGEST_SIZE];
+    kdfcache_make_tag(key, key_length, params, params_length, tag);
+
+    const uint64_t now = kdfcache_now();
+    pthread_mutex_lock(&kdfcache_mutex);
+    kdfcache_entry *target = NULL;
+    for (size_t i = 0; i < KDFCACHE_CAPACITY; i++) {
+        kdfcache_entry *entry = &kdfcache->entries[i];
+        if (entry->expires_at != 0 && entry->expires_at <= now) {
+            kdfcache_evict(entry);
+        }
+        if (entry->expires_at != 0 && kdfcache_tags_equal(entry->tag, tag)) {
+            target = entry;
+            break;
+        }
+        if (target == NULL ||
+            (target->expires_at != 0 && (entry->expires_at == 0 || entry->last_used < target->last_used)))
+        {
+            target = entry; // a free slot, or the least recently used one
+        }
+    }
+    kdfcache_evict(target);
+    memcpy(target->tag, tag, sizeof(tag));
+    memcpy(target->value, value, value_length);
+    target->value_length = value_length;
+    target->expires_at = now + ttl_seconds;
+    target->last_used = ++kdfcache->use_counter;
+    pthread_mutex_unlock(&kdfcache_mutex);
+    kdfcache_wipe(tag, sizeof(tag));
+    return KDFCACHE_OK;
+}
+
+void kdfcache_clear(void) {
+    pthread_once(&kdfcache_once, kdfcache_setup);
+    if (kdfcache == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&kdfcache_mutex);
+    for (size_t i = 0; i < KDFCACHE_CAPACITY; i++) {
+        kdfcache_evict(&kdfcache->entries[i]);
+    }
+    pthread_mutex_unlock(&kdfcache_mutex);
+}
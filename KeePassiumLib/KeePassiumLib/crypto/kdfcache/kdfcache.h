@@ -0,0 +1,59 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef kdfcache_h
+#define kdfcache_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Process-wide cache of KDF results, so that reloading a database with an unchanged
+/// header does not run the KDF again.
+/// Entries live in locked memory, excluded from core dumps, and are wiped on eviction.
+/// They are found by a salted SHA-256 tag of the KDF input and parameters,
+/// so the cache holds neither the input key nor anything to check a guess against
+/// without the per-process salt.
+
+#define KDFCACHE_OK 0
+#define KDFCACHE_MISS 1
+#define KDFCACHE_ERROR (-1)
+
+#define KDFCACHE_CAPACITY 8
+#define KDFCACHE_MAX_VALUE_SIZE 64
+
+/// Looks up the KDF output for the given input key and serialized KDF parameters
+/// (including the KDF ID and the salt). Expired entries are wiped along the way.
+/// @param  value         receives the cached output on KDFCACHE_OK
+/// @param  value_length  expected size of the output
+/// @return KDFCACHE_OK, KDFCACHE_MISS, or KDFCACHE_ERROR if the cache could not be set up
+int kdfcache_lookup(
+    const uint8_t *key, size_t key_length,
+    const uint8_t *params, size_t params_length,
+    uint8_t *value, size_t value_length);
+
+/// Remembers the KDF output for `ttl_seconds`, evicting the least recently used entry if needed.
+/// The time keeps running while the device sleeps.
+/// @return KDFCACHE_OK, or KDFCACHE_ERROR if the value is too large or the cache could not be set up
+int kdfcache_store(
+    const uint8_t *key, size_t key_length,
+    const uint8_t *params, size_t params_length,
+    const uint8_t *value, size_t value_length,
+    uint32_t ttl_seconds);
+
+/// Wipes all entries.
+void kdfcache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* kdfcache_h */
@@ -0,0 +1,105 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "memprotect.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+
+#include "../chacha20/chacha20.h"
+
+#define MEMPROTECT_KEY_SIZE 32
+#define MEMPROTECT_BLOCK_SIZE 64
+
+static pthread_once_t memprotect_once = PTHREAD_ONCE_INIT;
+static int memprotect_status = MEMPROTECT_ERROR;
+static const uint8_t *memprotect_key = NULL;
+static uint8_t memprotect_nonce_salt[4];
+static uint64_t memprotect_nonce_counter = 0;
+
+static void memprotect_wipe(void *buffer, size_t length) {
+    volatile uint8_t *bytes = buffer;
+    while (length--) {
+        *bytes++ = 0;
+    }
+}
+
+static void memprotect_setup(void) {
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    uint8_t *page = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (page == MAP_FAILED) {
+        return;
+    }
+    mlock(page, page_size); // best effort, keeps the key out of swap
+#ifdef MADV_DONTDUMP
+    madvise(page, page_size, MADV_DONTDUMP);
+#endif
+    if (getentropy(page, MEMPROTECT_KEY_SIZE) != 0 ||
+        getentropy(memprotect_nonce_salt, sizeof(memprotect_nonce_salt)) != 0)
+    {
+        memprotect_wipe(page, page_size);
+        munmap(page, page_size);
+        return;
+    }
+    mprotect(page, page_size, PROT_READ);
+    memprotect_key = page;
+    memprotect_status = MEMPROTECT_OK;
+}
+
+int memprotect_init(void) {
+    pthread_once(&memprotect_once, memprotect_setup);
+    return memprotect_status;
+}
+
+static void memprotect_xor(const uint8_t *nonce, const uint8_t *src, size_t length, uint8_t *dst) {
+    uint8_t block[MEMPROTECT_BLOCK_SIZE];
+    uint32_t counter = 0;
+    while (length > 0) {
+        const uint8_t counter_bytes[4] = {
+            (uint8_t)counter, (uint8_t)(counter >> 8), (uint8_t)(counter >> 16), (uint8_t)(counter >> 24)
+        };
+        chacha20_make_block(memprotect_key, nonce, counter_bytes, block);
+        counter++;
+        const size_t chunk = length < MEMPROTECT_BLOCK_SIZE ? length : MEMPROTECT_BLOCK_SIZE;
+        for (size_t i = 0; i < chunk; i++) {
+            dst[i] = src[i] ^ block[i];
+        }
+        src += chunk;
+        dst += chunk;
+        length -= chunk;
+    }
+    memprotect_wipe(block, sizeof(block));
+}
+
+int memprotect_seal(const uint8_t *src, size_t length, uint8_t *dst) {
+    if (memprotect_init() != MEMPROTECT_OK || !dst || (!src && length > 0)) {
+        return MEMPROTECT_ERROR;
+    }
+    const uint64_t sequence = __atomic_fetch_add(&memprotect_nonce_counter, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < 8; i++) {
+        dst[i] = (uint8_t)(sequence >> (8 * i));
+    }
+    memcpy(dst + 8, memprotect_nonce_salt, sizeof(memprotect_nonce_salt));
+    memprotect_xor(dst, src, length, dst + MEMPROTECT_NONCE_SIZE);
+    return MEMPROTECT_OK;
+}
+
+int memprotect_open(const uint8_t *sealed, size_t sealed_length, uint8_t *dst) {
+    if (memprotect_init() != MEMPROTECT_OK || !sealed || sealed_length < MEMPROTECT_NONCE_SIZE) {
+        return MEMPROTECT_ERROR;
+    }
+    const size_t length = sealed_length - MEMPROTECT_NONCE_SIZE;
+    if (length > 0 && !dst) {
+        return MEMPROTECT_ERROR;
+    }
+    memprotect_xor(sealed, sealed + MEMPROTECT_NONCE_SIZE, length, dst);
+    return MEMPROTECT_OK;
+}
@@ -0,0 +1,49 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef memprotect_h
+#define memprotect_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// In-memory protection of secrets with a symmetric cipher.
+/// The key is random, generated once per process and kept in a locked read-only page;
+/// each sealed buffer gets a unique nonce, so sealing is ChaCha20 under
+/// (process key, nonce) and costs about as much as a memcpy.
+/// Sealed buffers cannot be opened by another process, use a persistent key for storage.
+
+/// Number of bytes prepended to sealed data.
+#define MEMPROTECT_NONCE_SIZE 12
+
+#define MEMPROTECT_OK 0
+#define MEMPROTECT_ERROR (-1)
+
+/// Prepares the process key. Thread-safe; only the first call does actual work.
+/// @return MEMPROTECT_OK, or MEMPROTECT_ERROR if a random key could not be generated.
+int memprotect_init(void);
+
+/// Encrypts `length` bytes of `src` into `dst`, which must have room for
+/// MEMPROTECT_NONCE_SIZE + length bytes. Buffers must not overlap.
+/// @return MEMPROTECT_OK or MEMPROTECT_ERROR
+int memprotect_seal(const uint8_t *src, size_t length, uint8_t *dst);
+
+/// Decrypts the output of memprotect_seal(). `dst` must have room for
+/// sealed_length - MEMPROTECT_NONCE_SIZE bytes. Buffers must not overlap.
+/// @return MEMPROTECT_OK or MEMPROTECT_ERROR
+int memprotect_open(const uint8_t *sealed, size_t sealed_length, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* memprotect_h */
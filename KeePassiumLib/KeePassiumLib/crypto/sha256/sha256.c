@@ -0,0 +1,257 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "sha256.h"
+
+#include <string.h>
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define SHA256_USE_ARMV8 1
+#include <arm_neon.h>
+#elif defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#define SHA256_USE_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline void sha256_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+/***************ARMv8*****************/
+#if SHA256_USE_ARMV8
+
+static void sha256_blocks_armv8(uint32_t state[8], const uint8_t *data, size_t block_count) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+    for (; block_count > 0; block_count--, data += SHA256_BLOCK_SIZE) {
+        const uint32x4_t abcd_save = state0;
+        const uint32x4_t efgh_save = state1;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+        for (int g = 0; g < 16; g++) {
+            // w[g % 4] holds W[g - 4]; the next three hold W[g - 3], W[g - 2], W[g - 1]
+            if (g >= 4) {
+                w[g % 4] = vsha256su1q_u32(
+                    vsha256su0q_u32(w[g % 4], w[(g + 1) % 4]),
+                    w[(g + 2) % 4],
+                    w[(g + 3) % 4]);
+            }
+            const uint32x4_t wk = vaddq_u32(w[g % 4], vld1q_u32(&sha256_k[4 * g]));
+            const uint32x4_t abcd = state0;
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, abcd, wk);
+        }
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+    }
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+#endif /* SHA256_USE_ARMV8 */
+
+/***************SHA-NI*****************/
+#if SHA256_USE_SHANI
+
+#define SHA256_SHANI __attribute__((target("sha,sse4.1,ssse3")))
+
+static int sha256_has_shani(void) {
+    static int has_shani = -1;
+    if (has_shani < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        const int has_sse41 = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_1) && (ecx & bit_SSSE3);
+        const int has_sha = __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+        has_shani = (has_sse41 && has_sha) ? 1 : 0;
+    }
+    return has_shani;
+}
+
+SHA256_SHANI
+static void sha256_blocks_shani(uint32_t state[8], const uint8_t *data, size_t block_count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The instructions expect the state as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; block_count > 0; block_count--, data += SHA256_BLOCK_SIZE) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+        __m128i w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), byte_swap);
+        }
+        for (int g = 0; g < 16; g++) {
+            // w[g % 4] holds W[g - 4]; the next three hold W[g - 3], W[g - 2], W[g - 1]
+            if (g >= 4) {
+                __m128i next = _mm_sha256msg1_epu32(w[g % 4], w[(g + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(g + 3) % 4], w[(g + 2) % 4], 4));
+                w[g % 4] = _mm_sha256msg2_epu32(next, w[(g + 3) % 4]);
+            }
+            __m128i wk = _mm_add_epi32(w[g % 4], _mm_loadu_si128((const __m128i *)&sha256_k[4 * g]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            wk = _mm_shuffle_epi32(wk, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+        }
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i *)&state[0], state0);
+    _mm_storeu_si128((__m128i *)&state[4], state1);
+}
+
+#endif /* SHA256_USE_SHANI */
+
+/***************Scalar*****************/
+
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_blocks_scalar(uint32_t state[8], const uint8_t *data, size_t block_count) {
+    uint32_t w[64];
+    for (; block_count > 0; block_count--, data += SHA256_BLOCK_SIZE) {
+        for (int i = 0; i < 16; i++) {
+            const uint8_t *p = data + 4 * i;
+            w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        }
+        for (int i = 16; i < 64; i++) {
+            const uint32_t s0 = SHA256_ROTR(w[i - 15], 7) ^ SHA256_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = SHA256_ROTR(w[i - 2], 17) ^ SHA256_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            const uint32_t s1 = SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25);
+            const uint32_t ch = (e & f) ^ (~e & g);
+            const uint32_t t1 = h + s1 + ch + sha256_k[i] + w[i];
+            const uint32_t s0 = SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22);
+            const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            const uint32_t t2 = s0 + maj;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+    sha256_wipe(w, sizeof(w));
+}
+
+static void sha256_blocks(uint32_t state[8], const uint8_t *data, size_t block_count) {
+#if SHA256_USE_ARMV8
+    sha256_blocks_armv8(state, data, block_count);
+#elif SHA256_USE_SHANI
+    if (sha256_has_shani()) {
+        sha256_blocks_shani(state, data, block_count);
+    } else {
+        sha256_blocks_scalar(state, data, block_count);
+    }
+#else
+    sha256_blocks_scalar(state, data, block_count);
+#endif
+}
+
+/***************API*****************/
+
+void sha256_init(sha256_context *ctx) {
+    static const uint32_t initial_state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, initial_state, sizeof(initial_state));
+    ctx->length = 0;
+    ctx->buffered = 0;
+}
+
+void sha256_update(sha256_context *ctx, const uint8_t *data, size_t length) {
+    ctx->length += length;
+    if (ctx->buffered > 0) {
+        const size_t missing = SHA256_BLOCK_SIZE - ctx->buffered;
+        const size_t chunk = (length < missing) ? length : missing;
+        memcpy(ctx->buffer + ctx->buffered, data, chunk);
+        ctx->buffered += chunk;
+        data += chunk;
+        length -= chunk;
+        if (ctx->buffered < SHA256_BLOCK_SIZE) {
+            return;
+        }
+        sha256_blocks(ctx->state, ctx->buffer, 1);
+        ctx->buffered = 0;
+    }
+    const size_t block_count = length / SHA256_BLOCK_SIZE;
+    if (block_count > 0) {
+        sha256_blocks(ctx->state, data, block_count);
+        data += block_count * SHA256_BLOCK_SIZE;
+        length -= block_count * SHA256_BLOCK_SIZE;
+    }
+    if (length > 0) {
+        memcpy(ctx->buffer, data, length);
+        ctx->buffered = length;
+    }
+}
+
+void sha256_final(sha256_context *ctx, uint8_t digest[SHA256_DIGEST_SIZE]) {
+    const uint64_t bit_length = ctx->length * 8;
+    ctx->buffer[ctx->buffered++] = 0x80;
+    if (ctx->buffered > SHA256_BLOCK_SIZE - 8) {
+        memset(ctx->buffer + ctx->buffered, 0, SHA256_BLOCK_SIZE - ctx->buffered);
+        sha256_blocks(ctx->state, ctx->buffer, 1);
+        ctx->buffered = 0;
+    }
+    memset(ctx->buffer + ctx->buffered, 0, SHA256_BLOCK_SIZE - 8 - ctx->buffered);
+    for (int i = 0; i < 8; i++) {
+        ctx->buffer[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bit_length >> (8 * i));
+    }
+    sha256_blocks(ctx->state, ctx->buffer, 1);
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = (uint8_t)(ctx->state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+    sha256_wipe(ctx, sizeof(sha256_context));
+}
+
+void sha256(const uint8_t *data, size_t length, uint8_t digest[SHA256_DIGEST_SIZE]) {
+    sha256_context ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, length);
+    sha256_final(&ctx, digest);
+}
@@ -0,0 +1,44 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef sha256_h
+#define sha256_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SHA256_BLOCK_SIZE 64
+#define SHA256_DIGEST_SIZE 32
+
+/// Streaming SHA-256. Uses the ARMv8 SHA2 instructions or x86 SHA extensions
+/// when available, with a portable fallback.
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;                    // total bytes hashed so far
+    uint8_t buffer[SHA256_BLOCK_SIZE];  // incomplete block
+    size_t buffered;
+} sha256_context;
+
+void sha256_init(sha256_context *ctx);
+void sha256_update(sha256_context *ctx, const uint8_t *data, size_t length);
+
+/// Writes the digest and wipes the context.
+void sha256_final(sha256_context *ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/// One-shot digest of the buffer.
+void sha256(const uint8_t *data, size_t length, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* sha256_h */
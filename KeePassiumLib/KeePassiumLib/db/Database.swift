@@ -15,6 +15,9 @@ public class Database: Eraseable, AttachmentMaking {
 
     internal var compositeKey = CompositeKey.empty
 
+    private var searchIndex: SearchIndex?
+    private var autoFillIndex: AutoFillCandidateIndex?
+
     public func initProgress() -> ProgressEx {
         progress = ProgressEx()
         return progress
@@ -36,6 +39,8 @@ public class Database: Eraseable, AttachmentMaking {
     }
 
     public func erase() {
+        searchIndex = nil
+        autoFillIndex = nil
         root?.erase()
         root = nil
         compositeKey.erase()
@@ -49,7 +54,6 @@ public class Database: Eraseable, AttachmentMaking {
         dbFileName: String,
         dbFileData: ByteArray,
         compositeKey: CompositeKey,
-        useStreams: Bool,
         warnings: DatabaseLoadingWarnings
     ) throws {
         fatalError("Pure virtual method")
@@ -92,10 +96,33 @@ public class Database: Eraseable, AttachmentMaking {
     public func search(query: SearchQuery, foundEntries: inout [Entry], foundGroups: inout [Group]) -> Int {
         foundEntries.removeAll()
         foundGroups.removeAll()
-        root?.filter(query: query, foundEntries: &foundEntries, foundGroups: &foundGroups)
+        guard let root else {
+            return 0
+        }
+        if searchIndex == nil || searchIndex?.isFragmented == true {
+            searchIndex = SearchIndex(root: root)
+        }
+        let candidates = searchIndex?.candidates(for: query)
+        root.filter(query: query, candidates: candidates, foundEntries: &foundEntries, foundGroups: &foundGroups)
         return foundEntries.count + foundGroups.count
     }
 
+    /// Makes the next search take into account changes in the entry's content.
+    internal func markForReindexing(_ entry: Entry) {
+        searchIndex?.markChanged(entry)
+        autoFillIndex = nil
+    }
+
+    internal func getAutoFillIndex() -> AutoFillCandidateIndex? {
+        guard let root else {
+            return nil
+        }
+        if autoFillIndex == nil {
+            autoFillIndex = AutoFillCandidateIndex(root: root)
+        }
+        return autoFillIndex
+    }
+
     public func delete(group: Group) {
         fatalError("Pure virtual method")
     }
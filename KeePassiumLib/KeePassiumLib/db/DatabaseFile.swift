@@ -11,7 +11,6 @@ public class DatabaseFile: Eraseable {
     public enum StatusFlag {
         case readOnly
         case localFallback
-        case useStreams
     }
     public typealias Status = Set<StatusFlag>
 
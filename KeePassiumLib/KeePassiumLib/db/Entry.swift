@@ -230,8 +230,10 @@ public class Entry: DatabaseItem, Eraseable {
             break
         case .modified:
             lastModificationTime = Date.now
+            database?.markForReindexing(self)
         case let .modifiedAt(date):
             lastModificationTime = date
+            database?.markForReindexing(self)
         }
         if updateParents {
             parent?.touch(mode, updateParents: true)
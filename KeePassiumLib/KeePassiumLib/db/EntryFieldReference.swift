@@ -124,6 +124,11 @@ public class EntryFieldReference {
     }
 
 
+    /// Quick check whether the value might contain references or placeholders to resolve.
+    internal static func mayContainReferences(_ string: String) -> Bool {
+        return string.contains(referencePrefix) || string.contains(customFieldPlaceholderPrefix)
+    }
+
     private static func parseAll(_ string: String, referrerUUID: UUID) -> [EntryFieldReference] {
         let placeholders = parsePlaceholders(string, referrerUUID: referrerUUID)
         let references = parseReferences(string)
@@ -159,6 +159,7 @@ public class Group: DatabaseItem, Eraseable {
         entry.isDeleted = self.isDeleted
         entries.append(entry)
         isChildrenModified = true
+        database?.markForReindexing(entry)
     }
 
     public func remove(entry: Entry) {
@@ -168,6 +169,7 @@ public class Group: DatabaseItem, Eraseable {
         entries.remove(entry)
         entry.parent = nil
         isChildrenModified = true
+        database?.markForReindexing(entry)
     }
 
     override public func move(to newGroup: Group) {
@@ -261,6 +263,17 @@ public class Group: DatabaseItem, Eraseable {
     }
 
     public func filter(query: SearchQuery, foundEntries: inout [Entry], foundGroups: inout [Group]) {
+        filter(query: query, candidates: nil, foundEntries: &foundEntries, foundGroups: &foundGroups)
+    }
+
+    /// - Parameter candidates: entries that may match the query (as given by `SearchIndex`),
+    ///     or `nil` to check all the entries.
+    internal func filter(
+        query: SearchQuery,
+        candidates: Set<ObjectIdentifier>?,
+        foundEntries: inout [Entry],
+        foundGroups: inout [Group]
+    ) {
         guard !isDeleted else {
             return
         }
@@ -276,7 +289,12 @@ public class Group: DatabaseItem, Eraseable {
             } else if !isRoot && matches(query: query, scope: .fields) {
                 findAllEntries(deep: false, to: &foundEntries)
                 groups.forEach { subgroup in
-                    subgroup.filter(query: query, foundEntries: &foundEntries, foundGroups: &foundGroups)
+                    subgroup.filter(
+                        query: query,
+                        candidates: candidates,
+                        foundEntries: &foundEntries,
+                        foundGroups: &foundGroups
+                    )
                 }
                 return
             } else {
@@ -290,12 +308,19 @@ public class Group: DatabaseItem, Eraseable {
         }
 
         entries.forEach { entry in
-            if entry.matches(query: query, scope: .any) {
+            if candidates?.contains(ObjectIdentifier(entry)) ?? true,
+               entry.matches(query: query, scope: .any)
+            {
                 foundEntries.append(entry)
             }
         }
         groups.forEach { subgroup in
-            subgroup.filter(query: query, foundEntries: &foundEntries, foundGroups: &foundGroups)
+            subgroup.filter(
+                query: query,
+                candidates: candidates,
+                foundEntries: &foundEntries,
+                foundGroups: &foundGroups
+            )
         }
     }
 
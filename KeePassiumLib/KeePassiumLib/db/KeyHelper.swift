@@ -49,6 +49,52 @@ public class KeyHelper {
         return keyFileData.sha256
     }
 
+    /// Reduces the key file to its 32-byte key natively, mapping the file instead of loading it.
+    /// XML key files are loaded as is, since their handling depends on the database format.
+    /// The result can replace the original contents: `processKeyFile(keyFileData:)` keeps it unchanged.
+    public static func preprocessKeyFile(at fileURL: URL) throws -> SecureBytes {
+        assert(fileURL.isFileURL)
+        var key = [UInt8](repeating: 0, count: Int(KEYFILE_KEY_SIZE))
+        defer {
+            key.erase()
+        }
+        var kind = KEYFILE_KIND_EMPTY
+        let status = keyfile_process_file(fileURL.path, &key, &kind)
+        guard status == KEYFILE_OK else {
+            throw POSIXError(keyfileStatus: status)
+        }
+        switch kind {
+        case KEYFILE_KIND_EMPTY:
+            return SecureBytes.empty()
+        case KEYFILE_KIND_XML:
+            Diag.debug("Key file might be XML, loading it")
+            return SecureBytes.from(try ByteArray(contentsOf: fileURL, options: [.uncached, .mappedIfSafe]))
+        default:
+            Diag.debug("Key file processed natively [kind: \(kind.rawValue)]")
+            return SecureBytes.from(key)
+        }
+    }
+
+    /// Same as `preprocessKeyFile(at:)`, for key file contents already in memory.
+    public static func preprocessKeyFile(data: ByteArray) -> SecureBytes {
+        var key = [UInt8](repeating: 0, count: Int(KEYFILE_KEY_SIZE))
+        defer {
+            key.erase()
+        }
+        var kind = KEYFILE_KIND_EMPTY
+        data.withBytes { bytes in
+            keyfile_process_buffer(bytes, bytes.count, &key, &kind)
+        }
+        switch kind {
+        case KEYFILE_KIND_EMPTY:
+            return SecureBytes.empty()
+        case KEYFILE_KIND_XML:
+            return SecureBytes.from(data)
+        default:
+            return SecureBytes.from(key)
+        }
+    }
+
     public static func generateKeyFileData() throws -> ByteArray {
         do {
             return try CryptoManager.getRandomBytes(count: keyFileKeyLength)
@@ -14,67 +14,71 @@ final class AESDataCipher: DataCipher {
     var uuid: UUID { return _uuid }
     var name: String { return "AES" }
 
-    var initialVectorSize: Int { return kCCBlockSizeAES128 }
-    var keySize: Int { return kCCKeySizeAES256 }
+    var initialVectorSize: Int { return Int(AES_CBC_BLOCK_SIZE) }
+    var keySize: Int { return Int(AES_CBC_KEY_SIZE) }
 
     internal var progress = ProgressEx()
 
     init() {
     }
 
+    private static let progressCallback: aes_cbc_progress_fptr = { bytesDone, progressPtr in
+        guard let progressPtr else {
+            return 0 /* continue */
+        }
+        let progress = Unmanaged<ProgressEx>.fromOpaque(progressPtr).takeUnretainedValue()
+        progress.completedUnitCount = Int64(bytesDone)
+        return progress.isCancelled ? 1 : 0
+    }
+
     func encrypt(plainText data: ByteArray, key: SecureBytes, iv: SecureBytes) throws -> ByteArray {
-        assert(key.count == kCCKeySizeAES256)
-        assert(iv.count == kCCBlockSizeAES128)
+        assert(key.count == keySize)
+        assert(iv.count == initialVectorSize)
         progress.localizedDescription = NSLocalizedString(
             "[Cipher/Progress] Encrypting",
             bundle: Bundle.framework,
             value: "Encrypting",
             comment: "Progress status")
 
-        let operation: CCOperation = UInt32(kCCEncrypt)
-        let algoritm: CCAlgorithm = UInt32(kCCAlgorithmAES)
-        let options: CCOptions = UInt32(kCCOptionPKCS7Padding)
-
         progress.completedUnitCount = 0
         progress.totalUnitCount = Int64(data.count)
-        let out = ByteArray(count: data.count + kCCBlockSizeAES128)
-        var numBytesEncrypted: size_t = 0
+        let out = ByteArray(count: data.count + initialVectorSize)
+        var numBytesEncrypted = 0
+        var stats = crypto_stats()
+        let progressPtr = UnsafeRawPointer(Unmanaged.passUnretained(progress).toOpaque())
         let status = data.withBytes { dataBytes in
             return key.withDecryptedBytes { keyBytes in
                 return iv.withDecryptedBytes { ivBytes in
                     return out.withMutableBytes { (outBytes: inout [UInt8]) in
-                        return CCCrypt(
-                            operation, algoritm, options,
-                            keyBytes, keyBytes.count,
-                            ivBytes,
+                        return aes_cbc_encrypt(
+                            keyBytes, ivBytes,
                             dataBytes, dataBytes.count,
-                            &outBytes, outBytes.count,
-                            &numBytesEncrypted
+                            &outBytes, outBytes.count, &numBytesEncrypted,
+                            AESDataCipher.progressCallback, progressPtr,
+                            &stats
                         )
                     }
                 }
             }
         }
         progress.completedUnitCount = Int64(data.count)
-        if progress.isCancelled {
+        if progress.isCancelled || status == AES_CBC_INTERRUPTED {
             throw ProgressInterruption.cancelled(reason: progress.cancellationReason)
         }
-
-        #if DEBUG
-        debugPrint("encrypted size: \(numBytesEncrypted) bytes")
-        #endif
-
-        guard status == UInt32(kCCSuccess) else {
+        guard status == AES_CBC_OK else {
+            Diag.error("AES encryption failed [status: \(status)]")
             throw CryptoError.aesEncryptError(code: Int(status))
         }
+        Diag.debug("AES encryption done [\(CryptoInstrumentation.describe(stats))]")
         out.trim(toCount: numBytesEncrypted)
         return out
     }
 
+    /// Large inputs are decrypted on several threads, see `aes_cbc_decrypt()`.
     func decrypt(cipherText encData: ByteArray, key: SecureBytes, iv: SecureBytes) throws -> ByteArray {
-        assert(key.count == kCCKeySizeAES256)
-        assert(iv.count == kCCBlockSizeAES128)
-        assert(encData.count % kCCBlockSizeAES128 == 0)
+        assert(key.count == keySize)
+        assert(iv.count == initialVectorSize)
+        assert(encData.count % initialVectorSize == 0)
 
         progress.localizedDescription = NSLocalizedString(
             "[Cipher/Progress] Decrypting",
@@ -82,42 +86,37 @@ final class AESDataCipher: DataCipher {
             value: "Decrypting",
             comment: "Progress status")
 
-        let operation: CCOperation = UInt32(kCCDecrypt)
-        let algoritm: CCAlgorithm = UInt32(kCCAlgorithmAES)
-        let options: CCOptions = UInt32(kCCOptionPKCS7Padding)
-
         progress.completedUnitCount = 0
         progress.totalUnitCount = Int64(encData.count)
-        var numBytesDecrypted: size_t = 0
+        var numBytesDecrypted = 0
+        var stats = crypto_stats()
+        let progressPtr = UnsafeRawPointer(Unmanaged.passUnretained(progress).toOpaque())
         let out = ByteArray(count: encData.count)
         let status = encData.withBytes { encDataBytes in
             return key.withDecryptedBytes { keyBytes in
                 return iv.withDecryptedBytes { ivBytes in
                     return out.withMutableBytes { (outBytes: inout [UInt8]) in
-                        return CCCrypt(
-                            operation, algoritm, options,
-                            keyBytes, keyBytes.count,
-                            ivBytes,
+                        return aes_cbc_decrypt(
+                            keyBytes, ivBytes,
                             encDataBytes, encDataBytes.count,
-                            &outBytes, outBytes.count,
-                            &numBytesDecrypted
+                            &outBytes, outBytes.count, &numBytesDecrypted,
+                            0, /* threads: one per core */
+                            AESDataCipher.progressCallback, progressPtr,
+                            &stats
                         )
                     }
                 }
             }
         }
         progress.completedUnitCount = Int64(encData.count)
-        if progress.isCancelled {
+        if progress.isCancelled || status == AES_CBC_INTERRUPTED {
             throw ProgressInterruption.cancelled(reason: progress.cancellationReason)
         }
-
-        #if DEBUG
-        print("decrypted \(numBytesDecrypted) bytes")
-        #endif
-
-        guard status == UInt32(kCCSuccess) else {
+        guard status == AES_CBC_OK else {
+            Diag.error("AES decryption failed [status: \(status)]")
             throw CryptoError.aesDecryptError(code: Int(status))
         }
+        Diag.debug("AES decryption done [\(CryptoInstrumentation.describe(stats))]")
         out.trim(toCount: numBytesDecrypted)
         return out
     }
@@ -98,6 +98,7 @@ class AESKDF: KeyDerivationFunction {
         progress.totalUnitCount = Int64(transformRounds)
 
         var transformedKey = SecureBytes.empty()
+        var stats = crypto_stats()
         let status = transformSeed.withBytes { trSeedBytes  in
             return compositeKey.withDecryptedMutableBytes { (trKeyBytes: inout [UInt8]) -> Int32 in
 
@@ -120,7 +121,8 @@ class AESKDF: KeyDerivationFunction {
                         let isShouldStop: Int32 = progress.isCancelled ? 1 : 0
                         return isShouldStop
                     },
-                    progressPtr)
+                    progressPtr,
+                    &stats)
                 // swiftlint:enable opening_brace closure_parameter_position
                 let transformedKeyBytes = CryptoManager.sha256(of: trKeyBytes)
                 transformedKey = SecureBytes.from(transformedKeyBytes)
@@ -136,6 +138,7 @@ class AESKDF: KeyDerivationFunction {
             Diag.error("doRounds() crypto error [code: \(status)]")
             throw CryptoError.aesEncryptError(code: Int(status))
         }
+        Diag.debug("AES-KDF done [\(CryptoInstrumentation.describe(stats))]")
         return transformedKey
     }
 }
@@ -32,6 +32,9 @@ class AbstractArgon2KDF {
     static let defaultMemory: UInt64      = 8 * 1024 * 1024
     static let defaultParallelism: UInt32 = 4
 
+    /// Memory to leave for the rest of an app extension while Argon2 runs.
+    private static let extensionMemoryReserve = 8 * 1024 * 1024
+
     fileprivate var name: String {
         fatalError("Abstract method, override this")
     }
@@ -72,9 +75,29 @@ class AbstractArgon2KDF {
             assertionFailure("Memory parameter missing or has a wrong type")
             return 0
         }
+        if let hashingParams = try? getParams(kdfParams),
+           let footprint = Argon2.estimatePeakMemoryFootprint(
+               params: hashingParams,
+               limits: Self.makeLimits(enforceBudget: false))
+        {
+            return footprint
+        }
         return Int(value)
     }
 
+    /// App extensions have a hard memory limit, so there Argon2 uses few workers with small stacks,
+    /// and fails right away if it would not fit in the remaining memory.
+    private static func makeLimits(enforceBudget: Bool) -> Argon2.Limits {
+        guard AppGroup.isAppExtension else {
+            return .none
+        }
+        guard enforceBudget else {
+            return .constrained(memoryBudget: nil)
+        }
+        let memoryBudget = MemoryMonitor.estimateAutoFillMemoryRemaining() - extensionMemoryReserve
+        return .constrained(memoryBudget: memoryBudget)
+    }
+
     func apply(_ settings: EncryptionSettings, to kdfParams: inout KDFParams) {
         assert(settings.iterations != nil, "Iterations parameter must be defined")
         let iterations = settings.iterations ?? Self.defaultIterations
@@ -170,6 +193,7 @@ class AbstractArgon2KDF {
             data: key,
             params: hashingParams,
             type: primitiveType,
+            limits: Self.makeLimits(enforceBudget: true),
             progress: progress)
         return outHash
     }
@@ -0,0 +1,97 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+/// In-process cache of KDF results, so that reloading a database whose KDF salt and parameters
+/// have not changed (after a sync, a save or a file change) does not run the KDF again.
+/// Only used when final keys may be remembered; entries expire with the database lock timeout
+/// (but live no longer than `maxTimeToLive`) and are wiped whenever master keys are erased.
+public enum KeyDerivationCache {
+    private static let maxTimeToLive = 10 * 60
+
+    private static var timeToLive: UInt32 {
+        let settings = Settings.current
+        guard settings.isRememberDatabaseFinalKey else {
+            return 0
+        }
+        let lockTimeout = settings.databaseLockTimeout
+        switch lockTimeout {
+        case .never:
+            return UInt32(maxTimeToLive)
+        default:
+            return UInt32(max(0, min(lockTimeout.seconds, maxTimeToLive)))
+        }
+    }
+
+    /// Returns the cached result of `kdf.transform(key:params:)`, or runs the KDF and caches its result.
+    static func transform(
+        key: SecureBytes,
+        kdf: KeyDerivationFunction,
+        params: KDFParams,
+        progress: ProgressEx
+    ) throws -> SecureBytes {
+        let ttl = timeToLive
+        guard ttl > 0, let paramsData = params.data else {
+            return try kdf.transform(key: key, params: params)
+        }
+        if let cachedKey = lookup(key: key, paramsData: paramsData) {
+            Diag.debug("Using cached KDF result")
+            progress.totalUnitCount = 1
+            progress.completedUnitCount = 1
+            return cachedKey
+        }
+        let transformedKey = try kdf.transform(key: key, params: params)
+        store(transformedKey, key: key, paramsData: paramsData, ttl: ttl)
+        return transformedKey
+    }
+
+    /// Wipes all cached results.
+    public static func removeAll() {
+        kdfcache_clear()
+        Diag.debug("KDF cache cleared")
+    }
+
+    private static func lookup(key: SecureBytes, paramsData: ByteArray) -> SecureBytes? {
+        var outBytes = [UInt8](repeating: 0, count: SHA256_SIZE)
+        defer {
+            outBytes.erase()
+        }
+        let status = key.withDecryptedBytes { keyBytes in
+            paramsData.withBytes { paramsBytes in
+                kdfcache_lookup(
+                    keyBytes, keyBytes.count,
+                    paramsBytes, paramsBytes.count,
+                    &outBytes, outBytes.count
+                )
+            }
+        }
+        guard status == KDFCACHE_OK else {
+            return nil
+        }
+        return SecureBytes.from(outBytes)
+    }
+
+    private static func store(_ transformedKey: SecureBytes, key: SecureBytes, paramsData: ByteArray, ttl: UInt32) {
+        let status = key.withDecryptedBytes { keyBytes in
+            paramsData.withBytes { paramsBytes in
+                transformedKey.withDecryptedBytes { transformedBytes in
+                    kdfcache_store(
+                        keyBytes, keyBytes.count,
+                        paramsBytes, paramsBytes.count,
+                        transformedBytes, transformedBytes.count,
+                        ttl
+                    )
+                }
+            }
+        }
+        if status != KDFCACHE_OK {
+            Diag.warning("Failed to cache KDF result [status: \(status)]")
+        }
+    }
+}
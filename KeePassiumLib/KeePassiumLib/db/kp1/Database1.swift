@@ -149,7 +149,6 @@ public class Database1: Database {
         dbFileName: String,
         dbFileData: ByteArray,
         compositeKey: CompositeKey,
-        useStreams: Bool,
         warnings: DatabaseLoadingWarnings
     ) throws {
         Diag.info("Loading KP1 database")
@@ -165,10 +164,6 @@ public class Database1: Database {
             let dbWithoutHeader = dbFileData.suffix(from: header.count)
             let decryptedData = try decrypt(data: dbWithoutHeader)
             Diag.debug("Decryption OK")
-            guard decryptedData.sha256 == header.contentHash else {
-                Diag.error("Header hash mismatch - invalid master key?")
-                throw DatabaseError.invalidKey
-            }
 
             try loadContent(data: decryptedData, dbFileName: dbFileName)
             Diag.debug("Content loaded OK")
@@ -243,45 +238,83 @@ public class Database1: Database {
     }
 
     private func loadContent(data: ByteArray, dbFileName: String) throws {
-        let stream = data.asInputStream()
-        stream.open()
-        defer { stream.close() }
-
         let loadProgress = ProgressEx()
         loadProgress.totalUnitCount = Int64(header.groupCount + header.entryCount)
         loadProgress.localizedDescription = LString.Progress.database1ParsingContent
         self.progress.addChild(loadProgress, withPendingUnitCount: ProgressSteps.parsing)
 
-        Diag.debug("Loading groups")
+        guard header.groupCount + header.entryCount <= data.count / Int(KDB_MIN_RECORD_SIZE) else {
+            Diag.error("Header declares more records than the content can hold")
+            throw FormatError.prematureDataEnd
+        }
+
         var groups = ContiguousArray<Group1>()
         var groupByID = [Group1ID: Group1]() 
         var maxLevel = 0                      
-        for _ in 0..<header.groupCount {
-            loadProgress.completedUnitCount += 1
-            let group = Group1(database: self)
-            try group.load(from: stream) 
-            if group.isDeleted {
-                backupGroup = group
-            }
-            if group.level > maxLevel {
-                maxLevel = Int(group.level)
-            }
-            groupByID[group.id] = group
-            groups.append(group)
-        }
-
-        Diag.debug("Loading entries")
         var entries = ContiguousArray<Entry1>()
-        for _ in 0..<header.entryCount {
-            let entry = Entry1(database: self)
-            try entry.load(from: stream) 
-            entries.append(entry)
-            loadProgress.completedUnitCount += 1
-            if loadProgress.isCancelled {
-                throw ProgressInterruption.cancelled(reason: loadProgress.cancellationReason)
+        try data.withBytes { bytes in
+            try bytes.withUnsafeBufferPointer { buffer in
+                Diag.debug("Parsing content")
+                let groupCount = header.groupCount
+                let entryCount = header.entryCount
+                var groupRecords = [kdb_group](repeating: kdb_group(), count: groupCount)
+                var entryRecords = [kdb_entry](repeating: kdb_entry(), count: entryCount)
+                let result = header.contentHash.withBytes { contentHash in
+                    kdb_parse_content(
+                        buffer.baseAddress, buffer.count,
+                        contentHash,
+                        &groupRecords, groupCount,
+                        &entryRecords, entryCount)
+                }
+                switch kdb_parser_status(rawValue: result.status) {
+                case KDB_PARSER_OK:
+                    break
+                case KDB_PARSER_ERROR_HASH_MISMATCH:
+                    Diag.error("Header hash mismatch - invalid master key?")
+                    throw DatabaseError.invalidKey
+                case KDB_PARSER_ERROR_CORRUPTED_FIELD:
+                    let fieldName = result.field_name.map { String(cString: $0) }
+                    Diag.error("Corrupted field [name: \(fieldName ?? "?"), offset: \(result.offset)]")
+                    throw FormatError.corruptedField(fieldName: fieldName)
+                default:
+                    Diag.error("Failed to parse content [status: \(result.status), offset: \(result.offset)]")
+                    throw FormatError.prematureDataEnd
+                }
+
+                Diag.debug("Loading groups")
+                groups.reserveCapacity(groupRecords.count)
+                for record in groupRecords {
+                    loadProgress.completedUnitCount += 1
+                    let group = Group1(database: self)
+                    try group.load(from: record) 
+                    if group.isDeleted {
+                        backupGroup = group
+                    }
+                    if group.level > maxLevel {
+                        maxLevel = Int(group.level)
+                    }
+                    groupByID[group.id] = group
+                    groups.append(group)
+                }
+
+                Diag.debug("Loading entries")
+                entries.reserveCapacity(entryRecords.count)
+                for record in entryRecords {
+                    let entry = Entry1(database: self)
+                    try entry.load(from: record) 
+                    if record.is_meta_stream != 0 {
+                        metaStreamEntries.append(entry)
+                    } else {
+                        entries.append(entry)
+                    }
+                    loadProgress.completedUnitCount += 1
+                    if loadProgress.isCancelled {
+                        throw ProgressInterruption.cancelled(reason: loadProgress.cancellationReason)
+                    }
+                }
             }
         }
-        Diag.info("Loaded \(groups.count) groups and \(entries.count) entries")
+        Diag.info("Loaded \(groups.count) groups and \(entries.count)+\(metaStreamEntries.count) entries")
 
         let _root = Group1(database: self)
         _root.level = -1 
@@ -303,10 +336,6 @@ public class Database1: Database {
 
         Diag.debug("Moving entries to their groups")
         for entry in entries {
-            if entry.isMetaStream {
-                metaStreamEntries.append(entry)
-                continue
-            }
             let targetGroup: Group
             if let group = groupByID[entry.groupID] {
                 targetGroup = group
@@ -507,3 +536,28 @@ public class Database1: Database {
         return Attachment(name: name, isCompressed: false, data: data)
     }
 }
+
+extension kdb_slice {
+    var isPresent: Bool { return bytes != nil }
+
+    /// Decodes the slice as UTF-8; nil if the bytes are not valid UTF-8.
+    func toString() -> String? {
+        return String(bytes: UnsafeBufferPointer(start: bytes, count: length), encoding: .utf8)
+    }
+
+    func toByteArray() -> ByteArray {
+        return ByteArray(bytes: [UInt8](UnsafeBufferPointer(start: bytes, count: length)))
+    }
+}
+
+extension kdb_group {
+    func has(_ field: Int) -> Bool {
+        return fields & UInt32(field) != 0
+    }
+}
+
+extension kdb_entry {
+    func has(_ field: Int) -> Bool {
+        return fields & UInt32(field) != 0
+    }
+}
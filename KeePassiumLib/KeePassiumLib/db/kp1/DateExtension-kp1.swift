@@ -41,6 +41,19 @@ extension Date {
         self = date
     }
 
+    /// Converts a timestamp decoded by `kdb_parse_content`: local date and time,
+    /// as seconds since 1970-01-01 00:00:00 without time zone adjustment.
+    init(kp1LocalSeconds seconds: Int64) {
+        guard seconds != KDB_TIME_NEVER else {
+            self = Date.kp1Never
+            return
+        }
+        let wallClock = Date(timeIntervalSince1970: TimeInterval(seconds))
+        let timeZone = TimeZone.current
+        let estimate = wallClock.addingTimeInterval(-TimeInterval(timeZone.secondsFromGMT(for: wallClock)))
+        self = wallClock.addingTimeInterval(-TimeInterval(timeZone.secondsFromGMT(for: estimate)))
+    }
+
     func asKP1Bytes() -> ByteArray {
         let cal = Calendar(identifier: .iso8601)
         let dc = cal.dateComponents([.year, .month, .day, .hour, .minute, .second], from: self)
@@ -28,15 +28,6 @@ public class Entry1: Entry {
         case end               = 0xFFFF
     }
 
-    private enum MetaStreamID {
-        public static let iconID   = IconID.withZeroID
-        public static let title    = "Meta-Info"
-        public static let userName = "SYSTEM"
-        public static let url      = "$"
-        public static let attName  = "bin-stream"
-    }
-
-
     override public var isSupportsMultipleAttachments: Bool { return false }
 
     override public var canExpire: Bool {
@@ -56,17 +47,6 @@ public class Entry1: Entry {
 
     override public var isSupportsExtraFields: Bool { return false }
 
-    var isMetaStream: Bool {
-        guard let att = getAttachment() else { return false }
-        if rawNotes.isEmpty { return false }
-
-        return (iconID == MetaStreamID.iconID) &&
-            (att.name == MetaStreamID.attName) &&
-            (rawUserName == MetaStreamID.userName) &&
-            (rawURL == MetaStreamID.url) &&
-            (rawTitle == MetaStreamID.title)
-    }
-
     override init(database: Database?, creationDate: Date = Date()) {
         groupID = 0
         super.init(database: database, creationDate: creationDate)
@@ -101,160 +81,64 @@ public class Entry1: Entry {
         }
     }
 
-    func load(from stream: ByteArray.InputStream) throws {
+    func load(from record: kdb_entry) throws {
         Diag.verbose("Loading entry")
         erase()
 
-        var binaryDesc = ""
-        var binaryData = ByteArray()
-
-        while stream.hasBytesAvailable {
-            guard let fieldIDraw = stream.readUInt16() else {
-                throw Database1.FormatError.prematureDataEnd
+        func loadString(_ slice: kdb_slice, fieldName: String) throws -> String? {
+            guard slice.isPresent else { return nil }
+            guard let string = slice.toString() else {
+                throw Database1.FormatError.corruptedField(fieldName: fieldName)
             }
-            guard let fieldID = FieldID(rawValue: fieldIDraw) else {
-                throw Database1.FormatError.corruptedField(fieldName: "Entry/FieldID")
-            }
-            guard let _fieldSize = stream.readInt32() else {
-                throw Database1.FormatError.prematureDataEnd
-            }
-            guard _fieldSize >= 0 else {
-                throw Database1.FormatError.corruptedField(fieldName: "Entry/FieldSize")
-            }
-
-            let fieldSize = Int(_fieldSize)
-
-            switch fieldID {
-            case .reserved:
-                guard let _ = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-            case .uuid:
-                guard let uuid = UUID(data: stream.read(count: fieldSize)) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                self.uuid = uuid
-            case .groupID:
-                guard let groupID: Group1ID = stream.readInt32() else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                self.groupID = groupID
-            case .iconID:
-                guard let iconIDraw = stream.readUInt32() else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let iconID = IconID(rawValue: iconIDraw) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/IconID")
-                }
-                self.iconID = iconID
-            case .title:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/Title")
-                }
-                setField(name: EntryField.title, value: string)
-            case .url:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/URL")
-                }
-                setField(name: EntryField.url, value: string)
-            case .username:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/UserName")
-                }
-                setField(name: EntryField.userName, value: string)
-            case .password:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/Password")
-                }
-                setField(name: EntryField.password, value: string)
-            case .notes:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/Notes")
-                }
-                setField(name: EntryField.notes, value: string)
-            case .creationTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/CreationTime")
-                }
-                self.creationTime = date
-            case .lastModifiedTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/LastModifiedTime")
-                }
-                self.lastModificationTime = date
-            case .lastAccessTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/LastAccessTime")
-                }
-                self.lastAccessTime = date
-            case .expirationTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/ExpirationTime")
-                }
-                self.expiryTime = date
-            case .binaryDesc:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Entry/BinaryDesc")
-                }
-                binaryDesc = string
-            case .binaryData:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                binaryData = data
-            case .end:
-                guard let _ = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                if binaryDesc.isNotEmpty {
-                    let att = Attachment(
-                        name: binaryDesc,
-                        isCompressed: false,
-                        data: binaryData)
-                    attachments.append(att)
-                }
-                return
-            } 
-        } 
+            return string
+        }
 
-        Diag.warning("Entry data missing the .end field")
-        throw Database1.FormatError.prematureDataEnd
+        if record.has(KDB_FIELD_UUID) {
+            self.uuid = UUID(uuid: record.uuid)
+        }
+        if record.has(KDB_FIELD_GROUP_ID) {
+            self.groupID = record.group_id
+        }
+        if record.has(KDB_FIELD_ICON_ID) {
+            guard let iconID = IconID(rawValue: record.icon_id) else {
+                throw Database1.FormatError.corruptedField(fieldName: "Entry/IconID")
+            }
+            self.iconID = iconID
+        }
+        if let title = try loadString(record.title, fieldName: "Entry/Title") {
+            setField(name: EntryField.title, value: title)
+        }
+        if let url = try loadString(record.url, fieldName: "Entry/URL") {
+            setField(name: EntryField.url, value: url)
+        }
+        if let userName = try loadString(record.username, fieldName: "Entry/UserName") {
+            setField(name: EntryField.userName, value: userName)
+        }
+        if let password = try loadString(record.password, fieldName: "Entry/Password") {
+            setField(name: EntryField.password, value: password)
+        }
+        if let notes = try loadString(record.notes, fieldName: "Entry/Notes") {
+            setField(name: EntryField.notes, value: notes)
+        }
+        if record.has(KDB_FIELD_CREATION_TIME) {
+            self.creationTime = Date(kp1LocalSeconds: record.creation_time)
+        }
+        if record.has(KDB_FIELD_LAST_MODIFICATION_TIME) {
+            self.lastModificationTime = Date(kp1LocalSeconds: record.last_modification_time)
+        }
+        if record.has(KDB_FIELD_LAST_ACCESS_TIME) {
+            self.lastAccessTime = Date(kp1LocalSeconds: record.last_access_time)
+        }
+        if record.has(KDB_FIELD_EXPIRY_TIME) {
+            self.expiryTime = Date(kp1LocalSeconds: record.expiry_time)
+        }
+        if let binaryDesc = try loadString(record.binary_desc, fieldName: "Entry/BinaryDesc"),
+           binaryDesc.isNotEmpty
+        {
+            let att = Attachment(name: binaryDesc, isCompressed: false, data: ByteArray())
+            att.data = record.binary_data.toByteArray()
+            attachments.append(att)
+        }
     }
 
     func write(to stream: ByteArray.OutputStream) {
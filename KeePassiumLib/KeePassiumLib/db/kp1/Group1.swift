@@ -156,103 +156,46 @@ public class Group1: Group {
         return newGroup
     }
 
-    func load(from stream: ByteArray.InputStream) throws {
+    func load(from record: kdb_group) throws {
         Diag.verbose("Loading group")
         erase()
 
-        while stream.hasBytesAvailable {
-            guard let fieldIDraw = stream.readUInt16() else {
-                throw Database1.FormatError.prematureDataEnd
-            }
-            guard let fieldID = FieldID(rawValue: fieldIDraw) else {
-                throw Database1.FormatError.corruptedField(fieldName: "Group/FieldID")
-            }
-            guard let _fieldSize = stream.readInt32() else {
-                throw Database1.FormatError.prematureDataEnd
+        if record.has(KDB_FIELD_GROUP_ID) {
+            self.id = record.group_id
+        }
+        if record.name.isPresent {
+            guard let string = record.name.toString() else {
+                throw Database1.FormatError.corruptedField(fieldName: "Group/Name")
             }
-            guard _fieldSize >= 0 else {
-                throw Database1.FormatError.corruptedField(fieldName: "Group/FieldSize")
+            self.name = string
+        }
+        if record.has(KDB_FIELD_CREATION_TIME) {
+            self.creationTime = Date(kp1LocalSeconds: record.creation_time)
+        }
+        if record.has(KDB_FIELD_LAST_MODIFICATION_TIME) {
+            self.lastModificationTime = Date(kp1LocalSeconds: record.last_modification_time)
+        }
+        if record.has(KDB_FIELD_LAST_ACCESS_TIME) {
+            self.lastAccessTime = Date(kp1LocalSeconds: record.last_access_time)
+        }
+        if record.has(KDB_FIELD_EXPIRY_TIME) {
+            self.expiryTime = Date(kp1LocalSeconds: record.expiry_time)
+        }
+        if record.has(KDB_FIELD_ICON_ID) {
+            guard let _iconID = IconID(rawValue: record.icon_id) else {
+                throw Database1.FormatError.corruptedField(fieldName: "Group/IconID")
             }
-            let fieldSize = Int(_fieldSize)
-
-            switch fieldID {
-            case .reserved:
-                _ = stream.read(count: fieldSize) 
-            case .groupID:
-                guard let _groupID: Group1ID = stream.readInt32() else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                self.id = _groupID
-            case .name:
-                guard let data = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                data.trim(toCount: data.count - 1) 
-                guard let string = data.toString() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/Name")
-                }
-                self.name = string
-            case .creationTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/CreationTime")
-                }
-                self.creationTime = date
-            case .lastModifiedTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/LastModifiedTime")
-                }
-                self.lastModificationTime = date
-            case .lastAccessTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/LastAccessTime")
-                }
-                self.lastAccessTime = date
-            case .expirationTime:
-                guard let rawTimeData = stream.read(count: Date.kp1TimestampSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                guard let date = Date(kp1Bytes: rawTimeData) else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/ExpirationTime")
-                }
-                self.expiryTime = date
-            case .iconID:
-                guard let iconIDraw = stream.readUInt32(),
-                    let _iconID = IconID(rawValue: iconIDraw) else {
-                        throw Database1.FormatError.corruptedField(fieldName: "Group/IconID")
-                }
-                self.iconID = _iconID
-            case .groupLevel:
-                guard let _level = stream.readUInt16() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/Level")
-                }
-                self.level = Int16(_level)
-            case .groupFlags:
-                guard let _flags = stream.readInt32() else {
-                    throw Database1.FormatError.corruptedField(fieldName: "Group/Flags")
-                }
-                self.flags = _flags
-            case .end:
-                guard let _ = stream.read(count: fieldSize) else {
-                    throw Database1.FormatError.prematureDataEnd
-                }
-                if (level == 0) && (name == Group1.backupGroupName) { // TODO: also check for translated "Backup"
-                    self.isDeleted = true
-                }
-                return
-            } 
-        } 
-
-        Diag.warning("Group data missing the .end field")
-        throw Database1.FormatError.prematureDataEnd
+            self.iconID = _iconID
+        }
+        if record.has(KDB_FIELD_LEVEL) {
+            self.level = Int16(truncatingIfNeeded: record.level)
+        }
+        if record.has(KDB_FIELD_FLAGS) {
+            self.flags = record.flags
+        }
+        if (level == 0) && (name == Group1.backupGroupName) { // TODO: also check for translated "Backup"
+            self.isDeleted = true
+        }
     }
 
     func write(to stream: ByteArray.OutputStream) {
@@ -30,59 +30,6 @@ public class Attachment2: Attachment {
 }
 
 extension Attachment2 {
-    static func load(
-        xml: AEXMLElement,
-        database: Database2,
-        streamCipher: StreamCipher
-    ) throws -> Attachment2 {
-        assert(xml.name == Xml2.binary)
-
-        Diag.verbose("Loading XML: entry attachment")
-        var name: String?
-        var binary: Binary2?
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.key:
-                name = tag.value
-            case Xml2.value:
-                let refString = tag.attributes[Xml2.ref]
-                guard let binaryID = Int(refString) else {
-                    Diag.error("Cannot parse Entry/Binary/Value/Ref as Int")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: "Entry/Binary/Value/Ref",
-                        value: refString)
-                }
-
-                if let binaryInDatabasePool = database.binaries[binaryID] {
-                    binary = binaryInDatabasePool
-                } else {
-                    binary = Binary2(
-                        id: binaryID,
-                        data: ByteArray(),
-                        isCompressed: false,
-                        isProtected: false
-                    )
-                }
-            default:
-                Diag.error("Unexpected XML tag in Entry/Binary: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Entry/Binary/*")
-            }
-        }
-        let _name = name ?? ""
-        if _name.isEmpty {
-            Diag.error("Missing Entry/Binary/Name, ignoring")
-        }
-        guard let _binary = binary else {
-            Diag.error("Missing Entry/Binary/Value")
-            throw Xml2.ParsingError.malformedValue(tag: "Entry/Binary/Value/Ref", value: nil)
-        }
-        return Attachment2(
-            id: _binary.id,
-            name: _name,
-            isCompressed: _binary.isCompressed,
-            data: _binary.data)
-    }
-
     internal func toXml() -> AEXMLElement {
         Diag.verbose("Generating XML: entry attachment")
         let xmlAtt = AEXMLElement(name: Xml2.binary)
@@ -44,33 +44,6 @@ public class Binary2: Eraseable {
 
 extension Binary2 {
 
-    static func load(xml: AEXMLElement, streamCipher: StreamCipher) throws -> Binary2 {
-        assert(xml.name == Xml2.binary)
-        Diag.verbose("Loading XML: binary")
-
-        let idString = xml.attributes[Xml2.id]
-        guard let id = Int(idString) else {
-            Diag.error("Cannot parse Meta/Binary/ID as Int")
-            throw Xml2.ParsingError.malformedValue(tag: "Meta/Binary/ID", value: idString)
-        }
-        let isCompressedString = xml.attributes[Xml2.compressed]
-        let isProtectedString = xml.attributes[Xml2.protected]
-        let isCompressed: Bool = Bool(string: isCompressedString ?? "")
-        let isProtected: Bool = Bool(string: isProtectedString ?? "")
-        let base64 = xml.value ?? ""
-        guard var data = ByteArray(base64Encoded: base64) else {
-            Diag.error("Cannot parse Meta/Binary/Value as Base64 string")
-            throw Xml2.ParsingError.malformedValue(tag: "Meta/Binary/ValueBase64", value: String(base64.prefix(16)))
-        }
-
-        if isProtected {
-            Diag.verbose("Decrypting binary")
-            data = try streamCipher.decrypt(data: data, progress: nil) 
-        }
-
-        return Binary2(id: id, data: data, isCompressed: isCompressed, isProtected: isProtected)
-    }
-
     func toXml(streamCipher: StreamCipher) throws -> AEXMLElement {
         Diag.verbose("Generating XML: binary")
         var attributes = [
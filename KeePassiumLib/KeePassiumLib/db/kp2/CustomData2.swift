@@ -60,74 +60,6 @@ public class CustomData2: Eraseable {
 }
 
 extension CustomData2 {
-    func load(
-        xml: AEXMLElement,
-        streamCipher: StreamCipher,
-        timeParser: Database2.XMLTimeParser,
-        xmlParentName: String
-    ) throws {
-        assert(xml.name == Xml2.customData)
-        Diag.verbose("Loading XML: custom data")
-        erase()
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.item:
-                try loadItem(
-                    xml: tag,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    xmlParentName: xmlParentName
-                )
-                Diag.verbose("Item loaded OK")
-            default:
-                Diag.error("Unexpected XML tag in CustomData: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(
-                    actual: tag.name,
-                    expected: xmlParentName + "/CustomData/*")
-            }
-        }
-    }
-
-    private func loadItem(
-        xml: AEXMLElement,
-        streamCipher: StreamCipher,
-        timeParser: Database2.XMLTimeParser,
-        xmlParentName: String = "?"
-    ) throws {
-        assert(xml.name == Xml2.item)
-        var key: String?
-        var value: String?
-        var optionalTimestamp: Date? 
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.key:
-                key = tag.value ?? ""
-            case Xml2.value:
-                value = tag.value ?? ""
-            case Xml2.lastModificationTime:
-                optionalTimestamp = timeParser(tag.value)
-            default:
-                Diag.error("Unexpected XML tag in CustomData/Item: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(
-                    actual: tag.name,
-                    expected: xmlParentName + "/CustomData/Item/*")
-            }
-        }
-        guard let _key = key else {
-            Diag.error("Missing \(xmlParentName)/CustomData/Item/Key")
-            throw Xml2.ParsingError.malformedValue(
-                tag: xmlParentName + "/CustomData/Item/Key",
-                value: nil)
-        }
-        guard let _value = value else {
-            Diag.error("Missing \(xmlParentName)/CustomData/Item/Value")
-            throw Xml2.ParsingError.malformedValue(
-                tag: xmlParentName + "/CustomData/Item/Value",
-                value: nil)
-        }
-        dict[_key] = Item(value: _value, lastModificationTime: optionalTimestamp)
-    }
-
     func toXml(timeFormatter: Database2.XMLTimeFormatter) -> AEXMLElement {
         Diag.verbose("Generating XML: custom data")
         let xml = AEXMLElement(name: Xml2.customData)
@@ -12,13 +12,38 @@ public class CustomIcon2: Eraseable {
     public static let maxSidePixels = CGFloat(120)
 
     public private(set) var uuid: UUID
-    public private(set) var data: ByteArray
+    public private(set) var data: ByteArray {
+        didSet {
+            dataSHA256Cache = nil
+        }
+    }
     public private(set) var name: String?
     public private(set) var lastModificationTime: Date?
     public var description: String {
         return "CustomIcon(UUID: \(uuid.uuidString), Data: \(data.count) bytes"
     }
 
+    private var dataSHA256Cache: ByteArray?
+
+    /// SHA-256 of the icon's data, computed once.
+    public var dataSHA256: ByteArray {
+        if let dataSHA256Cache {
+            return dataSHA256Cache
+        }
+        let result = CustomIcon2.dataSHA256(of: data)
+        dataSHA256Cache = result
+        return result
+    }
+
+    /// Digest of icon data, as used by `dataSHA256` and `Database2.findCustomIcon(pngDataSha256:)`.
+    public static func dataSHA256(of data: ByteArray) -> ByteArray {
+        var digest = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_SIZE))
+        data.withBytes {
+            sha256($0, $0.count, &digest)
+        }
+        return ByteArray(bytes: digest)
+    }
+
     init() {
         uuid = UUID.ZERO
         data = ByteArray()
@@ -40,6 +65,7 @@ public class CustomIcon2: Eraseable {
     public func erase() {
         uuid.erase()
         data.erase()
+        dataSHA256Cache = nil
         name?.erase()
         lastModificationTime = nil
     }
@@ -64,44 +90,6 @@ public class CustomIcon2: Eraseable {
 }
 
 extension CustomIcon2 {
-    func load(xml: AEXMLElement, timeParser: Database2.XMLTimeParser) throws {
-        assert(xml.name == Xml2.icon)
-        Diag.verbose("Loading XML: custom icon")
-
-        erase()
-        var xmlUUID: UUID?
-        var xmlData: ByteArray?
-        var xmlName: String?
-        var xmlLastModificationTime: Date?
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.uuid:
-                xmlUUID = UUID(base64Encoded: tag.value)
-            case Xml2.data:
-                xmlData = ByteArray(base64Encoded: tag.value ?? "")
-            case Xml2.name:
-                xmlName = tag.value
-            case Xml2.lastModificationTime:
-                xmlLastModificationTime = timeParser(tag.value)
-            default:
-                Diag.error("Unexpected XML tag in CustomIcon: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "CustomIcon/*")
-            }
-        }
-        if xmlUUID == nil {
-            Diag.warning("Missing CustomIcon/UUID. Will generate a new one.")
-        }
-        let _uuid = xmlUUID ?? UUID()
-        guard let _data = xmlData else {
-            Diag.error("Missing CustomIcon/Data")
-            throw Xml2.ParsingError.malformedValue(tag: "CustomIcon/Data", value: nil)
-        }
-        self.uuid = _uuid
-        self.data = _data
-        self.name = xmlName
-        self.lastModificationTime = xmlLastModificationTime
-    }
-
     func toXml(
         formatVersion: Database2.FormatVersion,
         timeFormatter: Database2.XMLTimeFormatter
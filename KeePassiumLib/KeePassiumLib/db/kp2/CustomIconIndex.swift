@@ -0,0 +1,56 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+/// Lookup tables over a list of custom icons, by UUID and by SHA-256 of the icon data.
+///
+/// Icons must be inserted in list order. If several icons share a UUID or data,
+/// lookups return the earliest of them, as a linear search of the list would.
+final class CustomIconIndex {
+    private var iconsByUUID = [UUID: [CustomIcon2]]()
+    private var iconsByDataSHA256 = [ByteArray: [CustomIcon2]]()
+
+    init<S: Sequence>(_ icons: S) where S.Element == CustomIcon2 {
+        icons.forEach { insert($0) }
+    }
+
+    func insert(_ icon: CustomIcon2) {
+        iconsByUUID[icon.uuid, default: []].append(icon)
+        iconsByDataSHA256[icon.dataSHA256, default: []].append(icon)
+    }
+
+    /// Removes all the icons with the given UUID.
+    /// - Returns: the removed icons
+    @discardableResult
+    func remove(uuid: UUID) -> [CustomIcon2] {
+        guard let removedIcons = iconsByUUID.removeValue(forKey: uuid) else {
+            return []
+        }
+        for icon in removedIcons {
+            let digest = icon.dataSHA256
+            iconsByDataSHA256[digest]?.removeAll(where: { $0 === icon })
+            if iconsByDataSHA256[digest]?.isEmpty ?? false {
+                iconsByDataSHA256.removeValue(forKey: digest)
+            }
+        }
+        return removedIcons
+    }
+
+    func contains(uuid: UUID) -> Bool {
+        return iconsByUUID[uuid] != nil
+    }
+
+    func icon(uuid: UUID) -> CustomIcon2? {
+        return iconsByUUID[uuid]?.first
+    }
+
+    func icon(dataSHA256: ByteArray) -> CustomIcon2? {
+        return iconsByDataSHA256[dataSHA256]?.first
+    }
+}
@@ -140,6 +140,9 @@ public class Database2: Database {
     private var hmacKey = SecureBytes.empty()
     private var deletedObjects: ContiguousArray<DeletedObject2> = []
 
+    internal private(set) var loadTimings = StageTimings()
+    internal private(set) var saveTimings = StageTimings()
+
     override public var keyHelper: KeyHelper { return _keyHelper }
     private let _keyHelper = KeyHelper2()
 
@@ -171,7 +174,19 @@ public class Database2: Database {
         let db = Database2()
         db.header.loadDefaultValuesV4(version)
         db.meta.loadDefaultValuesV4()
+        db.root = makeRootGroup(database: db)
+        return db
+    }
 
+    internal static func makeNewV3() -> Database2 {
+        let db = Database2()
+        db.header.loadDefaultValuesV3()
+        db.meta.loadDefaultValuesV4()
+        db.root = makeRootGroup(database: db)
+        return db
+    }
+
+    private static func makeRootGroup(database db: Database2) -> Group2 {
         let rootGroup = Group2(database: db)
         rootGroup.uuid = UUID()
         rootGroup.name = "/"
@@ -179,8 +194,7 @@ public class Database2: Database {
         rootGroup.isSearchingEnabled = true
         rootGroup.canExpire = false
         rootGroup.isExpanded = true
-        db.root = rootGroup
-        return db
+        return rootGroup
     }
 
     public func formatUpgradeRequired(for feature: DatabaseFeature2) -> FormatVersion? {
@@ -225,16 +239,17 @@ public class Database2: Database {
         dbFileName: String,
         dbFileData: ByteArray,
         compositeKey: CompositeKey,
-        useStreams: Bool,
         warnings: DatabaseLoadingWarnings
     ) throws {
         Diag.info("Loading KDBX database")
         progress.completedUnitCount = 0
         progress.totalUnitCount = ProgressSteps.all
         progress.localizedDescription = LString.Progress.database2LoadingDatabase
+        loadTimings.start()
         do {
             try header.read(data: dbFileData) 
             Diag.debug("Header read OK [format: \(header.formatVersion)]")
+            loadTimings.lap("header")
             Diag.verbose("== DB2 progress CP1: \(progress.completedUnitCount)")
 
             try deriveMasterKey(
@@ -242,6 +257,7 @@ public class Database2: Database {
                 cipher: header.dataCipher,
                 canUseFinalKey: true)
             Diag.debug("Key derivation OK")
+            loadTimings.lap("kdf")
             Diag.verbose("== DB2 progress CP2: \(progress.completedUnitCount)")
 
             var decryptedData: ByteArray
@@ -258,6 +274,7 @@ public class Database2: Database {
                     cipher: header.dataCipher)
             }
             Diag.debug("Block decryption OK")
+            loadTimings.lap("decrypt")
             Diag.verbose("== DB2 progress CP3: \(progress.completedUnitCount)")
 
             if header.isCompressed {
@@ -267,6 +284,7 @@ public class Database2: Database {
             } else {
                 Diag.debug("Data not compressed")
             }
+            loadTimings.lap("gunzip")
             progress.completedUnitCount += ProgressSteps.gzipUnpack
             Diag.verbose("== DB2 progress CP4: \(progress.completedUnitCount)")
 
@@ -282,7 +300,8 @@ public class Database2: Database {
 
             try removeGarbageAfterXML(data: xmlData) 
 
-            try load(xmlData: xmlData, useStreams: useStreams, warnings: warnings)
+            try load(xmlData: xmlData, warnings: warnings)
+            loadTimings.lap("parse")
             if let backupGroup = getBackupGroup(createIfMissing: false) {
                 backupGroup.deepSetDeleted(true)
             }
@@ -310,8 +329,9 @@ public class Database2: Database {
             checkAttachmentsIntegrity(allEntries: allCurrentEntries, warnings: warnings)
 
             checkCustomFieldsIntegrity(allEntries: allCurrentEntries, warnings: warnings)
+            loadTimings.lap("postprocess")
 
-            Diag.debug("Content loaded OK")
+            Diag.debug("Content loaded OK [\(loadTimings)]")
             Diag.verbose("== DB2 progress CP5: \(progress.completedUnitCount)")
         } catch let error as Header2.HeaderError {
             Diag.error("Header error [reason: \(error.localizedDescription)]")
@@ -554,7 +574,8 @@ public class Database2: Database {
             return
         }
 
-        progress.addChild(header.kdf.initProgress(), withPendingUnitCount: ProgressSteps.keyDerivation)
+        let kdfProgress = header.kdf.initProgress()
+        progress.addChild(kdfProgress, withPendingUnitCount: ProgressSteps.keyDerivation)
         var combinedComponents: SecureBytes
         if compositeKey.state == .processedComponents {
             combinedComponents = try keyHelper.combineComponents(
@@ -575,9 +596,11 @@ public class Database2: Database {
 
             let keyToTransform = keyHelper.getKey(fromCombinedComponents: combinedComponents)
 
-            let transformedKey = try header.kdf.transform(
+            let transformedKey = try KeyDerivationCache.transform(
                 key: keyToTransform,
-                params: header.kdfParams)
+                kdf: header.kdf,
+                params: header.kdfParams,
+                progress: kdfProgress)
 
             let challengeResponse = try compositeKey.getResponse(challenge: secureMasterSeed) 
             joinedKey = SecureBytes.concat(secureMasterSeed, challengeResponse, transformedKey)
@@ -591,9 +614,11 @@ public class Database2: Database {
 
             let keyToTransform = keyHelper.getKey(fromCombinedComponents: combinedComponents)
 
-            let transformedKey = try header.kdf.transform(
+            let transformedKey = try KeyDerivationCache.transform(
                 key: keyToTransform,
-                params: header.kdfParams)
+                kdf: header.kdf,
+                params: header.kdfParams,
+                progress: kdfProgress)
             joinedKey = SecureBytes.concat(secureMasterSeed, transformedKey)
         }
         self.cipherKey = cipher.resizeKey(key: joinedKey)
@@ -602,6 +627,14 @@ public class Database2: Database {
         compositeKey.setFinalKeys(hmacKey, cipherKey)
     }
 
+    /// Reads the header from the beginning of the file and derives the final keys into `compositeKey`,
+    /// so the KDF can run before the rest of the file is available.
+    internal func deriveMasterKey(headerData: ByteArray, compositeKey: CompositeKey) throws {
+        try header.read(data: headerData)
+        Diag.debug("Header read OK [format: \(header.formatVersion)]")
+        try deriveMasterKey(compositeKey: compositeKey, cipher: header.dataCipher, canUseFinalKey: false)
+    }
+
     override public func changeCompositeKey(to newKey: CompositeKey) {
         compositeKey = newKey.clone()
         meta.masterKeyChangedTime = Date.now
@@ -823,6 +856,7 @@ public class Database2: Database {
         header.maybeUpdateFormatVersion()
         let formatVersion = header.formatVersion
         Diag.debug("Format version: \(formatVersion)")
+        saveTimings.start()
         do {
             try header.randomizeSeeds() 
             Diag.debug("Seeds randomized OK")
@@ -831,6 +865,7 @@ public class Database2: Database {
                 cipher: header.dataCipher,
                 canUseFinalKey: false)
             Diag.debug("Key derivation OK")
+            saveTimings.lap("kdf")
         } catch let error as CryptoError {
             Diag.error("Crypto error [reason: \(error.localizedDescription)]")
             throw DatabaseError.saveError(reason: error.localizedDescription)
@@ -852,18 +887,27 @@ public class Database2: Database {
         progress.completedUnitCount += ProgressSteps.packing
 
         header.write(to: outStream) 
+        saveTimings.lap("header")
 
         meta.headerHash = header.hash
         let timeFormatter = getTimeFormatter(for: formatVersion)
-        let xmlString = try self.toXml(timeFormatter: timeFormatter).xml
-        let xmlData = ByteArray(utf8String: xmlString)
-        Diag.debug("XML generation OK")
 
         switch formatVersion {
         case .v3:
+            let xmlData = try makeXmlData(timeFormatter: timeFormatter)
+            saveTimings.lap("xml")
             try encryptBlocksV3(to: outStream, xmlData: xmlData) 
+            saveTimings.lap("encrypt")
         case .v4, .v4_1:
-            try encryptBlocksV4(to: outStream, xmlData: xmlData) 
+            if KDBXStreamWriter.isSupported(cipher: header.dataCipher) {
+                try encryptStreamV4(to: outStream, timeFormatter: timeFormatter) 
+                saveTimings.lap("xml+encrypt") // serialized while being compressed and encrypted
+            } else {
+                let xmlData = try makeXmlData(timeFormatter: timeFormatter)
+                saveTimings.lap("xml")
+                try encryptBlocksV4(to: outStream, xmlData: xmlData) 
+                saveTimings.lap("encrypt")
+            }
         }
         Diag.debug("Content encryption OK")
 
@@ -874,11 +918,82 @@ public class Database2: Database {
             parentProgress: progress,
             pendingProgressUnits: ProgressSteps.resolvingReferences
         )
+        saveTimings.lap("postprocess")
+        Diag.debug("Database saved OK [\(saveTimings)]")
 
         progress.completedUnitCount = progress.totalUnitCount
         return outStream.data!
     }
 
+    internal func encryptStreamV4(
+        to outStream: ByteArray.OutputStream,
+        timeFormatter: XMLTimeFormatter
+    ) throws {
+        Diag.debug("Streaming kdbx4 blocks")
+        outStream.write(data: header.hash)
+        outStream.write(data: header.getHMAC(key: hmacKey))
+
+        let streamProgress = ProgressEx()
+        streamProgress.totalUnitCount = 1
+        streamProgress.localizedDescription = LString.Progress.database2WritingBlocks
+        progress.addChild(
+            streamProgress,
+            withPendingUnitCount: ProgressSteps.gzipPack + ProgressSteps.encryption + ProgressSteps.writingBlocks)
+
+        do {
+            let writer = try KDBXStreamWriter(
+                cipher: header.dataCipher,
+                key: cipherKey,
+                iv: header.initialVector,
+                hmacKey: hmacKey,
+                compress: header.isCompressed,
+                outStream: outStream,
+                progress: streamProgress)
+
+            let innerHeaderStream = ByteArray.makeOutputStream()
+            innerHeaderStream.open()
+            defer { innerHeaderStream.close() }
+            try header.writeInner(to: innerHeaderStream) 
+            guard let innerHeaderData = innerHeaderStream.data else { fatalError() }
+            try writer.write(data: innerHeaderData)
+            Diag.verbose("Header written OK")
+
+            let xmlWriter = XMLStreamWriter(output: { [streamProgress] chunk in
+                if streamProgress.isCancelled {
+                    throw ProgressInterruption.cancelled(reason: streamProgress.cancellationReason)
+                }
+                try writer.write(bytes: chunk)
+            })
+            try writeXml(to: xmlWriter, timeFormatter: timeFormatter)
+            try writer.finish()
+            Diag.verbose("Streamed \(writer.bytesIn) bytes into \(writer.bytesOut) bytes")
+            streamProgress.completedUnitCount = streamProgress.totalUnitCount
+        } catch let error as Header2.HeaderError {
+            Diag.error("Header error [message: \(error.localizedDescription)]")
+            throw DatabaseError.saveError(reason: error.localizedDescription)
+        } catch let error as GzipError {
+            Diag.error("Gzip error [kind: \(error.kind), message: \(error.message)]")
+            let errMsg = String.localizedStringWithFormat(
+                NSLocalizedString(
+                    "[Database2/Saving/Error] Data compression error: %@",
+                    bundle: Bundle.framework,
+                    value: "Data compression error: %@",
+                    comment: "Error message while saving a database. [errorDescription: String]"),
+                error.localizedDescription)
+            throw DatabaseError.saveError(reason: errMsg)
+        } catch let error as CryptoError {
+            Diag.error("Crypto error [reason: \(error.localizedDescription)]")
+            let errMsg = String.localizedStringWithFormat(
+                NSLocalizedString(
+                    "[Database2/Saving/Error] Encryption error: %@",
+                    bundle: Bundle.framework,
+                    value: "Encryption error: %@",
+                    comment: "Error message while saving a database. [errorDescription: String]"),
+                error.localizedDescription)
+            throw DatabaseError.saveError(reason: errMsg)
+        }
+    }
+
     internal func encryptBlocksV4(to outStream: ByteArray.OutputStream, xmlData: ByteArray) throws {
         Diag.debug("Encrypting kdbx4 blocks")
         outStream.write(data: header.hash)
@@ -1069,39 +1184,58 @@ public class Database2: Database {
         writingProgress.completedUnitCount = writingProgress.totalUnitCount
     }
 
-    func toXml(timeFormatter: XMLTimeFormatter) throws -> AEXMLDocument {
+    /// Serializes the database as XML, writing the tree one entry at a time.
+    func writeXml(to xmlWriter: XMLStreamWriter, timeFormatter: XMLTimeFormatter) throws {
         Diag.debug("Will generate XML")
-        var options = AEXMLOptions()
-        options.documentHeader.encoding = "utf-8"
-        options.documentHeader.standalone = "yes"
-        options.documentHeader.version = 1.0
+        var documentHeader = AEXMLOptions.DocumentHeader()
+        documentHeader.encoding = "utf-8"
+        documentHeader.standalone = "yes"
+        documentHeader.version = 1.0
+        xmlWriter.writeDeclaration(documentHeader)
 
         let xmlMain = AEXMLElement(name: Xml2.keePassFile)
-        let xmlDoc = AEXMLDocument(root: xmlMain, options: options)
-        xmlMain.addChild(
-            try meta.toXml(
+        try xmlWriter.writeStart(element: xmlMain, depth: 0)
+        try xmlWriter.write(
+            element: try meta.toXml(
                 streamCipher: header.streamCipher,
                 formatVersion: header.formatVersion,
                 timeFormatter: timeFormatter
-            )
+            ),
+            depth: 1
         ) 
         Diag.verbose("XML generation: Meta OK")
 
-        let xmlRoot = xmlMain.addChild(name: Xml2.root)
+        let xmlRoot = AEXMLElement(name: Xml2.root)
+        try xmlWriter.writeStart(element: xmlRoot, depth: 1)
         let root2 = root! as! Group2
-        let rootXML = try root2.toXml(
+        try root2.write(
+            to: xmlWriter,
+            depth: 2,
             formatVersion: header.formatVersion,
             streamCipher: header.streamCipher,
             timeFormatter: timeFormatter
         ) 
-        xmlRoot.addChild(rootXML)
         Diag.verbose("XML generation: Root group OK")
 
-        let xmlDeletedObjects = xmlRoot.addChild(name: Xml2.deletedObjects)
+        let xmlDeletedObjects = AEXMLElement(name: Xml2.deletedObjects)
         for deletedObject in deletedObjects {
             xmlDeletedObjects.addChild(deletedObject.toXml(timeFormatter: timeFormatter))
         }
-        return xmlDoc
+        try xmlWriter.write(element: xmlDeletedObjects, depth: 2)
+        try xmlWriter.writeEnd(element: xmlRoot, depth: 1)
+        try xmlWriter.writeEnd(element: xmlMain, depth: 0)
+        try xmlWriter.finish()
+        Diag.debug("XML generation OK")
+    }
+
+    /// Serializes the database as XML into memory, for formats that encrypt it as a whole.
+    private func makeXmlData(timeFormatter: XMLTimeFormatter) throws -> ByteArray {
+        var xmlBytes = [UInt8]()
+        let xmlWriter = XMLStreamWriter(output: { chunk in
+            xmlBytes.append(contentsOf: chunk)
+        })
+        try writeXml(to: xmlWriter, timeFormatter: timeFormatter)
+        return ByteArray(bytes: xmlBytes)
     }
 
     func setAllTimestamps(to time: Date) {
@@ -1236,7 +1370,7 @@ public class Database2: Database {
     }
 
     public func addCustomIcon(pngData: ByteArray) -> CustomIcon2 {
-        if let existingIcon = findCustomIcon(pngDataSha256: pngData.sha256) {
+        if let existingIcon = findCustomIcon(pngDataSha256: CustomIcon2.dataSHA256(of: pngData)) {
             return existingIcon
         }
 
@@ -1247,35 +1381,49 @@ public class Database2: Database {
     }
 
     public func findCustomIcon(pngDataSha256: ByteArray) -> CustomIcon2? {
-        return customIcons.first(where: { $0.data.sha256 == pngDataSha256 })
+        return meta.customIconIndex.icon(dataSHA256: pngDataSha256)
     }
 
     public func getCustomIcon(with uuid: UUID) -> CustomIcon2? {
-        return customIcons.first(where: { $0.uuid == uuid })
+        return meta.customIconIndex.icon(uuid: uuid)
     }
 
     @discardableResult
     public func deleteCustomIcon(uuid: UUID) -> Bool {
-        guard customIcons.contains(where: { $0.uuid == uuid }) else {
+        return deleteCustomIcons(uuids: [uuid]) > 0
+    }
+
+    /// Deletes the given custom icons and clears references to them, in one pass over the tree.
+    /// - Returns: the number of deleted icons
+    @discardableResult
+    public func deleteCustomIcons(uuids: Set<UUID>) -> Int {
+        let index = meta.customIconIndex
+        let existingUUIDs = uuids.filter { index.contains(uuid: $0) }
+        if existingUUIDs.count < uuids.count {
             Diag.warning("Tried to delete non-existent custom icon")
-            return false
         }
-        meta.deleteCustomIcon(uuid: uuid)
-        deletedObjects.append(DeletedObject2(uuid: uuid))
+        guard !existingUUIDs.isEmpty else {
+            return 0
+        }
+        meta.deleteCustomIcons(uuids: existingUUIDs)
+        existingUUIDs.forEach {
+            deletedObjects.append(DeletedObject2(uuid: $0))
+        }
         removeUnusedCustomIconRefs()
-        Diag.debug("Custom icon deleted OK")
-        return true
+        Diag.debug("Custom icons deleted OK [count: \(existingUUIDs.count)]")
+        return existingUUIDs.count
     }
 
     private func removeUnusedCustomIconRefs() {
-        let knownIconUUIDs = Set<UUID>(customIcons.map { $0.uuid })
+        let index = meta.customIconIndex
+        let isKnownIcon = { (uuid: UUID) in index.contains(uuid: uuid) }
         root?.applyToAllChildren(
             includeSelf: true,
             groupHandler: { group in
-                (group as! Group2).enforceCustomIconUUID(isValid: knownIconUUIDs)
+                (group as! Group2).enforceCustomIconUUID(isValid: isKnownIcon)
             },
             entryHandler: { entry in
-                (entry as! Entry2).enforceCustomIconUUID(isValid: knownIconUUIDs)
+                (entry as! Entry2).enforceCustomIconUUID(isValid: isKnownIcon)
             }
         )
     }
@@ -1292,22 +1440,26 @@ extension Database2 {
     }
 
     static private func xmlStringToDateV3(_ string: String?) -> Date? {
-        let trimmedString = string?.trimmingCharacters(in: .whitespacesAndNewlines)
-        if let formatAppropriateDate = Date(iso8601string: trimmedString) {
-            return formatAppropriateDate
-        }
-        if let altFormatDate = Date(base64Encoded: trimmedString) {
-            Diag.warning("Found Base64-formatted timestamp in v3 DB.")
-            return altFormatDate
+        guard let string else { return nil }
+        if let (date, format) = KDBXTime.parse(string, preferredFormat: .iso8601) {
+            if format == .base64 {
+                Diag.warning("Found Base64-formatted timestamp in v3 DB.")
+            }
+            return date
         }
-        return nil
+        let trimmedString = string.trimmingCharacters(in: .whitespacesAndNewlines)
+        return Date(iso8601string: trimmedString)
     }
 
     static private func xmlStringToDateV4(_ string: String?) -> Date? {
-        let trimmedString = string?.trimmingCharacters(in: .whitespacesAndNewlines)
-        if let formatAppropriateDate = Date(base64Encoded: trimmedString) {
-            return formatAppropriateDate
+        guard let string else { return nil }
+        if let (date, format) = KDBXTime.parse(string, preferredFormat: .base64) {
+            if format == .iso8601 {
+                Diag.warning("Found ISO8601-formatted timestamp in v4 DB.")
+            }
+            return date
         }
+        let trimmedString = string.trimmingCharacters(in: .whitespacesAndNewlines)
         if let altFormatDate = Date(iso8601string: trimmedString) {
             Diag.warning("Found ISO8601-formatted timestamp in v4 DB.")
             return altFormatDate
@@ -1324,17 +1476,16 @@ extension Database2 {
         }
     }
     static private func dateToXMLStringV3(_ date: Date) -> String {
-        return date.iso8601String()
+        return KDBXTime.format(date, as: .iso8601) ?? date.iso8601String()
     }
     static private func dateToXMLStringV4(_ date: Date) -> String {
-        return date.base64EncodedString()
+        return KDBXTime.format(date, as: .base64) ?? date.base64EncodedString()
     }
 }
 
 extension Database2 {
     internal func load(
         xmlData: ByteArray,
-        useStreams: Bool,
         warnings: DatabaseLoadingWarnings
     ) throws {
         do {
@@ -1342,11 +1493,7 @@ extension Database2 {
             let timeParser = getTimeParser(for: formatVersion)
 
             let startTime = Date.now
-            if useStreams {
-                try loadAsStream(xmlData: xmlData, timeParser: timeParser, progress: progress, warnings: warnings)
-            } else {
-                try loadAsDOM(xmlData: xmlData, timeParser: timeParser, warnings: warnings)
-            }
+            try loadAsStream(xmlData: xmlData, timeParser: timeParser, progress: progress, warnings: warnings)
             let timeSpent = Date.now.timeIntervalSince(startTime)
             Diag.info(String(format: "XML loaded in %.4f s", timeSpent))
 
@@ -1364,109 +1511,6 @@ extension Database2 {
         } catch let error as Xml2.ParsingError {
             Diag.error("XML parsing error [reason: \(error.localizedDescription)]")
             throw FormatError.parsingError(reason: error.localizedDescription)
-        } catch let error as AEXMLError {
-            Diag.error("Raw XML parsing error [reason: \(error.localizedDescription)]")
-            throw FormatError.parsingError(reason: error.localizedDescription)
-        }
-    }
-}
-
-extension Database2 {
-    private func loadAsDOM(
-        xmlData: ByteArray,
-        timeParser: XMLTimeParser,
-        warnings: DatabaseLoadingWarnings
-    ) throws {
-        Diag.debug("Parsing XML (DOM)")
-
-        var parsingOptions = AEXMLOptions()
-        parsingOptions.documentHeader.standalone = "yes"
-        parsingOptions.parserSettings.shouldTrimWhitespace = false
-
-        let xmlDoc = try AEXMLDocument(xml: xmlData.asData, options: parsingOptions)
-        if let xmlError = xmlDoc.error {
-            Diag.error("Cannot parse XML: \(xmlError.localizedDescription)")
-            throw Xml2.ParsingError.xmlError(details: xmlError.localizedDescription)
-        }
-        guard xmlDoc.root.name == Xml2.keePassFile else {
-            Diag.error("Not a KeePass XML document [xmlRoot: \(xmlDoc.root.name)]")
-            throw Xml2.ParsingError.unexpectedTag(actual: xmlDoc.root.name, expected: Xml2.keePassFile)
-        }
-
-        let rootGroup = Group2(database: self)
-        rootGroup.parent = nil
-
-        for tag in xmlDoc.root.children {
-            switch tag.name {
-            case Xml2.meta:
-                try meta.load(
-                    xml: tag,
-                    formatVersion: header.formatVersion,
-                    streamCipher: header.streamCipher,
-                    timeParser: timeParser,
-                    warnings: warnings
-                )
-
-                if meta.headerHash != nil && (header.hash != meta.headerHash!) {
-                    Diag.error("kdbx3 meta meta hash mismatch")
-                    throw Header2.HeaderError.hashMismatch
-                }
-                Diag.verbose("Meta loaded OK")
-            case Xml2.root:
-                try loadRoot(
-                    xml: tag,
-                    root: rootGroup,
-                    timeParser: timeParser,
-                    warnings: warnings
-                )
-                Diag.verbose("XML root loaded OK")
-            default:
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "KeePassFile/*")
-            }
-        }
-        self.root = rootGroup
-    }
-
-    private func loadRoot(
-        xml: AEXMLElement,
-        root: Group2,
-        timeParser: XMLTimeParser,
-        warnings: DatabaseLoadingWarnings
-    ) throws {
-        assert(xml.name == Xml2.root)
-        Diag.debug("Loading XML root")
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.group:
-                try root.load(
-                    xml: tag,
-                    formatVersion: header.formatVersion,
-                    streamCipher: header.streamCipher,
-                    timeParser: timeParser,
-                    warnings: warnings
-                )
-            case Xml2.deletedObjects:
-                try loadDeletedObjects(xml: tag, timeParser: timeParser)
-            default:
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Root/*")
-            }
-        }
-    }
-
-    private func loadDeletedObjects(
-        xml: AEXMLElement,
-        timeParser: XMLTimeParser
-    ) throws {
-        assert(xml.name == Xml2.deletedObjects)
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.deletedObject:
-                let deletedObject = DeletedObject2()
-                try deletedObject.load(xml: tag, timeParser: timeParser)
-                deletedObjects.append(deletedObject)
-            default:
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "DeletedObjects/*")
-            }
         }
     }
 }
@@ -1516,23 +1560,14 @@ extension Database2 {
             progress: progress,
             warnings: warnings
         )
-        let docParser = XMLDocumentReader(xmlData: xmlData.asData, documentContext: docContext)
+        let docParser = Xml2DocumentReader(xmlData: xmlData, documentContext: docContext)
         let readerContext = ParsingContext()
         docParser.pushReader(parseKeePassFileElement, context: readerContext)
-        do {
-            try docParser.parse()
-            guard readerContext.isKeePassFile else {
-                docParser.popReader()
-                Diag.error("XML does not contain any elements, cancelling")
-                throw Xml2.ParsingError.unexpectedTag(actual: "nil", expected: Xml2.keePassFile)
-            }
-        } catch let xmlError as NSError where (xmlError.domain == XMLParser.errorDomain) {
-            let parserMessage = xmlError.userInfo["NSXMLParserErrorMessage"] as? String
-            let detailedMessage = [parserMessage, xmlError.description]
-                .compactMap { $0 }
-                .joined()
-            Diag.error("Failed to parse XML: \(detailedMessage)")
-            throw Xml2.ParsingError.xmlError(details: xmlError.localizedDescription)
+        try docParser.parse()
+        guard readerContext.isKeePassFile else {
+            docParser.popReader()
+            Diag.error("XML does not contain any elements, cancelling")
+            throw Xml2.ParsingError.unexpectedTag(actual: "nil", expected: Xml2.keePassFile)
         }
     }
 
@@ -1612,22 +1647,22 @@ extension Database2 {
 }
 
 private extension Group2 {
-    func enforceCustomIconUUID(isValid validValues: Set<UUID>) {
+    func enforceCustomIconUUID(isValid: (UUID) -> Bool) {
         guard customIconUUID != UUID.ZERO else { return }
-        if !validValues.contains(self.customIconUUID) {
+        if !isValid(self.customIconUUID) {
             customIconUUID = UUID.ZERO
         }
     }
 }
 
 private extension Entry2 {
-    func enforceCustomIconUUID(isValid validValues: Set<UUID>) {
+    func enforceCustomIconUUID(isValid: (UUID) -> Bool) {
         guard customIconUUID != UUID.ZERO else { return }
-        if !validValues.contains(customIconUUID) {
+        if !isValid(customIconUUID) {
             customIconUUID = UUID.ZERO
         }
         history.forEach { historyEntry in
-            historyEntry.enforceCustomIconUUID(isValid: validValues)
+            historyEntry.enforceCustomIconUUID(isValid: isValid)
         }
     }
 }
@@ -30,31 +30,6 @@ public class DeletedObject2: Eraseable {
 }
 
 extension DeletedObject2 {
-    func load(xml: AEXMLElement, timeParser: Database2.XMLTimeParser) throws {
-        assert(xml.name == Xml2.deletedObject)
-        Diag.verbose("Loading XML: deleted object")
-        erase()
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.uuid:
-                self.uuid = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.deletionTime:
-                guard let deletionTime = timeParser(tag.value) else {
-                    Diag.error("Cannot parse DeletedObject/DeletionTime as Date")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: "DeletedObject/DeletionTime",
-                        value: tag.value)
-                }
-                self.deletionTime = deletionTime
-            default:
-                Diag.error("Unexpected XML tag in DeletedObject: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(
-                    actual: tag.name,
-                    expected: "DeletedObject/*")
-            }
-        }
-    }
-
     func toXml(timeFormatter: Database2.XMLTimeFormatter) -> AEXMLElement {
         Diag.verbose("Generating XML: deleted object")
         let xml = AEXMLElement(name: Xml2.deletedObject)
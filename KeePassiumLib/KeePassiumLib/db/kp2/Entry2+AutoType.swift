@@ -49,61 +49,6 @@ extension Entry2 {
 }
 
 extension Entry2.AutoType {
-    func load(xml: AEXMLElement, streamCipher: StreamCipher) throws {
-        assert(xml.name == Xml2.autoType)
-        Diag.verbose("Loading XML: entry autotype")
-        erase()
-
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.enabled:
-                isEnabled = Bool(string: tag.value)
-            case Xml2.dataTransferObfuscation:
-                obfuscationType = UInt32(tag.value) ?? 0
-            case Xml2.defaultSequence:
-                defaultSequence = tag.value ?? ""
-            case Xml2.association:
-                try loadAssociation(xml: tag)
-            default:
-                Diag.error("Unexpected XML tag in Entry/AutoType: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Entry/AutoType/*")
-            }
-        }
-    }
-
-    func loadAssociation(xml: AEXMLElement) throws {
-        assert(xml.name == Xml2.association)
-
-        var window: String?
-        var sequence: String?
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.window:
-                window = tag.value ?? ""
-            case Xml2.keystrokeSequence:
-                sequence = tag.value ?? ""
-            default:
-                Diag.error("Unexpected XML tag in Entry/AutoType/Association: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(
-                    actual: tag.name,
-                    expected: "Entry/AutoType/Association/*")
-            }
-        }
-        guard window != nil else {
-            Diag.error("Missing Entry/AutoType/Association/Window")
-            throw Xml2.ParsingError.malformedValue(
-                tag: "Entry/AutoType/Association/Window",
-                value: window)
-        }
-        guard sequence != nil else {
-            Diag.error("Missing Entry/AutoType/Association/Sequence")
-            throw Xml2.ParsingError.malformedValue(
-                tag: "Entry/AutoType/Association/Sequence",
-                value: sequence)
-        }
-        associations.append(Association(window: window!, keystrokeSequence: sequence!))
-    }
-
     internal func toXml() -> AEXMLElement {
         Diag.verbose("Generating XML: entry autotype")
         let xmlAutoType = AEXMLElement(name: Xml2.autoType)
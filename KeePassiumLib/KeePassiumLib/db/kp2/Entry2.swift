@@ -266,200 +266,6 @@ public class Entry2: Entry {
 }
 
 extension Entry2 {
-    func load(
-        xml: AEXMLElement,
-        formatVersion: Database2.FormatVersion,
-        streamCipher: StreamCipher,
-        timeParser: Database2.XMLTimeParser,
-        warnings: DatabaseLoadingWarnings
-    ) throws {
-        assert(xml.name == Xml2.entry)
-        Diag.verbose("Loading XML: entry")
-
-        let parent = self.parent
-        erase()
-        self.parent = parent
-
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.uuid:
-                self.uuid = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.iconID:
-                self.iconID = IconID(tag.value) ?? IconID.key
-            case Xml2.customIconUUID:
-                self.customIconUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.foregroundColor:
-                self.foregroundColor = tag.value ?? ""
-            case Xml2.backgroundColor:
-                self.backgroundColor = tag.value ?? ""
-            case Xml2.overrideURL:
-                self.overrideURL = tag.value ?? ""
-            case Xml2.tags:
-                self.tags = parseItemTags(xml: tag)
-            case Xml2.string:
-                let field = makeEntryField(name: "", value: "", isProtected: true) as! EntryField2
-                try field.load(xml: tag, streamCipher: streamCipher)
-                if field.isEmpty {
-                    Diag.debug("Loaded empty entry field, ignoring.")
-                } else if field.name.isEmpty {
-                    Diag.warning("Loaded entry field with an empty name, will show a warning.")
-                    setField(name: field.name, value: field.value, isProtected: field.isProtected)
-                } else {
-                    Diag.verbose("Entry field loaded OK")
-                    setField(name: field.name, value: field.value, isProtected: field.isProtected)
-                }
-            case Xml2.binary:
-                guard !tag.children.isEmpty else {
-                    Diag.warning("Skipping an empty Binary tag")
-                    continue
-                }
-                let att = try Attachment2.load(
-                    xml: tag,
-                    database: database as! Database2,
-                    streamCipher: streamCipher)
-                attachments.append(att)
-                Diag.verbose("Entry attachment loaded OK")
-            case Xml2.times:
-                try loadTimes(xml: tag, timeParser: timeParser)
-                Diag.verbose("Entry times loaded OK")
-            case Xml2.autoType:
-                try autoType.load(xml: tag, streamCipher: streamCipher)
-                Diag.verbose("Entry autotype loaded OK")
-            case Xml2.previousParentGroup:
-                assert(formatVersion.supports(.previousParentGroup))
-                previousParentGroupUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.qualityCheck:
-                assert(formatVersion.supports(.qualityCheckFlag))
-                qualityCheck = Bool(optString: tag.value) ?? true
-            case Xml2.customData: 
-                assert(formatVersion.supports(.customData))
-                try customData.load(
-                    xml: tag,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    xmlParentName: "Entry")
-                Diag.verbose("Entry custom data loaded OK")
-            case Xml2.history:
-                try loadHistory(
-                    xml: tag,
-                    formatVersion: formatVersion,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    warnings: warnings
-                ) 
-                Diag.verbose("Entry history loaded OK")
-            default:
-                Diag.error("Unexpected XML tag in Entry: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Entry/*")
-            }
-        }
-    }
-
-    func loadTimes(xml: AEXMLElement, timeParser: Database2.XMLTimeParser) throws {
-        assert(xml.name == Xml2.times)
-        Diag.verbose("Loading XML: entry times")
-
-        var optionalExpiryTime: Date?
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.lastModificationTime:
-                guard let time = timeParser(tag.value) else {
-                    Diag.error("Cannot parse Entry/Times/LastModificationTime as Date")
-                     throw Xml2.ParsingError.malformedValue(
-                        tag: "Entry/Times/LastModificationTime",
-                        value: tag.value)
-                }
-                lastModificationTime = time
-            case Xml2.creationTime:
-                guard let time = timeParser(tag.value) else {
-                    Diag.error("Cannot parse Entry/Times/CreationTime as Date")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: "Entry/Times/CreationTime",
-                        value: tag.value)
-                }
-                creationTime = time
-            case Xml2.lastAccessTime:
-                guard let time = timeParser(tag.value) else {
-                    Diag.error("Cannot parse Entry/Times/LastAccessTime as Date")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: "Entry/Times/LastAccessTime",
-                        value: tag.value)
-                }
-                lastAccessTime = time
-            case Xml2.expiryTime:
-                guard let tagValue = tag.value else {
-                    Diag.warning("Entry/Times/ExpiryTime is nil")
-                    optionalExpiryTime = nil 
-                    continue
-                }
-                guard let time = timeParser(tagValue) else {
-                    Diag.error("Cannot parse Entry/Times/ExpiryTime as Date")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: "Entry/Times/ExpiryTime",
-                        value: tagValue)
-                }
-                optionalExpiryTime = time
-            case Xml2.expires:
-                self.canExpire = Bool(string: tag.value)
-            case Xml2.usageCount:
-                usageCount = UInt32(tag.value) ?? 0
-            case Xml2.locationChanged:
-                guard let time = timeParser(tag.value) else {
-                    Diag.error("Cannot parse Entry/Times/LocationChanged as Date")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: "Entry/Times/LocationChanged",
-                        value: tag.value)
-                }
-                locationChangedTime = time
-            default:
-                Diag.error("Unexpected XML tag in Entry/Times: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Entry/Times/*")
-            }
-        }
-
-        if let expiryTime = optionalExpiryTime {
-            self.expiryTime = expiryTime
-        } else {
-            if canExpire {
-                Diag.error("Parsed an entry that can expire, but Entry/Times/ExpiryTime is nil")
-                throw Xml2.ParsingError.malformedValue(
-                    tag: "Entry/Times/ExpiryTime",
-                    value: nil)
-            } else {
-                self.expiryTime = Date.distantFuture
-            }
-        }
-    }
-
-    func loadHistory(
-        xml: AEXMLElement,
-        formatVersion: Database2.FormatVersion,
-        streamCipher: StreamCipher,
-        timeParser: Database2.XMLTimeParser,
-        warnings: DatabaseLoadingWarnings
-    ) throws {
-        assert(xml.name == Xml2.history)
-        Diag.verbose("Loading XML: entry history")
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.entry:
-                let histEntry = Entry2(database: database)
-                try histEntry.load(
-                    xml: tag,
-                    formatVersion: formatVersion,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    warnings: warnings
-                ) 
-                history.append(histEntry)
-                Diag.verbose("Entry history item loaded OK")
-            default:
-                Diag.error("Unexpected XML tag in Entry/History: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Entry/History/*")
-            }
-        }
-    }
-
     func toXml(
         formatVersion: Database2.FormatVersion,
         streamCipher: StreamCipher,
@@ -45,57 +45,6 @@ public class EntryField2: EntryField {
 }
 
 extension EntryField2 {
-    func load(xml: AEXMLElement, streamCipher: StreamCipher) throws {
-        assert(xml.name == Xml2.string)
-        Diag.verbose("Loading XML: entry field")
-        erase()
-
-        var key: String?
-        var value: String? = ""
-        var isProtected: Bool = false
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.key:
-                key = tag.value ?? ""
-            case Xml2.value:
-                isProtected = Bool(string: tag.attributes[Xml2.protected])
-                if isProtected {
-                    if let encData = ByteArray(base64Encoded: tag.value ?? "") {
-                        Diag.verbose("Decrypting field value")
-                        let plainData = try streamCipher.decrypt(data: encData, progress: nil)
-                        value = plainData.toString(using: .utf8)
-                        if value == nil {
-                            Diag.warning("Failed to decrypt field value")
-                            if Diag.isDeepDebugMode() {
-                                Diag.debug("Encrypted field value: `\(encData.asHexString)`")
-                                Diag.debug("Decrypted field value: `\(plainData.asHexString)`")
-                            }
-                        }
-                    }
-                } else {
-                    value = tag.value ?? ""
-                }
-            default:
-                Diag.error("Unexpected XML tag in Entry/String: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Entry/String/*")
-            }
-        }
-        guard let _key = key else {
-            Diag.error("Missing Entry/String/Key")
-            throw Xml2.ParsingError.malformedValue(tag: "Entry/String/Key", value: nil)
-        }
-        guard let _value = value else {
-            Diag.error("Missing Entry/String/Value")
-            throw Xml2.ParsingError.malformedValue(tag: "Entry/String/Value", value: nil)
-        }
-        if _key.isEmpty && _value.isNotEmpty {
-            Diag.error("Missing Entry/String/Key with present Value")
-        }
-        self.name = _key
-        self.value = _value
-        self.isProtected = isProtected
-    }
-
     func toXml(streamCipher: StreamCipher) throws -> AEXMLElement {
         Diag.verbose("Generating XML: entry string")
         let xmlField = AEXMLElement(name: Xml2.string)
@@ -154,104 +154,6 @@ public class Group2: Group {
 }
 
 extension Group2 {
-    func load(
-        xml: AEXMLElement,
-        formatVersion: Database2.FormatVersion,
-        streamCipher: StreamCipher,
-        timeParser: Database2.XMLTimeParser,
-        warnings: DatabaseLoadingWarnings
-    ) throws {
-        assert(xml.name == Xml2.group)
-        Diag.verbose("Loading XML: group")
-
-        let parent = self.parent
-        erase()
-        self.parent = parent
-
-        let db2: Database2 = database as! Database2
-        let meta: Meta2 = db2.meta
-        var isRecycleBin = false
-
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.uuid:
-                self.uuid = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-                if uuid == meta.recycleBinGroupUUID && meta.isRecycleBinEnabled {
-                    Diag.verbose("Is a backup group")
-                    isRecycleBin = true
-                }
-            case Xml2.name:
-                self.name = tag.value ?? ""
-            case Xml2.notes:
-                self.notes = tag.value ?? ""
-            case Xml2.iconID:
-                if let iconID = IconID(tag.value) {
-                    self.iconID = iconID
-                } else {
-                    self.iconID = isExpanded ? Group.defaultOpenIconID : Group.defaultIconID
-                }
-            case Xml2.customIconUUID:
-                self.customIconUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.times:
-                try loadTimes(xml: tag, timeParser: timeParser)
-                Diag.verbose("Group times loaded OK")
-            case Xml2.isExpanded:
-                self.isExpanded = Bool(string: tag.value)
-            case Xml2.defaultAutoTypeSequence:
-                self.defaultAutoTypeSequence = tag.value ?? ""
-            case Xml2.enableAutoType:
-                self.isAutoTypeEnabled = Bool(optString: tag.value) // value can be "True"/"False"/"null"
-            case Xml2.enableSearching:
-                self.isSearchingEnabled = Bool(optString: tag.value) // value can be "True"/"False"/"null"
-            case Xml2.lastTopVisibleEntry:
-                self.lastTopVisibleEntryUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.previousParentGroup:
-                assert(formatVersion.supports(.previousParentGroup))
-                self.previousParentGroupUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.tags:
-                assert(formatVersion.supports(.groupTags))
-                self.tags = parseItemTags(xml: tag)
-            case Xml2.customData:
-                assert(formatVersion.supports(.customData))
-                try customData.load(
-                    xml: tag,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    xmlParentName: "Group"
-                )
-                Diag.verbose("Custom data loaded OK")
-            case Xml2.group:
-                let subGroup = Group2(database: database)
-                try subGroup.load(
-                    xml: tag,
-                    formatVersion: formatVersion,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    warnings: warnings
-                ) 
-                self.add(group: subGroup)
-                Diag.verbose("Subgroup loaded OK")
-            case Xml2.entry:
-                let entry = Entry2(database: database)
-                try entry.load(
-                    xml: tag,
-                    formatVersion: formatVersion,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    warnings: warnings
-                ) 
-                self.add(entry: entry)
-                Diag.verbose("Entry loaded OK")
-            default:
-                Diag.error("Unexpected XML tag in Group: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Group/*")
-            }
-        }
-        if isRecycleBin {
-            deepSetDeleted(true)
-        }
-    }
-
     private func parseTimestamp(
         value: String?,
         tag: String,
@@ -271,58 +173,15 @@ extension Group2 {
         return time
     }
 
-    func loadTimes(xml: AEXMLElement, timeParser: Database2.XMLTimeParser) throws {
-        assert(xml.name == Xml2.times)
-        Diag.verbose("Loading XML: group times")
-
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.lastModificationTime:
-                lastModificationTime = try parseTimestamp(
-                    value: tag.value,
-                    tag: "Group/Times/LastModificationTime",
-                    fallbackToEpoch: true,
-                    timeParser: timeParser)
-            case Xml2.creationTime:
-                creationTime = try parseTimestamp(
-                    value: tag.value,
-                    tag: "Group/Times/CreationTime",
-                    fallbackToEpoch: true,
-                    timeParser: timeParser)
-            case Xml2.lastAccessTime:
-                lastAccessTime = try parseTimestamp(
-                    value: tag.value,
-                    tag: "Group/Times/LastAccessTime",
-                    fallbackToEpoch: true,
-                    timeParser: timeParser)
-            case Xml2.expiryTime:
-                expiryTime = try parseTimestamp(
-                    value: tag.value,
-                    tag: "Group/Times/ExpiryTime",
-                    fallbackToEpoch: true,
-                    timeParser: timeParser)
-            case Xml2.expires:
-                canExpire = Bool(string: tag.value)
-            case Xml2.usageCount:
-                usageCount = UInt32(tag.value) ?? 0
-            case Xml2.locationChanged:
-                locationChangedTime = try parseTimestamp(
-                    value: tag.value,
-                    tag: "Group/Times/LocationChanged",
-                    fallbackToEpoch: true,
-                    timeParser: timeParser)
-            default:
-                Diag.error("Unexpected XML tag in Group/Times: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Group/Times/*")
-            }
-        }
-    }
-
-    func toXml(
+    /// Writes the group and its subtree, one entry at a time,
+    /// so the XML of the whole tree is never kept in memory.
+    func write(
+        to xmlWriter: XMLStreamWriter,
+        depth: Int,
         formatVersion: Database2.FormatVersion,
         streamCipher: StreamCipher,
         timeFormatter: Database2.XMLTimeFormatter
-    ) throws -> AEXMLElement {
+    ) throws {
         Diag.verbose("Generating XML: group")
         let xmlGroup = AEXMLElement(name: Xml2.group)
         xmlGroup.addChild(name: Xml2.uuid, value: uuid.base64EncodedString())
@@ -403,6 +262,7 @@ extension Group2 {
             xmlGroup.addChild(customData.toXml(timeFormatter: timeFormatter))
         }
 
+        try xmlWriter.writeStart(element: xmlGroup, depth: depth)
         for entry in entries {
             let entry2 = entry as! Entry2
             let entryXML = try entry2.toXml(
@@ -410,18 +270,19 @@ extension Group2 {
                 streamCipher: streamCipher,
                 timeFormatter: timeFormatter
             ) 
-            xmlGroup.addChild(entryXML)
+            try xmlWriter.write(element: entryXML, depth: depth + 1)
         }
 
         for group in groups {
             let group2 = group as! Group2
-            let groupXML = try group2.toXml(
+            try group2.write(
+                to: xmlWriter,
+                depth: depth + 1,
                 formatVersion: formatVersion,
                 streamCipher: streamCipher,
                 timeFormatter: timeFormatter)
-            xmlGroup.addChild(groupXML)
         }
-        return xmlGroup
+        try xmlWriter.writeEnd(element: xmlGroup, depth: depth)
     }
 }
 
@@ -253,6 +253,24 @@ final class Header2: Eraseable {
         initialized = true
     }
 
+    func loadDefaultValuesV3() {
+        self.formatVersion = .v3
+        applyEncryptionSettings(settings: EncryptionSettings(
+            dataCipher: .aes,
+            kdf: .aesKdf,
+            iterations: AESKDF.defaultIterations,
+            memory: 0,
+            parallelism: 0
+        ))
+        innerStreamAlgorithm = .Salsa20
+        fields[.publicCustomData] = nil
+        initialized = true
+    }
+
+    func setCompression(_ algorithm: CompressionAlgorithm) {
+        fields[.compressionFlags] = UInt32(algorithm.rawValue).data
+    }
+
     func applyEncryptionSettings(settings: EncryptionSettings) {
         dataCipher = settings.dataCipher.cipher
         fields[.cipherID] = dataCipher.uuid.data
@@ -0,0 +1,137 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+import zlib
+
+final class KDBXStreamWriter {
+    private final class Sink {
+        let outStream: ByteArray.OutputStream
+        let progress: ProgressEx
+
+        init(outStream: ByteArray.OutputStream, progress: ProgressEx) {
+            self.outStream = outStream
+            self.progress = progress
+        }
+    }
+
+    private let writer: OpaquePointer
+    private let sink: Sink
+    private let stats: UnsafeMutablePointer<crypto_stats>
+
+    var bytesIn: UInt64 { kdbx_writer_bytes_in(writer) }
+    var bytesOut: UInt64 { kdbx_writer_bytes_out(writer) }
+
+    static func isSupported(cipher: DataCipher) -> Bool {
+        return nativeCipherID(for: cipher) != nil
+    }
+
+    private static func nativeCipherID(for cipher: DataCipher) -> kdbx_cipher_id? {
+        switch cipher {
+        case is AESDataCipher:
+            return KDBX_CIPHER_AES256_CBC
+        case is ChaCha20DataCipher:
+            return KDBX_CIPHER_CHACHA20
+        case is TwofishDataCipher:
+            return KDBX_CIPHER_TWOFISH_CBC
+        default:
+            return nil
+        }
+    }
+
+    init(
+        cipher: DataCipher,
+        key: SecureBytes,
+        iv: ByteArray,
+        hmacKey: SecureBytes,
+        compress: Bool,
+        outStream: ByteArray.OutputStream,
+        progress: ProgressEx
+    ) throws {
+        guard let cipherID = Self.nativeCipherID(for: cipher) else {
+            Diag.error("Cipher is not supported by the stream writer [name: \(cipher.name)]")
+            throw CryptoError.aesInitError(code: Int(KDBX_WRITER_INVALID_PARAMETER.rawValue))
+        }
+        let sink = Sink(outStream: outStream, progress: progress)
+        let sinkObject = UnsafeRawPointer(Unmanaged.passUnretained(sink).toOpaque())
+        let outputCallback: kdbx_writer_output_fptr = { bytes, length, userObject -> Int32 in
+            guard let bytes, let userObject else { return 1 /* stop */ }
+            let sink = Unmanaged<Sink>.fromOpaque(userObject).takeUnretainedValue()
+            if sink.progress.isCancelled {
+                return 1
+            }
+            sink.outStream.write(bytes: bytes, count: length)
+            return 0
+        }
+
+        let writer = key.withDecryptedBytes { keyBytes in
+            hmacKey.withDecryptedBytes { hmacKeyBytes in
+                iv.withBytes { ivBytes in
+                    kdbx_writer_create(
+                        cipherID,
+                        keyBytes, ivBytes, ivBytes.count,
+                        hmacKeyBytes,
+                        compress ? 1 : 0,
+                        outputCallback,
+                        sinkObject)
+                }
+            }
+        }
+        guard let writer else {
+            Diag.error("Failed to create stream writer")
+            throw CryptoError.aesInitError(code: Int(KDBX_WRITER_INVALID_PARAMETER.rawValue))
+        }
+        self.writer = writer
+        self.sink = sink
+        self.stats = UnsafeMutablePointer<crypto_stats>.allocate(capacity: 1)
+        self.stats.initialize(to: crypto_stats())
+        kdbx_writer_set_stats(writer, stats)
+    }
+
+    deinit {
+        kdbx_writer_destroy(writer)
+        stats.deallocate()
+    }
+
+    func write(data: ByteArray) throws {
+        let status = data.withBytes { bytes in
+            kdbx_writer_write(writer, bytes, bytes.count)
+        }
+        try check(status)
+    }
+
+    func write(bytes: UnsafeRawBufferPointer) throws {
+        guard let baseAddress = bytes.baseAddress, bytes.count > 0 else { return }
+        let status = kdbx_writer_write(
+            writer,
+            baseAddress.assumingMemoryBound(to: UInt8.self),
+            bytes.count)
+        try check(status)
+    }
+
+    func finish() throws {
+        try check(kdbx_writer_finish(writer))
+        Diag.debug("Stream writer done [\(CryptoInstrumentation.describe(stats.pointee))]")
+    }
+
+    private func check(_ status: Int32) throws {
+        switch kdbx_writer_status(rawValue: status) {
+        case KDBX_WRITER_OK:
+            return
+        case KDBX_WRITER_INTERRUPTED:
+            throw ProgressInterruption.cancelled(reason: sink.progress.cancellationReason)
+        case KDBX_WRITER_COMPRESSION_ERROR:
+            throw GzipError(code: Z_STREAM_ERROR, msg: nil)
+        case KDBX_WRITER_CIPHER_ERROR:
+            throw CryptoError.aesEncryptError(code: Int(status))
+        default:
+            Diag.error("Stream writer failed [status: \(status)]")
+            throw CryptoError.aesEncryptError(code: Int(status))
+        }
+    }
+}
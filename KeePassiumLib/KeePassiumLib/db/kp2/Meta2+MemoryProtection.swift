@@ -27,32 +27,6 @@ extension Meta2 {
 }
 
 extension Meta2.MemoryProtection {
-    func load(xml: AEXMLElement) throws {
-        assert(xml.name == Xml2.memoryProtection)
-        Diag.verbose("Loading XML: memory protection")
-
-        erase()
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.protectTitle:
-                isProtectTitle = Bool(string: tag.value)
-            case Xml2.protectUserName:
-                isProtectUserName = Bool(string: tag.value)
-            case Xml2.protectPassword:
-                isProtectPassword = Bool(string: tag.value)
-            case Xml2.protectURL:
-                isProtectURL = Bool(string: tag.value)
-            case Xml2.protectNotes:
-                isProtectNotes = Bool(string: tag.value)
-            default:
-                Diag.error("Unexpected XML tag in Meta/MemoryProtection: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(
-                    actual: tag.name,
-                    expected: "Meta/MemoryProtection/*")
-            }
-        }
-    }
-
     func toXml() -> AEXMLElement {
         Diag.verbose("Generating XML: memory protection")
         let xmlMP = AEXMLElement(name: Xml2.memoryProtection)
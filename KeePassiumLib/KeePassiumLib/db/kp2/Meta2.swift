@@ -42,6 +42,17 @@ final class Meta2: Eraseable {
     private(set) var lastTopVisibleGroupUUID: UUID
     private(set) var customData: CustomData2
     private(set) var customIcons: [CustomIcon2]
+    private var customIconIndexCache: CustomIconIndex?
+
+    /// Index of `customIcons`, built on first use and then updated along with the list.
+    var customIconIndex: CustomIconIndex {
+        if let customIconIndexCache {
+            return customIconIndexCache
+        }
+        let index = CustomIconIndex(customIcons)
+        customIconIndexCache = index
+        return index
+    }
 
     init(database: Database2) {
         self.database = database
@@ -104,6 +115,7 @@ final class Meta2: Eraseable {
         lastSelectedGroupUUID.erase()
         lastTopVisibleGroupUUID.erase()
         customData.erase()
+        customIconIndexCache = nil
         customIcons.erase()
     }
 
@@ -286,167 +298,17 @@ final class Meta2: Eraseable {
 
     func addCustomIcon(_ icon: CustomIcon2) {
         customIcons.append(icon)
+        customIconIndexCache?.insert(icon)
     }
 
     func deleteCustomIcon(uuid: UUID) {
-        customIcons.removeAll(where: { $0.uuid == uuid })
-    }
-}
-
-extension Meta2 {
-
-    func load(
-        xml: AEXMLElement,
-        formatVersion: Database2.FormatVersion,
-        streamCipher: StreamCipher,
-        timeParser: Database2.XMLTimeParser,
-        warnings: DatabaseLoadingWarnings
-    ) throws {
-        assert(xml.name == Xml2.meta)
-        Diag.verbose("Loading XML: meta")
-        erase()
-
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.generator:
-                self.generator = tag.value ?? ""
-                warnings.databaseGenerator = tag.value 
-                Diag.info("Database was last edited by: \(generator)")
-            case Xml2.settingsChanged: 
-                guard formatVersion >= .v4 else {
-                    Diag.error("Found \(tag.name) tag in non-V4 database")
-                    throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: nil)
-                }
-                self.settingsChangedTime = timeParser(tag.value) ?? Date.now
-            case Xml2.headerHash:
-                guard formatVersion == .v3 else {
-                    Diag.warning("Found \(tag.name) tag in non-V3 database. Ignoring")
-                    continue
-                }
-                self.headerHash = ByteArray(base64Encoded: tag.value) 
-            case Xml2.databaseName:
-                self.databaseName = tag.value ?? ""
-            case Xml2.databaseNameChanged:
-                self.databaseNameChangedTime = timeParser(tag.value) ?? Date.now
-            case Xml2.databaseDescription:
-                self.databaseDescription = tag.value ?? ""
-            case Xml2.databaseDescriptionChanged:
-                self.databaseDescriptionChangedTime =
-                    timeParser(tag.value) ?? Date.now
-            case Xml2.defaultUserName:
-                self.defaultUserName = tag.value ?? ""
-            case Xml2.defaultUserNameChanged:
-                self.defaultUserNameChangedTime = timeParser(tag.value) ?? Date.now
-            case Xml2.maintenanceHistoryDays:
-                self.maintenanceHistoryDays =
-                    UInt32(tag.value) ?? Meta2.defaultMaintenanceHistoryDays
-            case Xml2.color:
-                self.colorString = tag.value ?? ""
-            case Xml2.masterKeyChanged:
-                self.masterKeyChangedTime = timeParser(tag.value) ?? Date.now
-            case Xml2.masterKeyChangeRec:
-                self.masterKeyChangeRec = Int64(tag.value) ?? -1
-            case Xml2.masterKeyChangeForce:
-                self.masterKeyChangeForce = Int64(tag.value) ?? -1
-            case Xml2.masterKeyChangeForceOnce:
-                self.masterKeyChangeForceOnce = Bool(string: tag.value)
-            case Xml2.memoryProtection:
-                try memoryProtection.load(xml: tag)
-                Diag.verbose("Memory protection loaded OK")
-            case Xml2.customIcons:
-                try loadCustomIcons(xml: tag, timeParser: timeParser)
-                Diag.verbose("Custom icons loaded OK [count: \(customIcons.count)]")
-            case Xml2.recycleBinEnabled:
-                self.isRecycleBinEnabled = Bool(string: tag.value)
-            case Xml2.recycleBinUUID:
-                self.recycleBinGroupUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.recycleBinChanged:
-                self.recycleBinChangedTime = timeParser(tag.value) ?? Date.now
-            case Xml2.entryTemplatesGroup:
-                self.entryTemplatesGroupUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.entryTemplatesGroupChanged:
-                self.entryTemplatesGroupChangedTime =
-                    timeParser(tag.value) ?? Date.now
-            case Xml2.historyMaxItems:
-                self.historyMaxItems = Int32(tag.value) ?? -1
-            case Xml2.historyMaxSize:
-                self.historyMaxSize = Int64(tag.value) ?? -1
-            case Xml2.lastSelectedGroup:
-                self.lastSelectedGroupUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.lastTopVisibleGroup:
-                self.lastTopVisibleGroupUUID = UUID(base64Encoded: tag.value) ?? UUID.ZERO
-            case Xml2.binaries:
-                try loadBinaries(xml: tag, formatVersion: formatVersion, streamCipher: streamCipher)
-                Diag.verbose("Binaries loaded OK [count: \(database.binaries.count)]")
-            case Xml2.customData:
-                try customData.load(
-                    xml: tag,
-                    streamCipher: streamCipher,
-                    timeParser: timeParser,
-                    xmlParentName: "Meta"
-                ) 
-                Diag.verbose("Custom data loaded OK [count: \(customData.count)]")
-            default:
-                Diag.error("Unexpected XML tag in Meta: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Meta/*")
-            }
-        }
+        deleteCustomIcons(uuids: [uuid])
     }
 
-    func loadCustomIcons(xml: AEXMLElement, timeParser: Database2.XMLTimeParser) throws {
-        assert(xml.name == Xml2.customIcons)
-        Diag.verbose("Loading XML: custom icons")
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.icon:
-                let icon = CustomIcon2()
-                try icon.load(xml: tag, timeParser: timeParser) 
-                customIcons.append(icon)
-                Diag.verbose("Custom icon loaded OK")
-            default:
-                Diag.error("Unexpected XML tag in Meta/CustomIcons: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(
-                    actual: tag.name,
-                    expected: "Meta/CustomIcons/*")
-            }
-        }
-    }
-
-    func loadBinaries(
-        xml: AEXMLElement,
-        formatVersion: Database2.FormatVersion,
-        streamCipher: StreamCipher
-    ) throws {
-        assert(xml.name == Xml2.binaries)
-        Diag.verbose("Loading XML: meta binaries")
-        guard formatVersion == .v3 else {
-            if let tag = xml.children.first {
-                Diag.error("Unexpected XML content in V4 Meta/Binaries: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: nil)
-            } else {
-                Diag.warning("Found empty Meta/Binaries in a V4 database, ignoring.")
-            }
-            return
-        }
-
-        database.binaries.removeAll()
-        for tag in xml.children {
-            switch tag.name {
-            case Xml2.binary:
-                let binary = try Binary2.load(xml: tag, streamCipher: streamCipher)
-
-                if let conflictingBinary = database.binaries[binary.id] {
-                    Diag.error("Multiple Meta/Binary items with the same ID: \(conflictingBinary.id)")
-                    throw Xml2.ParsingError.malformedValue(
-                        tag: tag.name,
-                        value: String(conflictingBinary.id))
-                }
-                database.binaries[binary.id] = binary
-                Diag.verbose("Binary loaded OK")
-            default:
-                Diag.error("Unexpected XML tag in Meta/Binaries: \(tag.name)")
-                throw Xml2.ParsingError.unexpectedTag(actual: tag.name, expected: "Meta/Binaries/*")
-            }
+    func deleteCustomIcons(uuids: Set<UUID>) {
+        customIcons.removeAll(where: { uuids.contains($0.uuid) })
+        if let customIconIndexCache {
+            uuids.forEach { customIconIndexCache.remove(uuid: $0) }
         }
     }
 }
@@ -550,7 +412,7 @@ extension Meta2 {
             Diag.verbose("Loading XML: custom icons")
         case (Xml2.icon, .start):
             try CustomIcon2.readFromXML(xml) { [unowned self] icon in
-                customIcons.append(icon)
+                addCustomIcon(icon)
             }
         case (Xml2.customIcons, .end):
             Diag.verbose("Custom icons loaded OK [count: \(customIcons.count)]")
@@ -13,11 +13,6 @@ public protocol Taggable {
 }
 
 extension Taggable {
-    func parseItemTags(xml element: AEXMLElement) -> [String] {
-        assert(element.name == Xml2.tags)
-        return TagHelper.stringToTags(element.value)
-    }
-
     func itemTagsToString(_ tags: [String]) -> String {
         return TagHelper.tagsToString(tags)
     }
@@ -0,0 +1,135 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+final class Xml2DocumentReader<DocumentContext: XMLDocumentContext> {
+    private let xmlData: ByteArray
+    private let readers: XMLReaderStack<DocumentContext>
+    private var elementNames = [String?]()
+    private var isFailed = false
+
+    init(xmlData: ByteArray, documentContext: DocumentContext) {
+        self.xmlData = xmlData
+        self.readers = XMLReaderStack(documentContext: documentContext)
+    }
+
+    deinit {
+        if !isFailed {
+            assert(readers.isEmpty, "Some XML readers left in the stack: imbalanced pushReader/popReader calls?")
+        }
+        readers.removeAll()
+    }
+
+    public func pushReader(_ reader: @escaping XMLReader<DocumentContext>, context: XMLReaderContext?) {
+        readers.push(reader, context: context)
+    }
+
+    public func popReader() {
+        readers.pop()
+    }
+
+    public func parse() throws {
+        assert(!readers.isEmpty, "Push at least one reader before parsing.")
+        do {
+            try xmlData.withMutableBytes { bytes in
+                try bytes.withUnsafeMutableBufferPointer { buffer in
+                    guard let reader = kdbx_xml_reader_create(buffer.baseAddress, buffer.count) else {
+                        Diag.error("Failed to create XML reader")
+                        throw Xml2.ParsingError.xmlError(details: "Out of memory")
+                    }
+                    defer { kdbx_xml_reader_destroy(reader) }
+                    try parse(reader)
+                }
+            }
+        } catch {
+            isFailed = true
+            throw error
+        }
+    }
+
+    private func parse(_ reader: OpaquePointer) throws {
+        while true {
+            let status = kdbx_xml_reader_next(reader)
+            guard status >= 0 else {
+                let line = kdbx_xml_reader_line(reader)
+                let details = describeError(status, line: line)
+                Diag.error("XML parsing error: \(details)")
+                throw Xml2.ParsingError.xmlError(details: details)
+            }
+            switch kdbx_xml_event(rawValue: UInt32(status)) {
+            case KDBX_XML_START:
+                try readers.dispatch(
+                    .start,
+                    elementName(reader),
+                    value: nil,
+                    attributes: attributes(reader))
+            case KDBX_XML_END:
+                try readers.dispatch(
+                    .end,
+                    elementName(reader),
+                    value: string(from: kdbx_xml_reader_value(reader)),
+                    attributes: attributes(reader))
+            default:
+                return
+            }
+        }
+    }
+
+    private func elementName(_ reader: OpaquePointer) -> String {
+        let nameID = Int(kdbx_xml_reader_name_id(reader))
+        if nameID < elementNames.count, let name = elementNames[nameID] {
+            return name
+        }
+        let name = string(from: kdbx_xml_reader_name_for_id(reader, UInt32(nameID))) ?? ""
+        if nameID >= elementNames.count {
+            elementNames.append(contentsOf: repeatElement(nil, count: nameID - elementNames.count + 1))
+        }
+        elementNames[nameID] = name
+        return name
+    }
+
+    private func attributes(_ reader: OpaquePointer) -> [String: String] {
+        let count = kdbx_xml_reader_attribute_count(reader)
+        guard count > 0 else {
+            return [:]
+        }
+        var result = [String: String](minimumCapacity: count)
+        for index in 0..<count {
+            let name = string(from: kdbx_xml_reader_attribute_name(reader, index)) ?? ""
+            result[name] = string(from: kdbx_xml_reader_attribute_value(reader, index)) ?? ""
+        }
+        return result
+    }
+
+    private func string(from slice: kdbx_xml_slice) -> String? {
+        guard let bytes = slice.bytes else {
+            return nil
+        }
+        return String(decoding: UnsafeBufferPointer(start: bytes, count: slice.length), as: UTF8.self)
+    }
+
+    private func describeError(_ status: Int32, line: Int) -> String {
+        let reason: String
+        switch kdbx_xml_error(rawValue: status) {
+        case KDBX_XML_ERROR_UNEXPECTED_END:
+            reason = "Unexpected end of document"
+        case KDBX_XML_ERROR_TAG_MISMATCH:
+            reason = "Mismatched closing tag"
+        case KDBX_XML_ERROR_ENTITY:
+            reason = "Invalid entity reference"
+        case KDBX_XML_ERROR_UNSUPPORTED:
+            reason = "Unsupported markup declaration"
+        case KDBX_XML_ERROR_MEMORY:
+            reason = "Out of memory"
+        default:
+            reason = "Syntax error"
+        }
+        return "\(reason) (line \(line))"
+    }
+}
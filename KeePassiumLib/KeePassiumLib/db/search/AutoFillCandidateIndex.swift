@@ -0,0 +1,223 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import DomainParser
+import Foundation
+
+/// Finds entries that may be relevant to an AutoFill request,
+/// without parsing the URLs of all the entries on each request.
+///
+/// Entry URLs are parsed once; their full URL, host, registrable domain and service name
+/// are linked to the entry (`domain_index`). Titles, notes and custom field values are
+/// kept pre-folded (`search_arena`), for the substring part of AutoFill scoring.
+/// Only raw unprotected values are indexed. Entries with protected fields or references
+/// are always included, since their values are not in the index.
+///
+/// The result is a superset of entries with non-zero similarity, the scoring remains with the caller.
+internal final class AutoFillCandidateIndex {
+    private enum KeyKind: String {
+        case url = "u:"
+        case host = "h:"
+        case domain = "d:"
+        case service = "s:"
+    }
+
+    private let index: OpaquePointer
+    private let arena: OpaquePointer
+    private var entries = [Entry]()
+    private var alwaysIncluded = [UInt32]()
+
+    init?(root: Group) {
+        guard let index = domain_index_create() else {
+            Diag.error("Failed to create domain index")
+            return nil
+        }
+        guard let arena = search_arena_create() else {
+            Diag.error("Failed to create search arena")
+            domain_index_destroy(index)
+            return nil
+        }
+        self.index = index
+        self.arena = arena
+
+        var allEntries = [Entry]()
+        root.collectAllEntries(to: &allEntries)
+        for entry in allEntries {
+            guard add(entry) else {
+                Diag.warning("Failed to build AutoFill index")
+                return nil
+            }
+        }
+        Diag.debug("AutoFill index ready [entries: \(entries.count), keys: \(domain_index_key_count(index))]")
+    }
+
+    deinit {
+        domain_index_destroy(index)
+        search_arena_destroy(arena)
+    }
+
+    /// Candidates for `.URL` service identifiers.
+    func candidates(url: URL, parsedHost: ParsedHost?) -> [Entry] {
+        var found = Set(alwaysIncluded)
+        lookUp(.url, url.absoluteString, into: &found)
+        if let host = url.host?.localizedLowercase {
+            lookUp(.host, host, into: &found)
+        }
+        if let domain = parsedHost?.domain {
+            lookUp(.domain, domain, into: &found)
+        }
+        let serviceName = parsedHost?.serviceName.map { String($0) }
+        if let serviceName {
+            lookUp(.service, serviceName, into: &found)
+        }
+
+        // The service name is a part of the domain, which is a part of the host.
+        let textNeedle = serviceName.flatMap { $0.isEmpty ? nil : $0 } ?? parsedHost?.domain ?? url.host
+        if let textNeedle {
+            findText(textNeedle, into: &found)
+        }
+        findText(url.absoluteString, into: &found)
+        return makeEntries(found)
+    }
+
+    /// Candidates for `.domain` service identifiers.
+    func candidates(mainDomain: String) -> [Entry] {
+        var found = Set(alwaysIncluded)
+        lookUp(.host, mainDomain, into: &found)
+        lookUp(.domain, mainDomain, into: &found)
+        findText(mainDomain, into: &found)
+        return makeEntries(found)
+    }
+
+    private func add(_ entry: Entry) -> Bool {
+        let documentID = UInt32(entries.count)
+        guard search_arena_begin_document(arena) == documentID else {
+            return false
+        }
+        entries.append(entry)
+
+        var isAlwaysIncluded = false
+        var urlStrings = [String]()
+        if let entry2 = entry as? Entry2 {
+            urlStrings.append(entry2.overrideURL)
+        }
+        var isOK = true
+        for field in entry.fields {
+            let isIndexed = !field.isStandardField
+                || field.name == EntryField.title
+                || field.name == EntryField.url
+                || field.name == EntryField.notes
+            guard isIndexed, field.value.isNotEmpty else { continue }
+
+            // Protected values are never copied; resolved values might come from protected ones.
+            if field.isProtected || EntryFieldReference.mayContainReferences(field.value) {
+                isAlwaysIncluded = true
+            }
+            if field.isProtected {
+                continue
+            }
+            if field.name == EntryField.url {
+                urlStrings.append(field.value)
+            } else {
+                isOK = isOK && addText(field.value)
+            }
+        }
+        if isAlwaysIncluded {
+            alwaysIncluded.append(documentID)
+        }
+
+        for urlString in urlStrings where urlString.isNotEmpty {
+            guard let url = URL.from(malformedString: urlString) else { continue }
+            isOK = isOK && link(.url, url.absoluteString, to: documentID)
+            guard let host = url.host?.localizedLowercase else { continue }
+            isOK = isOK && link(.host, host, to: documentID)
+            guard let parsedHost = DomainNameHelper.shared.parse(host: host) else { continue }
+            if let domain = parsedHost.domain {
+                isOK = isOK && link(.domain, domain, to: documentID)
+            }
+            if let serviceName = parsedHost.serviceName {
+                isOK = isOK && link(.service, String(serviceName), to: documentID)
+            }
+        }
+        return isOK
+    }
+
+    private func link(_ kind: KeyKind, _ value: String, to documentID: UInt32) -> Bool {
+        var key = kind.rawValue + value
+        let status = key.withUTF8 { buffer in
+            domain_index_add(index, buffer.baseAddress, buffer.count, documentID)
+        }
+        return status == 0
+    }
+
+    private func addText(_ text: String) -> Bool {
+        guard text.isNotEmpty else { return true }
+        var folded = SearchIndex.fold(text)
+        let status = folded.withUTF8 { buffer in
+            search_arena_add_text(arena, buffer.baseAddress, buffer.count)
+        }
+        return status == 0
+    }
+
+    private func lookUp(_ kind: KeyKind, _ value: String, into found: inout Set<UInt32>) {
+        var key = kind.rawValue + value
+        key.withUTF8 { buffer in
+            var docs: UnsafePointer<UInt32>?
+            let count = domain_index_lookup(index, buffer.baseAddress, buffer.count, &docs)
+            if let docs {
+                found.formUnion(UnsafeBufferPointer(start: docs, count: count))
+            }
+        }
+    }
+
+    private func findText(_ text: String, into found: inout Set<UInt32>) {
+        var needle = SearchIndex.fold(text)
+        guard needle.isNotEmpty, !entries.isEmpty else { return }
+        var result = [UInt32](repeating: 0, count: entries.count)
+        let count = needle.withUTF8 { buffer -> Int in
+            var word = buffer.baseAddress
+            var length = buffer.count
+            return search_arena_query(arena, &word, &length, 1, nil, 0, &result)
+        }
+        if count >= 0 {
+            found.formUnion(result.prefix(count))
+        } else {
+            Diag.warning("AutoFill text lookup failed, including all entries")
+            found.formUnion(0..<UInt32(entries.count))
+        }
+    }
+
+    private func makeEntries(_ documentIDs: Set<UInt32>) -> [Entry] {
+        return documentIDs.sorted().map { entries[Int($0)] }
+    }
+}
+
+extension Database {
+    /// Entries that may be relevant to the AutoFill request for the given URL:
+    /// a superset of those with a matching host, domain, service name, or mentioning them.
+    public func getAutoFillCandidates(url: URL, parsedHost: ParsedHost?) -> [Entry] {
+        if let autoFillIndex = getAutoFillIndex() {
+            return autoFillIndex.candidates(url: url, parsedHost: parsedHost)
+        }
+        return getAllEntries()
+    }
+
+    /// Entries that may be relevant to the AutoFill request for the given registrable domain.
+    public func getAutoFillCandidates(mainDomain: String) -> [Entry] {
+        if let autoFillIndex = getAutoFillIndex() {
+            return autoFillIndex.candidates(mainDomain: mainDomain)
+        }
+        return getAllEntries()
+    }
+
+    private func getAllEntries() -> [Entry] {
+        var allEntries = [Entry]()
+        root?.collectAllEntries(to: &allEntries)
+        return allEntries
+    }
+}
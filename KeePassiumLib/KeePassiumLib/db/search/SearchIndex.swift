@@ -0,0 +1,218 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+/// Narrows down the entries that need to be checked by `Searchable.matches(query:scope:)`.
+///
+/// The index is a superset filter: it only tells which entries certainly
+/// do NOT contain some positive text word, the actual matching stays exact.
+/// Only raw field values are indexed, and protected values are never indexed.
+/// Entries with references are always candidates: their resolved values
+/// can change without the entry itself being modified.
+///
+/// Candidates are first looked up by trigrams (`search_index`), then checked
+/// for the actual substrings in pre-folded copies of entry texts (`search_arena`).
+/// The latter also handles words too short for trigrams.
+internal final class SearchIndex {
+    private static let minFragmentedCount = 1024
+    private static let foldingOptions: String.CompareOptions = [.diacriticInsensitive, .widthInsensitive]
+
+    private let index: OpaquePointer
+    private let arena: OpaquePointer
+    private var isArenaUsable = true
+    private var documentIDs = [ObjectIdentifier: UInt32]()
+    private var documentEntries = ContiguousArray<ObjectIdentifier?>()
+    private var pendingEntries = [ObjectIdentifier: Entry]()
+    private var referringEntries = Set<ObjectIdentifier>()
+
+    init?(root: Group) {
+        guard let index = search_index_create() else {
+            Diag.error("Failed to create search index")
+            return nil
+        }
+        guard let arena = search_arena_create() else {
+            Diag.error("Failed to create search arena")
+            search_index_destroy(index)
+            return nil
+        }
+        self.index = index
+        self.arena = arena
+        root.applyToAllChildren(groupHandler: nil, entryHandler: { [self] entry in
+            add(entry)
+        })
+        Diag.debug("Search index ready [entries: \(documentIDs.count)]")
+    }
+
+    deinit {
+        search_index_destroy(index)
+        search_arena_destroy(arena)
+    }
+
+    /// True when reindexed entries left so much stale data that it is better to rebuild the index.
+    var isFragmented: Bool {
+        let documentCount = documentEntries.count + pendingEntries.count
+        return documentCount > max(2 * documentIDs.count, Self.minFragmentedCount)
+    }
+
+    /// Schedules (re)indexing of the entry before the next query.
+    func markChanged(_ entry: Entry) {
+        pendingEntries[ObjectIdentifier(entry)] = entry
+    }
+
+    /// Returns entries that might match the query,
+    /// or `nil` if the index cannot narrow it down (so all entries must be checked).
+    func candidates(for query: SearchQuery) -> Set<ObjectIdentifier>? {
+        guard !query.fieldScope.contains(.protectedValues),
+              !query.compareOptions.contains(.regularExpression)
+        else {
+            return nil
+        }
+        let words: [String] = query.queryWords.compactMap { word in
+            guard let textWord = word as? SearchQuery.TextWord,
+                  !textWord.isNegated
+            else {
+                return nil
+            }
+            return Self.fold(textWord.text)
+        }.filter { !$0.isEmpty }
+        guard !words.isEmpty else {
+            return nil
+        }
+
+        flushPendingEntries()
+        var found = [UInt32](repeating: 0, count: Int(search_index_document_limit(index)))
+        let wordScalars = words.map { $0.unicodeScalars.map { $0.value } }
+        var foundCount = withArrayOfPointers(wordScalars) { wordPointers, lengths in
+            search_index_query(index, wordPointers, lengths, words.count, &found)
+        }
+        if foundCount == Int(SEARCH_INDEX_ERROR) {
+            Diag.warning("Search index query failed, falling back to full scan")
+            return nil
+        }
+
+        if isArenaUsable {
+            let isRestricted = foundCount != Int(SEARCH_INDEX_UNRESTRICTED)
+            let wordBytes = words.map { Array($0.utf8) }
+            foundCount = withArrayOfPointers(wordBytes) { wordPointers, lengths in
+                found.withUnsafeMutableBufferPointer { foundBuffer in
+                    search_arena_query(
+                        arena,
+                        wordPointers,
+                        lengths,
+                        words.count,
+                        isRestricted ? UnsafePointer(foundBuffer.baseAddress) : nil,
+                        isRestricted ? foundCount : 0,
+                        foundBuffer.baseAddress
+                    )
+                }
+            }
+            if foundCount < 0 {
+                Diag.warning("Search arena query failed, falling back to full scan")
+                return nil
+            }
+        } else if foundCount < 0 {
+            return nil
+        }
+
+        var result = referringEntries
+        result.reserveCapacity(referringEntries.count + foundCount)
+        for documentID in found.prefix(foundCount) {
+            if let entryID = documentEntries[Int(documentID)] {
+                result.insert(entryID)
+            }
+        }
+        return result
+    }
+
+    private func flushPendingEntries() {
+        guard !pendingEntries.isEmpty else {
+            return
+        }
+        for entry in pendingEntries.values {
+            remove(entry)
+            if entry.parent != nil {
+                add(entry)
+            }
+        }
+        pendingEntries.removeAll()
+    }
+
+    private func remove(_ entry: Entry) {
+        let entryID = ObjectIdentifier(entry)
+        referringEntries.remove(entryID)
+        guard let documentID = documentIDs.removeValue(forKey: entryID) else {
+            return
+        }
+        search_index_remove_document(index, documentID)
+        documentEntries[Int(documentID)] = nil
+    }
+
+    private func add(_ entry: Entry) {
+        let entryID = ObjectIdentifier(entry)
+        let documentID = search_index_begin_document(index)
+        assert(documentEntries.count == Int(documentID))
+        documentEntries.append(entryID)
+        documentIDs[entryID] = documentID
+        if isArenaUsable && search_arena_begin_document(arena) != documentID {
+            Diag.warning("Search arena is out of sync, disabling it")
+            isArenaUsable = false
+        }
+
+        for field in entry.fields {
+            if !field.isStandardField {
+                addText(field.name)
+            }
+            if !field.isProtected {
+                addText(field.value)
+                if EntryFieldReference.mayContainReferences(field.value) {
+                    referringEntries.insert(entryID)
+                }
+            }
+        }
+        entry.attachments.forEach { addText($0.name) }
+        entry.tags.forEach { addText($0) }
+    }
+
+    private func addText(_ text: String) {
+        guard !text.isEmpty else { return }
+        let folded = Self.fold(text)
+        let scalars = folded.unicodeScalars.map { $0.value }
+        if search_index_add_text(index, scalars, scalars.count) != 0 {
+            Diag.warning("Failed to index text")
+        }
+        guard isArenaUsable else { return }
+        var utf8 = folded
+        let status = utf8.withUTF8 { buffer in
+            search_arena_add_text(arena, buffer.baseAddress, buffer.count)
+        }
+        if status != 0 {
+            Diag.warning("Failed to add text to search arena, disabling it")
+            isArenaUsable = false
+        }
+    }
+
+    /// Normalizes text so that case- and diacritic-insensitive matches become bytewise ones.
+    static func fold<T: StringProtocol>(_ text: T) -> String {
+        // Upper case expands "ß" and ligatures the same way case-insensitive comparison does
+        return text.folding(options: foldingOptions, locale: Locale.current).uppercased()
+    }
+
+    private func withArrayOfPointers<T, R>(
+        _ arrays: [[T]],
+        _ body: ([UnsafePointer<T>?], [Int]) -> R
+    ) -> R {
+        let buffers = arrays.map { array -> UnsafeMutablePointer<T> in
+            let buffer = UnsafeMutablePointer<T>.allocate(capacity: max(array.count, 1))
+            buffer.initialize(from: array, count: array.count)
+            return buffer
+        }
+        defer { buffers.forEach { $0.deallocate() } }
+        return body(buffers.map { UnsafePointer($0) }, arrays.map { $0.count })
+    }
+}
@@ -0,0 +1,87 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+/// Native HMAC key of a TOTP secret, with the pad states hashed once (see `totp.h`).
+/// The pad states are as sensitive as the secret itself, so each key belongs to one generator
+/// and is wiped together with it.
+final class TOTPHMACKey {
+    let key: OpaquePointer
+
+    private init?(seed: ByteArray, algorithm: TOTPHashAlgorithm) {
+        let key = seed.withBytes { seedBytes in
+            totp_key_create(algorithm.nativeID, seedBytes, seedBytes.count)
+        }
+        guard let key else {
+            return nil
+        }
+        self.key = key
+    }
+
+    deinit {
+        totp_key_destroy(key)
+    }
+
+    /// Prepares a key for the secret, or returns nil if the native code cannot handle it.
+    static func make(seed: ByteArray, algorithm: TOTPHashAlgorithm) -> TOTPHMACKey? {
+        guard let hmacKey = TOTPHMACKey(seed: seed, algorithm: algorithm) else {
+            Diag.warning("Failed to prepare native TOTP key")
+            return nil
+        }
+        return hmacKey
+    }
+
+    func getFullCode(counter: UInt64) -> Int {
+        return Int(totp_key_full_code(key, counter))
+    }
+}
+
+/// Computes codes of many TOTP generators at once, for lists which show lots of them.
+public enum TOTPBatchGenerator {
+    /// Returns the codes of the given generators at the given time, in the same order.
+    public static func generate(_ generators: [TOTPGenerator], at date: Date = .now) -> [String] {
+        var results = [String?](repeating: nil, count: generators.count)
+        var batchIndices = [Int]()
+        var keys = [OpaquePointer?]()
+        var periods = [UInt32]()
+        var digits = [UInt8]()
+        batchIndices.reserveCapacity(generators.count)
+        keys.reserveCapacity(generators.count)
+        periods.reserveCapacity(generators.count)
+        digits.reserveCapacity(generators.count)
+
+        for (index, generator) in generators.enumerated() {
+            guard let batchable = generator as? BatchableTOTPGenerator else {
+                results[index] = generator.generate()
+                continue
+            }
+            guard let hmacKey = batchable.hmacKey,
+                  let period = UInt32(exactly: batchable.timeStep)
+            else {
+                results[index] = batchable.generate(at: date)
+                continue
+            }
+            batchIndices.append(index)
+            keys.append(hmacKey.key)
+            periods.append(period)
+            digits.append(batchable.nativeDigits)
+        }
+
+        if !batchIndices.isEmpty {
+            var codes = [UInt32](repeating: 0, count: batchIndices.count)
+            let unixTime = UInt64(max(0, date.timeIntervalSince1970))
+            totp_compute_batch(keys, periods, digits, keys.count, unixTime, &codes)
+            for (batchIndex, index) in batchIndices.enumerated() {
+                let batchable = generators[index] as! BatchableTOTPGenerator
+                results[index] = batchable.format(code: Int(codes[batchIndex]))
+            }
+        }
+        return results.map { $0 ?? "" }
+    }
+}
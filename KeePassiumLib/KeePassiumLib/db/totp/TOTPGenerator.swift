@@ -14,6 +14,14 @@ public enum TOTPHashAlgorithm {
     case sha256
     case sha512
 
+    var nativeID: Int32 {
+        switch self {
+        case .sha1: return TOTP_ALGORITHM_SHA1
+        case .sha256: return TOTP_ALGORITHM_SHA256
+        case .sha512: return TOTP_ALGORITHM_SHA512
+        }
+    }
+
     var asString: String {
         switch self {
         case .sha1: return "SHA1"
@@ -50,6 +58,10 @@ extension TOTPGenerator {
         return result
     }
 
+    fileprivate func getCounter(at date: Date, timeStep: Int) -> UInt64 {
+        return UInt64(floor(date.timeIntervalSince1970 / Double(timeStep)))
+    }
+
     fileprivate func calculateFullCode(
         counterBytes: ByteArray,
         seed: ByteArray,
@@ -74,11 +86,27 @@ extension TOTPGenerator {
     }
 }
 
-public class TOTPGeneratorRFC6238: TOTPGenerator {
+/// Generator which can be computed natively, together with others (see `TOTPBatchGenerator`).
+internal protocol BatchableTOTPGenerator: TOTPGenerator {
+    var hmacKey: TOTPHMACKey? { get }
+    var timeStep: Int { get }
+
+    /// Number of decimal digits the native code is reduced to, or 0 to get the full code.
+    var nativeDigits: UInt8 { get }
+
+    /// Returns the code for the given time.
+    func generate(at date: Date) -> String
+
+    func format(code: Int) -> String
+}
+
+public class TOTPGeneratorRFC6238: BatchableTOTPGenerator {
     internal let seed: ByteArray
     internal let timeStep: Int
     internal let length: Int
     internal let hashAlgorithm: TOTPHashAlgorithm
+    internal private(set) lazy var hmacKey = TOTPHMACKey.make(seed: seed, algorithm: hashAlgorithm)
+    internal var nativeDigits: UInt8 { UInt8(length) }
 
     public var remainingTime: TimeInterval {
         return getRemainingTime(timeStep: timeStep)
@@ -98,19 +126,31 @@ public class TOTPGeneratorRFC6238: TOTPGenerator {
     }
 
     public func generate() -> String {
-        let counter = UInt64(floor(Date.now.timeIntervalSince1970 / Double(timeStep))).bigEndian
-        let fullCode = calculateFullCode(
-            counterBytes: ByteArray(bytes: counter.bytes),
-            seed: seed,
-            algorithm: hashAlgorithm
-        )
+        return generate(at: .now)
+    }
+
+    internal func generate(at date: Date) -> String {
+        let counter = getCounter(at: date, timeStep: timeStep)
+        let fullCode: Int
+        if let hmacKey {
+            fullCode = hmacKey.getFullCode(counter: counter)
+        } else {
+            fullCode = calculateFullCode(
+                counterBytes: ByteArray(bytes: counter.bigEndian.bytes),
+                seed: seed,
+                algorithm: hashAlgorithm
+            )
+        }
         let trimmingMask = Int(pow(Double(10), Double(length)))
-        let trimmedCode = fullCode % trimmingMask
-        return String(format: "%0.\(length)d", arguments: [trimmedCode])
+        return format(code: fullCode % trimmingMask)
+    }
+
+    internal func format(code: Int) -> String {
+        return String(format: "%0.\(length)d", arguments: [code])
     }
 }
 
-public class TOTPGeneratorSteam: TOTPGenerator {
+public class TOTPGeneratorSteam: BatchableTOTPGenerator {
     public static let typeSymbol = "S"
     private let steamChars = [
         "2", "3", "4", "5", "6", "7", "8", "9", "B", "C", "D", "F", "G",
@@ -124,9 +164,11 @@ public class TOTPGeneratorSteam: TOTPGenerator {
     }
 
     private let seed: ByteArray
-    private let timeStep: Int
+    internal let timeStep: Int
     private let length = 5
     private let hashAlgorithm = TOTPHashAlgorithm.sha1
+    internal private(set) lazy var hmacKey = TOTPHMACKey.make(seed: seed, algorithm: hashAlgorithm)
+    internal let nativeDigits: UInt8 = 0
 
     internal init?(seed: ByteArray, timeStep: Int) {
         guard timeStep > 0 else { return nil }
@@ -136,12 +178,24 @@ public class TOTPGeneratorSteam: TOTPGenerator {
     }
 
     public func generate() -> String {
-        let counter = UInt64(floor(Date.now.timeIntervalSince1970 / Double(timeStep))).bigEndian
-        var code = calculateFullCode(
-            counterBytes: ByteArray(bytes: counter.bytes),
+        return generate(at: .now)
+    }
+
+    internal func generate(at date: Date) -> String {
+        let counter = getCounter(at: date, timeStep: timeStep)
+        if let hmacKey {
+            return format(code: hmacKey.getFullCode(counter: counter))
+        }
+        let fullCode = calculateFullCode(
+            counterBytes: ByteArray(bytes: counter.bigEndian.bytes),
             seed: seed,
             algorithm: hashAlgorithm
         )
+        return format(code: fullCode)
+    }
+
+    internal func format(code fullCode: Int) -> String {
+        var code = fullCode
         var result = [String]()
         for _ in 0..<length {
             let index = code % steamChars.count
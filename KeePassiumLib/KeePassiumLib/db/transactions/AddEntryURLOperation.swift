@@ -63,6 +63,7 @@ public final class AddEntryURLOperation: DatabaseOperation {
             let newURLField = entry.makeExtraURLField(value: urlString)
             entry.fields.append(newURLField)
         }
+        databaseFile.database.markForReindexing(entry)
 
         QuickTypeAutoFillStorage.saveIdentities(from: entry, in: databaseFile)
     }
@@ -53,6 +53,7 @@ public final class EditEntryOperation: DatabaseOperation {
         fields.forEach { field in
             entry.setField(name: field.name, value: field.value, isProtected: field.isProtected)
         }
+        databaseFile.database.markForReindexing(entry)
 
         QuickTypeAutoFillStorage.saveIdentities(from: entry, in: databaseFile)
     }
@@ -0,0 +1,52 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+internal enum Base64 {
+    static func encode(_ bytes: UnsafeRawBufferPointer) -> String {
+        guard let source = bytes.baseAddress, bytes.count > 0 else {
+            return ""
+        }
+        let encodedLength = base64_encoded_length(bytes.count)
+        return String(unsafeUninitializedCapacity: encodedLength) { buffer in
+            let target = UnsafeMutableRawPointer(buffer.baseAddress!).assumingMemoryBound(to: CChar.self)
+            return base64_encode(source.assumingMemoryBound(to: UInt8.self), bytes.count, target)
+        }
+    }
+
+    static func encode(_ bytes: [UInt8]) -> String {
+        return bytes.withUnsafeBytes { encode($0) }
+    }
+
+    static func decode(_ string: String) -> [UInt8]? {
+        var string = string
+        return string.withUTF8 { decode($0) }
+    }
+
+    static func decode(_ chars: UnsafeBufferPointer<UInt8>) -> [UInt8]? {
+        guard let source = chars.baseAddress, chars.count > 0 else {
+            return []
+        }
+        var status = BASE64_OK.rawValue
+        let decoded = [UInt8](unsafeUninitializedCapacity: base64_decoded_max_length(chars.count)) {
+            buffer, initializedCount in
+            var decodedLength = 0
+            status = base64_decode(
+                UnsafeRawPointer(source).assumingMemoryBound(to: CChar.self),
+                chars.count,
+                buffer.baseAddress,
+                &decodedLength)
+            initializedCount = (status == BASE64_OK.rawValue) ? decodedLength : 0
+        }
+        guard status == BASE64_OK.rawValue else {
+            return nil
+        }
+        return decoded
+    }
+}
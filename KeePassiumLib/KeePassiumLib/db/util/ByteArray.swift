@@ -81,23 +81,20 @@ public class ByteArray: Eraseable, Cloneable, Codable, CustomDebugStringConverti
             return Int64(data: data)
         }
     }
+    /// Collects written bytes in memory.
+    /// The resulting `data` shares the buffer instead of copying it.
     public class OutputStream {
-        private let base: Foundation.OutputStream
-        fileprivate init() {
-            base = Foundation.OutputStream(toMemory: ())
-        }
+        private var buffer = [UInt8]()
+        private var isOpen = false
+        fileprivate init() {}
         public func open() {
-            base.open()
+            isOpen = true
         }
         public func close() {
-            base.close()
+            isOpen = false
         }
         var data: ByteArray? {
-            if let data = base.property(forKey: .dataWrittenToMemoryStreamKey) as? Data {
-                return ByteArray(data: data)
-            } else {
-                return nil
-            }
+            return ByteArray(bytes: buffer)
         }
 
         @discardableResult
@@ -108,11 +105,18 @@ public class ByteArray: Eraseable, Cloneable, Codable, CustomDebugStringConverti
         func write(data: ByteArray) -> Int {
             guard data.count > 0 else { return 0 } 
 
-            let writtenCount = data.withBytes { bytes in
-                return base.write(bytes, maxLength: bytes.count)
+            assert(isOpen, "Writing to a stream that is not open")
+            data.withBytes { bytes in
+                buffer.append(contentsOf: bytes)
             }
-            assert(writtenCount == data.count, "Written \(writtenCount) bytes instead of \(data.count) requested")
-            return writtenCount
+            return data.count
+        }
+        @discardableResult
+        func write(bytes: UnsafePointer<UInt8>, count: Int) -> Int {
+            guard count > 0 else { return 0 }
+            assert(isOpen, "Writing to a stream that is not open")
+            buffer.append(contentsOf: UnsafeBufferPointer(start: bytes, count: count))
+            return count
         }
     }
 
@@ -184,8 +188,8 @@ public class ByteArray: Eraseable, Cloneable, Codable, CustomDebugStringConverti
     }
     convenience public init?(base64Encoded: String?) {
         if let base64Encoded {
-            guard let data = Data(base64Encoded: base64Encoded) else { return nil }
-            self.init(data: data)
+            guard let bytes = Base64.decode(base64Encoded) else { return nil }
+            self.init(bytes: bytes)
         } else {
             return nil
         }
@@ -307,16 +311,16 @@ public class ByteArray: Eraseable, Cloneable, Codable, CustomDebugStringConverti
     }
 
     @discardableResult
-    public func withBytes<TResult>(_ body: ([UInt8]) -> TResult) -> TResult {
-        return body(bytes)
+    public func withBytes<TResult>(_ body: ([UInt8]) throws -> TResult) rethrows -> TResult {
+        return try body(bytes)
     }
     @discardableResult
-    public func withMutableBytes<TResult>(_ body: (inout [UInt8]) -> TResult) -> TResult {
-        return body(&bytes)
+    public func withMutableBytes<TResult>(_ body: (inout [UInt8]) throws -> TResult) rethrows -> TResult {
+        return try body(&bytes)
     }
 
     public func base64EncodedString() -> String {
-        return Data(bytes).base64EncodedString()
+        return Base64.encode(bytes)
     }
 
     public func toString(using encoding: String.Encoding = .utf8) -> String? {
@@ -365,13 +369,13 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
 
     fileprivate var bytes: [UInt8]
 
-    private var key: SecKey?
+    private var isProtected: Bool
 
     public var count: Int {
-        if bytes.isEmpty {
-            return 0
+        if isProtected {
+            return bytes.count - SecureBytes.nonceSize
         } else {
-            return withDecryptedBytes { $0.count }
+            return bytes.count
         }
     }
 
@@ -380,7 +384,7 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
     }
 
     public var isEncrypted: Bool {
-        return key != nil
+        return isProtected
     }
 
     public var sha256: SecureBytes {
@@ -397,8 +401,8 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
         return SecureBytes.from(hashBytes)
     }
 
-    private init(_ bytes: [UInt8], key: SecKey?) {
-        self.key = key
+    private init(_ bytes: [UInt8], isProtected: Bool) {
+        self.isProtected = isProtected
         self.bytes = bytes.withUnsafeBufferPointer { [UInt8]($0) } 
         _ = self.bytes.withUnsafeBufferPointer { ptr in
             mlock(ptr.baseAddress, ptr.count)
@@ -413,7 +417,7 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
     }
 
     public func erase() {
-        key = nil
+        isProtected = false
         bytes.erase()
     }
 
@@ -426,42 +430,52 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
     public convenience init(from decoder: Decoder) throws {
         let container = try decoder.container(keyedBy: CodingKeys.self)
         let format = try container.decodeIfPresent(Int.self, forKey: .format) ?? 0
+        var plainTextBytes: [UInt8]
         switch format {
         case 0:
-            var plainTextBytes = try container.decode([UInt8].self, forKey: .bytes)
-            defer {
-                plainTextBytes.erase()
-            }
-            var key = Keychain.shared.getMemoryProtectionKey()
-            let bytes = SecureBytes.encrypt(plainTextBytes, with: &key)
-            self.init(bytes, key: key)
+            plainTextBytes = try container.decode([UInt8].self, forKey: .bytes)
         case 1:
             guard let key = Keychain.shared.getMemoryProtectionKey() else {
                 SecureBytes.__encryption_key_is_missing()
                 fatalError()
             }
             let encryptedBytes = try container.decode([UInt8].self, forKey: .bytes)
-            self.init(encryptedBytes, key: key)
+            plainTextBytes = SecureBytes.decryptFromStorage(encryptedBytes, with: key)
         default:
             SecureBytes.__unexpected_serialization_format(format)
             fatalError()
         }
+        defer {
+            plainTextBytes.erase()
+        }
+        let (bytes, isProtected) = SecureBytes.protect(plainTextBytes)
+        self.init(bytes, isProtected: isProtected)
     }
 
     public func encode(to encoder: Encoder) throws {
         var container = encoder.container(keyedBy: CodingKeys.self)
-        if key == nil {
+        guard isProtected else {
             try container.encode(bytes, forKey: .bytes)
-        } else {
+            return
+        }
+
+        var key = Keychain.shared.getMemoryProtectionKey()
+        var storedBytes = withDecryptedBytes {
+            SecureBytes.encryptForStorage($0, with: &key)
+        }
+        defer {
+            storedBytes.erase()
+        }
+        if key != nil {
             let format: Int = 1
             try container.encode(format, forKey: .format)
-            try container.encode(bytes, forKey: .bytes)
         }
+        try container.encode(storedBytes, forKey: .bytes)
     }
 
 
     public static func empty() -> SecureBytes {
-        return SecureBytes([], key: nil)
+        return SecureBytes([], isProtected: false)
     }
 
     public static func from(_ bytes: [UInt8], encrypt: Bool = true) -> SecureBytes {
@@ -469,11 +483,10 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
             return SecureBytes.empty()
         }
         if encrypt {
-            var key = Keychain.shared.getMemoryProtectionKey()
-            let encrypted = SecureBytes.encrypt(bytes, with: &key)
-            return SecureBytes(encrypted, key: key)
+            let (protectedBytes, isProtected) = SecureBytes.protect(bytes)
+            return SecureBytes(protectedBytes, isProtected: isProtected)
         } else {
-            return SecureBytes(bytes.clone(), key: nil)
+            return SecureBytes(bytes.clone(), isProtected: false)
         }
     }
 
@@ -504,7 +517,7 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
 
         assert(!bytes.allSatisfy { $0 == 0 }, "All bytes are zero. Possibly erased too early?")
 
-        guard let key else {
+        guard isProtected else {
             var bytesCopy = bytes.clone()
             defer {
                 bytesCopy.erase()
@@ -512,7 +525,7 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
             return try handler(bytesCopy)
         }
 
-        let decryptedBytes = SecureBytes.decrypt(bytes, with: key)
+        let decryptedBytes = SecureBytes.unprotect(bytes)
         let result = try decryptedBytes.withUnsafeBytes { pointer -> T in
             let mutablePointer = UnsafeMutableRawPointer(mutating: pointer.baseAddress!)
             mlock(mutablePointer, pointer.count)
@@ -528,7 +541,7 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
     @discardableResult
     public func withDecryptedMutableBytes<T>(_ handler: (inout [UInt8]) throws -> T) rethrows -> T {
         return try withDecryptedBytes {
-            var copy = isEncrypted ? $0 : $0.clone()
+            var copy = isProtected ? $0 : $0.clone()
             defer {
                 copy.erase()
             }
@@ -560,9 +573,15 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
         }
     }
 
+    /// Protected bytes are sealed anew, so the clone gets its own nonce.
     public func clone() -> SecureBytes {
-        let bytesCopy = bytes.clone()
-        return SecureBytes(bytesCopy, key: key)
+        guard isProtected else {
+            return SecureBytes(bytes.clone(), isProtected: false)
+        }
+        let (sealedBytes, isSealed) = withDecryptedBytes {
+            SecureBytes.protect($0)
+        }
+        return SecureBytes(sealedBytes, isProtected: isSealed)
     }
 
     public static func concat(_ parts: SecureBytes...) -> SecureBytes {
@@ -599,9 +618,57 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
     }
 
 
+    /// Size of the per-object nonce prepended to protected bytes.
+    private static let nonceSize = Int(MEMPROTECT_NONCE_SIZE)
+
+    private static let isMemoryProtectionAvailable: Bool = {
+        guard memprotect_init() == MEMPROTECT_OK else {
+            Diag.warning("Failed to initialize memory protection, continuing without")
+            return false
+        }
+        return true
+    }()
+
+    /// Encrypts the bytes with the in-process memory protection key.
+    private static func protect(_ plainText: [UInt8]) -> (bytes: [UInt8], isProtected: Bool) {
+        guard plainText.count > 0 else {
+            return ([], false)
+        }
+        guard isMemoryProtectionAvailable else {
+            return (plainText.clone(), false)
+        }
+        let sealed = [UInt8](unsafeUninitializedCapacity: nonceSize + plainText.count) {
+            buffer, initializedCount in
+            let status = plainText.withUnsafeBufferPointer {
+                memprotect_seal($0.baseAddress, $0.count, buffer.baseAddress)
+            }
+            guard status == MEMPROTECT_OK else {
+                __memory_protection_failed()
+                fatalError()
+            }
+            initializedCount = buffer.count
+        }
+        return (sealed, true)
+    }
+
+    private static func unprotect(_ sealed: [UInt8]) -> [UInt8] {
+        return [UInt8](unsafeUninitializedCapacity: sealed.count - nonceSize) {
+            buffer, initializedCount in
+            let status = sealed.withUnsafeBufferPointer {
+                memprotect_open($0.baseAddress, $0.count, buffer.baseAddress)
+            }
+            guard status == MEMPROTECT_OK else {
+                __memory_protection_failed()
+                fatalError()
+            }
+            initializedCount = buffer.count
+        }
+    }
+
+    /// The Keychain-held key survives app restarts, so it is used for serialized instances only.
     private static let algorithm = SecKeyAlgorithm.eciesEncryptionCofactorVariableIVX963SHA256AESGCM
 
-    private static func encrypt(_ plainText: [UInt8], with key: inout SecKey?) -> [UInt8] {
+    private static func encryptForStorage(_ plainText: [UInt8], with key: inout SecKey?) -> [UInt8] {
         guard plainText.count > 0 else {
             return []
         }
@@ -633,13 +700,10 @@ public final class SecureBytes: Eraseable, Cloneable, Codable {
         return Array(outData)
     }
 
-    private static func decrypt(_ encrypted: [UInt8], with key: SecKey?) -> [UInt8] {
+    private static func decryptFromStorage(_ encrypted: [UInt8], with key: SecKey) -> [UInt8] {
         guard encrypted.count > 0 else {
             return []
         }
-        guard let key else {
-            return Array(encrypted)
-        }
 
         guard SecKeyIsAlgorithmSupported(key, .decrypt, SecureBytes.algorithm) else {
             __decryption_algorithm_is_not_supported()
@@ -679,6 +743,11 @@ extension SecureBytes {
         fatalError("Got encrypted SecureBytes, but no key. Something is very wrong.")
     }
 
+    @inline(never)
+    private static func __memory_protection_failed() {
+        fatalError("Memory protection failed. Something is very wrong.")
+    }
+
     @inline(never)
     private static func __decryption_algorithm_is_not_supported() {
         fatalError("Decryption algorithm is not supported. Something is very wrong.")
@@ -0,0 +1,67 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+internal enum KDBXTime {
+    enum Format {
+        case base64
+        case iso8601
+
+        fileprivate var nativeFormat: kdbx_time_format {
+            switch self {
+            case .base64:
+                return KDBX_TIME_FORMAT_BASE64
+            case .iso8601:
+                return KDBX_TIME_FORMAT_ISO8601
+            }
+        }
+    }
+
+    static func parse(_ string: String, preferredFormat: Format) -> (date: Date, format: Format)? {
+        var string = string
+        var kdbxSeconds: Int64 = 0
+        let matchedFormat = string.withUTF8 { chars -> Int32 in
+            guard let baseAddress = chars.baseAddress else {
+                return KDBX_TIME_ERROR
+            }
+            return kdbx_time_parse(
+                UnsafeRawPointer(baseAddress).assumingMemoryBound(to: CChar.self),
+                chars.count,
+                preferredFormat.nativeFormat,
+                &kdbxSeconds)
+        }
+        let date = Date(
+            timeIntervalSinceReferenceDate:
+                Double(kdbxSeconds - Date.secondsBetweenSwiftAndDotNetReferenceDates))
+        switch matchedFormat {
+        case Int32(KDBX_TIME_FORMAT_BASE64.rawValue):
+            return (date, .base64)
+        case Int32(KDBX_TIME_FORMAT_ISO8601.rawValue):
+            return (date, .iso8601)
+        default:
+            return nil
+        }
+    }
+
+    static func format(_ date: Date, as format: Format) -> String? {
+        let secondsSinceSwiftReferenceDate: Int64
+        switch format {
+        case .base64:
+            secondsSinceSwiftReferenceDate = Int64(date.timeIntervalSinceReferenceDate)
+        case .iso8601:
+            secondsSinceSwiftReferenceDate = Int64(date.timeIntervalSinceReferenceDate.rounded(.down))
+        }
+        let kdbxSeconds = secondsSinceSwiftReferenceDate + Date.secondsBetweenSwiftAndDotNetReferenceDates
+        let result = String(unsafeUninitializedCapacity: Int(KDBX_TIME_MAX_LENGTH)) { buffer in
+            let target = UnsafeMutableRawPointer(buffer.baseAddress!).assumingMemoryBound(to: CChar.self)
+            return kdbx_time_format_as(kdbxSeconds, format.nativeFormat, target)
+        }
+        return result.isEmpty ? nil : result
+    }
+}
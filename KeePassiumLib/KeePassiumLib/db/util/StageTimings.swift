@@ -0,0 +1,40 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+internal struct StageTimings: CustomStringConvertible {
+    struct Stage {
+        let name: String
+        let duration: TimeInterval
+    }
+
+    private(set) var stages = [Stage]()
+    private var lapStartTime: UInt64 = 0
+
+    var total: TimeInterval {
+        stages.reduce(0) { $0 + $1.duration }
+    }
+
+    var description: String {
+        stages
+            .map { String(format: "\($0.name): %.1f ms", $0.duration * 1000) }
+            .joined(separator: ", ")
+    }
+
+    mutating func start() {
+        stages.removeAll(keepingCapacity: true)
+        lapStartTime = DispatchTime.now().uptimeNanoseconds
+    }
+
+    mutating func lap(_ name: String) {
+        let now = DispatchTime.now().uptimeNanoseconds
+        stages.append(Stage(name: name, duration: TimeInterval(now - lapStartTime) / 1e9))
+        lapStartTime = now
+    }
+}
@@ -193,12 +193,17 @@ extension FileDataProvider {
         }
     }
 
+    /// - Parameters:
+    ///   - prefixHandler: if given, might be called with the first `prefixLength` bytes of the file
+    ///     before the whole file is read (see `DataSource.read`).
     public static func read(
         _ fileURL: URL,
         fileProvider: FileProvider?,
         queue: OperationQueue? = nil,
         timeout: Timeout,
         completionQueue: OperationQueue? = nil,
+        prefixLength: Int = 0,
+        prefixHandler: FilePrefixHandler? = nil,
         completion: @escaping FileOperationCompletion<ByteArray>
     ) {
         let operationQueue = queue ?? FileDataProvider.backgroundQueue
@@ -223,14 +228,114 @@ extension FileDataProvider {
                         fileURL.stopAccessingSecurityScopedResource()
                     }
                 }
+                guard let prefixHandler else {
+                    dataSource.read(
+                        coordinatedURL,
+                        fileProvider: fileProvider,
+                        timeout: timeout,
+                        queue: operationQueue,
+                        completionQueue: completionQueue,
+                        completion: completion
+                    )
+                    return
+                }
                 dataSource.read(
                     coordinatedURL,
                     fileProvider: fileProvider,
                     timeout: timeout,
                     queue: operationQueue,
                     completionQueue: completionQueue,
+                    prefixLength: prefixLength,
+                    prefixHandler: prefixHandler,
+                    completion: completion
+                )
+            },
+            completionQueue: completionQueue,
+            completion: completion
+        )
+    }
+
+    /// Same as `read`, but returns the key file reduced to its key (see `KeyHelper.preprocessKeyFile`).
+    /// Local key files are hashed in place, without loading them into memory.
+    public static func readKeyFile(
+        _ fileRef: URLReference,
+        queue: OperationQueue? = nil,
+        timeout: Timeout,
+        completionQueue: OperationQueue? = nil,
+        completion: @escaping FileOperationCompletion<SecureBytes>
+    ) {
+        let operationQueue = queue ?? FileDataProvider.backgroundQueue
+        let completionQueue = completionQueue ?? FileDataProvider.backgroundQueue
+        fileRef.resolveAsync(timeout: timeout, callbackQueue: operationQueue) {
+            assert(operationQueue.isCurrent)
+            switch $0 {
+            case .success(let prefixedFileURL):
+                readKeyFile(
+                    prefixedFileURL,
+                    fileProvider: fileRef.fileProvider,
+                    queue: operationQueue,
+                    timeout: timeout,
+                    completionQueue: completionQueue,
                     completion: completion
                 )
+            case .failure(let fileAccessError):
+                Diag.error("Failed to resolve file reference [message: \(fileAccessError.localizedDescription)]")
+                completionQueue.addOperation {
+                    completion(.failure(fileAccessError))
+                }
+            }
+        }
+    }
+
+    public static func readKeyFile(
+        _ fileURL: URL,
+        fileProvider: FileProvider?,
+        queue: OperationQueue? = nil,
+        timeout: Timeout,
+        completionQueue: OperationQueue? = nil,
+        completion: @escaping FileOperationCompletion<SecureBytes>
+    ) {
+        let operationQueue = queue ?? FileDataProvider.backgroundQueue
+        let completionQueue = completionQueue ?? FileDataProvider.backgroundQueue
+        guard fileProvider?.isAllowed ?? true else {
+            completionQueue.addOperation { completion(.failure(.managedAccessDenied)) }
+            return
+        }
+
+        let isAccessed = fileURL.startAccessingSecurityScopedResource()
+        let dataSource = DataSourceFactory.getDataSource(for: fileURL)
+        coordinateFileOperation(
+            accessCoordinator: dataSource.getAccessCoordinator(),
+            intent: .readingIntent(with: fileURL, options: [.forUploading]),
+            fileProvider: fileProvider,
+            timeout: timeout,
+            queue: operationQueue,
+            fileOperation: { coordinatedURL in
+                assert(operationQueue.isCurrent)
+                defer {
+                    if isAccessed {
+                        fileURL.stopAccessingSecurityScopedResource()
+                    }
+                }
+                if let localDataSource = dataSource as? LocalDataSource {
+                    localDataSource.readKeyFile(
+                        coordinatedURL,
+                        fileProvider: fileProvider,
+                        completionQueue: completionQueue,
+                        completion: completion
+                    )
+                    return
+                }
+                dataSource.read(
+                    coordinatedURL,
+                    fileProvider: fileProvider,
+                    timeout: timeout,
+                    queue: operationQueue,
+                    completionQueue: completionQueue,
+                    completion: { result in
+                        completion(result.map { KeyHelper.preprocessKeyFile(data: $0) })
+                    }
+                )
             },
             completionQueue: completionQueue,
             completion: completion
@@ -9,6 +9,9 @@
 public typealias FileOperationResult<T> = Result<T, FileAccessError>
 public typealias FileOperationCompletion<T> = (FileOperationResult<T>) -> Void
 
+/// Receives the first bytes of a file while the rest is still being read.
+public typealias FilePrefixHandler = (ByteArray) -> Void
+
 protocol DataSource {
 
     func getAccessCoordinator() -> FileAccessCoordinator
@@ -32,6 +35,20 @@ protocol DataSource {
         completion: @escaping FileOperationCompletion<ByteArray>
     )
 
+    /// Same as `read`, but can also call `prefixHandler` once the first `prefixLength` bytes have arrived.
+    /// The prefix is only reported by sources which receive the file gradually,
+    /// and is not reported at all if the file is shorter.
+    func read(
+        _ url: URL,
+        fileProvider: FileProvider?,
+        timeout: Timeout,
+        queue: OperationQueue,
+        completionQueue: OperationQueue,
+        prefixLength: Int,
+        prefixHandler: @escaping FilePrefixHandler,
+        completion: @escaping FileOperationCompletion<ByteArray>
+    )
+
     func write(
         _ data: ByteArray,
         to url: URL,
@@ -42,3 +59,25 @@ protocol DataSource {
         completion: @escaping FileOperationCompletion<Void>
     )
 }
+
+extension DataSource {
+    func read(
+        _ url: URL,
+        fileProvider: FileProvider?,
+        timeout: Timeout,
+        queue: OperationQueue,
+        completionQueue: OperationQueue,
+        prefixLength: Int,
+        prefixHandler: @escaping FilePrefixHandler,
+        completion: @escaping FileOperationCompletion<ByteArray>
+    ) {
+        read(
+            url,
+            fileProvider: fileProvider,
+            timeout: timeout,
+            queue: queue,
+            completionQueue: completionQueue,
+            completion: completion
+        )
+    }
+}
@@ -65,6 +65,31 @@ public final class LocalDataSource: DataSource {
         }
     }
 
+    /// Reads a key file reduced to its key (see `KeyHelper.preprocessKeyFile(at:)`),
+    /// so large key files are hashed in place instead of being loaded.
+    public func readKeyFile(
+        _ url: URL,
+        fileProvider: FileProvider?,
+        completionQueue: OperationQueue,
+        completion: @escaping FileOperationCompletion<SecureBytes>
+    ) {
+        do {
+            let keyFileData = try KeyHelper.preprocessKeyFile(at: url)
+            completionQueue.addOperation {
+                completion(.success(keyFileData))
+            }
+        } catch {
+            Diag.error("Failed to read key file [message: \((error as NSError).description)]")
+            let fileAccessError = FileAccessError.make(
+                from: error,
+                fileName: url.lastPathComponent,
+                fileProvider: fileProvider)
+            completionQueue.addOperation {
+                completion(.failure(fileAccessError))
+            }
+        }
+    }
+
     public func write(
         _ data: ByteArray,
         to url: URL,
@@ -53,6 +53,47 @@ public final class WebDAVDataSource: DataSource {
         queue: OperationQueue,
         completionQueue: OperationQueue,
         completion: @escaping FileOperationCompletion<ByteArray>
+    ) {
+        download(
+            url,
+            fileProvider: fileProvider,
+            timeout: timeout,
+            completionQueue: completionQueue,
+            prefixLength: 0,
+            prefixHandler: nil,
+            completion: completion
+        )
+    }
+
+    public func read(
+        _ url: URL,
+        fileProvider: FileProvider?,
+        timeout: Timeout,
+        queue: OperationQueue,
+        completionQueue: OperationQueue,
+        prefixLength: Int,
+        prefixHandler: @escaping FilePrefixHandler,
+        completion: @escaping FileOperationCompletion<ByteArray>
+    ) {
+        download(
+            url,
+            fileProvider: fileProvider,
+            timeout: timeout,
+            completionQueue: completionQueue,
+            prefixLength: prefixLength,
+            prefixHandler: prefixHandler,
+            completion: completion
+        )
+    }
+
+    private func download(
+        _ url: URL,
+        fileProvider: FileProvider?,
+        timeout: Timeout,
+        completionQueue: OperationQueue,
+        prefixLength: Int,
+        prefixHandler: FilePrefixHandler?,
+        completion: @escaping FileOperationCompletion<ByteArray>
     ) {
         assert(fileProvider == .keepassiumWebDAV)
         guard Settings.current.isNetworkAccessAllowed else {
@@ -74,6 +115,8 @@ public final class WebDAVDataSource: DataSource {
             credential: credential,
             timeout: timeout,
             completionQueue: completionQueue,
+            prefixLength: prefixLength,
+            prefixHandler: prefixHandler,
             completion: completion
         )
     }
@@ -14,16 +14,23 @@ final class WebDAVDownloadRequest: WebDAVRequestBase {
     let completionQueue: OperationQueue
     let completion: Completion
 
+    private let prefixLength: Int
+    private var prefixHandler: FilePrefixHandler?
+
     init(
         url: URL,
         credential: URLCredential,
         allowUntrustedCertificate: Bool,
         timeout: Timeout,
         completionQueue: OperationQueue,
+        prefixLength: Int = 0,
+        prefixHandler: FilePrefixHandler? = nil,
         completion: @escaping Completion
     ) {
         self.completionQueue = completionQueue
         self.completion = completion
+        self.prefixLength = prefixLength
+        self.prefixHandler = prefixHandler
         super.init(
             url: url,
             credential: credential,
@@ -42,6 +49,19 @@ final class WebDAVDownloadRequest: WebDAVRequestBase {
         return request
     }
 
+    override func appendReceivedData(_ chunk: Data) {
+        super.appendReceivedData(chunk)
+        guard let prefixHandler, receivedData.count >= prefixLength else {
+            return
+        }
+        self.prefixHandler = nil
+        // The status code is not checked yet, so this might be an error page; the handler must validate it.
+        let prefix = ByteArray(data: receivedData.prefix(prefixLength))
+        completionQueue.addOperation {
+            prefixHandler(prefix)
+        }
+    }
+
     override func finishWith(error: FileAccessError) {
         completionQueue.addOperation {
             self.completion(.failure(error))
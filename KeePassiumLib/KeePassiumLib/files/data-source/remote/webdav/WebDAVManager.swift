@@ -71,6 +71,8 @@ public final class WebDAVManager: NSObject {
         credential: NetworkCredential,
         timeout: Timeout,
         completionQueue: OperationQueue? = nil,
+        prefixLength: Int = 0,
+        prefixHandler: FilePrefixHandler? = nil,
         completion: @escaping (Result<ByteArray, FileAccessError>) -> Void
     ) {
         let downloadRequest = WebDAVDownloadRequest(
@@ -79,6 +81,8 @@ public final class WebDAVManager: NSObject {
             allowUntrustedCertificate: credential.allowUntrustedCertificate,
             timeout: timeout,
             completionQueue: completionQueue ?? .main,
+            prefixLength: prefixLength,
+            prefixHandler: prefixHandler,
             completion: completion
         )
 
@@ -0,0 +1,303 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "base64.h"
+
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define BASE64_USE_NEON 1
+#include <arm_neon.h>
+#elif defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#define BASE64_USE_AVX2 1
+#include <immintrin.h>
+#endif
+
+static const char base64_alphabet[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Maps characters to their 6-bit values; 0xFF for anything outside the alphabet (including '='). */
+static const uint8_t base64_values[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   62, 0xFF, 0xFF, 0xFF,   63,
+      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+      15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+      41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+size_t base64_encoded_length(size_t length) {
+    return (length + 2) / 3 * 4;
+}
+
+size_t base64_decoded_max_length(size_t length) {
+    return length / 4 * 3;
+}
+
+/***************NEON*****************/
+#if BASE64_USE_NEON
+
+/* Encodes 48-byte blocks into 64 characters; returns the number of input bytes consumed. */
+static size_t base64_encode_neon(const uint8_t *src, size_t length, char *dst) {
+    const uint8x16x4_t alphabet = vld1q_u8_x4((const uint8_t *)base64_alphabet);
+    const uint8x16_t mask6 = vdupq_n_u8(0x3F);
+    size_t done = 0;
+    while (length - done >= 48) {
+        const uint8x16x3_t in = vld3q_u8(src + done);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[1], 4), vshlq_n_u8(in.val[0], 4)), mask6);
+        out.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[2], 6), vshlq_n_u8(in.val[1], 2)), mask6);
+        out.val[3] = vandq_u8(in.val[2], mask6);
+        out.val[0] = vqtbl4q_u8(alphabet, out.val[0]);
+        out.val[1] = vqtbl4q_u8(alphabet, out.val[1]);
+        out.val[2] = vqtbl4q_u8(alphabet, out.val[2]);
+        out.val[3] = vqtbl4q_u8(alphabet, out.val[3]);
+        vst4q_u8((uint8_t *)dst + done / 3 * 4, out);
+        done += 48;
+    }
+    return done;
+}
+
+static inline uint8x16_t base64_lookup_neon(uint8x16_t c, uint8x16x4_t lut_lo, uint8x16x4_t lut_hi) {
+    /* out-of-range indices yield zero, so each table only answers for its own 64 characters */
+    const uint8x16_t lo = vqtbl4q_u8(lut_lo, c);
+    const uint8x16_t hi = vqtbl4q_u8(lut_hi, vsubq_u8(c, vdupq_n_u8(64)));
+    /* characters >= 0x80 are not covered by either table: flag them explicitly */
+    return vorrq_u8(vorrq_u8(lo, hi), vandq_u8(c, vdupq_n_u8(0x80)));
+}
+
+/*
+ * Decodes 64-character blocks into 48 bytes; returns the number of characters consumed.
+ * Stops at the first block containing anything but alphabet characters (such as padding).
+ */
+static size_t base64_decode_neon(const char *src, size_t length, uint8_t *dst) {
+    const uint8x16x4_t lut_lo = vld1q_u8_x4(base64_values);
+    const uint8x16x4_t lut_hi = vld1q_u8_x4(base64_values + 64);
+    size_t done = 0;
+    while (length - done >= 64) {
+        const uint8x16x4_t in = vld4q_u8((const uint8_t *)src + done);
+        const uint8x16_t d0 = base64_lookup_neon(in.val[0], lut_lo, lut_hi);
+        const uint8x16_t d1 = base64_lookup_neon(in.val[1], lut_lo, lut_hi);
+        const uint8x16_t d2 = base64_lookup_neon(in.val[2], lut_lo, lut_hi);
+        const uint8x16_t d3 = base64_lookup_neon(in.val[3], lut_lo, lut_hi);
+        const uint8x16_t any = vorrq_u8(vorrq_u8(d0, d1), vorrq_u8(d2, d3));
+        if (vmaxvq_u8(any) > 63) {
+            break;
+        }
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(d0, 2), vshrq_n_u8(d1, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(d1, 4), vshrq_n_u8(d2, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(d2, 6), d3);
+        vst3q_u8(dst + done / 4 * 3, out);
+        done += 64;
+    }
+    return done;
+}
+
+#endif /* BASE64_USE_NEON */
+
+/***************AVX2*****************/
+#if BASE64_USE_AVX2
+
+#define BASE64_AVX2 __attribute__((target("avx2")))
+
+static int base64_has_avx2(void) {
+    static int has_avx2 = -1;
+    if (has_avx2 < 0) {
+        __builtin_cpu_init();
+        has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return has_avx2;
+}
+
+/* Encodes 24-byte blocks into 32 characters; returns the number of input bytes consumed. */
+BASE64_AVX2
+static size_t base64_encode_avx2(const uint8_t *src, size_t length, char *dst) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i translation = _mm256_setr_epi8(
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    size_t done = 0;
+    /* each iteration reads 28 bytes (two overlapping 16-byte loads) but consumes 24 */
+    while (length - done >= 28) {
+        const __m128i lo = _mm_loadu_si128((const __m128i *)(src + done));
+        const __m128i hi = _mm_loadu_si128((const __m128i *)(src + done + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+
+        /* split each 3-byte group into four 6-bit indices, one per byte */
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        /* map indices to ASCII by adding a per-range offset */
+        __m256i ranges = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i is_lowercase_or_more = _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25));
+        ranges = _mm256_sub_epi8(ranges, is_lowercase_or_more);
+        const __m256i out = _mm256_add_epi8(indices, _mm256_shuffle_epi8(translation, ranges));
+
+        _mm256_storeu_si256((__m256i *)(dst + done / 3 * 4), out);
+        done += 24;
+    }
+    return done;
+}
+
+/*
+ * Decodes 32-character blocks into 24 bytes; returns the number of characters consumed.
+ * Each store writes 32 bytes, so the loop leaves enough input for the scalar tail
+ * to guarantee the output stays within base64_decoded_max_length().
+ * Stops at the first block containing anything but alphabet characters (such as padding).
+ */
+BASE64_AVX2
+static size_t base64_decode_avx2(const char *src, size_t length, uint8_t *dst) {
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2F = _mm256_set1_epi8(0x2F);
+    const __m256i pack_shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i pack_permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+    size_t done = 0;
+    while (length - done >= 48) {
+        __m256i str = _mm256_loadu_si256((const __m256i *)(src + done));
+
+        /* validate by nibble classes: a character is valid iff its lo and hi class bits do not intersect */
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2F);
+        const __m256i lo_nibbles = _mm256_and_si256(str, mask_2F);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+
+        /* convert ASCII to 6-bit values */
+        const __m256i eq_2F = _mm256_cmpeq_epi8(str, mask_2F);
+        const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2F, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        /* pack four 6-bit values into three bytes */
+        const __m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        __m256i out = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        out = _mm256_shuffle_epi8(out, pack_shuffle);
+        out = _mm256_permutevar8x32_epi32(out, pack_permute);
+        _mm256_storeu_si256((__m256i *)(dst + done / 4 * 3), out);
+        done += 32;
+    }
+    return done;
+}
+
+#endif /* BASE64_USE_AVX2 */
+
+/***************Scalar*****************/
+
+size_t base64_encode(const uint8_t *src, size_t length, char *dst) {
+    size_t i = 0;
+#if BASE64_USE_NEON
+    i = base64_encode_neon(src, length, dst);
+#elif BASE64_USE_AVX2
+    if (base64_has_avx2()) {
+        i = base64_encode_avx2(src, length, dst);
+    }
+#endif
+    char *out = dst + i / 3 * 4;
+    for (; length - i >= 3; i += 3) {
+        const uint32_t triple = ((uint32_t)src[i] << 16) | ((uint32_t)src[i + 1] << 8) | src[i + 2];
+        out[0] = base64_alphabet[(triple >> 18) & 0x3F];
+        out[1] = base64_alphabet[(triple >> 12) & 0x3F];
+        out[2] = base64_alphabet[(triple >> 6) & 0x3F];
+        out[3] = base64_alphabet[triple & 0x3F];
+        out += 4;
+    }
+    const size_t rest = length - i;
+    if (rest > 0) {
+        const uint32_t triple = ((uint32_t)src[i] << 16) | (rest == 2 ? ((uint32_t)src[i + 1] << 8) : 0);
+        out[0] = base64_alphabet[(triple >> 18) & 0x3F];
+        out[1] = base64_alphabet[(triple >> 12) & 0x3F];
+        out[2] = (rest == 2) ? base64_alphabet[(triple >> 6) & 0x3F] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+    return (size_t)(out - dst);
+}
+
+int base64_decode(const char *src, size_t length, uint8_t *dst, size_t *out_length) {
+    if (length % 4 != 0) {
+        return BASE64_ERROR_LENGTH;
+    }
+    const uint8_t *in = (const uint8_t *)src;
+    size_t i = 0;
+#if BASE64_USE_NEON
+    i = base64_decode_neon(src, length, dst);
+#elif BASE64_USE_AVX2
+    if (base64_has_avx2()) {
+        i = base64_decode_avx2(src, length, dst);
+    }
+#endif
+    uint8_t *out = dst + i / 4 * 3;
+    for (; i < length; i += 4) {
+        const uint32_t a = base64_values[in[i]];
+        const uint32_t b = base64_values[in[i + 1]];
+        const uint32_t c = base64_values[in[i + 2]];
+        const uint32_t d = base64_values[in[i + 3]];
+        if ((a | b | c | d) <= 63) {
+            const uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+            out[0] = (uint8_t)(triple >> 16);
+            out[1] = (uint8_t)(triple >> 8);
+            out[2] = (uint8_t)triple;
+            out += 3;
+            continue;
+        }
+
+        /* only the last quartet may be padded: "xx==" or "xxx=" */
+        if (i + 4 != length) {
+            return (in[i] == '=' || in[i + 1] == '=' || in[i + 2] == '=' || in[i + 3] == '=')
+                ? BASE64_ERROR_PADDING : BASE64_ERROR_CHARACTER;
+        }
+        if (a > 63 || b > 63) {
+            return (in[i] == '=' || in[i + 1] == '=') ? BASE64_ERROR_PADDING : BASE64_ERROR_CHARACTER;
+        }
+        if (in[i + 3] != '=') {
+            return BASE64_ERROR_CHARACTER;
+        }
+        /* as in Foundation, unused bits of the last character are ignored */
+        out[0] = (uint8_t)((a << 2) | (b >> 4));
+        out += 1;
+        if (in[i + 2] != '=') {
+            if (c > 63) {
+                return BASE64_ERROR_CHARACTER;
+            }
+            out[0] = (uint8_t)((b << 4) | (c >> 2));
+            out += 1;
+        }
+    }
+    *out_length = (size_t)(out - dst);
+    return BASE64_OK;
+}
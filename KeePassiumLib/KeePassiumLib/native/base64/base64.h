@@ -0,0 +1,53 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef base64_h
+#define base64_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    BASE64_OK = 0,
+    BASE64_ERROR_LENGTH = -1,    // input length is not a multiple of 4
+    BASE64_ERROR_CHARACTER = -2, // character outside of the standard alphabet
+    BASE64_ERROR_PADDING = -3    // misplaced or excessive padding
+} base64_status;
+
+/// Number of characters produced by base64_encode() for `length` input bytes.
+size_t base64_encoded_length(size_t length);
+
+/// Upper bound of bytes produced by base64_decode() for `length` input characters.
+size_t base64_decoded_max_length(size_t length);
+
+/// Encodes bytes to standard (RFC 4648) padded base64. Does not append a terminating zero.
+/// @param  src  input bytes
+/// @param  length  number of input bytes
+/// @param  dst  output buffer of at least base64_encoded_length(length) characters
+/// @return number of characters written
+size_t base64_encode(const uint8_t *src, size_t length, char *dst);
+
+/// Decodes standard padded base64. Whitespace and other characters outside
+/// of the alphabet are rejected, padding is only accepted at the very end.
+/// Decoding in place is supported: `dst` may point to the same memory as `src`.
+/// @param  src  input characters
+/// @param  length  number of input characters
+/// @param  dst  output buffer of at least base64_decoded_max_length(length) bytes
+/// @param  out_length  number of decoded bytes (undefined in case of error)
+/// @return BASE64_OK or one of the base64_status error codes
+int base64_decode(const char *src, size_t length, uint8_t *dst, size_t *out_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* base64_h */
@@ -0,0 +1,356 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "kdb_parser.h"
+
+#include <string.h>
+
+#include "../../crypto/sha256/sha256.h"
+
+/// The content is hashed in steps of this size, right behind the parsing position,
+/// so that both passes find the data in cache.
+#define KDB_HASH_STEP (64 * 1024)
+
+#define KDB_FIELD_HEADER_SIZE 6
+#define KDB_TIME_SIZE 5
+#define KDB_UUID_SIZE 16
+
+#define KDB_END_FIELD_ID 0xFFFF
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    size_t hashed;
+    sha256_context hasher;
+    const char *field_name;  // of the last corrupted field
+} kdb_reader;
+
+/// Field layout rules of a record type.
+typedef struct {
+    int (*is_valid_id)(uint16_t id);
+    const char *field_id_name;
+    const char *field_size_name;
+} kdb_record_kind;
+
+/// A field of a record, as stored: 2 bytes ID, 4 bytes size, then data.
+typedef struct {
+    uint16_t id;
+    const uint8_t *data;
+    uint32_t size;
+} kdb_field;
+
+static inline uint16_t kdb_load16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t kdb_load32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void kdb_hash_parsed(kdb_reader *reader, int is_final) {
+    const size_t target = is_final ? reader->length : reader->position;
+    if (target - reader->hashed >= KDB_HASH_STEP || (is_final && target > reader->hashed)) {
+        sha256_update(&reader->hasher, reader->data + reader->hashed, target - reader->hashed);
+        reader->hashed = target;
+    }
+}
+
+static int kdb_corrupted(kdb_reader *reader, const char *field_name) {
+    reader->field_name = field_name;
+    return KDB_PARSER_ERROR_CORRUPTED_FIELD;
+}
+
+/// Reads the next field header and makes sure the field data is within the buffer.
+static int kdb_next_field(kdb_reader *reader, const kdb_record_kind *kind, kdb_field *field) {
+    const size_t available = reader->length - reader->position;
+    if (available < sizeof(uint16_t)) {
+        return KDB_PARSER_ERROR_PREMATURE_END;
+    }
+    const uint8_t *header = reader->data + reader->position;
+    field->id = kdb_load16(header);
+    if (!kind->is_valid_id(field->id)) {
+        return kdb_corrupted(reader, kind->field_id_name);
+    }
+    if (available < KDB_FIELD_HEADER_SIZE) {
+        return KDB_PARSER_ERROR_PREMATURE_END;
+    }
+    const int32_t size = (int32_t)kdb_load32(header + sizeof(uint16_t));
+    if (size < 0) {
+        return kdb_corrupted(reader, kind->field_size_name);
+    }
+    if (available - KDB_FIELD_HEADER_SIZE < (uint32_t)size) {
+        return KDB_PARSER_ERROR_PREMATURE_END;
+    }
+    field->size = (uint32_t)size;
+    field->data = header + KDB_FIELD_HEADER_SIZE;
+    reader->position += KDB_FIELD_HEADER_SIZE + field->size;
+    return KDB_PARSER_OK;
+}
+
+/// Days since 1970-01-01 in the proleptic Gregorian calendar.
+static int64_t kdb_days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= (month <= 2);
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned year_of_era = (unsigned)(year - era * 400);
+    const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + (int64_t)day_of_era - 719468;
+}
+
+/// Decodes the packed 5-byte date format of KeePass 1.x.
+static int64_t kdb_decode_time(const uint8_t *bytes) {
+    int64_t year = ((int64_t)bytes[0] << 6) | (bytes[1] >> 2);
+    int month_index = (((bytes[1] & 0x03) << 2) | (bytes[2] >> 6)) - 1; // zero-based, may be out of range
+    const int day = (bytes[2] >> 1) & 0x1F;
+    const int hour = ((bytes[2] & 0x01) << 4) | (bytes[3] >> 4);
+    const int minute = ((bytes[3] & 0x0F) << 2) | (bytes[4] >> 6);
+    const int second = bytes[4] & 0x3F;
+    if (month_index < 0) {
+        year -= 1;
+        month_index += 12;
+    }
+    year += month_index / 12;
+    month_index %= 12;
+    const int64_t days = kdb_days_from_civil(year, (unsigned)month_index + 1, 1) + day - 1;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+static int kdb_read_time(kdb_reader *reader, const kdb_field *field, const char *field_name, int64_t *time) {
+    if (field->size < KDB_TIME_SIZE) {
+        return kdb_corrupted(reader, field_name);
+    }
+    *time = kdb_decode_time(field->data);
+    return KDB_PARSER_OK;
+}
+
+static int kdb_read_uint32(kdb_reader *reader, const kdb_field *field, const char *field_name, uint32_t *value) {
+    if (field->size < sizeof(uint32_t)) {
+        return kdb_corrupted(reader, field_name);
+    }
+    *value = kdb_load32(field->data);
+    return KDB_PARSER_OK;
+}
+
+/// String fields end with a zero byte, which is left out.
+static kdb_slice kdb_string_slice(const kdb_field *field) {
+    const kdb_slice slice = { field->data, field->size > 0 ? field->size - 1 : 0 };
+    return slice;
+}
+
+static int kdb_slice_equals(kdb_slice slice, const char *string) {
+    const size_t length = strlen(string);
+    return slice.bytes != NULL && slice.length == length && memcmp(slice.bytes, string, length) == 0;
+}
+
+static int kdb_is_group_field(uint16_t id) {
+    return id <= 0x0009 || id == KDB_END_FIELD_ID;
+}
+
+static int kdb_is_entry_field(uint16_t id) {
+    return id <= 0x000E || id == KDB_END_FIELD_ID;
+}
+
+static const kdb_record_kind kdb_group_kind = { kdb_is_group_field, "Group/FieldID", "Group/FieldSize" };
+static const kdb_record_kind kdb_entry_kind = { kdb_is_entry_field, "Entry/FieldID", "Entry/FieldSize" };
+
+static int kdb_parse_group(kdb_reader *reader, kdb_group *group) {
+    memset(group, 0, sizeof(kdb_group));
+    group->group_id = -1;
+    int status;
+    kdb_field field;
+    while ((status = kdb_next_field(reader, &kdb_group_kind, &field)) == KDB_PARSER_OK) {
+        uint32_t value = 0;
+        switch (field.id) {
+        case 0x0000: // reserved
+            break;
+        case 0x0001:
+            if ((status = kdb_read_uint32(reader, &field, "Group/GroupID", &value)) != KDB_PARSER_OK) {
+                return status;
+            }
+            group->group_id = (int32_t)value;
+            group->fields |= KDB_FIELD_GROUP_ID;
+            break;
+        case 0x0002:
+            group->name = kdb_string_slice(&field);
+            break;
+        case 0x0003:
+            status = kdb_read_time(reader, &field, "Group/CreationTime", &group->creation_time);
+            group->fields |= KDB_FIELD_CREATION_TIME;
+            break;
+        case 0x0004:
+            status = kdb_read_time(reader, &field, "Group/LastModifiedTime", &group->last_modification_time);
+            group->fields |= KDB_FIELD_LAST_MODIFICATION_TIME;
+            break;
+        case 0x0005:
+            status = kdb_read_time(reader, &field, "Group/LastAccessTime", &group->last_access_time);
+            group->fields |= KDB_FIELD_LAST_ACCESS_TIME;
+            break;
+        case 0x0006:
+            status = kdb_read_time(reader, &field, "Group/ExpirationTime", &group->expiry_time);
+            group->fields |= KDB_FIELD_EXPIRY_TIME;
+            break;
+        case 0x0007:
+            status = kdb_read_uint32(reader, &field, "Group/IconID", &group->icon_id);
+            group->fields |= KDB_FIELD_ICON_ID;
+            break;
+        case 0x0008:
+            if (field.size < sizeof(uint16_t)) {
+                return kdb_corrupted(reader, "Group/Level");
+            }
+            group->level = kdb_load16(field.data);
+            group->fields |= KDB_FIELD_LEVEL;
+            break;
+        case 0x0009:
+            if ((status = kdb_read_uint32(reader, &field, "Group/Flags", &value)) != KDB_PARSER_OK) {
+                return status;
+            }
+            group->flags = (int32_t)value;
+            group->fields |= KDB_FIELD_FLAGS;
+            break;
+        case KDB_END_FIELD_ID:
+            return KDB_PARSER_OK;
+        }
+        if (status != KDB_PARSER_OK) {
+            return status;
+        }
+    }
+    return status;
+}
+
+static void kdb_detect_meta_stream(kdb_entry *entry) {
+    entry->is_meta_stream =
+        entry->binary_desc.length > 0 &&
+        entry->notes.length > 0 &&
+        entry->icon_id == 0 &&
+        kdb_slice_equals(entry->binary_desc, "bin-stream") &&
+        kdb_slice_equals(entry->username, "SYSTEM") &&
+        kdb_slice_equals(entry->url, "$") &&
+        kdb_slice_equals(entry->title, "Meta-Info");
+}
+
+static int kdb_parse_entry(kdb_reader *reader, kdb_entry *entry) {
+    memset(entry, 0, sizeof(kdb_entry));
+    int status;
+    kdb_field field;
+    while ((status = kdb_next_field(reader, &kdb_entry_kind, &field)) == KDB_PARSER_OK) {
+        uint32_t value = 0;
+        switch (field.id) {
+        case 0x0000: // reserved
+            break;
+        case 0x0001:
+            if (field.size != KDB_UUID_SIZE) {
+                return kdb_corrupted(reader, "Entry/UUID");
+            }
+            memcpy(entry->uuid, field.data, KDB_UUID_SIZE);
+            entry->fields |= KDB_FIELD_UUID;
+            break;
+        case 0x0002:
+            if ((status = kdb_read_uint32(reader, &field, "Entry/GroupID", &value)) != KDB_PARSER_OK) {
+                return status;
+            }
+            entry->group_id = (int32_t)value;
+            entry->fields |= KDB_FIELD_GROUP_ID;
+            break;
+        case 0x0003:
+            status = kdb_read_uint32(reader, &field, "Entry/IconID", &entry->icon_id);
+            entry->fields |= KDB_FIELD_ICON_ID;
+            break;
+        case 0x0004:
+            entry->title = kdb_string_slice(&field);
+            break;
+        case 0x0005:
+            entry->url = kdb_string_slice(&field);
+            break;
+        case 0x0006:
+            entry->username = kdb_string_slice(&field);
+            break;
+        case 0x0007:
+            entry->password = kdb_string_slice(&field);
+            break;
+        case 0x0008:
+            entry->notes = kdb_string_slice(&field);
+            break;
+        case 0x0009:
+            status = kdb_read_time(reader, &field, "Entry/CreationTime", &entry->creation_time);
+            entry->fields |= KDB_FIELD_CREATION_TIME;
+            break;
+        case 0x000A:
+            status = kdb_read_time(reader, &field, "Entry/LastModifiedTime", &entry->last_modification_time);
+            entry->fields |= KDB_FIELD_LAST_MODIFICATION_TIME;
+            break;
+        case 0x000B:
+            status = kdb_read_time(reader, &field, "Entry/LastAccessTime", &entry->last_access_time);
+            entry->fields |= KDB_FIELD_LAST_ACCESS_TIME;
+            break;
+        case 0x000C:
+            status = kdb_read_time(reader, &field, "Entry/ExpirationTime", &entry->expiry_time);
+            entry->fields |= KDB_FIELD_EXPIRY_TIME;
+            break;
+        case 0x000D:
+            entry->binary_desc = kdb_string_slice(&field);
+            break;
+        case 0x000E:
+            entry->binary_data.bytes = field.data;
+            entry->binary_data.length = field.size;
+            break;
+        case KDB_END_FIELD_ID:
+            kdb_detect_meta_stream(entry);
+            return KDB_PARSER_OK;
+        }
+        if (status != KDB_PARSER_OK) {
+            return status;
+        }
+    }
+    return status;
+}
+
+kdb_parser_result kdb_parse_content(
+    const uint8_t *data, size_t length,
+    const uint8_t content_hash[32],
+    kdb_group *groups, size_t group_count,
+    kdb_entry *entries, size_t entry_count)
+{
+    kdb_parser_result result = { KDB_PARSER_OK, NULL, 0 };
+    if ((data == NULL && length > 0) || content_hash == NULL ||
+        (groups == NULL && group_count > 0) || (entries == NULL && entry_count > 0))
+    {
+        result.status = KDB_PARSER_ERROR_INVALID_PARAMETER;
+        return result;
+    }
+
+    kdb_reader reader = { .data = data, .length = length };
+    sha256_init(&reader.hasher);
+    int status = KDB_PARSER_OK;
+    for (size_t i = 0; i < group_count && status == KDB_PARSER_OK; i++) {
+        status = kdb_parse_group(&reader, &groups[i]);
+        kdb_hash_parsed(&reader, 0);
+    }
+    for (size_t i = 0; i < entry_count && status == KDB_PARSER_OK; i++) {
+        status = kdb_parse_entry(&reader, &entries[i]);
+        kdb_hash_parsed(&reader, 0);
+    }
+    kdb_hash_parsed(&reader, 1);
+
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_final(&reader.hasher, digest);
+    uint8_t difference = 0;
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        difference |= digest[i] ^ content_hash[i];
+    }
+    if (difference != 0) {
+        result.status = KDB_PARSER_ERROR_HASH_MISMATCH;
+        return result;
+    }
+    result.status = status;
+    if (status != KDB_PARSER_OK) {
+        result.field_name = reader.field_name;
+        result.offset = reader.position;
+    }
+    return result;
+}
@@ -0,0 +1,113 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef kdb_parser_h
+#define kdb_parser_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Parser of the decrypted content of KeePass 1.x (KDB) databases.
+/// Records do not own their strings and binaries: slices point directly into the parsed buffer,
+/// which must outlive them.
+
+typedef enum {
+    KDB_PARSER_OK = 0,
+    KDB_PARSER_ERROR_HASH_MISMATCH = -1,    // content hash does not match, usually a wrong key
+    KDB_PARSER_ERROR_PREMATURE_END = -2,
+    KDB_PARSER_ERROR_CORRUPTED_FIELD = -3,  // see kdb_parser_result.field_name
+    KDB_PARSER_ERROR_INVALID_PARAMETER = -4
+} kdb_parser_status;
+
+/// Smallest possible size of a group or entry record (a lone end-of-record field).
+#define KDB_MIN_RECORD_SIZE 6
+
+/// Timestamp used by KeePass 1.x for "never expires", as decoded by the parser.
+#define KDB_TIME_NEVER 32503420799LL
+
+/// A piece of the parsed buffer. `bytes` is NULL when the field is absent.
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+} kdb_slice;
+
+/// Bits of `fields` of the records, set for each non-string field present in the data.
+enum {
+    KDB_FIELD_GROUP_ID = 1 << 0,  // ID of the group itself, or of the entry's group
+    KDB_FIELD_ICON_ID = 1 << 1,
+    KDB_FIELD_CREATION_TIME = 1 << 2,
+    KDB_FIELD_LAST_MODIFICATION_TIME = 1 << 3,
+    KDB_FIELD_LAST_ACCESS_TIME = 1 << 4,
+    KDB_FIELD_EXPIRY_TIME = 1 << 5,
+    KDB_FIELD_LEVEL = 1 << 6,
+    KDB_FIELD_FLAGS = 1 << 7,
+    KDB_FIELD_UUID = 1 << 8
+};
+
+/// Timestamps are the stored local date and time, as seconds since 1970-01-01 00:00:00
+/// (that is, not adjusted for any time zone). Out-of-range components are carried over,
+/// so "Feb 30" becomes "Mar 2".
+typedef struct {
+    uint32_t fields;
+    int32_t group_id;
+    uint32_t icon_id;
+    int32_t flags;
+    uint16_t level;
+    kdb_slice name;  // without the trailing zero, as are all the string slices
+    int64_t creation_time;
+    int64_t last_modification_time;
+    int64_t last_access_time;
+    int64_t expiry_time;
+} kdb_group;
+
+typedef struct {
+    uint32_t fields;
+    uint8_t uuid[16];
+    int32_t group_id;
+    uint32_t icon_id;
+    uint8_t is_meta_stream;  // internal KeePass data disguised as an entry
+    kdb_slice title;
+    kdb_slice url;
+    kdb_slice username;
+    kdb_slice password;
+    kdb_slice notes;
+    kdb_slice binary_desc;   // attachment name
+    kdb_slice binary_data;   // attachment contents
+    int64_t creation_time;
+    int64_t last_modification_time;
+    int64_t last_access_time;
+    int64_t expiry_time;
+} kdb_entry;
+
+typedef struct {
+    int status;              // kdb_parser_status
+    const char *field_name;  // for KDB_PARSER_ERROR_CORRUPTED_FIELD, such as "Entry/Title"
+    size_t offset;           // where the error was found
+} kdb_parser_result;
+
+/// Verifies the content hash and decodes `group_count` groups followed by `entry_count` entries,
+/// in one pass over `data`. The hash is checked even if parsing fails,
+/// and a mismatch takes precedence over format errors.
+/// @param  content_hash  SHA-256 of the content, from the KDB header
+/// @param  groups        receives `group_count` records
+/// @param  entries       receives `entry_count` records
+kdb_parser_result kdb_parse_content(
+    const uint8_t *data, size_t length,
+    const uint8_t content_hash[32],
+    kdb_group *groups, size_t group_count,
+    kdb_entry *entries, size_t entry_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* kdb_parser_h */
@@ -0,0 +1,291 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "kdbx_time.h"
+
+#include <string.h>
+
+#include "../base64/base64.h"
+
+#define KDBX_SECONDS_PER_DAY 86400
+/* days from 0001-01-01 to 1970-01-01 */
+#define KDBX_DAYS_TO_UNIX_EPOCH 719162
+/* 0001-01-01T00:00:00Z .. 9999-12-31T23:59:59Z */
+#define KDBX_ISO8601_MAX_SECONDS 315537897599LL
+
+static inline int kdbx_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void kdbx_trim(const char **text, size_t *length) {
+    const char *start = *text;
+    const char *end = start + *length;
+    while (start < end && kdbx_is_space(*start)) {
+        start++;
+    }
+    while (end > start && kdbx_is_space(end[-1])) {
+        end--;
+    }
+    *text = start;
+    *length = (size_t)(end - start);
+}
+
+/*
+ * Reads `count` decimal digits. Any non-digit sets bits above 9 in `*invalid`,
+ * so a whole timestamp can be validated with a single check at the end.
+ */
+static inline int kdbx_digits(const char *p, int count, unsigned *invalid) {
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        const unsigned digit = (unsigned)(uint8_t)p[i] - '0';
+        *invalid |= digit & ~0xFu;
+        *invalid |= (digit > 9);
+        value = value * 10 + (int)digit;
+    }
+    return value;
+}
+
+/* Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm). */
+static int64_t kdbx_days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= (m <= 2);
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static void kdbx_civil_from_days(int64_t z, int64_t *year, unsigned *month, unsigned *day) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    *day = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = (int64_t)yoe + era * 400 + (*month <= 2);
+}
+
+static unsigned kdbx_days_in_month(int year, unsigned month) {
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const int is_leap = (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+    return days[month - 1] + (month == 2 && is_leap);
+}
+
+/***************Parsing*****************/
+
+static int kdbx_time_parse_base64(const char *text, size_t length, int64_t *kdbx_seconds) {
+    if (length != KDBX_TIME_BASE64_LENGTH) {
+        return KDBX_TIME_ERROR;
+    }
+    uint8_t bytes[9];
+    size_t decoded_length = 0;
+    if (base64_decode(text, length, bytes, &decoded_length) != BASE64_OK || decoded_length != 8) {
+        return KDBX_TIME_ERROR;
+    }
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    *kdbx_seconds = (int64_t)value;
+    return 0;
+}
+
+static int kdbx_time_parse_iso8601(const char *text, size_t length, int64_t *kdbx_seconds) {
+    /* YYYY-MM-DDTHH:MM:SS */
+    if (length < 20) {
+        return KDBX_TIME_ERROR;
+    }
+    unsigned invalid = 0;
+    const int year = kdbx_digits(text, 4, &invalid);
+    const unsigned month = (unsigned)kdbx_digits(text + 5, 2, &invalid);
+    const unsigned day = (unsigned)kdbx_digits(text + 8, 2, &invalid);
+    const unsigned hour = (unsigned)kdbx_digits(text + 11, 2, &invalid);
+    const unsigned minute = (unsigned)kdbx_digits(text + 14, 2, &invalid);
+    const unsigned second = (unsigned)kdbx_digits(text + 17, 2, &invalid);
+    invalid |= (text[4] != '-') | (text[7] != '-') | (text[10] != 'T');
+    invalid |= (text[13] != ':') | (text[16] != ':');
+    invalid |= (year < 1) | (month - 1 > 11) | (hour > 23) | (minute > 59) | (second > 59);
+    if (invalid || day < 1 || day > kdbx_days_in_month(year, month)) {
+        return KDBX_TIME_ERROR;
+    }
+
+    const char *p = text + 19;
+    const char *end = text + length;
+    if (*p == '.') { /* fractional seconds are truncated */
+        p++;
+        const char *digits = p;
+        while (p < end && (unsigned)(uint8_t)*p - '0' <= 9) {
+            p++;
+        }
+        if (p == digits) {
+            return KDBX_TIME_ERROR;
+        }
+    }
+
+    int64_t offset = 0;
+    const size_t rest = (size_t)(end - p);
+    if (rest == 1 && (*p == 'Z' || *p == 'z')) {
+        offset = 0;
+    } else if (rest == 4 && (memcmp(p, " GMT", 4) == 0 || memcmp(p, " UTC", 4) == 0)) {
+        offset = 0;
+    } else if ((rest == 6 && p[3] == ':') || rest == 5) {
+        if (*p != '+' && *p != '-') {
+            return KDBX_TIME_ERROR;
+        }
+        const unsigned offset_hours = (unsigned)kdbx_digits(p + 1, 2, &invalid);
+        const unsigned offset_minutes = (unsigned)kdbx_digits(p + (rest == 6 ? 4 : 3), 2, &invalid);
+        if (invalid || offset_hours > 23 || offset_minutes > 59) {
+            return KDBX_TIME_ERROR;
+        }
+        offset = (int64_t)(offset_hours * 3600 + offset_minutes * 60);
+        if (*p == '-') {
+            offset = -offset;
+        }
+    } else {
+        return KDBX_TIME_ERROR;
+    }
+
+    const int64_t days = kdbx_days_from_civil(year, month, day) + KDBX_DAYS_TO_UNIX_EPOCH;
+    *kdbx_seconds = days * KDBX_SECONDS_PER_DAY + hour * 3600 + minute * 60 + second - offset;
+    return 0;
+}
+
+int kdbx_time_parse_as(const char *text, size_t length, kdbx_time_format format, int64_t *kdbx_seconds) {
+    if (!text || !kdbx_seconds) {
+        return KDBX_TIME_ERROR;
+    }
+    kdbx_trim(&text, &length);
+    switch (format) {
+    case KDBX_TIME_FORMAT_BASE64:
+        return kdbx_time_parse_base64(text, length, kdbx_seconds);
+    case KDBX_TIME_FORMAT_ISO8601:
+        return kdbx_time_parse_iso8601(text, length, kdbx_seconds);
+    }
+    return KDBX_TIME_ERROR;
+}
+
+int kdbx_time_parse(const char *text, size_t length, kdbx_time_format preferred_format, int64_t *kdbx_seconds) {
+    if (!text || !kdbx_seconds) {
+        return KDBX_TIME_ERROR;
+    }
+    kdbx_trim(&text, &length);
+    /* the formats have distinct lengths, so the cheap length check picks the candidate */
+    if (preferred_format == KDBX_TIME_FORMAT_BASE64) {
+        if (kdbx_time_parse_base64(text, length, kdbx_seconds) == 0) {
+            return KDBX_TIME_FORMAT_BASE64;
+        }
+        if (kdbx_time_parse_iso8601(text, length, kdbx_seconds) == 0) {
+            return KDBX_TIME_FORMAT_ISO8601;
+        }
+    } else {
+        if (kdbx_time_parse_iso8601(text, length, kdbx_seconds) == 0) {
+            return KDBX_TIME_FORMAT_ISO8601;
+        }
+        if (kdbx_time_parse_base64(text, length, kdbx_seconds) == 0) {
+            return KDBX_TIME_FORMAT_BASE64;
+        }
+    }
+    return KDBX_TIME_ERROR;
+}
+
+/***************Formatting*****************/
+
+static inline void kdbx_put2(char *out, unsigned value) {
+    out[0] = (char)('0' + value / 10);
+    out[1] = (char)('0' + value % 10);
+}
+
+static size_t kdbx_time_format_iso8601(int64_t kdbx_seconds, char *out) {
+    if (kdbx_seconds < 0 || kdbx_seconds > KDBX_ISO8601_MAX_SECONDS) {
+        return 0;
+    }
+    const int64_t days = kdbx_seconds / KDBX_SECONDS_PER_DAY;
+    unsigned seconds_of_day = (unsigned)(kdbx_seconds % KDBX_SECONDS_PER_DAY);
+    int64_t year;
+    unsigned month, day;
+    kdbx_civil_from_days(days - KDBX_DAYS_TO_UNIX_EPOCH, &year, &month, &day);
+
+    kdbx_put2(out, (unsigned)(year / 100));
+    kdbx_put2(out + 2, (unsigned)(year % 100));
+    out[4] = '-';
+    kdbx_put2(out + 5, month);
+    out[7] = '-';
+    kdbx_put2(out + 8, day);
+    out[10] = 'T';
+    kdbx_put2(out + 11, seconds_of_day / 3600);
+    out[13] = ':';
+    seconds_of_day %= 3600;
+    kdbx_put2(out + 14, seconds_of_day / 60);
+    out[16] = ':';
+    kdbx_put2(out + 17, seconds_of_day % 60);
+    out[19] = 'Z';
+    return KDBX_TIME_ISO8601_LENGTH;
+}
+
+static size_t kdbx_time_format_base64(int64_t kdbx_seconds, char *out) {
+    uint8_t bytes[8];
+    uint64_t value = (uint64_t)kdbx_seconds;
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t)value;
+        value >>= 8;
+    }
+    return base64_encode(bytes, sizeof(bytes), out);
+}
+
+size_t kdbx_time_format_as(int64_t kdbx_seconds, kdbx_time_format format, char *out) {
+    if (!out) {
+        return 0;
+    }
+    switch (format) {
+    case KDBX_TIME_FORMAT_BASE64:
+        return kdbx_time_format_base64(kdbx_seconds, out);
+    case KDBX_TIME_FORMAT_ISO8601:
+        return kdbx_time_format_iso8601(kdbx_seconds, out);
+    }
+    return 0;
+}
+
+/***************Batch*****************/
+
+size_t kdbx_time_parse_batch(const char *const *texts, const size_t *lengths, size_t count,
+                             kdbx_time_format preferred_format,
+                             int64_t *kdbx_seconds, int8_t *matched_formats)
+{
+    if (!texts || !lengths || !kdbx_seconds) {
+        return 0;
+    }
+    size_t parsed = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t value = 0;
+        const int format = kdbx_time_parse(texts[i], lengths[i], preferred_format, &value);
+        const int is_ok = (format >= 0);
+        kdbx_seconds[i] = is_ok ? value : 0;
+        if (matched_formats) {
+            matched_formats[i] = (int8_t)format;
+        }
+        parsed += (size_t)is_ok;
+    }
+    return parsed;
+}
+
+size_t kdbx_time_format_batch(const int64_t *kdbx_seconds, size_t count, kdbx_time_format format,
+                              char *out, size_t stride, uint8_t *out_lengths)
+{
+    if (!kdbx_seconds || !out || !out_lengths || stride < KDBX_TIME_MAX_LENGTH) {
+        return 0;
+    }
+    size_t formatted = 0;
+    for (size_t i = 0; i < count; i++) {
+        const size_t length = kdbx_time_format_as(kdbx_seconds[i], format, out + i * stride);
+        out_lengths[i] = (uint8_t)length;
+        formatted += (length != 0);
+    }
+    return formatted;
+}
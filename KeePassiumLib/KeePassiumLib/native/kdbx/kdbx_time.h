@@ -0,0 +1,82 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef kdbx_time_h
+#define kdbx_time_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Timestamps are handled as "KDBX seconds": whole seconds since 0001-01-01T00:00:00Z,
+/// which is what KDBX4 stores (as base64 of a little-endian int64).
+/// Seconds between 0001-01-01T00:00:00Z and 1970-01-01T00:00:00Z.
+#define KDBX_TIME_UNIX_EPOCH_OFFSET 62135596800LL
+
+/// Length of a KDBX4 base64 timestamp ("AAAAAAAAAAA=").
+#define KDBX_TIME_BASE64_LENGTH 12
+/// Length of an ISO-8601 timestamp produced by the formatter ("2001-02-03T04:05:06Z").
+#define KDBX_TIME_ISO8601_LENGTH 20
+/// Output buffer size sufficient for any supported format.
+#define KDBX_TIME_MAX_LENGTH 20
+
+typedef enum {
+    KDBX_TIME_FORMAT_BASE64 = 0,  // KDBX4
+    KDBX_TIME_FORMAT_ISO8601 = 1  // KDBX3
+} kdbx_time_format;
+
+#define KDBX_TIME_ERROR (-1)
+
+/// Parses a timestamp in the given format. Leading and trailing whitespace is ignored.
+/// ISO-8601 input may have fractional seconds (truncated), and a time zone
+/// as "Z", "±HH:MM", "±HHMM", " GMT" or " UTC".
+/// @param  text  UTF-8 characters (not necessarily zero-terminated)
+/// @param  length  number of characters
+/// @param  format  expected format
+/// @param  kdbx_seconds  parsed value
+/// @return 0 on success, KDBX_TIME_ERROR otherwise
+int kdbx_time_parse_as(const char *text, size_t length, kdbx_time_format format, int64_t *kdbx_seconds);
+
+/// Parses a timestamp trying the `preferred_format` first, and then the other one.
+/// @return the format that matched (kdbx_time_format), or KDBX_TIME_ERROR
+int kdbx_time_parse(const char *text, size_t length, kdbx_time_format preferred_format, int64_t *kdbx_seconds);
+
+/// Formats a timestamp. Does not append a terminating zero.
+/// @param  kdbx_seconds  time to format
+/// @param  format  output format
+/// @param  out  output buffer of at least KDBX_TIME_MAX_LENGTH characters
+/// @return number of characters written; 0 if the time cannot be represented
+///         in the format (ISO-8601 covers years 0001 to 9999).
+size_t kdbx_time_format_as(int64_t kdbx_seconds, kdbx_time_format format, char *out);
+
+/// Parses `count` timestamps in one call.
+/// @param  texts  array of `count` character pointers
+/// @param  lengths  array of `count` lengths
+/// @param  preferred_format  see kdbx_time_parse()
+/// @param  kdbx_seconds  array of `count` results (0 for failed items)
+/// @param  matched_formats  optional array of `count` matched formats (KDBX_TIME_ERROR for failed items)
+/// @return number of successfully parsed items
+size_t kdbx_time_parse_batch(const char *const *texts, const size_t *lengths, size_t count,
+                             kdbx_time_format preferred_format,
+                             int64_t *kdbx_seconds, int8_t *matched_formats);
+
+/// Formats `count` timestamps in one call.
+/// Item `i` is written at `out + i * stride`, its length is stored in `out_lengths[i]` (0 on failure).
+/// @param  stride  distance between items, at least KDBX_TIME_MAX_LENGTH
+/// @return number of successfully formatted items
+size_t kdbx_time_format_batch(const int64_t *kdbx_seconds, size_t count, kdbx_time_format format,
+                              char *out, size_t stride, uint8_t *out_lengths);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* kdbx_time_h */
@@ -0,0 +1,766 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "kdbx_writer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <CommonCrypto/CommonCrypto.h>
+
+#include "../../crypto/aes/aes_cbc.h"
+#include "../../crypto/chacha20/chacha20.h"
+#include "../../crypto/instrumentation/crypto_stats.h"
+#include "../../crypto/twofish/twofish.h"
+
+/* Size of the plain and compressed chunks passed between the stages */
+#define KDBX_CHUNK_SIZE (256 * 1024)
+/* Max number of chunks waiting in each queue; bounds the pipeline memory */
+#define KDBX_QUEUE_CAPACITY 4
+/* Max number of chunks in use at once: both queues full, plus the one being filled
+   by the producer, the input and output of the compressor, and the encryptor's input */
+#define KDBX_POOL_CAPACITY (2 * KDBX_QUEUE_CAPACITY + 4)
+#define KDBX_CBC_BLOCK_SIZE 16
+#define KDBX_CHACHA20_BLOCK_SIZE 64
+#define KDBX_HMAC_KEY_SIZE 64
+
+typedef struct {
+    uint8_t *bytes;
+    size_t length;
+} kdbx_chunk;
+
+/* Chunks are allocated on demand, up to the capacity, and then recycled. */
+typedef struct {
+    kdbx_chunk chunks[KDBX_POOL_CAPACITY];
+    kdbx_chunk *free_chunks[KDBX_POOL_CAPACITY];
+    unsigned allocated_count;
+    unsigned free_count;
+    int is_aborted;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+} kdbx_chunk_pool;
+
+typedef struct {
+    kdbx_chunk *slots[KDBX_QUEUE_CAPACITY];
+    unsigned head;
+    unsigned count;
+    int is_closed;  /* no more chunks will be pushed */
+    int is_aborted; /* the pipeline has failed, drop everything */
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} kdbx_queue;
+
+struct kdbx_writer {
+    kdbx_cipher_id cipher;
+    int compress;
+    kdbx_writer_output_fptr output;
+    const void *user_obj;
+
+    /* cipher state */
+    aes_cbc_context *aes_context;
+    Twofish_key twofish_key;
+    uint8_t cbc_iv[KDBX_CBC_BLOCK_SIZE];
+    uint8_t chacha_key[32];
+    uint8_t chacha_iv[12];
+    uint32_t chacha_counter;
+    uint8_t chacha_block[KDBX_CHACHA20_BLOCK_SIZE];
+    size_t chacha_pos;
+
+    /* HMAC block framing */
+    uint8_t hmac_key[KDBX_HMAC_KEY_SIZE];
+    uint64_t block_index;
+    uint8_t *block;        /* encrypted bytes, followed by a not-yet-encrypted CBC tail */
+    size_t encrypted_length;
+    size_t tail_length;
+
+    /* compression */
+    z_stream zstream;
+    int is_zstream_ready;
+
+    /* optional instrumentation; compression and encryption stages update separate fields */
+    crypto_stats *stats;
+
+    /* producer side */
+    kdbx_chunk_pool pool;
+    kdbx_chunk *pending;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+
+    kdbx_queue plain_queue;
+    kdbx_queue packed_queue;
+    pthread_t compressor_thread;
+    pthread_t encryptor_thread;
+    int are_threads_running;
+    int is_finished;
+    int status;
+};
+
+/* Pointer to memset that the compiler cannot optimize away. */
+static void *(*const volatile kdbx_memset_sec)(void *, int, size_t) = &memset;
+
+static void kdbx_wipe(void *bytes, size_t length) {
+    if (bytes && length) {
+        kdbx_memset_sec(bytes, 0, length);
+    }
+}
+
+static void kdbx_store32_le(uint8_t *dst, uint32_t w) {
+    dst[0] = (uint8_t)w; w >>= 8;
+    dst[1] = (uint8_t)w; w >>= 8;
+    dst[2] = (uint8_t)w; w >>= 8;
+    dst[3] = (uint8_t)w;
+}
+
+static void kdbx_store64_le(uint8_t *dst, uint64_t w) {
+    kdbx_store32_le(dst, (uint32_t)w);
+    kdbx_store32_le(dst + 4, (uint32_t)(w >> 32));
+}
+
+static int kdbx_get_status(kdbx_writer *w) {
+    return __atomic_load_n(&w->status, __ATOMIC_ACQUIRE);
+}
+
+/***************Chunks and queues*****************/
+
+static int kdbx_pool_init(kdbx_chunk_pool *pool) {
+    memset(pool->chunks, 0, sizeof(pool->chunks));
+    pool->allocated_count = 0;
+    pool->free_count = 0;
+    pool->is_aborted = 0;
+    if (pthread_mutex_init(&pool->mutex, NULL)) {
+        return -1;
+    }
+    if (pthread_cond_init(&pool->not_empty, NULL)) {
+        pthread_mutex_destroy(&pool->mutex);
+        return -1;
+    }
+    return 0;
+}
+
+/* Wipes and releases all the chunks, including those still in the queues. */
+static void kdbx_pool_free(kdbx_chunk_pool *pool) {
+    unsigned i;
+    for (i = 0; i < pool->allocated_count; i++) {
+        kdbx_wipe(pool->chunks[i].bytes, KDBX_CHUNK_SIZE);
+        free(pool->chunks[i].bytes);
+    }
+    pool->allocated_count = 0;
+    pool->free_count = 0;
+    pthread_cond_destroy(&pool->not_empty);
+    pthread_mutex_destroy(&pool->mutex);
+}
+
+/* Returns an empty chunk, waiting for one to be recycled if all are in use.
+   Returns NULL if the pipeline has been aborted or memory is insufficient. */
+static kdbx_chunk *kdbx_pool_get(kdbx_chunk_pool *pool) {
+    kdbx_chunk *chunk = NULL;
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->free_count == 0 && pool->allocated_count == KDBX_POOL_CAPACITY && !pool->is_aborted) {
+        pthread_cond_wait(&pool->not_empty, &pool->mutex);
+    }
+    if (!pool->is_aborted) {
+        if (pool->free_count > 0) {
+            chunk = pool->free_chunks[--pool->free_count];
+        } else {
+            kdbx_chunk *fresh = &pool->chunks[pool->allocated_count];
+            fresh->bytes = malloc(KDBX_CHUNK_SIZE);
+            if (fresh->bytes) {
+                pool->allocated_count++;
+                chunk = fresh;
+            }
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    if (chunk) {
+        chunk->length = 0;
+    }
+    return chunk;
+}
+
+static void kdbx_pool_put(kdbx_chunk_pool *pool, kdbx_chunk *chunk) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->free_chunks[pool->free_count++] = chunk;
+    pthread_cond_signal(&pool->not_empty);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void kdbx_pool_abort(kdbx_chunk_pool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->is_aborted = 1;
+    pthread_cond_broadcast(&pool->not_empty);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static int kdbx_queue_init(kdbx_queue *q) {
+    memset(q->slots, 0, sizeof(q->slots));
+    q->head = 0;
+    q->count = 0;
+    q->is_closed = 0;
+    q->is_aborted = 0;
+    if (pthread_mutex_init(&q->mutex, NULL)) {
+        return -1;
+    }
+    if (pthread_cond_init(&q->not_empty, NULL)) {
+        pthread_mutex_destroy(&q->mutex);
+        return -1;
+    }
+    if (pthread_cond_init(&q->not_full, NULL)) {
+        pthread_cond_destroy(&q->not_empty);
+        pthread_mutex_destroy(&q->mutex);
+        return -1;
+    }
+    return 0;
+}
+
+/* Queued chunks belong to the pool, which releases them. */
+static void kdbx_queue_free(kdbx_queue *q) {
+    q->count = 0;
+    pthread_cond_destroy(&q->not_full);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_mutex_destroy(&q->mutex);
+}
+
+/* Returns -1 if the pipeline has been aborted; the chunk is then left to the pool. */
+static int kdbx_queue_push(kdbx_queue *q, kdbx_chunk *chunk) {
+    pthread_mutex_lock(&q->mutex);
+    while (q->count == KDBX_QUEUE_CAPACITY && !q->is_aborted) {
+        pthread_cond_wait(&q->not_full, &q->mutex);
+    }
+    if (q->is_aborted) {
+        pthread_mutex_unlock(&q->mutex);
+        return -1;
+    }
+    q->slots[(q->head + q->count) % KDBX_QUEUE_CAPACITY] = chunk;
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->mutex);
+    return 0;
+}
+
+/* Returns NULL once the queue is closed and drained, or aborted. */
+static kdbx_chunk *kdbx_queue_pop(kdbx_queue *q) {
+    kdbx_chunk *chunk = NULL;
+    pthread_mutex_lock(&q->mutex);
+    while (q->count == 0 && !q->is_closed && !q->is_aborted) {
+        pthread_cond_wait(&q->not_empty, &q->mutex);
+    }
+    if (q->count > 0 && !q->is_aborted) {
+        chunk = q->slots[q->head];
+        q->slots[q->head] = NULL;
+        q->head = (q->head + 1) % KDBX_QUEUE_CAPACITY;
+        q->count--;
+        pthread_cond_signal(&q->not_full);
+    }
+    pthread_mutex_unlock(&q->mutex);
+    return chunk;
+}
+
+static void kdbx_queue_close(kdbx_queue *q) {
+    pthread_mutex_lock(&q->mutex);
+    q->is_closed = 1;
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+static void kdbx_queue_abort(kdbx_queue *q) {
+    pthread_mutex_lock(&q->mutex);
+    q->is_aborted = 1;
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_cond_broadcast(&q->not_full);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+/* Records the first error and unblocks all the stages. */
+static void kdbx_fail(kdbx_writer *w, int status) {
+    int expected = KDBX_WRITER_OK;
+    __atomic_compare_exchange_n(&w->status, &expected, status, 0,
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    kdbx_queue_abort(&w->plain_queue);
+    kdbx_queue_abort(&w->packed_queue);
+    kdbx_pool_abort(&w->pool);
+}
+
+/***************HMAC block framing*****************/
+
+static int kdbx_emit_block(kdbx_writer *w, const uint8_t *data, uint32_t length) {
+    uint8_t index_bytes[8];
+    uint8_t size_bytes[4];
+    uint8_t key_material[8 + KDBX_HMAC_KEY_SIZE];
+    uint8_t block_key[CC_SHA512_DIGEST_LENGTH];
+    uint8_t block_header[CC_SHA256_DIGEST_LENGTH + 4];
+    CCHmacContext hmac;
+
+    kdbx_store64_le(index_bytes, w->block_index);
+    kdbx_store32_le(size_bytes, length);
+
+    memcpy(key_material, index_bytes, sizeof(index_bytes));
+    memcpy(key_material + sizeof(index_bytes), w->hmac_key, KDBX_HMAC_KEY_SIZE);
+    CC_SHA512(key_material, (CC_LONG)sizeof(key_material), block_key);
+
+    const uint64_t phase_start = crypto_phase_begin(w->stats);
+    CCHmacInit(&hmac, kCCHmacAlgSHA256, block_key, sizeof(block_key));
+    CCHmacUpdate(&hmac, index_bytes, sizeof(index_bytes));
+    CCHmacUpdate(&hmac, size_bytes, sizeof(size_bytes));
+    if (length > 0) {
+        CCHmacUpdate(&hmac, data, length);
+    }
+    CCHmacFinal(&hmac, block_header);
+    crypto_phase_end(w->stats, CRYPTO_OPERATION_KDBX_WRITER, CRYPTO_PHASE_AUTHENTICATE, phase_start, length);
+    memcpy(block_header + CC_SHA256_DIGEST_LENGTH, size_bytes, sizeof(size_bytes));
+
+    kdbx_wipe(key_material, sizeof(key_material));
+    kdbx_wipe(block_key, sizeof(block_key));
+    kdbx_wipe(&hmac, sizeof(hmac));
+
+    if (w->output(block_header, sizeof(block_header), w->user_obj)) {
+        return KDBX_WRITER_INTERRUPTED;
+    }
+    if (length > 0 && w->output(data, length, w->user_obj)) {
+        return KDBX_WRITER_INTERRUPTED;
+    }
+    w->bytes_out += sizeof(block_header) + length;
+    w->block_index++;
+    return KDBX_WRITER_OK;
+}
+
+static int kdbx_emit_full_blocks(kdbx_writer *w) {
+    while (w->encrypted_length >= KDBX_WRITER_BLOCK_SIZE) {
+        int status = kdbx_emit_block(w, w->block, KDBX_WRITER_BLOCK_SIZE);
+        if (status != KDBX_WRITER_OK) {
+            return status;
+        }
+        size_t remaining = w->encrypted_length - KDBX_WRITER_BLOCK_SIZE + w->tail_length;
+        memmove(w->block, w->block + KDBX_WRITER_BLOCK_SIZE, remaining);
+        w->encrypted_length -= KDBX_WRITER_BLOCK_SIZE;
+    }
+    return KDBX_WRITER_OK;
+}
+
+/***************Bulk ciphers*****************/
+
+static int kdbx_is_cbc(const kdbx_writer *w) {
+    return w->cipher != KDBX_CIPHER_CHACHA20;
+}
+
+/* Encrypts `length` bytes in place; for CBC ciphers, length must be block-aligned. */
+static int kdbx_encrypt_in_place(kdbx_writer *w, uint8_t *bytes, size_t length) {
+    size_t i;
+    switch (w->cipher) {
+    case KDBX_CIPHER_AES256_CBC: {
+        size_t moved = 0;
+        if (length == 0) {
+            return KDBX_WRITER_OK;
+        }
+        /* whole blocks only, so nothing is kept pending and in-place is allowed */
+        int status = aes_cbc_update(w->aes_context, bytes, length, bytes, length, &moved);
+        if (status != AES_CBC_OK || moved != length) {
+            return KDBX_WRITER_CIPHER_ERROR;
+        }
+        return KDBX_WRITER_OK;
+    }
+    case KDBX_CIPHER_TWOFISH_CBC: {
+        uint8_t block[KDBX_CBC_BLOCK_SIZE];
+        for (i = 0; i < length; i += KDBX_CBC_BLOCK_SIZE) {
+            unsigned j;
+            for (j = 0; j < KDBX_CBC_BLOCK_SIZE; j++) {
+                block[j] = bytes[i + j] ^ w->cbc_iv[j];
+            }
+            Twofish_encrypt(&w->twofish_key, block, w->cbc_iv);
+            memcpy(bytes + i, w->cbc_iv, KDBX_CBC_BLOCK_SIZE);
+        }
+        kdbx_wipe(block, sizeof(block));
+        return KDBX_WRITER_OK;
+    }
+    case KDBX_CIPHER_CHACHA20:
+        for (i = 0; i < length; i++) {
+            if (w->chacha_pos == KDBX_CHACHA20_BLOCK_SIZE) {
+                uint8_t counter_bytes[4];
+                kdbx_store32_le(counter_bytes, w->chacha_counter);
+                chacha20_make_block(w->chacha_key, w->chacha_iv, counter_bytes, w->chacha_block);
+                w->chacha_counter++;
+                w->chacha_pos = 0;
+            }
+            bytes[i] ^= w->chacha_block[w->chacha_pos++];
+        }
+        return KDBX_WRITER_OK;
+    }
+    return KDBX_WRITER_INVALID_PARAMETER;
+}
+
+static int kdbx_encrypt_and_frame(kdbx_writer *w, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        size_t space = KDBX_WRITER_BLOCK_SIZE + KDBX_CBC_BLOCK_SIZE
+                       - (w->encrypted_length + w->tail_length);
+        size_t n = (length < space) ? length : space;
+        memcpy(w->block + w->encrypted_length + w->tail_length, bytes, n);
+        w->tail_length += n;
+        bytes += n;
+        length -= n;
+
+        size_t aligned = w->tail_length;
+        if (kdbx_is_cbc(w)) {
+            aligned -= aligned % KDBX_CBC_BLOCK_SIZE;
+        }
+        const uint64_t phase_start = crypto_phase_begin(w->stats);
+        int status = kdbx_encrypt_in_place(w, w->block + w->encrypted_length, aligned);
+        if (status != KDBX_WRITER_OK) {
+            return status;
+        }
+        crypto_phase_end(w->stats, CRYPTO_OPERATION_KDBX_WRITER, CRYPTO_PHASE_TRANSFORM, phase_start, aligned);
+        if (w->stats) {
+            w->stats->bytes_processed += aligned;
+        }
+        w->encrypted_length += aligned;
+        w->tail_length -= aligned;
+
+        status = kdbx_emit_full_blocks(w);
+        if (status != KDBX_WRITER_OK) {
+            return status;
+        }
+    }
+    return KDBX_WRITER_OK;
+}
+
+static int kdbx_finish_encryption(kdbx_writer *w) {
+    int status;
+    if (kdbx_is_cbc(w)) {
+        /* PKCS7 padding, always at least one byte */
+        uint8_t pad = (uint8_t)(KDBX_CBC_BLOCK_SIZE - w->tail_length);
+        memset(w->block + w->encrypted_length + w->tail_length, pad, pad);
+        w->tail_length += pad;
+        status = kdbx_encrypt_in_place(w, w->block + w->encrypted_length, w->tail_length);
+        if (status != KDBX_WRITER_OK) {
+            return status;
+        }
+        w->encrypted_length += w->tail_length;
+        w->tail_length = 0;
+    }
+    status = kdbx_emit_full_blocks(w);
+    if (status != KDBX_WRITER_OK) {
+        return status;
+    }
+    if (w->encrypted_length > 0) {
+        status = kdbx_emit_block(w, w->block, (uint32_t)w->encrypted_length);
+        if (status != KDBX_WRITER_OK) {
+            return status;
+        }
+        w->encrypted_length = 0;
+    }
+    /* terminating empty block */
+    return kdbx_emit_block(w, NULL, 0);
+}
+
+/***************Pipeline stages*****************/
+
+static int kdbx_deflate_chunk(kdbx_writer *w, const uint8_t *bytes, size_t length, int flush) {
+    w->zstream.next_in = (Bytef *)bytes;
+    w->zstream.avail_in = (uInt)length;
+    do {
+        kdbx_chunk *out = kdbx_pool_get(&w->pool);
+        if (!out) {
+            return (kdbx_get_status(w) != KDBX_WRITER_OK) ? KDBX_WRITER_INTERRUPTED : KDBX_WRITER_MEMORY_ERROR;
+        }
+        w->zstream.next_out = out->bytes;
+        w->zstream.avail_out = KDBX_CHUNK_SIZE;
+        const uint64_t phase_start = crypto_phase_begin(w->stats);
+        int zstatus = deflate(&w->zstream, flush);
+        crypto_phase_end(w->stats, CRYPTO_OPERATION_KDBX_WRITER, CRYPTO_PHASE_COMPRESS, phase_start,
+                         KDBX_CHUNK_SIZE - w->zstream.avail_out);
+        if (zstatus == Z_STREAM_ERROR) {
+            kdbx_pool_put(&w->pool, out);
+            return KDBX_WRITER_COMPRESSION_ERROR;
+        }
+        out->length = KDBX_CHUNK_SIZE - w->zstream.avail_out;
+        if (out->length == 0) {
+            kdbx_pool_put(&w->pool, out);
+        } else if (kdbx_queue_push(&w->packed_queue, out)) {
+            return KDBX_WRITER_INTERRUPTED;
+        }
+    } while (w->zstream.avail_out == 0);
+    return KDBX_WRITER_OK;
+}
+
+static void *kdbx_compressor_main(void *arg) {
+    kdbx_writer *w = arg;
+    kdbx_chunk *chunk;
+    int status = KDBX_WRITER_OK;
+
+    while ((chunk = kdbx_queue_pop(&w->plain_queue)) != NULL) {
+        if (w->compress) {
+            status = kdbx_deflate_chunk(w, chunk->bytes, chunk->length, Z_NO_FLUSH);
+            kdbx_pool_put(&w->pool, chunk);
+        } else {
+            status = kdbx_queue_push(&w->packed_queue, chunk) ? KDBX_WRITER_INTERRUPTED : KDBX_WRITER_OK;
+        }
+        if (status != KDBX_WRITER_OK) {
+            kdbx_fail(w, status);
+            return NULL;
+        }
+    }
+    if (kdbx_get_status(w) != KDBX_WRITER_OK) {
+        return NULL;
+    }
+    if (w->compress) {
+        status = kdbx_deflate_chunk(w, NULL, 0, Z_FINISH);
+        if (status != KDBX_WRITER_OK) {
+            kdbx_fail(w, status);
+            return NULL;
+        }
+    }
+    kdbx_queue_close(&w->packed_queue);
+    return NULL;
+}
+
+static void *kdbx_encryptor_main(void *arg) {
+    kdbx_writer *w = arg;
+    kdbx_chunk *chunk;
+    int status;
+
+    while ((chunk = kdbx_queue_pop(&w->packed_queue)) != NULL) {
+        status = kdbx_encrypt_and_frame(w, chunk->bytes, chunk->length);
+        kdbx_pool_put(&w->pool, chunk);
+        if (status != KDBX_WRITER_OK) {
+            kdbx_fail(w, status);
+            return NULL;
+        }
+    }
+    if (kdbx_get_status(w) != KDBX_WRITER_OK) {
+        return NULL;
+    }
+    status = kdbx_finish_encryption(w);
+    if (status != KDBX_WRITER_OK) {
+        kdbx_fail(w, status);
+    }
+    return NULL;
+}
+
+/***************Public interface*****************/
+
+static int kdbx_init_cipher(kdbx_writer *w, const uint8_t *key, const uint8_t *iv, size_t iv_length) {
+    switch (w->cipher) {
+    case KDBX_CIPHER_AES256_CBC:
+        if (iv_length != KDBX_CBC_BLOCK_SIZE) {
+            return KDBX_WRITER_INVALID_PARAMETER;
+        }
+        /* CBC without padding, PKCS7 is added manually at the end */
+        w->aes_context = aes_cbc_create(AES_CBC_ENCRYPT, key, iv, 0);
+        if (!w->aes_context) {
+            return KDBX_WRITER_CIPHER_ERROR;
+        }
+        return KDBX_WRITER_OK;
+    case KDBX_CIPHER_TWOFISH_CBC: {
+        uint8_t key_copy[32];
+        if (iv_length != KDBX_CBC_BLOCK_SIZE) {
+            return KDBX_WRITER_INVALID_PARAMETER;
+        }
+        if (Twofish_initialise() != 0) {
+            return KDBX_WRITER_CIPHER_ERROR;
+        }
+        memcpy(key_copy, key, sizeof(key_copy));
+        int status = Twofish_prepare_key(key_copy, sizeof(key_copy), &w->twofish_key);
+        kdbx_wipe(key_copy, sizeof(key_copy));
+        if (status != 0) {
+            return KDBX_WRITER_CIPHER_ERROR;
+        }
+        memcpy(w->cbc_iv, iv, KDBX_CBC_BLOCK_SIZE);
+        return KDBX_WRITER_OK;
+    }
+    case KDBX_CIPHER_CHACHA20:
+        if (iv_length != sizeof(w->chacha_iv)) {
+            return KDBX_WRITER_INVALID_PARAMETER;
+        }
+        memcpy(w->chacha_key, key, sizeof(w->chacha_key));
+        memcpy(w->chacha_iv, iv, sizeof(w->chacha_iv));
+        w->chacha_counter = 0;
+        w->chacha_pos = KDBX_CHACHA20_BLOCK_SIZE;
+        return KDBX_WRITER_OK;
+    }
+    return KDBX_WRITER_INVALID_PARAMETER;
+}
+
+kdbx_writer *kdbx_writer_create(kdbx_cipher_id cipher,
+                                const uint8_t *key,
+                                const uint8_t *iv, size_t iv_length,
+                                const uint8_t *hmac_key,
+                                int compress,
+                                kdbx_writer_output_fptr output, const void *user_obj) {
+    if (!key || !iv || !hmac_key || !output) {
+        return NULL;
+    }
+    kdbx_writer *w = calloc(1, sizeof(kdbx_writer));
+    if (!w) {
+        return NULL;
+    }
+    w->cipher = cipher;
+    w->compress = compress;
+    w->output = output;
+    w->user_obj = user_obj;
+    w->status = KDBX_WRITER_OK;
+    memcpy(w->hmac_key, hmac_key, KDBX_HMAC_KEY_SIZE);
+
+    if (kdbx_pool_init(&w->pool)) {
+        kdbx_wipe(w, sizeof(kdbx_writer));
+        free(w);
+        return NULL;
+    }
+    w->block = malloc(KDBX_WRITER_BLOCK_SIZE + 2 * KDBX_CBC_BLOCK_SIZE);
+    w->pending = kdbx_pool_get(&w->pool);
+    if (!w->block || !w->pending) {
+        goto fail;
+    }
+    if (kdbx_init_cipher(w, key, iv, iv_length) != KDBX_WRITER_OK) {
+        goto fail;
+    }
+    if (compress) {
+        /* gzip wrapper, same settings as Data.gzipped(level: .bestCompression) */
+        if (deflateInit2(&w->zstream, Z_BEST_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16,
+                         MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+            goto fail;
+        }
+        w->is_zstream_ready = 1;
+    }
+    if (kdbx_queue_init(&w->plain_queue)) {
+        goto fail;
+    }
+    if (kdbx_queue_init(&w->packed_queue)) {
+        kdbx_queue_free(&w->plain_queue);
+        goto fail;
+    }
+    if (pthread_create(&w->compressor_thread, NULL, kdbx_compressor_main, w)) {
+        goto fail_queues;
+    }
+    if (pthread_create(&w->encryptor_thread, NULL, kdbx_encryptor_main, w)) {
+        kdbx_queue_abort(&w->plain_queue);
+        pthread_join(w->compressor_thread, NULL);
+        goto fail_queues;
+    }
+    w->are_threads_running = 1;
+    return w;
+
+fail_queues:
+    kdbx_queue_free(&w->packed_queue);
+    kdbx_queue_free(&w->plain_queue);
+fail:
+    if (w->is_zstream_ready) {
+        deflateEnd(&w->zstream);
+    }
+    aes_cbc_free(w->aes_context);
+    kdbx_pool_free(&w->pool);
+    free(w->block);
+    kdbx_wipe(w, sizeof(kdbx_writer));
+    free(w);
+    return NULL;
+}
+
+int kdbx_writer_write(kdbx_writer *w, const uint8_t *bytes, size_t length) {
+    if (!w || (!bytes && length > 0)) {
+        return KDBX_WRITER_INVALID_PARAMETER;
+    }
+    if (w->is_finished) {
+        return KDBX_WRITER_FINISHED;
+    }
+    if (!w->pending) {
+        return kdbx_get_status(w);
+    }
+    while (length > 0) {
+        int status = kdbx_get_status(w);
+        if (status != KDBX_WRITER_OK) {
+            return status;
+        }
+        size_t space = KDBX_CHUNK_SIZE - w->pending->length;
+        size_t n = (length < space) ? length : space;
+        memcpy(w->pending->bytes + w->pending->length, bytes, n);
+        w->pending->length += n;
+        w->bytes_in += n;
+        bytes += n;
+        length -= n;
+
+        if (w->pending->length == KDBX_CHUNK_SIZE) {
+            kdbx_chunk *full = w->pending;
+            w->pending = NULL;
+            if (kdbx_queue_push(&w->plain_queue, full)) {
+                return kdbx_get_status(w);
+            }
+            w->pending = kdbx_pool_get(&w->pool);
+            if (!w->pending) {
+                status = kdbx_get_status(w);
+                if (status != KDBX_WRITER_OK) {
+                    return status;
+                }
+                kdbx_fail(w, KDBX_WRITER_MEMORY_ERROR);
+                return KDBX_WRITER_MEMORY_ERROR;
+            }
+        }
+    }
+    return kdbx_get_status(w);
+}
+
+static void kdbx_join_workers(kdbx_writer *w) {
+    if (w->are_threads_running) {
+        pthread_join(w->compressor_thread, NULL);
+        pthread_join(w->encryptor_thread, NULL);
+        w->are_threads_running = 0;
+    }
+}
+
+int kdbx_writer_finish(kdbx_writer *w) {
+    if (!w) {
+        return KDBX_WRITER_INVALID_PARAMETER;
+    }
+    if (w->is_finished) {
+        return kdbx_get_status(w);
+    }
+    w->is_finished = 1;
+    if (w->pending && w->pending->length > 0) {
+        kdbx_chunk *last = w->pending;
+        w->pending = NULL;
+        kdbx_queue_push(&w->plain_queue, last);
+    }
+    kdbx_queue_close(&w->plain_queue);
+    kdbx_join_workers(w);
+    return kdbx_get_status(w);
+}
+
+void kdbx_writer_destroy(kdbx_writer *w) {
+    if (!w) {
+        return;
+    }
+    if (w->are_threads_running) {
+        kdbx_fail(w, KDBX_WRITER_INTERRUPTED);
+        kdbx_join_workers(w);
+    }
+    kdbx_queue_free(&w->packed_queue);
+    kdbx_queue_free(&w->plain_queue);
+    if (w->is_zstream_ready) {
+        deflateEnd(&w->zstream);
+    }
+    aes_cbc_free(w->aes_context);
+    Twofish_clear_key(&w->twofish_key);
+    kdbx_pool_free(&w->pool);
+    kdbx_wipe(w->block, KDBX_WRITER_BLOCK_SIZE + 2 * KDBX_CBC_BLOCK_SIZE);
+    free(w->block);
+    kdbx_wipe(w, sizeof(kdbx_writer));
+    free(w);
+}
+
+void kdbx_writer_set_stats(kdbx_writer *w, crypto_stats *stats) {
+    /* the workers only touch `stats` after receiving a chunk through a queue, which orders the accesses */
+    if (w && w->bytes_in == 0 && !w->is_finished) {
+        w->stats = stats;
+    }
+}
+
+uint64_t kdbx_writer_bytes_in(const kdbx_writer *w) {
+    return w ? w->bytes_in : 0;
+}
+
+uint64_t kdbx_writer_bytes_out(const kdbx_writer *w) {
+    return w ? w->bytes_out : 0;
+}
@@ -0,0 +1,100 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef kdbx_writer_h
+#define kdbx_writer_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto_stats.h"
+
+/// Bulk ciphers supported by the streaming writer.
+typedef enum {
+    KDBX_CIPHER_AES256_CBC = 0,
+    KDBX_CIPHER_CHACHA20 = 1,
+    KDBX_CIPHER_TWOFISH_CBC = 2
+} kdbx_cipher_id;
+
+typedef enum {
+    KDBX_WRITER_OK = 0,
+    KDBX_WRITER_INVALID_PARAMETER = -1,
+    KDBX_WRITER_MEMORY_ERROR = -2,
+    KDBX_WRITER_COMPRESSION_ERROR = -3,
+    KDBX_WRITER_CIPHER_ERROR = -4,
+    KDBX_WRITER_THREAD_ERROR = -5,
+    KDBX_WRITER_INTERRUPTED = -6,
+    KDBX_WRITER_FINISHED = -7
+} kdbx_writer_status;
+
+/// Size of KDBX4 HMAC blocks produced by the writer (matches the Swift implementation).
+#define KDBX_WRITER_BLOCK_SIZE (1024 * 1024)
+
+/// Receives ready-to-store output (block HMAC, block size and encrypted block data).
+/// Called from the writer's worker thread, in output order.
+/// @param  bytes  output bytes
+/// @param  length  number of output bytes
+/// @param  user_obj  any object passed to kdbx_writer_create()
+/// @return zero to continue, anything else to stop and return KDBX_WRITER_INTERRUPTED
+typedef int (*kdbx_writer_output_fptr)(const uint8_t *bytes, size_t length, const void *user_obj);
+
+typedef struct kdbx_writer kdbx_writer;
+
+/// Creates a streaming KDBX4 content writer.
+/// The plain content pushed by kdbx_writer_write() is optionally gzipped, encrypted
+/// and split into HMAC-authenticated blocks. Compression and encryption run
+/// on two worker threads, connected by bounded queues. Intermediate buffers
+/// come from a fixed-size pool and are recycled, so memory use does not depend on content size.
+/// Key material is copied internally and wiped once the writer is destroyed.
+/// @param  cipher  bulk cipher to use
+/// @param  key  cipher key (32 bytes)
+/// @param  iv  initial vector (16 bytes for CBC ciphers, 12 bytes for ChaCha20)
+/// @param  iv_length  size of `iv`
+/// @param  hmac_key  64-byte HMAC base key
+/// @param  compress  non-zero to gzip the content before encryption
+/// @param  output  callback that receives the result
+/// @param  user_obj  any object to be passed to `output`
+/// @return writer instance or NULL in case of wrong parameters or insufficient memory
+kdbx_writer *kdbx_writer_create(kdbx_cipher_id cipher,
+                                const uint8_t *key,
+                                const uint8_t *iv, size_t iv_length,
+                                const uint8_t *hmac_key,
+                                int compress,
+                                kdbx_writer_output_fptr output, const void *user_obj);
+
+/// Pushes a piece of plain content into the pipeline.
+/// Blocks only when all the intermediate buffers are busy.
+/// @return KDBX_WRITER_OK or an error reported by any of the pipeline stages
+int kdbx_writer_write(kdbx_writer *writer, const uint8_t *bytes, size_t length);
+
+/// Flushes all the stages, writes the terminating block and waits for the workers to finish.
+/// @return KDBX_WRITER_OK or the first error reported by any of the pipeline stages
+int kdbx_writer_finish(kdbx_writer *writer);
+
+/// Stops the workers (if still running), wipes and releases all the writer's memory.
+void kdbx_writer_destroy(kdbx_writer *writer);
+
+/// Makes the writer add per-stage timings (compress, transform, authenticate) to `stats`.
+/// Must be called before the first kdbx_writer_write(); `stats` must outlive the writer.
+void kdbx_writer_set_stats(kdbx_writer *w, crypto_stats *stats);
+
+/// Number of plain content bytes pushed so far.
+uint64_t kdbx_writer_bytes_in(const kdbx_writer *writer);
+
+/// Number of output bytes delivered so far.
+uint64_t kdbx_writer_bytes_out(const kdbx_writer *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* kdbx_writer_h */
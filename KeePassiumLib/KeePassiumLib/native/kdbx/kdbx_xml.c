@@ -0,0 +1,735 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "kdbx_xml.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define KDBX_XML_INITIAL_NAMES 64    /* KDBX files use about 80 distinct element names */
+#define KDBX_XML_INITIAL_DEPTH 32
+#define KDBX_XML_INITIAL_ATTRIBUTES 4
+
+typedef struct {
+    const uint8_t *bytes;
+    uint32_t length;
+    uint32_t hash;
+} kdbx_xml_name;
+
+typedef struct {
+    kdbx_xml_slice name;
+    kdbx_xml_slice value;
+} kdbx_xml_attribute;
+
+typedef enum {
+    KDBX_XML_STATE_PROLOG = 0,  /* before the document element */
+    KDBX_XML_STATE_CONTENT,     /* inside the document element */
+    KDBX_XML_STATE_EPILOG,      /* after the document element */
+    KDBX_XML_STATE_FAILED
+} kdbx_xml_state;
+
+struct kdbx_xml_reader {
+    uint8_t *buffer;
+    uint8_t *pos;
+    uint8_t *end;
+    kdbx_xml_state state;
+    int error;
+
+    /* interned names; `names` is indexed by name ID, `name_slots` is an open-addressing hash of IDs + 1 */
+    kdbx_xml_name *names;
+    uint32_t name_count;
+    uint32_t name_capacity;
+    uint32_t *name_slots;
+    uint32_t slot_mask;
+
+    /* open elements */
+    uint32_t *stack;
+    size_t depth;
+    size_t stack_capacity;
+
+    /* current event */
+    uint32_t name_id;
+    int last_event;
+    int has_pending_end;
+    kdbx_xml_attribute *attributes;
+    size_t attribute_count;
+    size_t attribute_capacity;
+
+    /* character data of the current element, compacted in place */
+    uint8_t *text;
+    size_t text_length;
+    int has_text;
+    kdbx_xml_slice value;
+};
+
+/*
+ * Character classes:
+ * 1 - whitespace, 2 - terminates a name, 4 - needs special handling in character data
+ */
+static const uint8_t kdbx_xml_char_class[256] = {
+    ['\t'] = 1 | 2, ['\n'] = 1 | 2 | 4, ['\r'] = 1 | 2 | 4, [' '] = 1 | 2,
+    ['/'] = 2, ['>'] = 2, ['='] = 2, ['<'] = 2 | 4, ['&'] = 4,
+    ['"'] = 2, ['\''] = 2, ['?'] = 2
+};
+
+static inline int kdbx_xml_is_space(uint8_t c) {
+    return kdbx_xml_char_class[c] & 1;
+}
+
+static inline int kdbx_xml_is_name_end(uint8_t c) {
+    return kdbx_xml_char_class[c] & 2;
+}
+
+static int kdbx_xml_fail(kdbx_xml_reader *r, int error) {
+    r->state = KDBX_XML_STATE_FAILED;
+    r->error = error;
+    return error;
+}
+
+static int kdbx_xml_starts_with(const kdbx_xml_reader *r, const uint8_t *p, const char *prefix, size_t length) {
+    return (size_t)(r->end - p) >= length && memcmp(p, prefix, length) == 0;
+}
+
+/* Returns the position right after `terminator`, or NULL if it is not found. */
+static uint8_t *kdbx_xml_skip_past(const kdbx_xml_reader *r, uint8_t *p, const char *terminator, size_t length) {
+    while ((size_t)(r->end - p) >= length) {
+        uint8_t *found = memchr(p, terminator[0], (size_t)(r->end - p) - length + 1);
+        if (!found) {
+            return NULL;
+        }
+        if (memcmp(found, terminator, length) == 0) {
+            return found + length;
+        }
+        p = found + 1;
+    }
+    return NULL;
+}
+
+static uint8_t *kdbx_xml_skip_spaces(const kdbx_xml_reader *r, uint8_t *p) {
+    while (p < r->end && kdbx_xml_is_space(*p)) {
+        p++;
+    }
+    return p;
+}
+
+/***************Name interning*****************/
+
+static uint32_t kdbx_xml_hash(const uint8_t *bytes, size_t length) {
+    uint32_t hash = 2166136261u; /* FNV-1a */
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int kdbx_xml_rehash(kdbx_xml_reader *r, uint32_t slot_count) {
+    uint32_t *slots = calloc(slot_count, sizeof(uint32_t));
+    if (!slots) {
+        return KDBX_XML_ERROR_MEMORY;
+    }
+    uint32_t mask = slot_count - 1;
+    for (uint32_t id = 0; id < r->name_count; id++) {
+        uint32_t slot = r->names[id].hash & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = id + 1;
+    }
+    free(r->name_slots);
+    r->name_slots = slots;
+    r->slot_mask = mask;
+    return 0;
+}
+
+/* Returns the name ID (>= 0) or an error code. */
+static int64_t kdbx_xml_intern(kdbx_xml_reader *r, const uint8_t *bytes, size_t length) {
+    if (length > UINT32_MAX) {
+        return KDBX_XML_ERROR_SYNTAX;
+    }
+    uint32_t hash = kdbx_xml_hash(bytes, length);
+    uint32_t slot = hash & r->slot_mask;
+    while (r->name_slots[slot] != 0) {
+        const kdbx_xml_name *name = &r->names[r->name_slots[slot] - 1];
+        if (name->hash == hash && name->length == length && memcmp(name->bytes, bytes, length) == 0) {
+            return r->name_slots[slot] - 1;
+        }
+        slot = (slot + 1) & r->slot_mask;
+    }
+
+    if (r->name_count == r->name_capacity) {
+        uint32_t capacity = r->name_capacity * 2;
+        kdbx_xml_name *names = realloc(r->names, capacity * sizeof(kdbx_xml_name));
+        if (!names) {
+            return KDBX_XML_ERROR_MEMORY;
+        }
+        r->names = names;
+        r->name_capacity = capacity;
+    }
+    uint32_t id = r->name_count++;
+    r->names[id].bytes = bytes;
+    r->names[id].length = (uint32_t)length;
+    r->names[id].hash = hash;
+    r->name_slots[slot] = id + 1;
+
+    /* keep the load factor under 1/2 */
+    if (r->name_count * 2 > r->slot_mask + 1) {
+        int status = kdbx_xml_rehash(r, (r->slot_mask + 1) * 2);
+        if (status != 0) {
+            return status;
+        }
+    }
+    return id;
+}
+
+/***************Lifecycle*****************/
+
+kdbx_xml_reader *kdbx_xml_reader_create(uint8_t *buffer, size_t length) {
+    if (!buffer && length > 0) {
+        return NULL;
+    }
+    kdbx_xml_reader *r = calloc(1, sizeof(kdbx_xml_reader));
+    if (!r) {
+        return NULL;
+    }
+    r->buffer = buffer;
+    r->pos = buffer;
+    r->end = buffer + length;
+    r->state = KDBX_XML_STATE_PROLOG;
+
+    r->name_capacity = KDBX_XML_INITIAL_NAMES;
+    r->names = malloc(r->name_capacity * sizeof(kdbx_xml_name));
+    r->stack_capacity = KDBX_XML_INITIAL_DEPTH;
+    r->stack = malloc(r->stack_capacity * sizeof(uint32_t));
+    r->attribute_capacity = KDBX_XML_INITIAL_ATTRIBUTES;
+    r->attributes = malloc(r->attribute_capacity * sizeof(kdbx_xml_attribute));
+    if (!r->names || !r->stack || !r->attributes || kdbx_xml_rehash(r, KDBX_XML_INITIAL_NAMES * 2) != 0) {
+        kdbx_xml_reader_destroy(r);
+        return NULL;
+    }
+
+    /* skip UTF-8 BOM */
+    if (length >= 3 && buffer[0] == 0xEF && buffer[1] == 0xBB && buffer[2] == 0xBF) {
+        r->pos += 3;
+    }
+    return r;
+}
+
+void kdbx_xml_reader_destroy(kdbx_xml_reader *r) {
+    if (!r) {
+        return;
+    }
+    free(r->names);
+    free(r->name_slots);
+    free(r->stack);
+    free(r->attributes);
+    free(r);
+}
+
+/***************Character data*****************/
+
+static size_t kdbx_xml_encode_utf8(uint32_t cp, uint8_t *out) {
+    if (cp < 0x80) {
+        out[0] = (uint8_t)cp;
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = (uint8_t)(0xC0 | (cp >> 6));
+        out[1] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = (uint8_t)(0xE0 | (cp >> 12));
+        out[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 3;
+    } else {
+        out[0] = (uint8_t)(0xF0 | (cp >> 18));
+        out[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 4;
+    }
+}
+
+/*
+ * Decodes the entity reference at `*src` (which points to '&') into `*dst`.
+ * The decoded form is never longer than the reference, so `dst` may trail `src` in the same buffer.
+ */
+static int kdbx_xml_decode_entity(const kdbx_xml_reader *r, uint8_t **src, uint8_t **dst) {
+    uint8_t *p = *src + 1;
+    uint8_t *semicolon = NULL;
+    for (uint8_t *q = p; q < r->end && q - p <= 10; q++) {
+        if (*q == ';') {
+            semicolon = q;
+            break;
+        }
+    }
+    if (!semicolon || semicolon == p) {
+        return KDBX_XML_ERROR_ENTITY;
+    }
+    size_t length = (size_t)(semicolon - p);
+
+    uint8_t decoded[4];
+    size_t decoded_length = 1;
+    if (length == 3 && memcmp(p, "amp", 3) == 0) {
+        decoded[0] = '&';
+    } else if (length == 2 && memcmp(p, "lt", 2) == 0) {
+        decoded[0] = '<';
+    } else if (length == 2 && memcmp(p, "gt", 2) == 0) {
+        decoded[0] = '>';
+    } else if (length == 4 && memcmp(p, "quot", 4) == 0) {
+        decoded[0] = '"';
+    } else if (length == 4 && memcmp(p, "apos", 4) == 0) {
+        decoded[0] = '\'';
+    } else if (p[0] == '#' && length > 1) {
+        uint32_t cp = 0;
+        int is_hex = (p[1] == 'x');
+        uint8_t *digit = p + (is_hex ? 2 : 1);
+        if (digit == semicolon) {
+            return KDBX_XML_ERROR_ENTITY;
+        }
+        for (; digit < semicolon; digit++) {
+            uint8_t c = *digit;
+            uint32_t value;
+            if (c >= '0' && c <= '9') {
+                value = c - '0';
+            } else if (is_hex && c >= 'a' && c <= 'f') {
+                value = c - 'a' + 10;
+            } else if (is_hex && c >= 'A' && c <= 'F') {
+                value = c - 'A' + 10;
+            } else {
+                return KDBX_XML_ERROR_ENTITY;
+            }
+            cp = cp * (is_hex ? 16 : 10) + value;
+            if (cp > 0x10FFFF) {
+                return KDBX_XML_ERROR_ENTITY;
+            }
+        }
+        if (cp == 0 || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return KDBX_XML_ERROR_ENTITY;
+        }
+        decoded_length = kdbx_xml_encode_utf8(cp, decoded);
+    } else {
+        return KDBX_XML_ERROR_ENTITY;
+    }
+
+    memmove(*dst, decoded, decoded_length);
+    *dst += decoded_length;
+    *src = semicolon + 1;
+    return 0;
+}
+
+/*
+ * Reads character data up to the next markup tag, appending it to the current text.
+ * Comments and processing instructions are skipped, CDATA sections are unwrapped.
+ */
+static int kdbx_xml_read_text(kdbx_xml_reader *r) {
+    uint8_t *src = r->pos;
+    if (!r->has_text) {
+        r->text = src;
+        r->text_length = 0;
+    }
+    uint8_t *dst = r->text + r->text_length;
+    uint8_t *const start_dst = dst;
+
+    while (src < r->end) {
+        uint8_t c = *src;
+        if (!(kdbx_xml_char_class[c] & 4)) {
+            if (dst != src) {
+                *dst = c;
+            }
+            dst++;
+            src++;
+            continue;
+        }
+        if (c == '<') {
+            if (kdbx_xml_starts_with(r, src, "<![CDATA[", 9)) {
+                uint8_t *data = src + 9;
+                uint8_t *after = kdbx_xml_skip_past(r, data, "]]>", 3);
+                if (!after) {
+                    return KDBX_XML_ERROR_UNEXPECTED_END;
+                }
+                size_t length = (size_t)(after - 3 - data);
+                memmove(dst, data, length);
+                dst += length;
+                src = after;
+            } else if (kdbx_xml_starts_with(r, src, "<!--", 4)) {
+                src = kdbx_xml_skip_past(r, src + 4, "-->", 3);
+                if (!src) {
+                    return KDBX_XML_ERROR_UNEXPECTED_END;
+                }
+            } else if (kdbx_xml_starts_with(r, src, "<?", 2)) {
+                src = kdbx_xml_skip_past(r, src + 2, "?>", 2);
+                if (!src) {
+                    return KDBX_XML_ERROR_UNEXPECTED_END;
+                }
+            } else {
+                break;
+            }
+        } else if (c == '&') {
+            int status = kdbx_xml_decode_entity(r, &src, &dst);
+            if (status != 0) {
+                return status;
+            }
+        } else { /* line breaks: CRLF and CR become LF */
+            if (c == '\r') {
+                src++;
+                if (src < r->end && *src == '\n') {
+                    src++;
+                }
+            } else {
+                src++;
+            }
+            *dst++ = '\n';
+        }
+    }
+    r->pos = src;
+    if (dst != start_dst) {
+        r->has_text = 1;
+        r->text_length = (size_t)(dst - r->text);
+    }
+    return 0;
+}
+
+/* Decodes attribute value [start, end) in place, returns the decoded length or an error code. */
+static int64_t kdbx_xml_decode_attribute(const kdbx_xml_reader *r, uint8_t *start, uint8_t *end) {
+    uint8_t *src = start;
+    uint8_t *dst = start;
+    while (src < end) {
+        uint8_t c = *src;
+        if (c == '&') {
+            int status = kdbx_xml_decode_entity(r, &src, &dst);
+            if (status != 0 || src > end) {
+                return KDBX_XML_ERROR_ENTITY;
+            }
+        } else if (c == '<') {
+            return KDBX_XML_ERROR_SYNTAX;
+        } else if (c == '\r' && src + 1 < end && src[1] == '\n') {
+            *dst++ = ' ';
+            src += 2;
+        } else {
+            *dst++ = kdbx_xml_is_space(c) ? ' ' : c;
+            src++;
+        }
+    }
+    return dst - start;
+}
+
+/***************Tags*****************/
+
+static int kdbx_xml_push_attribute(kdbx_xml_reader *r, kdbx_xml_slice name, kdbx_xml_slice value) {
+    if (r->attribute_count == r->attribute_capacity) {
+        size_t capacity = r->attribute_capacity * 2;
+        kdbx_xml_attribute *attributes = realloc(r->attributes, capacity * sizeof(kdbx_xml_attribute));
+        if (!attributes) {
+            return KDBX_XML_ERROR_MEMORY;
+        }
+        r->attributes = attributes;
+        r->attribute_capacity = capacity;
+    }
+    r->attributes[r->attribute_count].name = name;
+    r->attributes[r->attribute_count].value = value;
+    r->attribute_count++;
+    return 0;
+}
+
+static int kdbx_xml_push_element(kdbx_xml_reader *r, uint32_t name_id) {
+    if (r->depth == r->stack_capacity) {
+        size_t capacity = r->stack_capacity * 2;
+        uint32_t *stack = realloc(r->stack, capacity * sizeof(uint32_t));
+        if (!stack) {
+            return KDBX_XML_ERROR_MEMORY;
+        }
+        r->stack = stack;
+        r->stack_capacity = capacity;
+    }
+    r->stack[r->depth++] = name_id;
+    return 0;
+}
+
+static uint8_t *kdbx_xml_scan_name(const kdbx_xml_reader *r, uint8_t *p) {
+    while (p < r->end && !kdbx_xml_is_name_end(*p) && *p != '<' && *p != '&') {
+        p++;
+    }
+    return p;
+}
+
+/* Parses a start tag; `r->pos` points right after '<'. */
+static int kdbx_xml_read_start_tag(kdbx_xml_reader *r) {
+    uint8_t *name = r->pos;
+    uint8_t *p = kdbx_xml_scan_name(r, name);
+    if (p == name) {
+        return KDBX_XML_ERROR_SYNTAX;
+    }
+    int64_t name_id = kdbx_xml_intern(r, name, (size_t)(p - name));
+    if (name_id < 0) {
+        return (int)name_id;
+    }
+
+    r->attribute_count = 0;
+    while (1) {
+        uint8_t *after_space = kdbx_xml_skip_spaces(r, p);
+        if (after_space >= r->end) {
+            return KDBX_XML_ERROR_UNEXPECTED_END;
+        }
+        if (*after_space == '>') {
+            p = after_space + 1;
+            r->has_pending_end = 0;
+            break;
+        }
+        if (*after_space == '/') {
+            if (after_space + 1 >= r->end) {
+                return KDBX_XML_ERROR_UNEXPECTED_END;
+            }
+            if (after_space[1] != '>') {
+                return KDBX_XML_ERROR_SYNTAX;
+            }
+            p = after_space + 2;
+            r->has_pending_end = 1;
+            break;
+        }
+        if (after_space == p) { /* attributes must be separated by whitespace */
+            return KDBX_XML_ERROR_SYNTAX;
+        }
+
+        uint8_t *attr_name = after_space;
+        p = kdbx_xml_scan_name(r, attr_name);
+        if (p == attr_name) {
+            return KDBX_XML_ERROR_SYNTAX;
+        }
+        uint8_t *attr_name_end = p;
+        p = kdbx_xml_skip_spaces(r, p);
+        if (p >= r->end || *p != '=') {
+            return p >= r->end ? KDBX_XML_ERROR_UNEXPECTED_END : KDBX_XML_ERROR_SYNTAX;
+        }
+        p = kdbx_xml_skip_spaces(r, p + 1);
+        if (p >= r->end) {
+            return KDBX_XML_ERROR_UNEXPECTED_END;
+        }
+        uint8_t quote = *p;
+        if (quote != '"' && quote != '\'') {
+            return KDBX_XML_ERROR_SYNTAX;
+        }
+        uint8_t *value = p + 1;
+        uint8_t *value_end = memchr(value, quote, (size_t)(r->end - value));
+        if (!value_end) {
+            return KDBX_XML_ERROR_UNEXPECTED_END;
+        }
+        int64_t value_length = kdbx_xml_decode_attribute(r, value, value_end);
+        if (value_length < 0) {
+            return (int)value_length;
+        }
+        kdbx_xml_slice name_slice = { attr_name, (size_t)(attr_name_end - attr_name) };
+        kdbx_xml_slice value_slice = { value, (size_t)value_length };
+        int status = kdbx_xml_push_attribute(r, name_slice, value_slice);
+        if (status != 0) {
+            return status;
+        }
+        p = value_end + 1;
+    }
+
+    int status = kdbx_xml_push_element(r, (uint32_t)name_id);
+    if (status != 0) {
+        return status;
+    }
+    r->pos = p;
+    r->name_id = (uint32_t)name_id;
+    r->last_event = KDBX_XML_START;
+    r->has_text = 0;
+    r->text = NULL;
+    r->text_length = 0;
+    return KDBX_XML_START;
+}
+
+/* Parses an end tag; `r->pos` points right after "</". */
+static int kdbx_xml_read_end_tag(kdbx_xml_reader *r) {
+    uint8_t *name = r->pos;
+    uint8_t *p = kdbx_xml_scan_name(r, name);
+    if (p == name) {
+        return KDBX_XML_ERROR_SYNTAX;
+    }
+    if (r->depth == 0) {
+        return KDBX_XML_ERROR_TAG_MISMATCH;
+    }
+    const kdbx_xml_name *expected = &r->names[r->stack[r->depth - 1]];
+    size_t length = (size_t)(p - name);
+    if (length != expected->length || memcmp(name, expected->bytes, length) != 0) {
+        return KDBX_XML_ERROR_TAG_MISMATCH;
+    }
+    p = kdbx_xml_skip_spaces(r, p);
+    if (p >= r->end) {
+        return KDBX_XML_ERROR_UNEXPECTED_END;
+    }
+    if (*p != '>') {
+        return KDBX_XML_ERROR_SYNTAX;
+    }
+    r->pos = p + 1;
+    r->name_id = r->stack[--r->depth];
+    return KDBX_XML_END;
+}
+
+/* Skips everything allowed outside of the document element; returns position of the next tag or `end`. */
+static int kdbx_xml_skip_misc(kdbx_xml_reader *r) {
+    uint8_t *p = r->pos;
+    while (1) {
+        p = kdbx_xml_skip_spaces(r, p);
+        if (p >= r->end) {
+            break;
+        }
+        if (*p != '<') {
+            return KDBX_XML_ERROR_SYNTAX;
+        }
+        if (kdbx_xml_starts_with(r, p, "<?", 2)) {
+            p = kdbx_xml_skip_past(r, p + 2, "?>", 2);
+        } else if (kdbx_xml_starts_with(r, p, "<!--", 4)) {
+            p = kdbx_xml_skip_past(r, p + 4, "-->", 3);
+        } else if (kdbx_xml_starts_with(r, p, "<!", 2)) {
+            return KDBX_XML_ERROR_UNSUPPORTED; /* DOCTYPE */
+        } else {
+            break;
+        }
+        if (!p) {
+            return KDBX_XML_ERROR_UNEXPECTED_END;
+        }
+    }
+    r->pos = p;
+    return 0;
+}
+
+static int kdbx_xml_end_event(kdbx_xml_reader *r, int has_value) {
+    if (has_value) {
+        r->value.bytes = r->text;
+        r->value.length = r->text_length;
+    } else {
+        r->value.bytes = NULL;
+        r->value.length = 0;
+    }
+    r->has_text = 0;
+    if (r->last_event != KDBX_XML_START) {
+        r->attribute_count = 0; /* leaf elements keep their attributes until the end tag */
+    }
+    r->last_event = KDBX_XML_END;
+    if (r->depth == 0) {
+        r->state = KDBX_XML_STATE_EPILOG;
+    }
+    return KDBX_XML_END;
+}
+
+int kdbx_xml_reader_next(kdbx_xml_reader *r) {
+    int status;
+    switch (r->state) {
+    case KDBX_XML_STATE_FAILED:
+        return r->error;
+    case KDBX_XML_STATE_PROLOG:
+        status = kdbx_xml_skip_misc(r);
+        if (status != 0) {
+            return kdbx_xml_fail(r, status);
+        }
+        if (r->pos >= r->end) {
+            return kdbx_xml_fail(r, KDBX_XML_ERROR_UNEXPECTED_END);
+        }
+        if (kdbx_xml_starts_with(r, r->pos, "</", 2)) {
+            return kdbx_xml_fail(r, KDBX_XML_ERROR_TAG_MISMATCH);
+        }
+        r->pos++;
+        status = kdbx_xml_read_start_tag(r);
+        if (status < 0) {
+            return kdbx_xml_fail(r, status);
+        }
+        r->state = KDBX_XML_STATE_CONTENT;
+        return status;
+    case KDBX_XML_STATE_EPILOG:
+        status = kdbx_xml_skip_misc(r);
+        if (status != 0) {
+            return kdbx_xml_fail(r, status);
+        }
+        if (r->pos < r->end) {
+            return kdbx_xml_fail(r, KDBX_XML_ERROR_SYNTAX); /* second document element */
+        }
+        return KDBX_XML_DONE;
+    case KDBX_XML_STATE_CONTENT:
+        break;
+    }
+
+    if (r->has_pending_end) {
+        r->has_pending_end = 0;
+        r->depth--;
+        return kdbx_xml_end_event(r, 0);
+    }
+
+    status = kdbx_xml_read_text(r);
+    if (status != 0) {
+        return kdbx_xml_fail(r, status);
+    }
+    if (r->end - r->pos < 2) {
+        return kdbx_xml_fail(r, KDBX_XML_ERROR_UNEXPECTED_END);
+    }
+    /* r->pos is at '<' of a tag */
+    if (r->pos[1] == '/') {
+        r->pos += 2;
+        status = kdbx_xml_read_end_tag(r);
+        if (status < 0) {
+            return kdbx_xml_fail(r, status);
+        }
+        return kdbx_xml_end_event(r, r->has_text);
+    }
+    if (r->pos[1] == '!') {
+        return kdbx_xml_fail(r, KDBX_XML_ERROR_UNSUPPORTED);
+    }
+    r->pos++;
+    status = kdbx_xml_read_start_tag(r);
+    if (status < 0) {
+        return kdbx_xml_fail(r, status);
+    }
+    return status;
+}
+
+/***************Accessors*****************/
+
+uint32_t kdbx_xml_reader_name_id(const kdbx_xml_reader *r) {
+    return r->name_id;
+}
+
+kdbx_xml_slice kdbx_xml_reader_name_for_id(const kdbx_xml_reader *r, uint32_t name_id) {
+    kdbx_xml_slice result = { NULL, 0 };
+    if (name_id < r->name_count) {
+        result.bytes = r->names[name_id].bytes;
+        result.length = r->names[name_id].length;
+    }
+    return result;
+}
+
+kdbx_xml_slice kdbx_xml_reader_value(const kdbx_xml_reader *r) {
+    return r->value;
+}
+
+size_t kdbx_xml_reader_attribute_count(const kdbx_xml_reader *r) {
+    return r->attribute_count;
+}
+
+kdbx_xml_slice kdbx_xml_reader_attribute_name(const kdbx_xml_reader *r, size_t index) {
+    kdbx_xml_slice empty = { NULL, 0 };
+    return index < r->attribute_count ? r->attributes[index].name : empty;
+}
+
+kdbx_xml_slice kdbx_xml_reader_attribute_value(const kdbx_xml_reader *r, size_t index) {
+    kdbx_xml_slice empty = { NULL, 0 };
+    return index < r->attribute_count ? r->attributes[index].value : empty;
+}
+
+size_t kdbx_xml_reader_depth(const kdbx_xml_reader *r) {
+    return r->depth;
+}
+
+size_t kdbx_xml_reader_line(const kdbx_xml_reader *r) {
+    /* approximate after in-place decoding, good enough for error messages */
+    size_t line = 1;
+    for (const uint8_t *p = r->buffer; p < r->pos && p < r->end; p++) {
+        line += (*p == '\n');
+    }
+    return line;
+}
@@ -0,0 +1,89 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef kdbx_xml_h
+#define kdbx_xml_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    KDBX_XML_DONE = 0,
+    KDBX_XML_START = 1,
+    KDBX_XML_END = 2
+} kdbx_xml_event;
+
+typedef enum {
+    KDBX_XML_ERROR_SYNTAX = -1,
+    KDBX_XML_ERROR_UNEXPECTED_END = -2,
+    KDBX_XML_ERROR_TAG_MISMATCH = -3,
+    KDBX_XML_ERROR_ENTITY = -4,
+    KDBX_XML_ERROR_UNSUPPORTED = -5,
+    KDBX_XML_ERROR_MEMORY = -6
+} kdbx_xml_error;
+
+/// A piece of the parsed buffer. `bytes` is NULL when there is no such item.
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+} kdbx_xml_slice;
+
+typedef struct kdbx_xml_reader kdbx_xml_reader;
+
+/// Creates a pull parser over a complete XML document.
+/// The parser does not copy the document: all the returned names and values point
+/// directly into `buffer`. Entity references and line breaks are decoded in place,
+/// so the buffer contents are modified during parsing and must outlive the reader.
+/// DTDs are not supported.
+/// @param  buffer  UTF-8 XML document
+/// @param  length  size of `buffer`
+/// @return reader instance or NULL if out of memory
+kdbx_xml_reader *kdbx_xml_reader_create(uint8_t *buffer, size_t length);
+
+/// Releases the reader (but not the buffer).
+void kdbx_xml_reader_destroy(kdbx_xml_reader *reader);
+
+/// Advances to the next element boundary.
+/// Self-closing elements produce both KDBX_XML_START and KDBX_XML_END events.
+/// @return one of kdbx_xml_event values, or a (negative) kdbx_xml_error code
+int kdbx_xml_reader_next(kdbx_xml_reader *reader);
+
+/// Interned ID of the current element's name.
+/// Equal names always have equal IDs; IDs are assigned sequentially from zero
+/// in order of first appearance.
+uint32_t kdbx_xml_reader_name_id(const kdbx_xml_reader *reader);
+
+/// Name of the element with the given interned ID.
+kdbx_xml_slice kdbx_xml_reader_name_for_id(const kdbx_xml_reader *reader, uint32_t name_id);
+
+/// Character data between the last tag and the current end tag (KDBX_XML_END only).
+/// The slice has NULL `bytes` if there was no character data at all.
+kdbx_xml_slice kdbx_xml_reader_value(const kdbx_xml_reader *reader);
+
+/// Number of attributes of the current element.
+/// Available on KDBX_XML_START, and also on KDBX_XML_END of elements without child elements
+/// (so that leaf elements can be processed entirely at their end tag).
+size_t kdbx_xml_reader_attribute_count(const kdbx_xml_reader *reader);
+kdbx_xml_slice kdbx_xml_reader_attribute_name(const kdbx_xml_reader *reader, size_t index);
+kdbx_xml_slice kdbx_xml_reader_attribute_value(const kdbx_xml_reader *reader, size_t index);
+
+/// Nesting depth of the current element (1 for the document element).
+size_t kdbx_xml_reader_depth(const kdbx_xml_reader *reader);
+
+/// Line number (1-based) of the parsing position, for error reporting.
+size_t kdbx_xml_reader_line(const kdbx_xml_reader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* kdbx_xml_h */
@@ -0,0 +1,225 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "keyfile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../../crypto/sha256/sha256.h"
+
+/* Chunk size and alignment of the reads used when the file cannot be mapped */
+#define KEYFILE_READ_CHUNK_SIZE (1024 * 1024)
+#define KEYFILE_READ_ALIGNMENT 16384
+
+static inline void keyfile_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+static inline int keyfile_hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Decodes exactly 2 * KEYFILE_KEY_SIZE hex digits; returns 0 if there is anything else. */
+static int keyfile_decode_hex(const uint8_t *data, uint8_t key[KEYFILE_KEY_SIZE]) {
+    int valid = 1;
+    for (size_t i = 0; i < KEYFILE_KEY_SIZE; i++) {
+        const int high = keyfile_hex_value(data[2 * i]);
+        const int low = keyfile_hex_value(data[2 * i + 1]);
+        valid &= (high >= 0) & (low >= 0);
+        key[i] = (uint8_t)(((high & 0x0F) << 4) | (low & 0x0F));
+    }
+    if (!valid) {
+        keyfile_wipe(key, KEYFILE_KEY_SIZE);
+    }
+    return valid;
+}
+
+/*
+ * Whether an XML parser might accept the data: optional BOM and whitespace, then '<'.
+ * UTF-16 and UTF-32 text is reported as XML too, to let the parser decide.
+ * If the given prefix is too short to tell, it is considered XML as well.
+ */
+static int keyfile_looks_like_xml(const uint8_t *data, size_t length) {
+    if (length >= 2 && ((data[0] == 0xFE && data[1] == 0xFF) || (data[0] == 0xFF && data[1] == 0xFE))) {
+        return 1;
+    }
+    if (length >= 2 && ((data[0] == '<' && data[1] == 0) || (data[0] == 0 && data[1] == '<'))) {
+        return 1;
+    }
+    size_t i = 0;
+    if (length >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+        i = 3;
+    }
+    while (i < length && (data[i] == ' ' || data[i] == '\t' || data[i] == '\r' || data[i] == '\n')) {
+        i++;
+    }
+    return (i == length) || (data[i] == '<');
+}
+
+/* Handles the cases decided by the size and the first bytes; returns 0 if the whole file has to be hashed. */
+static int keyfile_classify(
+    const uint8_t *head,
+    size_t head_length,
+    uint64_t file_size,
+    uint8_t key[KEYFILE_KEY_SIZE],
+    keyfile_kind *kind)
+{
+    if (file_size == 0) {
+        *kind = KEYFILE_KIND_EMPTY;
+        return 1;
+    }
+    if (file_size == KEYFILE_KEY_SIZE && head_length >= KEYFILE_KEY_SIZE) {
+        memcpy(key, head, KEYFILE_KEY_SIZE);
+        *kind = KEYFILE_KIND_BINARY;
+        return 1;
+    }
+    if (file_size == 2 * KEYFILE_KEY_SIZE && head_length >= 2 * KEYFILE_KEY_SIZE && keyfile_decode_hex(head, key)) {
+        *kind = KEYFILE_KIND_HEX;
+        return 1;
+    }
+    if (keyfile_looks_like_xml(head, head_length)) {
+        *kind = KEYFILE_KIND_XML;
+        return 1;
+    }
+    return 0;
+}
+
+void keyfile_process_buffer(const uint8_t *data, size_t length, uint8_t key[KEYFILE_KEY_SIZE], keyfile_kind *kind) {
+    if (keyfile_classify(data, length, length, key, kind)) {
+        return;
+    }
+    sha256(data, length, key);
+    *kind = KEYFILE_KIND_HASHED;
+}
+
+/***************File access*****************/
+
+/*
+ * Calls the handler with the head of the file (the whole mapped file, or the first chunk),
+ * then feeds the complete contents to the hasher unless the handler returns nonzero.
+ */
+typedef int (*keyfile_head_handler)(const uint8_t *head, size_t head_length, uint64_t file_size, void *context);
+
+static int keyfile_hash_streamed(int fd, uint64_t file_size, keyfile_head_handler handler, void *context, uint8_t digest[KEYFILE_KEY_SIZE]) {
+    uint8_t *buffer = NULL;
+    if (posix_memalign((void **)&buffer, KEYFILE_READ_ALIGNMENT, KEYFILE_READ_CHUNK_SIZE) != 0) {
+        return KEYFILE_ERROR_MEMORY;
+    }
+    int status = KEYFILE_OK;
+    int is_first_chunk = 1;
+    sha256_context hasher;
+    sha256_init(&hasher);
+    while (1) {
+        size_t filled = 0;
+        while (filled < KEYFILE_READ_CHUNK_SIZE) {
+            const ssize_t count = read(fd, buffer + filled, KEYFILE_READ_CHUNK_SIZE - filled);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                status = KEYFILE_ERROR_IO;
+                break;
+            }
+            if (count == 0) {
+                break;
+            }
+            filled += (size_t)count;
+        }
+        if (status != KEYFILE_OK) {
+            break;
+        }
+        if (is_first_chunk) {
+            is_first_chunk = 0;
+            if (handler && handler(buffer, filled, file_size, context)) {
+                break;
+            }
+        }
+        sha256_update(&hasher, buffer, filled);
+        if (filled < KEYFILE_READ_CHUNK_SIZE) {
+            sha256_final(&hasher, digest);
+            break;
+        }
+    }
+    keyfile_wipe(&hasher, sizeof(hasher));
+    keyfile_wipe(buffer, KEYFILE_READ_CHUNK_SIZE);
+    free(buffer);
+    return status;
+}
+
+/* Hashes the file, mapped if possible; the handler can decide the result from the head instead. */
+static int keyfile_hash_file(const char *path, keyfile_head_handler handler, void *context, uint8_t digest[KEYFILE_KEY_SIZE]) {
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return KEYFILE_ERROR_IO;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 0) {
+        close(fd);
+        return KEYFILE_ERROR_IO;
+    }
+    const uint64_t file_size = (uint64_t)info.st_size;
+    if (file_size == 0) {
+        if (!handler || !handler(NULL, 0, file_size, context)) {
+            sha256(NULL, 0, digest);
+        }
+        close(fd);
+        return KEYFILE_OK;
+    }
+
+    void *map = (file_size <= SIZE_MAX)
+        ? mmap(NULL, (size_t)file_size, PROT_READ, MAP_PRIVATE, fd, 0)
+        : MAP_FAILED;
+    if (map == MAP_FAILED) {
+        const int status = keyfile_hash_streamed(fd, file_size, handler, context, digest);
+        close(fd);
+        return status;
+    }
+    close(fd);
+    madvise(map, (size_t)file_size, MADV_SEQUENTIAL);
+    if (!handler || !handler(map, (size_t)file_size, file_size, context)) {
+        sha256(map, (size_t)file_size, digest);
+    }
+    munmap(map, (size_t)file_size);
+    return KEYFILE_OK;
+}
+
+typedef struct {
+    uint8_t *key;
+    keyfile_kind *kind;
+} keyfile_classify_context;
+
+static int keyfile_classify_head(const uint8_t *head, size_t head_length, uint64_t file_size, void *context) {
+    keyfile_classify_context *target = context;
+    return keyfile_classify(head, head_length, file_size, target->key, target->kind);
+}
+
+int keyfile_process_file(const char *path, uint8_t key[KEYFILE_KEY_SIZE], keyfile_kind *kind) {
+    keyfile_classify_context context = { key, kind };
+    *kind = KEYFILE_KIND_HASHED;
+    return keyfile_hash_file(path, keyfile_classify_head, &context, key);
+}
+
+int keyfile_sha256_file(const char *path, uint8_t digest[KEYFILE_KEY_SIZE]) {
+    return keyfile_hash_file(path, NULL, NULL, digest);
+}
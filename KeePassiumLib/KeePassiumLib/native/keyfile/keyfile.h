@@ -0,0 +1,59 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef keyfile_h
+#define keyfile_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define KEYFILE_OK 0
+#define KEYFILE_ERROR_IO (-1)
+#define KEYFILE_ERROR_MEMORY (-3)
+
+#define KEYFILE_KEY_SIZE 32
+
+/// How the key file contents have been interpreted.
+typedef enum {
+    /// The file is empty, no key.
+    KEYFILE_KIND_EMPTY = 0,
+    /// The file is exactly 32 bytes long, which are the key.
+    KEYFILE_KIND_BINARY = 1,
+    /// The file consists of 64 hex digits, which encode the key.
+    KEYFILE_KIND_HEX = 2,
+    /// The file looks like XML; its contents need format-specific parsing, no key.
+    KEYFILE_KIND_XML = 3,
+    /// Anything else; the key is the SHA-256 of the file.
+    KEYFILE_KIND_HASHED = 4,
+} keyfile_kind;
+
+/// Reduces key file contents to the 32-byte key, the same way KeyHelper does it,
+/// except for XML candidates, which are only detected.
+/// The result does not depend on the database format, and processing it again yields the same key.
+/// @param  key   receives the key, unless the kind is KEYFILE_KIND_EMPTY or KEYFILE_KIND_XML
+/// @param  kind  receives the detected kind
+void keyfile_process_buffer(const uint8_t *data, size_t length, uint8_t key[KEYFILE_KEY_SIZE], keyfile_kind *kind);
+
+/// Same as keyfile_process_buffer(), for a file which is memory-mapped
+/// (or, if that fails, read in large aligned chunks) instead of being loaded.
+/// @return KEYFILE_OK or an error code
+int keyfile_process_file(const char *path, uint8_t key[KEYFILE_KEY_SIZE], keyfile_kind *kind);
+
+/// SHA-256 digest of the whole file, mapped or read in chunks like keyfile_process_file().
+/// @return KEYFILE_OK or an error code
+int keyfile_sha256_file(const char *path, uint8_t digest[KEYFILE_KEY_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* keyfile_h */
@@ -0,0 +1,208 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "domain_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define DOMAIN_INDEX_INITIAL_SLOTS 256
+#define DOMAIN_INDEX_INITIAL_POOL 4096
+
+/// Keys are entry URLs, possibly with credentials or tokens, so every discarded buffer is wiped first.
+static inline void domain_index_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+typedef struct {
+    uint64_t hash;      // 0 marks an empty slot
+    size_t key_offset;  // in the key pool
+    size_t key_length;
+    uint32_t *docs;
+    uint32_t count;
+    uint32_t capacity;
+} domain_index_slot;
+
+struct domain_index {
+    domain_index_slot *slots;
+    uint32_t slot_count;    // power of two
+    uint32_t used_slots;
+    uint8_t *pool;          // concatenated keys
+    size_t pool_size;
+    size_t pool_capacity;
+};
+
+/* FNV-1a; never returns 0, which is reserved for empty slots. */
+static uint64_t domain_index_hash(const uint8_t *key, size_t length) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= key[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash ? hash : 1;
+}
+
+domain_index *domain_index_create(void) {
+    domain_index *index = calloc(1, sizeof(domain_index));
+    if (!index) {
+        return NULL;
+    }
+    index->slots = calloc(DOMAIN_INDEX_INITIAL_SLOTS, sizeof(domain_index_slot));
+    index->pool = malloc(DOMAIN_INDEX_INITIAL_POOL);
+    if (!index->slots || !index->pool) {
+        domain_index_destroy(index);
+        return NULL;
+    }
+    index->slot_count = DOMAIN_INDEX_INITIAL_SLOTS;
+    index->pool_capacity = DOMAIN_INDEX_INITIAL_POOL;
+    return index;
+}
+
+void domain_index_destroy(domain_index *index) {
+    if (!index) {
+        return;
+    }
+    if (index->slots) {
+        for (uint32_t i = 0; i < index->slot_count; i++) {
+            domain_index_slot *slot = &index->slots[i];
+            if (slot->docs) {
+                domain_index_wipe(slot->docs, slot->capacity * sizeof(uint32_t));
+                free(slot->docs);
+            }
+        }
+        domain_index_wipe(index->slots, index->slot_count * sizeof(domain_index_slot));
+        free(index->slots);
+    }
+    if (index->pool) {
+        domain_index_wipe(index->pool, index->pool_capacity);
+        free(index->pool);
+    }
+    domain_index_wipe(index, sizeof(domain_index));
+    free(index);
+}
+
+static domain_index_slot *domain_index_probe(const domain_index *index,
+                                             const uint8_t *key, size_t length, uint64_t hash)
+{
+    const uint32_t mask = index->slot_count - 1;
+    for (uint32_t i = (uint32_t)hash & mask; ; i = (i + 1) & mask) {
+        domain_index_slot *slot = &index->slots[i];
+        if (slot->hash == 0) {
+            return slot;
+        }
+        if (slot->hash == hash
+            && slot->key_length == length
+            && memcmp(index->pool + slot->key_offset, key, length) == 0)
+        {
+            return slot;
+        }
+    }
+}
+
+static int domain_index_grow_table(domain_index *index) {
+    const uint32_t new_count = index->slot_count * 2;
+    domain_index_slot *new_slots = calloc(new_count, sizeof(domain_index_slot));
+    if (!new_slots) {
+        return DOMAIN_INDEX_ERROR;
+    }
+    const uint32_t mask = new_count - 1;
+    for (uint32_t i = 0; i < index->slot_count; i++) {
+        const domain_index_slot *slot = &index->slots[i];
+        if (slot->hash == 0) {
+            continue;
+        }
+        uint32_t j = (uint32_t)slot->hash & mask;
+        while (new_slots[j].hash != 0) {
+            j = (j + 1) & mask;
+        }
+        new_slots[j] = *slot;
+    }
+    domain_index_wipe(index->slots, index->slot_count * sizeof(domain_index_slot));
+    free(index->slots);
+    index->slots = new_slots;
+    index->slot_count = new_count;
+    return 0;
+}
+
+static int domain_index_store_key(domain_index *index, const uint8_t *key, size_t length, size_t *offset) {
+    if (index->pool_capacity - index->pool_size < length) {
+        size_t new_capacity = index->pool_capacity * 2;
+        while (new_capacity - index->pool_size < length) {
+            new_capacity *= 2;
+        }
+        /* not realloc(), which could leave the old copy behind unwiped */
+        uint8_t *pool = malloc(new_capacity);
+        if (!pool) {
+            return DOMAIN_INDEX_ERROR;
+        }
+        memcpy(pool, index->pool, index->pool_size);
+        domain_index_wipe(index->pool, index->pool_capacity);
+        free(index->pool);
+        index->pool = pool;
+        index->pool_capacity = new_capacity;
+    }
+    if (length > 0) {
+        memcpy(index->pool + index->pool_size, key, length);
+    }
+    *offset = index->pool_size;
+    index->pool_size += length;
+    return 0;
+}
+
+int domain_index_add(domain_index *index, const uint8_t *key, size_t length, uint32_t doc_id) {
+    if ((uint64_t)(index->used_slots + 1) * 10 > (uint64_t)index->slot_count * 7) {
+        if (domain_index_grow_table(index) != 0) {
+            return DOMAIN_INDEX_ERROR;
+        }
+    }
+    const uint64_t hash = domain_index_hash(key, length);
+    domain_index_slot *slot = domain_index_probe(index, key, length, hash);
+    if (slot->hash == 0) {
+        size_t offset;
+        if (domain_index_store_key(index, key, length, &offset) != 0) {
+            return DOMAIN_INDEX_ERROR;
+        }
+        slot->hash = hash;
+        slot->key_offset = offset;
+        slot->key_length = length;
+        index->used_slots++;
+    }
+
+    if (slot->count > 0 && slot->docs[slot->count - 1] == doc_id) {
+        return 0;
+    }
+    if (slot->count == slot->capacity) {
+        const uint32_t new_capacity = slot->capacity ? slot->capacity * 2 : 2;
+        uint32_t *docs = malloc(new_capacity * sizeof(uint32_t));
+        if (!docs) {
+            return DOMAIN_INDEX_ERROR;
+        }
+        if (slot->docs) {
+            memcpy(docs, slot->docs, slot->count * sizeof(uint32_t));
+            domain_index_wipe(slot->docs, slot->capacity * sizeof(uint32_t));
+            free(slot->docs);
+        }
+        slot->docs = docs;
+        slot->capacity = new_capacity;
+    }
+    slot->docs[slot->count++] = doc_id;
+    return 0;
+}
+
+size_t domain_index_lookup(const domain_index *index, const uint8_t *key, size_t length,
+                           const uint32_t **docs)
+{
+    const domain_index_slot *slot = domain_index_probe(index, key, length, domain_index_hash(key, length));
+    *docs = slot->hash ? slot->docs : NULL;
+    return slot->hash ? slot->count : 0;
+}
+
+uint32_t domain_index_key_count(const domain_index *index) {
+    return index->used_slots;
+}
@@ -0,0 +1,53 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef domain_index_h
+#define domain_index_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Maps byte-string keys (such as host names or registrable domains)
+/// to ascending lists of document IDs.
+///
+/// Keys are compared bytewise, so the caller should normalize them
+/// (e.g. lowercase) before adding or looking up.
+///
+/// Not thread-safe.
+typedef struct domain_index domain_index;
+
+#define DOMAIN_INDEX_ERROR (-1)
+
+domain_index *domain_index_create(void);
+
+void domain_index_destroy(domain_index *index);
+
+/// Links the document to the key.
+/// Document IDs must be added in non-decreasing order; repeated links are ignored.
+/// @return 0 on success, DOMAIN_INDEX_ERROR if out of memory
+int domain_index_add(domain_index *index, const uint8_t *key, size_t length, uint32_t doc_id);
+
+/// Finds the documents linked to the key.
+/// @param  docs  receives a pointer to the ascending document IDs (owned by the index,
+///         valid until the next modification), or NULL if there are none
+/// @return number of documents
+size_t domain_index_lookup(const domain_index *index, const uint8_t *key, size_t length,
+                           const uint32_t **docs);
+
+/// Number of distinct keys.
+uint32_t domain_index_key_count(const domain_index *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* domain_index_h */
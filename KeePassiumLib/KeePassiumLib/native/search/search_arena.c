@@ -0,0 +1,283 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "search_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define SEARCH_ARENA_USE_NEON 1
+#include <arm_neon.h>
+#elif defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#define SEARCH_ARENA_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#define SEARCH_ARENA_INITIAL_CAPACITY 4096
+#define SEARCH_ARENA_INITIAL_DOCUMENTS 256
+/// Zero bytes kept after the used part, so that vector loads never leave the buffer.
+#define SEARCH_ARENA_PADDING 16
+#define SEARCH_ARENA_NOT_FOUND SIZE_MAX
+
+/// The arena holds plaintext copies of entry fields, so every discarded buffer is wiped first.
+static inline void search_arena_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+struct search_arena {
+    uint8_t *bytes;
+    size_t size;
+    size_t capacity;        // excluding the padding
+    size_t *doc_start;      // offset of the first text of each document
+    uint32_t doc_count;
+    uint32_t doc_capacity;
+};
+
+search_arena *search_arena_create(void) {
+    search_arena *arena = calloc(1, sizeof(search_arena));
+    if (!arena) {
+        return NULL;
+    }
+    arena->bytes = calloc(SEARCH_ARENA_INITIAL_CAPACITY + SEARCH_ARENA_PADDING, 1);
+    arena->doc_start = malloc(SEARCH_ARENA_INITIAL_DOCUMENTS * sizeof(size_t));
+    if (!arena->bytes || !arena->doc_start) {
+        search_arena_destroy(arena);
+        return NULL;
+    }
+    arena->capacity = SEARCH_ARENA_INITIAL_CAPACITY;
+    arena->doc_capacity = SEARCH_ARENA_INITIAL_DOCUMENTS;
+    return arena;
+}
+
+void search_arena_destroy(search_arena *arena) {
+    if (!arena) {
+        return;
+    }
+    if (arena->bytes) {
+        search_arena_wipe(arena->bytes, arena->capacity + SEARCH_ARENA_PADDING);
+        free(arena->bytes);
+    }
+    free(arena->doc_start);
+    free(arena);
+}
+
+uint32_t search_arena_begin_document(search_arena *arena) {
+    if (arena->doc_count == arena->doc_capacity) {
+        const uint32_t new_capacity = arena->doc_capacity * 2;
+        size_t *doc_start = realloc(arena->doc_start, new_capacity * sizeof(size_t));
+        if (!doc_start) {
+            return SEARCH_ARENA_NO_DOCUMENT;
+        }
+        arena->doc_start = doc_start;
+        arena->doc_capacity = new_capacity;
+    }
+    arena->doc_start[arena->doc_count] = arena->size;
+    return arena->doc_count++;
+}
+
+static int search_arena_reserve(search_arena *arena, size_t extra) {
+    if (arena->capacity - arena->size >= extra) {
+        return 0;
+    }
+    size_t new_capacity = arena->capacity * 2;
+    while (new_capacity - arena->size < extra) {
+        new_capacity *= 2;
+    }
+    /* not realloc(), which could leave the old copy behind unwiped */
+    uint8_t *bytes = malloc(new_capacity + SEARCH_ARENA_PADDING);
+    if (!bytes) {
+        return SEARCH_ARENA_ERROR;
+    }
+    memcpy(bytes, arena->bytes, arena->size);
+    memset(bytes + arena->size, 0, new_capacity + SEARCH_ARENA_PADDING - arena->size);
+    search_arena_wipe(arena->bytes, arena->capacity + SEARCH_ARENA_PADDING);
+    free(arena->bytes);
+    arena->bytes = bytes;
+    arena->capacity = new_capacity;
+    return 0;
+}
+
+int search_arena_add_text(search_arena *arena, const uint8_t *utf8, size_t length) {
+    if (arena->doc_count == 0 || search_arena_reserve(arena, length + 1) != 0) {
+        return SEARCH_ARENA_ERROR;
+    }
+    uint8_t *out = arena->bytes + arena->size;
+    for (size_t i = 0; i < length; i++) {
+        *out = utf8[i];
+        out += (utf8[i] != 0);
+    }
+    if (out == arena->bytes + arena->size) {
+        return 0;
+    }
+    *out++ = 0;
+    arena->size = (size_t)(out - arena->bytes);
+    return 0;
+}
+
+uint32_t search_arena_document_limit(const search_arena *arena) {
+    return arena->doc_count;
+}
+
+static inline size_t search_arena_doc_end(const search_arena *arena, uint32_t doc_id) {
+    return (doc_id + 1 < arena->doc_count) ? arena->doc_start[doc_id + 1] : arena->size;
+}
+
+/* Last document that starts at or before the offset. */
+static uint32_t search_arena_locate(const search_arena *arena, size_t offset) {
+    uint32_t low = 0;
+    uint32_t high = arena->doc_count;
+    while (high - low > 1) {
+        const uint32_t mid = low + (high - low) / 2;
+        if (arena->doc_start[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/***************Substring search*****************/
+
+static inline int search_arena_verify(const uint8_t *candidate, const uint8_t *needle, size_t length) {
+    return length <= 2 || memcmp(candidate + 1, needle + 1, length - 2) == 0;
+}
+
+/*
+ * Returns the offset of the first occurrence of the needle within [start, end),
+ * or SEARCH_ARENA_NOT_FOUND.
+ *
+ * The vector version compares the first and the last byte of the needle with
+ * 16 consecutive positions at once, and verifies only the positions where both match.
+ */
+static size_t search_arena_find(const uint8_t *bytes, size_t start, size_t end,
+                                const uint8_t *needle, size_t length)
+{
+    if (end - start < length) {
+        return SEARCH_ARENA_NOT_FOUND;
+    }
+    const size_t last_start = end - length;
+    const uint8_t first = needle[0];
+    const uint8_t last = needle[length - 1];
+
+#if SEARCH_ARENA_USE_NEON || SEARCH_ARENA_USE_SSE2
+#if SEARCH_ARENA_USE_NEON
+    const uint8x16_t first_vec = vdupq_n_u8(first);
+    const uint8x16_t last_vec = vdupq_n_u8(last);
+    const unsigned lane_bits = 4; // the narrowing shift keeps 4 bits per lane
+#else
+    const __m128i first_vec = _mm_set1_epi8((char)first);
+    const __m128i last_vec = _mm_set1_epi8((char)last);
+    const unsigned lane_bits = 1;
+#endif
+    const uint64_t lane_mask = (1ULL << lane_bits) - 1;
+    for (size_t i = start; i <= last_start; i += 16) {
+#if SEARCH_ARENA_USE_NEON
+        const uint8x16_t eq = vandq_u8(
+            vceqq_u8(vld1q_u8(bytes + i), first_vec),
+            vceqq_u8(vld1q_u8(bytes + i + length - 1), last_vec));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+#else
+        const __m128i eq = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(bytes + i)), first_vec),
+            _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(bytes + i + length - 1)), last_vec));
+        uint64_t mask = (uint64_t)_mm_movemask_epi8(eq);
+#endif
+        const size_t positions_left = last_start - i + 1;
+        if (positions_left < 16) {
+            mask &= (1ULL << (positions_left * lane_bits)) - 1;
+        }
+        while (mask) {
+            const unsigned lane = (unsigned)__builtin_ctzll(mask) / lane_bits;
+            if (search_arena_verify(bytes + i + lane, needle, length)) {
+                return i + lane;
+            }
+            mask &= ~(lane_mask << (lane * lane_bits));
+        }
+    }
+    return SEARCH_ARENA_NOT_FOUND;
+#else
+    for (size_t i = start; i <= last_start; i++) {
+        const uint8_t *candidate = memchr(bytes + i, first, last_start - i + 1);
+        if (!candidate) {
+            break;
+        }
+        i = (size_t)(candidate - bytes);
+        if (candidate[length - 1] == last && search_arena_verify(candidate, needle, length)) {
+            return i;
+        }
+    }
+    return SEARCH_ARENA_NOT_FOUND;
+#endif
+}
+
+/* Scans the whole arena once, skipping the rest of a document after its first match. */
+static size_t search_arena_scan_all(const search_arena *arena,
+                                    const uint8_t *word, size_t length, uint32_t *out)
+{
+    size_t found = 0;
+    size_t offset = 0;
+    while (offset < arena->size) {
+        const size_t match = search_arena_find(arena->bytes, offset, arena->size, word, length);
+        if (match == SEARCH_ARENA_NOT_FOUND) {
+            break;
+        }
+        const uint32_t doc_id = search_arena_locate(arena, match);
+        out[found++] = doc_id;
+        offset = search_arena_doc_end(arena, doc_id);
+    }
+    return found;
+}
+
+/* Keeps only those of the documents that contain the word; `out` may be the same as `docs`. */
+static size_t search_arena_scan_docs(const search_arena *arena,
+                                     const uint8_t *word, size_t length,
+                                     const uint32_t *docs, size_t doc_count, uint32_t *out)
+{
+    size_t found = 0;
+    for (size_t i = 0; i < doc_count; i++) {
+        const uint32_t doc_id = docs[i];
+        if (doc_id >= arena->doc_count) {
+            continue;
+        }
+        const size_t start = arena->doc_start[doc_id];
+        const size_t end = search_arena_doc_end(arena, doc_id);
+        if (search_arena_find(arena->bytes, start, end, word, length) != SEARCH_ARENA_NOT_FOUND) {
+            out[found++] = doc_id;
+        }
+    }
+    return found;
+}
+
+long search_arena_query(const search_arena *arena,
+                        const uint8_t *const *words, const size_t *lengths, size_t word_count,
+                        const uint32_t *docs, size_t doc_count,
+                        uint32_t *out)
+{
+    if (word_count == 0) {
+        return SEARCH_ARENA_ERROR;
+    }
+    for (size_t w = 0; w < word_count; w++) {
+        if (lengths[w] == 0 || memchr(words[w], 0, lengths[w])) {
+            return SEARCH_ARENA_ERROR;
+        }
+    }
+
+    size_t found;
+    if (docs) {
+        found = search_arena_scan_docs(arena, words[0], lengths[0], docs, doc_count, out);
+    } else {
+        found = search_arena_scan_all(arena, words[0], lengths[0], out);
+    }
+    for (size_t w = 1; w < word_count && found > 0; w++) {
+        found = search_arena_scan_docs(arena, words[w], lengths[w], out, found, out);
+    }
+    return (long)found;
+}
@@ -0,0 +1,66 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef search_arena_h
+#define search_arena_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Contiguous buffer of pre-folded UTF-8 texts, grouped by document,
+/// for brute-force substring search without per-field string objects.
+///
+/// Texts are stored zero-terminated, so a match never spans two texts.
+/// Both the texts and the needles are expected to be folded the same way
+/// by the caller; the comparison itself is bytewise.
+///
+/// Not thread-safe.
+typedef struct search_arena search_arena;
+
+#define SEARCH_ARENA_ERROR (-1)
+#define SEARCH_ARENA_NO_DOCUMENT UINT32_MAX
+
+search_arena *search_arena_create(void);
+
+void search_arena_destroy(search_arena *arena);
+
+/// Starts a new document, which receives all the subsequent search_arena_add_text() calls.
+/// Document IDs are assigned sequentially, starting with 0.
+/// @return ID of the new document, or SEARCH_ARENA_NO_DOCUMENT if out of memory
+uint32_t search_arena_begin_document(search_arena *arena);
+
+/// Appends a piece of text (such as a field value) to the current document.
+/// Zero bytes are dropped.
+/// @return 0 on success, SEARCH_ARENA_ERROR if out of memory or there is no current document
+int search_arena_add_text(search_arena *arena, const uint8_t *utf8, size_t length);
+
+/// Upper bound of document IDs, to size the output buffer of search_arena_query().
+uint32_t search_arena_document_limit(const search_arena *arena);
+
+/// Finds documents that contain each of the words in some of their texts.
+/// @param  words  array of `word_count` folded non-empty words
+/// @param  lengths  length of each word, in bytes
+/// @param  docs  ascending document IDs to check, or NULL to check all the documents
+/// @param  doc_count  number of items in `docs`
+/// @param  out  output buffer for document IDs, at least search_arena_document_limit() items
+///         (or `doc_count`, if `docs` is given); may be the same as `docs`
+/// @return number of found documents (in ascending order), or SEARCH_ARENA_ERROR
+long search_arena_query(const search_arena *arena,
+                        const uint8_t *const *words, const size_t *lengths, size_t word_count,
+                        const uint32_t *docs, size_t doc_count,
+                        uint32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* search_arena_h */
@@ -0,0 +1,408 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "search_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SEARCH_INDEX_INITIAL_SLOTS 1024
+#define SEARCH_INDEX_MIN_COMPACTION 256
+#define SEARCH_INDEX_NO_DOCUMENT UINT32_MAX
+
+/// Trigram keys and posting lists reveal the indexed text, so discarded buffers are wiped first.
+static inline void search_index_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+/*
+ * Posting lists store ascending document IDs as varint-encoded deltas.
+ * Documents are only ever appended, so a list never needs reordering.
+ */
+typedef struct {
+    uint64_t key;       // packed trigram, 0 marks an empty slot
+    uint8_t *bytes;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t last_doc;
+} search_posting_list;
+
+struct search_index {
+    search_posting_list *slots;
+    uint32_t slot_count;    // power of two
+    uint32_t slot_shift;
+    uint32_t used_slots;
+    uint8_t *removed;       // bitmap of removed document IDs
+    uint32_t removed_capacity;
+    uint32_t doc_limit;
+    uint32_t removed_count;
+    uint32_t removed_since_compaction;
+    uint32_t current_doc;
+};
+
+/*
+ * Three 21-bit scalars, the first one in the highest bits.
+ * Zero scalars are skipped, so a valid key is never 0.
+ */
+static inline uint64_t search_pack(uint32_t a, uint32_t b, uint32_t c) {
+    return ((uint64_t)(a & 0x1FFFFF) << 42) | ((uint64_t)(b & 0x1FFFFF) << 21) | (c & 0x1FFFFF);
+}
+
+static inline uint32_t search_slot(const search_index *index, uint64_t key) {
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> index->slot_shift);
+}
+
+static search_posting_list *search_find(const search_index *index, uint64_t key) {
+    const uint32_t mask = index->slot_count - 1;
+    for (uint32_t i = search_slot(index, key); ; i = (i + 1) & mask) {
+        search_posting_list *list = &index->slots[i];
+        if (list->key == key) {
+            return list;
+        }
+        if (list->key == 0) {
+            return NULL;
+        }
+    }
+}
+
+static int search_grow_table(search_index *index) {
+    const uint32_t new_count = index->slot_count * 2;
+    search_posting_list *new_slots = calloc(new_count, sizeof(search_posting_list));
+    if (!new_slots) {
+        return SEARCH_INDEX_ERROR;
+    }
+    search_posting_list *old_slots = index->slots;
+    const uint32_t old_count = index->slot_count;
+    index->slots = new_slots;
+    index->slot_count = new_count;
+    index->slot_shift--;
+
+    const uint32_t mask = new_count - 1;
+    for (uint32_t i = 0; i < old_count; i++) {
+        if (old_slots[i].key == 0) {
+            continue;
+        }
+        uint32_t j = search_slot(index, old_slots[i].key);
+        while (new_slots[j].key != 0) {
+            j = (j + 1) & mask;
+        }
+        new_slots[j] = old_slots[i];
+    }
+    search_index_wipe(old_slots, (size_t)old_count * sizeof(search_posting_list));
+    free(old_slots);
+    return 0;
+}
+
+static search_posting_list *search_find_or_insert(search_index *index, uint64_t key) {
+    if ((uint64_t)(index->used_slots + 1) * 10 > (uint64_t)index->slot_count * 7) {
+        if (search_grow_table(index) != 0) {
+            return NULL;
+        }
+    }
+    const uint32_t mask = index->slot_count - 1;
+    for (uint32_t i = search_slot(index, key); ; i = (i + 1) & mask) {
+        search_posting_list *list = &index->slots[i];
+        if (list->key == key) {
+            return list;
+        }
+        if (list->key == 0) {
+            list->key = key;
+            index->used_slots++;
+            return list;
+        }
+    }
+}
+
+/***************Posting lists*****************/
+
+/* Appends without checking the capacity, which must fit 5 more bytes. */
+static inline void search_list_put(search_posting_list *list, uint32_t doc_id) {
+    uint32_t delta = list->count ? doc_id - list->last_doc : doc_id;
+    while (delta >= 0x80) {
+        list->bytes[list->size++] = (uint8_t)(delta | 0x80);
+        delta >>= 7;
+    }
+    list->bytes[list->size++] = (uint8_t)delta;
+    list->last_doc = doc_id;
+    list->count++;
+}
+
+static int search_list_append(search_posting_list *list, uint32_t doc_id) {
+    if (list->capacity - list->size < 5) {
+        const uint32_t new_capacity = list->capacity ? list->capacity * 2 : 8;
+        uint8_t *bytes = malloc(new_capacity);
+        if (!bytes) {
+            return SEARCH_INDEX_ERROR;
+        }
+        if (list->bytes) {
+            memcpy(bytes, list->bytes, list->size);
+            search_index_wipe(list->bytes, list->capacity);
+            free(list->bytes);
+        }
+        list->bytes = bytes;
+        list->capacity = new_capacity;
+    }
+    search_list_put(list, doc_id);
+    return 0;
+}
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    uint32_t doc;
+    int started;
+} search_list_cursor;
+
+static inline int search_cursor_next(search_list_cursor *cursor, uint32_t *doc_id) {
+    if (cursor->p >= cursor->end) {
+        return 0;
+    }
+    uint32_t delta = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = *cursor->p++;
+        delta |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && cursor->p < cursor->end);
+    cursor->doc = cursor->started ? cursor->doc + delta : delta;
+    cursor->started = 1;
+    *doc_id = cursor->doc;
+    return 1;
+}
+
+static inline search_list_cursor search_cursor(const search_posting_list *list) {
+    search_list_cursor cursor = { list->bytes, list->bytes + list->size, 0, 0 };
+    return cursor;
+}
+
+static inline int search_is_removed(const search_index *index, uint32_t doc_id) {
+    return (doc_id >> 3) < index->removed_capacity && (index->removed[doc_id >> 3] >> (doc_id & 7)) & 1;
+}
+
+/* Drops removed documents from all the posting lists. */
+static void search_compact(search_index *index) {
+    for (uint32_t i = 0; i < index->slot_count; i++) {
+        search_posting_list *list = &index->slots[i];
+        if (list->key == 0 || list->count == 0) {
+            continue;
+        }
+        search_posting_list compacted = { list->key, list->bytes, 0, list->capacity, 0, 0 };
+        search_list_cursor cursor = search_cursor(list);
+        uint32_t doc_id;
+        while (search_cursor_next(&cursor, &doc_id)) {
+            if (!search_is_removed(index, doc_id)) {
+                /* a merged delta is never longer than the deltas it replaces,
+                   so the writes stay behind the reads within the same buffer */
+                search_list_put(&compacted, doc_id);
+            }
+        }
+        search_index_wipe(list->bytes + compacted.size, list->size - compacted.size);
+        *list = compacted;
+    }
+    index->removed_since_compaction = 0;
+}
+
+/***************Public API*****************/
+
+search_index *search_index_create(void) {
+    search_index *index = calloc(1, sizeof(search_index));
+    if (!index) {
+        return NULL;
+    }
+    index->slots = calloc(SEARCH_INDEX_INITIAL_SLOTS, sizeof(search_posting_list));
+    if (!index->slots) {
+        free(index);
+        return NULL;
+    }
+    index->slot_count = SEARCH_INDEX_INITIAL_SLOTS;
+    index->slot_shift = 64 - 10;
+    index->current_doc = SEARCH_INDEX_NO_DOCUMENT;
+    return index;
+}
+
+void search_index_destroy(search_index *index) {
+    if (!index) {
+        return;
+    }
+    for (uint32_t i = 0; i < index->slot_count; i++) {
+        search_posting_list *list = &index->slots[i];
+        if (list->bytes) {
+            search_index_wipe(list->bytes, list->capacity);
+            free(list->bytes);
+        }
+    }
+    search_index_wipe(index->slots, (size_t)index->slot_count * sizeof(search_posting_list));
+    free(index->slots);
+    free(index->removed);
+    free(index);
+}
+
+uint32_t search_index_begin_document(search_index *index) {
+    index->current_doc = index->doc_limit++;
+    return index->current_doc;
+}
+
+int search_index_add_text(search_index *index, const uint32_t *scalars, size_t count) {
+    if (!index || index->current_doc == SEARCH_INDEX_NO_DOCUMENT || (!scalars && count > 0)) {
+        return SEARCH_INDEX_ERROR;
+    }
+    const uint32_t doc_id = index->current_doc;
+    uint32_t a = 0, b = 0;
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t c = scalars[i];
+        if (c == 0) {
+            continue;
+        }
+        if (a != 0) {
+            search_posting_list *list = search_find_or_insert(index, search_pack(a, b, c));
+            if (!list) {
+                return SEARCH_INDEX_ERROR;
+            }
+            if (list->count == 0 || list->last_doc != doc_id) {
+                if (search_list_append(list, doc_id) != 0) {
+                    return SEARCH_INDEX_ERROR;
+                }
+            }
+        }
+        a = b;
+        b = c;
+    }
+    return 0;
+}
+
+void search_index_remove_document(search_index *index, uint32_t doc_id) {
+    if (!index || doc_id >= index->doc_limit || search_is_removed(index, doc_id)) {
+        return;
+    }
+    const uint32_t needed = (index->doc_limit + 7) / 8;
+    if (needed > index->removed_capacity) {
+        uint32_t new_capacity = index->removed_capacity ? index->removed_capacity : 64;
+        while (new_capacity < needed) {
+            new_capacity *= 2;
+        }
+        uint8_t *removed = realloc(index->removed, new_capacity);
+        if (!removed) {
+            return; /* the document stays visible, which only costs an extra check */
+        }
+        memset(removed + index->removed_capacity, 0, new_capacity - index->removed_capacity);
+        index->removed = removed;
+        index->removed_capacity = new_capacity;
+    }
+    index->removed[doc_id >> 3] |= (uint8_t)(1 << (doc_id & 7));
+    index->removed_count++;
+    index->removed_since_compaction++;
+
+    const uint32_t live_count = index->doc_limit - index->removed_count;
+    if (index->removed_since_compaction >= SEARCH_INDEX_MIN_COMPACTION
+        && index->removed_since_compaction > live_count)
+    {
+        search_compact(index);
+    }
+}
+
+uint32_t search_index_document_limit(const search_index *index) {
+    return index ? index->doc_limit : 0;
+}
+
+uint32_t search_index_document_count(const search_index *index) {
+    return index ? index->doc_limit - index->removed_count : 0;
+}
+
+long search_index_query(const search_index *index,
+                        const uint32_t *const *words, const size_t *lengths, size_t word_count,
+                        uint32_t *out)
+{
+    if (!index || (word_count > 0 && (!words || !lengths)) || !out) {
+        return SEARCH_INDEX_ERROR;
+    }
+    size_t max_lists = 0;
+    for (size_t w = 0; w < word_count; w++) {
+        max_lists += lengths[w];
+    }
+    if (max_lists == 0) {
+        return SEARCH_INDEX_UNRESTRICTED;
+    }
+    const search_posting_list **lists = malloc(max_lists * sizeof(*lists));
+    if (!lists) {
+        return SEARCH_INDEX_ERROR;
+    }
+
+    size_t list_count = 0;
+    for (size_t w = 0; w < word_count; w++) {
+        uint32_t a = 0, b = 0;
+        for (size_t i = 0; i < lengths[w]; i++) {
+            const uint32_t c = words[w][i];
+            if (c == 0) {
+                continue;
+            }
+            if (a != 0) {
+                const search_posting_list *list = search_find(index, search_pack(a, b, c));
+                if (!list || list->count == 0) {
+                    free(lists);
+                    return 0;
+                }
+                int is_duplicate = 0;
+                for (size_t k = 0; k < list_count && !is_duplicate; k++) {
+                    is_duplicate = (lists[k] == list);
+                }
+                if (!is_duplicate) {
+                    lists[list_count++] = list;
+                }
+            }
+            a = b;
+            b = c;
+        }
+    }
+    if (list_count == 0) {
+        free(lists);
+        return SEARCH_INDEX_UNRESTRICTED;
+    }
+
+    /* the shortest list bounds the result, so start with it */
+    for (size_t i = 1; i < list_count; i++) {
+        const search_posting_list *list = lists[i];
+        size_t j = i;
+        while (j > 0 && lists[j - 1]->count > list->count) {
+            lists[j] = lists[j - 1];
+            j--;
+        }
+        lists[j] = list;
+    }
+
+    size_t found = 0;
+    search_list_cursor cursor = search_cursor(lists[0]);
+    uint32_t doc_id;
+    while (search_cursor_next(&cursor, &doc_id)) {
+        if (!search_is_removed(index, doc_id)) {
+            out[found++] = doc_id;
+        }
+    }
+
+    for (size_t i = 1; i < list_count && found > 0; i++) {
+        cursor = search_cursor(lists[i]);
+        size_t kept = 0;
+        size_t j = 0;
+        int has_doc = search_cursor_next(&cursor, &doc_id);
+        while (has_doc && j < found) {
+            if (doc_id < out[j]) {
+                has_doc = search_cursor_next(&cursor, &doc_id);
+            } else if (doc_id > out[j]) {
+                j++;
+            } else {
+                out[kept++] = out[j++];
+                has_doc = search_cursor_next(&cursor, &doc_id);
+            }
+        }
+        found = kept;
+    }
+    free(lists);
+    return (long)found;
+}
@@ -0,0 +1,78 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef search_index_h
+#define search_index_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// In-memory inverted index of trigrams (sequences of three Unicode scalars).
+///
+/// A document that contains a word as a substring necessarily contains every
+/// trigram of the word, so intersecting the posting lists of the trigrams
+/// yields a superset of matching documents. The caller is expected to verify
+/// the candidates with the exact (locale-aware) comparison.
+///
+/// Text is given as Unicode scalars, already folded by the caller
+/// (case, diacritics), so that documents and queries are folded the same way.
+/// Zero scalars are ignored.
+///
+/// Not thread-safe.
+typedef struct search_index search_index;
+
+/// Words shorter than this do not restrict the query.
+#define SEARCH_INDEX_GRAM_LENGTH 3
+
+#define SEARCH_INDEX_ERROR (-1)
+/// Returned by search_index_query() when none of the words restricts the result.
+#define SEARCH_INDEX_UNRESTRICTED (-2)
+
+search_index *search_index_create(void);
+
+void search_index_destroy(search_index *index);
+
+/// Starts a new document, which receives all the subsequent search_index_add_text() calls.
+/// Document IDs are assigned sequentially, starting with 0.
+/// @return ID of the new document
+uint32_t search_index_begin_document(search_index *index);
+
+/// Adds a piece of text (such as a field value) to the current document.
+/// Trigrams do not span separate calls.
+/// @return 0 on success, SEARCH_INDEX_ERROR if out of memory or there is no current document
+int search_index_add_text(search_index *index, const uint32_t *scalars, size_t count);
+
+/// Excludes a document from subsequent query results.
+/// The space is reclaimed once removed documents prevail.
+void search_index_remove_document(search_index *index, uint32_t doc_id);
+
+/// Upper bound of document IDs, to size the output buffer of search_index_query().
+uint32_t search_index_document_limit(const search_index *index);
+
+/// Number of documents that were not removed.
+uint32_t search_index_document_count(const search_index *index);
+
+/// Finds documents that may contain all the given words.
+/// @param  words  array of `word_count` folded words
+/// @param  lengths  number of scalars in each word
+/// @param  out  output buffer for document IDs, at least search_index_document_limit() items
+/// @return number of found documents (in ascending order), or SEARCH_INDEX_UNRESTRICTED
+///         if all the words are too short to be looked up.
+long search_index_query(const search_index *index,
+                        const uint32_t *const *words, const size_t *lengths, size_t word_count,
+                        uint32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* search_index_h */
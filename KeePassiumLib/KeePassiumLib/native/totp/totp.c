@@ -0,0 +1,190 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "totp.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <CommonCrypto/CommonCrypto.h>
+
+#define TOTP_MAX_BLOCK_SIZE CC_SHA512_BLOCK_BYTES
+#define TOTP_MAX_DIGEST_SIZE CC_SHA512_DIGEST_LENGTH
+
+/* Digest contexts are plain structs, so the prepared pad states are reused by copying them. */
+typedef union {
+    CC_SHA1_CTX sha1;
+    CC_SHA256_CTX sha256;
+    CC_SHA512_CTX sha512;
+} totp_hash_state;
+
+struct totp_key {
+    int algorithm;
+    totp_hash_state inner;  // after hashing (key ^ ipad)
+    totp_hash_state outer;  // after hashing (key ^ opad)
+};
+
+static const uint32_t totp_powers_of_ten[TOTP_MAX_DIGITS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static inline void totp_wipe(void *buffer, size_t length) {
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+static size_t totp_block_size(int algorithm) {
+    switch (algorithm) {
+    case TOTP_ALGORITHM_SHA1:
+        return CC_SHA1_BLOCK_BYTES;
+    case TOTP_ALGORITHM_SHA256:
+        return CC_SHA256_BLOCK_BYTES;
+    case TOTP_ALGORITHM_SHA512:
+        return CC_SHA512_BLOCK_BYTES;
+    default:
+        return 0;
+    }
+}
+
+static void totp_hash_init(int algorithm, totp_hash_state *state) {
+    switch (algorithm) {
+    case TOTP_ALGORITHM_SHA1:
+        CC_SHA1_Init(&state->sha1);
+        break;
+    case TOTP_ALGORITHM_SHA256:
+        CC_SHA256_Init(&state->sha256);
+        break;
+    case TOTP_ALGORITHM_SHA512:
+        CC_SHA512_Init(&state->sha512);
+        break;
+    }
+}
+
+static void totp_hash_update(int algorithm, totp_hash_state *state, const uint8_t *data, size_t length) {
+    switch (algorithm) {
+    case TOTP_ALGORITHM_SHA1:
+        CC_SHA1_Update(&state->sha1, data, (CC_LONG)length);
+        break;
+    case TOTP_ALGORITHM_SHA256:
+        CC_SHA256_Update(&state->sha256, data, (CC_LONG)length);
+        break;
+    case TOTP_ALGORITHM_SHA512:
+        CC_SHA512_Update(&state->sha512, data, (CC_LONG)length);
+        break;
+    }
+}
+
+/* Finalizes the hash and returns the digest length. */
+static size_t totp_hash_final(int algorithm, totp_hash_state *state, uint8_t *digest) {
+    switch (algorithm) {
+    case TOTP_ALGORITHM_SHA1:
+        CC_SHA1_Final(digest, &state->sha1);
+        return CC_SHA1_DIGEST_LENGTH;
+    case TOTP_ALGORITHM_SHA256:
+        CC_SHA256_Final(digest, &state->sha256);
+        return CC_SHA256_DIGEST_LENGTH;
+    case TOTP_ALGORITHM_SHA512:
+        CC_SHA512_Final(digest, &state->sha512);
+        return CC_SHA512_DIGEST_LENGTH;
+    default:
+        return 0;
+    }
+}
+
+totp_key *totp_key_create(int algorithm, const uint8_t *secret, size_t secret_length) {
+    const size_t block_size = totp_block_size(algorithm);
+    if (block_size == 0) {
+        return NULL;
+    }
+    totp_key *key = calloc(1, sizeof(totp_key));
+    if (!key) {
+        return NULL;
+    }
+    key->algorithm = algorithm;
+
+    uint8_t block[TOTP_MAX_BLOCK_SIZE] = { 0 };
+    if (secret_length > block_size) {
+        totp_hash_state state;
+        totp_hash_init(algorithm, &state);
+        totp_hash_update(algorithm, &state, secret, secret_length);
+        totp_hash_final(algorithm, &state, block);
+        totp_wipe(&state, sizeof(state));
+    } else if (secret_length > 0) {
+        memcpy(block, secret, secret_length);
+    }
+
+    uint8_t pad[TOTP_MAX_BLOCK_SIZE];
+    for (size_t i = 0; i < block_size; i++) {
+        pad[i] = block[i] ^ 0x36;
+    }
+    totp_hash_init(algorithm, &key->inner);
+    totp_hash_update(algorithm, &key->inner, pad, block_size);
+    for (size_t i = 0; i < block_size; i++) {
+        pad[i] = block[i] ^ 0x5C;
+    }
+    totp_hash_init(algorithm, &key->outer);
+    totp_hash_update(algorithm, &key->outer, pad, block_size);
+
+    totp_wipe(pad, sizeof(pad));
+    totp_wipe(block, sizeof(block));
+    return key;
+}
+
+void totp_key_destroy(totp_key *key) {
+    if (!key) {
+        return;
+    }
+    totp_wipe(key, sizeof(totp_key));
+    free(key);
+}
+
+uint32_t totp_key_full_code(const totp_key *key, uint64_t counter) {
+    uint8_t message[8];
+    for (int i = 7; i >= 0; i--) {
+        message[i] = (uint8_t)counter;
+        counter >>= 8;
+    }
+
+    uint8_t digest[TOTP_MAX_DIGEST_SIZE];
+    totp_hash_state state = key->inner;
+    totp_hash_update(key->algorithm, &state, message, sizeof(message));
+    const size_t digest_length = totp_hash_final(key->algorithm, &state, digest);
+    state = key->outer;
+    totp_hash_update(key->algorithm, &state, digest, digest_length);
+    totp_hash_final(key->algorithm, &state, digest);
+
+    // Dynamic truncation, RFC 4226 section 5.3
+    const size_t offset = digest[digest_length - 1] & 0x0F;
+    const uint32_t code =
+        ((uint32_t)(digest[offset] & 0x7F) << 24) |
+        ((uint32_t)digest[offset + 1] << 16) |
+        ((uint32_t)digest[offset + 2] << 8) |
+        (uint32_t)digest[offset + 3];
+    totp_wipe(&state, sizeof(state));
+    totp_wipe(digest, sizeof(digest));
+    return code;
+}
+
+void totp_compute_batch(
+    const totp_key *const *keys,
+    const uint32_t *periods,
+    const uint8_t *digits,
+    size_t count,
+    uint64_t unix_time,
+    uint32_t *codes)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!keys[i] || periods[i] == 0) {
+            codes[i] = 0;
+            continue;
+        }
+        const uint32_t code = totp_key_full_code(keys[i], unix_time / periods[i]);
+        codes[i] = (digits[i] > 0 && digits[i] <= TOTP_MAX_DIGITS)
+            ? code % totp_powers_of_ten[digits[i]]
+            : code;
+    }
+}
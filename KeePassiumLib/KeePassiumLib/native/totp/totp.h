@@ -0,0 +1,60 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef totp_h
+#define totp_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// HMAC key of a TOTP secret, with the inner and outer pad states already hashed.
+/// Computing a code then takes two short hash updates instead of a full HMAC setup.
+/// Immutable once created, so it can be shared between threads.
+typedef struct totp_key totp_key;
+
+#define TOTP_ALGORITHM_SHA1 1
+#define TOTP_ALGORITHM_SHA256 2
+#define TOTP_ALGORITHM_SHA512 3
+
+/// Max number of decimal digits of a code; the dynamically truncated value has 31 bits.
+#define TOTP_MAX_DIGITS 9
+
+/// Prepares the HMAC key for the given secret (of any length, as per RFC 2104).
+/// @return the key, or NULL if the algorithm is unknown or memory is short
+totp_key *totp_key_create(int algorithm, const uint8_t *secret, size_t secret_length);
+
+/// Wipes and releases the key.
+void totp_key_destroy(totp_key *key);
+
+/// Computes HOTP value (RFC 4226) for the given counter, before reducing it to digits.
+uint32_t totp_key_full_code(const totp_key *key, uint64_t counter);
+
+/// Computes TOTP codes (RFC 6238) of many keys for the same moment.
+/// @param  keys       `count` keys
+/// @param  periods    time step of each key, in seconds; codes of zero-period keys are 0
+/// @param  digits     number of decimal digits of each code (1...TOTP_MAX_DIGITS),
+///                    or 0 to keep the full 31-bit value (for custom encodings, like Steam)
+/// @param  unix_time  seconds since 1970
+/// @param  codes      receives `count` codes
+void totp_compute_batch(
+    const totp_key *const *keys,
+    const uint32_t *periods,
+    const uint8_t *digits,
+    size_t count,
+    uint64_t unix_time,
+    uint32_t *codes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* totp_h */
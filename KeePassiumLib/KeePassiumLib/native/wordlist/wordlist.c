@@ -0,0 +1,263 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#include "wordlist.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../crypto/sha256/sha256.h"
+
+static const uint8_t wordlist_magic[4] = { 'K', 'P', 'W', 'L' };
+
+struct wordlist {
+    const uint8_t *map;
+    size_t map_size;
+    const uint8_t *offsets;
+    const uint8_t *blob;
+    uint32_t count;
+};
+
+static inline uint32_t wordlist_load32_le(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static inline uint64_t wordlist_load64_le(const uint8_t *src) {
+    return (uint64_t)wordlist_load32_le(src) | ((uint64_t)wordlist_load32_le(src + 4) << 32);
+}
+
+static inline void wordlist_store32_le(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+static inline void wordlist_store64_le(uint8_t *dst, uint64_t value) {
+    wordlist_store32_le(dst, (uint32_t)value);
+    wordlist_store32_le(dst + 4, (uint32_t)(value >> 32));
+}
+
+/***************Compiler*****************/
+
+typedef struct {
+    const uint8_t *bytes;
+    uint32_t length;
+} wordlist_ref;
+
+static int wordlist_compare_refs(const void *a, const void *b) {
+    const wordlist_ref *x = a;
+    const wordlist_ref *y = b;
+    const uint32_t common = (x->length < y->length) ? x->length : y->length;
+    const int result = memcmp(x->bytes, y->bytes, common);
+    if (result != 0) {
+        return result;
+    }
+    return (x->length > y->length) - (x->length < y->length);
+}
+
+static inline int wordlist_is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+int wordlist_compile(const uint8_t *text, size_t length, uint8_t **out, size_t *out_length) {
+    *out = NULL;
+    *out_length = 0;
+    if (!text || length == 0) {
+        return WORDLIST_ERROR_FORMAT;
+    }
+
+    size_t line_count = 1;
+    for (size_t i = 0; i < length; i++) {
+        line_count += (text[i] == '\n');
+    }
+    wordlist_ref *refs = malloc(line_count * sizeof(wordlist_ref));
+    if (!refs) {
+        return WORDLIST_ERROR_MEMORY;
+    }
+
+    size_t count = 0;
+    size_t line_start = 0;
+    while (line_start <= length) {
+        const uint8_t *newline = memchr(text + line_start, '\n', length - line_start);
+        const size_t line_end = newline ? (size_t)(newline - text) : length;
+        size_t start = line_start;
+        size_t end = line_end;
+        while (start < end && wordlist_is_space(text[start])) {
+            start++;
+        }
+        while (end > start && wordlist_is_space(text[end - 1])) {
+            end--;
+        }
+        if (end > start && end - start <= UINT32_MAX) {
+            refs[count].bytes = text + start;
+            refs[count].length = (uint32_t)(end - start);
+            count++;
+        }
+        line_start = line_end + 1;
+    }
+    if (count == 0) {
+        free(refs);
+        return WORDLIST_ERROR_FORMAT;
+    }
+
+    qsort(refs, count, sizeof(wordlist_ref), wordlist_compare_refs);
+    size_t unique = 1;
+    uint64_t blob_size = refs[0].length;
+    for (size_t i = 1; i < count; i++) {
+        if (wordlist_compare_refs(&refs[unique - 1], &refs[i]) != 0) {
+            refs[unique++] = refs[i];
+            blob_size += refs[i].length;
+        }
+    }
+    const uint64_t offsets_size = ((uint64_t)unique + 1) * sizeof(uint32_t);
+    if (unique >= UINT32_MAX || blob_size > UINT32_MAX
+        || WORDLIST_HEADER_SIZE + offsets_size + blob_size > UINT32_MAX)
+    {
+        free(refs);
+        return WORDLIST_ERROR_FORMAT;
+    }
+
+    const size_t total_size = (size_t)(WORDLIST_HEADER_SIZE + offsets_size + blob_size);
+    uint8_t *result = calloc(1, total_size);
+    if (!result) {
+        free(refs);
+        return WORDLIST_ERROR_MEMORY;
+    }
+    const uint32_t offsets_offset = WORDLIST_HEADER_SIZE;
+    const uint32_t blob_offset = (uint32_t)(WORDLIST_HEADER_SIZE + offsets_size);
+    memcpy(result, wordlist_magic, sizeof(wordlist_magic));
+    wordlist_store32_le(result + 4, WORDLIST_VERSION);
+    wordlist_store32_le(result + 8, (uint32_t)unique);
+    wordlist_store32_le(result + 12, offsets_offset);
+    wordlist_store32_le(result + 16, blob_offset);
+    wordlist_store32_le(result + 20, (uint32_t)blob_size);
+    wordlist_store64_le(result + 24, (uint64_t)length);
+    sha256(text, length, result + 32);
+
+    uint32_t position = 0;
+    for (size_t i = 0; i < unique; i++) {
+        wordlist_store32_le(result + offsets_offset + i * sizeof(uint32_t), position);
+        memcpy(result + blob_offset + position, refs[i].bytes, refs[i].length);
+        position += refs[i].length;
+    }
+    wordlist_store32_le(result + offsets_offset + unique * sizeof(uint32_t), position);
+    free(refs);
+
+    *out = result;
+    *out_length = total_size;
+    return WORDLIST_OK;
+}
+
+/***************Reader*****************/
+
+static int wordlist_validate(wordlist *list) {
+    const uint8_t *header = list->map;
+    if (list->map_size < WORDLIST_HEADER_SIZE
+        || memcmp(header, wordlist_magic, sizeof(wordlist_magic)) != 0
+        || wordlist_load32_le(header + 4) != WORDLIST_VERSION)
+    {
+        return WORDLIST_ERROR_FORMAT;
+    }
+    const uint64_t count = wordlist_load32_le(header + 8);
+    const uint64_t offsets_offset = wordlist_load32_le(header + 12);
+    const uint64_t blob_offset = wordlist_load32_le(header + 16);
+    const uint64_t blob_size = wordlist_load32_le(header + 20);
+    if (count == 0
+        || offsets_offset + (count + 1) * sizeof(uint32_t) > list->map_size
+        || blob_offset + blob_size > list->map_size)
+    {
+        return WORDLIST_ERROR_FORMAT;
+    }
+    list->count = (uint32_t)count;
+    list->offsets = list->map + offsets_offset;
+    list->blob = list->map + blob_offset;
+
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i <= list->count; i++) {
+        const uint32_t offset = wordlist_load32_le(list->offsets + i * sizeof(uint32_t));
+        if (offset < previous || offset > blob_size) {
+            return WORDLIST_ERROR_FORMAT;
+        }
+        previous = offset;
+    }
+    return (previous == blob_size) ? WORDLIST_OK : WORDLIST_ERROR_FORMAT;
+}
+
+wordlist *wordlist_open(const char *path, int *status) {
+    int error = WORDLIST_ERROR_IO;
+    wordlist *list = NULL;
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        goto done;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        goto done;
+    }
+    void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        goto done;
+    }
+    list = calloc(1, sizeof(wordlist));
+    if (!list) {
+        munmap(map, (size_t)info.st_size);
+        error = WORDLIST_ERROR_MEMORY;
+        goto done;
+    }
+    list->map = map;
+    list->map_size = (size_t)info.st_size;
+    error = wordlist_validate(list);
+    if (error != WORDLIST_OK) {
+        wordlist_close(list);
+        list = NULL;
+    }
+done:
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (status) {
+        *status = error;
+    }
+    return list;
+}
+
+void wordlist_close(wordlist *list) {
+    if (!list) {
+        return;
+    }
+    munmap((void *)list->map, list->map_size);
+    free(list);
+}
+
+uint32_t wordlist_count(const wordlist *list) {
+    return list->count;
+}
+
+int wordlist_matches_source(const wordlist *list, const uint8_t *text, size_t length) {
+    if (wordlist_load64_le(list->map + 24) != (uint64_t)length) {
+        return 0;
+    }
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256(text, length, digest);
+    return memcmp(digest, list->map + 32, WORDLIST_SOURCE_DIGEST_SIZE) == 0;
+}
+
+const uint8_t *wordlist_word(const wordlist *list, uint32_t index, size_t *length) {
+    if (index >= list->count) {
+        *length = 0;
+        return NULL;
+    }
+    const uint8_t *entry = list->offsets + (size_t)index * sizeof(uint32_t);
+    const uint32_t start = wordlist_load32_le(entry);
+    *length = wordlist_load32_le(entry + sizeof(uint32_t)) - start;
+    return list->blob + start;
+}
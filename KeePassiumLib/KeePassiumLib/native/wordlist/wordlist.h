@@ -0,0 +1,64 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+#ifndef wordlist_h
+#define wordlist_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Compiled passphrase wordlist, which can be memory-mapped and sampled without parsing.
+///
+/// File layout (all integers little-endian):
+///   header:  magic "KPWL", version, word count, offsets of the offset table and of the word blob,
+///            blob size, source text size (64 bits), SHA-256 of the source text
+///   offsets: word count + 1 `uint32_t` offsets into the blob; word `i` spans [offsets[i], offsets[i + 1])
+///   blob:    words in UTF-8, sorted bytewise, without separators
+typedef struct wordlist wordlist;
+
+#define WORDLIST_OK 0
+#define WORDLIST_ERROR_IO (-1)
+#define WORDLIST_ERROR_FORMAT (-2)
+#define WORDLIST_ERROR_MEMORY (-3)
+
+#define WORDLIST_HEADER_SIZE 64
+#define WORDLIST_VERSION 2
+#define WORDLIST_SOURCE_DIGEST_SIZE 32
+
+/// Converts a text wordlist (one word per line, blank lines ignored,
+/// surrounding whitespace trimmed, duplicates removed) to the compiled format.
+/// @param  out  receives a malloc'ed buffer, to be released by the caller with free()
+/// @return WORDLIST_OK, WORDLIST_ERROR_FORMAT if there are no words, or WORDLIST_ERROR_MEMORY
+int wordlist_compile(const uint8_t *text, size_t length, uint8_t **out, size_t *out_length);
+
+/// Maps a compiled wordlist file read-only and validates its structure.
+/// @param  status  receives WORDLIST_OK or the error code; may be NULL
+/// @return the wordlist, or NULL on error
+wordlist *wordlist_open(const char *path, int *status);
+
+/// Unmaps and releases the wordlist.
+void wordlist_close(wordlist *list);
+
+uint32_t wordlist_count(const wordlist *list);
+
+/// Checks whether the wordlist was compiled from exactly this text.
+/// @return 1 if the size and SHA-256 of the text match those recorded on compilation, 0 otherwise
+int wordlist_matches_source(const wordlist *list, const uint8_t *text, size_t length);
+
+/// Returns the word at `index` (not zero-terminated), or NULL if the index is out of range.
+const uint8_t *wordlist_word(const wordlist *list, uint32_t index, size_t *length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* wordlist_h */
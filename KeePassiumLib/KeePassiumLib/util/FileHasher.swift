@@ -6,35 +6,30 @@
 //  by the Free Software Foundation: https://www.gnu.org/licenses/).
 //  For commercial licensing, please contact us.
 
-import CryptoKit
+import Foundation
 
 final class FileHasher {
-    private static let chunkSize = 65536
-
-    public static func sha256(fileURL: URL) throws -> SHA256Digest {
+    /// Hashes the file natively, memory-mapped (or read in large chunks if it cannot be mapped).
+    public static func sha256(fileURL: URL) throws -> ByteArray {
         assert(!Thread.isMainThread)
         assert(fileURL.isFileURL)
-        let fileHandle = try FileHandle(forReadingFrom: fileURL)
-        var hasher = SHA256()
-        var isDone = false
-        repeat {
-            try autoreleasepool {
-                if let chunk = try fileHandle.read(upToCount: chunkSize),
-                   !chunk.isEmpty
-                {
-                    hasher.update(data: chunk)
-                } else {
-                    isDone = true
-                }
-            }
-        } while !isDone
-        let digest = hasher.finalize()
-        return digest
+        var digest = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_SIZE))
+        let status = keyfile_sha256_file(fileURL.path, &digest)
+        guard status == KEYFILE_OK else {
+            throw POSIXError(keyfileStatus: status)
+        }
+        return ByteArray(bytes: digest)
     }
 }
 
-public extension SHA256Digest {
-    var asHexString: String {
-        self.map { String(format: "%02hhx", $0) }.joined()
+internal extension POSIXError {
+    /// Error for a failed `keyfile_*` call; must be created right after the call, while `errno` is relevant.
+    init(keyfileStatus status: Int32) {
+        switch status {
+        case KEYFILE_ERROR_MEMORY:
+            self.init(.ENOMEM)
+        default:
+            self.init(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
     }
 }
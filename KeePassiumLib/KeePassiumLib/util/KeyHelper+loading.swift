@@ -27,13 +27,13 @@ public extension KeyHelper {
             return
         }
 
-        FileDataProvider.read(keyFileRef, timeout: timeout, completionQueue: nil) { result in
+        FileDataProvider.readKeyFile(keyFileRef, timeout: timeout, completionQueue: nil) { result in
             assert(!Thread.isMainThread)
             switch result {
             case .success(let keyFileData):
                 self.buildCompositeKey(
                     password: password,
-                    keyFileData: SecureBytes.from(keyFileData),
+                    keyFileData: keyFileData,
                     challengeHandler: challengeHandler,
                     completionQueue: completionQueue,
                     completion: completion
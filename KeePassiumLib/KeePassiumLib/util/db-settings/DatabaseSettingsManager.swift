@@ -85,6 +85,7 @@ public class DatabaseSettingsManager {
     }
 
     public func eraseAllMasterKeys() {
+        KeyDerivationCache.removeAll()
         do {
             try updateAllSettings { $0.clearMasterKey() }
         } catch {
@@ -93,6 +94,7 @@ public class DatabaseSettingsManager {
     }
 
     public func eraseAllFinalKeys() {
+        KeyDerivationCache.removeAll()
         do {
             try updateAllSettings { $0.clearFinalKey() }
         } catch {
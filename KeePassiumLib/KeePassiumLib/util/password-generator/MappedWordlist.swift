@@ -0,0 +1,72 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+/// Compiled wordlist mapped read-only into memory (see `wordlist.h`).
+/// Words are decoded only when picked, so opening a large list costs next to nothing.
+public final class MappedWordlist {
+    public static let fileExtension = "kpwl"
+
+    private let list: OpaquePointer
+
+    public let count: Int
+
+    init?(fileURL: URL) {
+        var status: Int32 = WORDLIST_OK
+        guard let list = wordlist_open(fileURL.path, &status) else {
+            Diag.warning("Failed to open compiled wordlist [status: \(status)]")
+            return nil
+        }
+        self.list = list
+        self.count = Int(wordlist_count(list))
+    }
+
+    deinit {
+        wordlist_close(list)
+    }
+
+    public subscript(index: Int) -> String {
+        precondition(index >= 0 && index < count, "Word index out of range")
+        var length = 0
+        guard let bytes = wordlist_word(list, UInt32(index), &length) else {
+            return ""
+        }
+        return String(decoding: UnsafeBufferPointer(start: bytes, count: length), as: UTF8.self)
+    }
+
+    /// Whether the wordlist was compiled from exactly this text (same size and SHA-256).
+    func matches(source: Data) -> Bool {
+        return source.withUnsafeBytes { buffer in
+            wordlist_matches_source(
+                list,
+                buffer.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                buffer.count
+            ) != 0
+        }
+    }
+
+    /// Converts a text wordlist (one word per line) to the compiled format.
+    static func compile(text: Data) -> Data? {
+        var compiled: UnsafeMutablePointer<UInt8>?
+        var compiledLength = 0
+        let status = text.withUnsafeBytes { buffer in
+            wordlist_compile(
+                buffer.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                buffer.count,
+                &compiled,
+                &compiledLength
+            )
+        }
+        guard status == WORDLIST_OK, let compiled else {
+            Diag.warning("Failed to compile wordlist [status: \(status)]")
+            return nil
+        }
+        return Data(bytesNoCopy: compiled, count: compiledLength, deallocator: .free)
+    }
+}
@@ -22,10 +22,12 @@ public class PassphraseGeneratorParams: Codable, Equatable {
     public var wordCase: PassphraseGenerator.WordCase = .lowerCase
     public var wordlist: PassphraseWordlist = .effLarge {
         didSet {
-            loadedStringSet = PassphraseWordlistManager.load(wordlist)
+            loadedStringSet = nil
+            mappedWordlist = PassphraseWordlistManager.loadMapped(wordlist)
         }
     }
 
+    private var mappedWordlist: MappedWordlist?
     private var loadedStringSet: StringSet? 
 
     public static func == (lhs: PassphraseGeneratorParams, rhs: PassphraseGeneratorParams) -> Bool {
@@ -38,16 +40,30 @@ public class PassphraseGeneratorParams: Codable, Equatable {
 
 extension PassphraseGeneratorParams: PasswordGeneratorRequirementsConvertible {
     public func toRequirements() -> PasswordGeneratorRequirements {
+        let preprocessor = makePreprocessorFunction(for: wordCase)
+        let merger: PasswordGenerator.ElementMergingFunction = { [separator] elements in
+            elements.joined(separator: separator)
+        }
+
+        if mappedWordlist == nil && loadedStringSet == nil {
+            mappedWordlist = PassphraseWordlistManager.loadMapped(wordlist)
+        }
+        if let mappedWordlist {
+            return PasswordGeneratorRequirements(
+                length: wordCount,
+                sets: [],
+                maxConsecutive: nil,
+                elementPreprocessor: preprocessor,
+                elementMerger: merger,
+                wordlist: mappedWordlist
+            )
+        }
+
         if loadedStringSet == nil {
             loadedStringSet = PassphraseWordlistManager.load(wordlist)
         }
         let stringSet = loadedStringSet ?? StringSet()
         let conditionalSet = ConditionalStringSet(stringSet, condition: .allowed)
-
-        let preprocessor = makePreprocessorFunction(for: wordCase)
-        let merger: PasswordGenerator.ElementMergingFunction = { [separator] elements in
-            elements.joined(separator: separator)
-        }
         return PasswordGeneratorRequirements(
             length: wordCount,
             sets: [conditionalSet],
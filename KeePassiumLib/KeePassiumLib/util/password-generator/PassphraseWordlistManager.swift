@@ -15,6 +15,12 @@ public final class PassphraseWordlistManager {
         return sharedContainerURL.appendingPathComponent("wordlists")
     }
 
+    private static var compiledWordlistsFolder: URL {
+        guard let sharedContainerURL = FileManager.default.containerURL(
+            forSecurityApplicationGroupIdentifier: AppGroup.id) else { fatalError() }
+        return sharedContainerURL.appendingPathComponent("wordlists-compiled")
+    }
+
     public static let customWordlistExtension = "txt"
 
     private static let maxWordsCount = 10000
@@ -36,21 +42,77 @@ public final class PassphraseWordlistManager {
         }
     }
 
+    private static func getSourceURL(_ wordlist: PassphraseWordlist) -> URL? {
+        switch wordlist {
+        case .custom:
+            return wordlistsFolder.appendingPathComponent(wordlist.fileName)
+        default:
+            return Bundle.framework.url(
+                forResource: wordlist.fileName,
+                withExtension: "",
+                subdirectory: ""
+            )
+        }
+    }
+
+    private static func getCompiledURL(_ wordlist: PassphraseWordlist) -> URL {
+        let prefix: String
+        switch wordlist {
+        case .custom:
+            prefix = "custom-"
+        default:
+            prefix = "builtin-"
+        }
+        return compiledWordlistsFolder
+            .appendingPathComponent(prefix + wordlist.fileName)
+            .appendingPathExtension(MappedWordlist.fileExtension)
+    }
+
+    /// Maps the compiled version of the wordlist, (re)compiling it first if it is missing or outdated.
+    /// Returns `nil` if that fails, in which case `load(_:)` can be used instead.
+    ///
+    /// The compiled file is up to date if it records the size and hash of the current source.
+    /// (File dates are not reliable: bundled wordlists keep their build-time dates across updates.)
+    public static func loadMapped(_ wordlist: PassphraseWordlist) -> MappedWordlist? {
+        guard let sourceURL = getSourceURL(wordlist) else {
+            Diag.error("Failed to find wordlist file [fileName: \(wordlist.fileName)]")
+            return nil
+        }
+        let sourceData: Data
+        do {
+            sourceData = try Data(contentsOf: sourceURL, options: .mappedIfSafe)
+        } catch {
+            Diag.error("Failed to read wordlist [message: \(error.localizedDescription)]")
+            return nil
+        }
+        let compiledURL = getCompiledURL(wordlist)
+        if let mappedWordlist = MappedWordlist(fileURL: compiledURL),
+           mappedWordlist.matches(source: sourceData)
+        {
+            return mappedWordlist
+        }
+
+        Diag.debug("Will compile wordlist [fileName: \(wordlist.fileName)]")
+        do {
+            guard let compiledData = MappedWordlist.compile(text: sourceData) else {
+                return nil
+            }
+            let fileManager = FileManager.default
+            if !fileManager.fileExists(atPath: compiledWordlistsFolder.path) {
+                try fileManager.createDirectory(at: compiledWordlistsFolder, withIntermediateDirectories: true)
+            }
+            try compiledData.write(to: compiledURL, options: .atomic)
+            Diag.debug("Wordlist compiled successfully")
+        } catch {
+            Diag.error("Failed to compile wordlist [message: \(error.localizedDescription)]")
+            return nil
+        }
+        return MappedWordlist(fileURL: compiledURL)
+    }
+
     public static func load(_ wordlist: PassphraseWordlist) -> StringSet? {
         Diag.debug("Will load wordlist [fileName: \(wordlist.fileName)]")
-        let resourcePath = { () -> URL? in
-            switch wordlist {
-            case .custom:
-                return wordlistsFolder.appendingPathComponent(wordlist.fileName)
-            default:
-                return Bundle.framework.url(
-                    forResource: wordlist.fileName,
-                    withExtension: "",
-                    subdirectory: ""
-                )
-            }
-        }()
-        guard let resourcePath else {
+        guard let resourcePath = getSourceURL(wordlist) else {
             Diag.error("Failed to find wordlist file [fileName: \(wordlist.fileName)]")
             return nil
         }
@@ -80,6 +142,7 @@ public final class PassphraseWordlistManager {
         } catch {
             Diag.error("Failed to delete custom wordlist [message: \(error.localizedDescription)]")
         }
+        try? FileManager.default.removeItem(at: getCompiledURL(wordlist))
     }
 }
 
@@ -142,7 +205,10 @@ extension PassphraseWordlistManager {
         try sanitizedContent.write(to: targetFileURL, atomically: false, encoding: .utf8)
         Diag.info("Wordlist imported successfully")
 
-        return .custom(fileName)
+        let wordlist = PassphraseWordlist.custom(fileName)
+        try? FileManager.default.removeItem(at: getCompiledURL(wordlist))
+        _ = loadMapped(wordlist)
+        return wordlist
     }
 
     private static func loadTextFile(from fileURL: URL) throws -> String {
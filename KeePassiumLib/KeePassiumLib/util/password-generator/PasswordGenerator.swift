@@ -41,20 +41,20 @@ public class PasswordGenerator {
         var pickedElements = requiredElementsSample
 
         let fillerCount = targetLength - requiredElementsSample.count
-        if fillerCount > 0 {
-            let allowedElements = try requirements.getAllowedElementsFiltered()
+        if let wordlist = requirements.wordlist, fillerCount > 0 {
+            guard wordlist.count > 0 else {
+                throw PasswordGeneratorError.notEnoughElementsToSample
+            }
+            let fillerIndices = rng.nextIndices(count: fillerCount, upperBound: wordlist.count)
+            pickedElements.append(contentsOf: fillerIndices.map { wordlist[$0] })
+        } else if fillerCount > 0 {
+            let allowedElements = Array(try requirements.getAllowedElementsFiltered())
             guard allowedElements.count > 0 else {
                 assertionFailure("An allowed set is empty. This cannot be possible here.")
                 throw PasswordGeneratorError.notEnoughElementsToSample
             }
-            for _ in 0..<fillerCount {
-                if let element = allowedElements.randomElement(using: &rng) {
-                    pickedElements.append(element)
-                } else {
-                    assertionFailure("Should not be here")
-                    throw PasswordGeneratorError.notEnoughElementsToSample
-                }
-            }
+            let fillerIndices = rng.nextIndices(count: fillerCount, upperBound: allowedElements.count)
+            pickedElements.append(contentsOf: fillerIndices.map { allowedElements[$0] })
         }
 
         if let preprocessorFunction = requirements.elementPreprocessor {
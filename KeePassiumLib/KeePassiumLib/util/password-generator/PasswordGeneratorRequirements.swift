@@ -21,18 +21,23 @@ public struct PasswordGeneratorRequirements {
     let elementPreprocessor: PasswordGenerator.ElementPreprocessingFunction?
     let elementMerger: PasswordGenerator.ElementMergingFunction?
 
+    /// Allowed elements sampled directly, instead of the allowed sets. Excluded sets do not apply to it.
+    let wordlist: MappedWordlist?
+
     public init(
         length: Int,
         sets: [ConditionalStringSet],
         maxConsecutive: Int?,
         elementPreprocessor: PasswordGenerator.ElementPreprocessingFunction? = nil,
-        elementMerger: PasswordGenerator.ElementMergingFunction? = nil
+        elementMerger: PasswordGenerator.ElementMergingFunction? = nil,
+        wordlist: MappedWordlist? = nil
     ) {
         self.length = length
         self.sets = sets.filter { $0.condition != .inactive }
         self.maxConsecutive = maxConsecutive
         self.elementPreprocessor = elementPreprocessor
         self.elementMerger = elementMerger
+        self.wordlist = wordlist
     }
 
     func getExcludedSets() -> [StringSet] {
@@ -30,7 +30,7 @@ class XMLParserStream<DocumentContext: XMLDocumentContext>: CustomStringConverti
     public fileprivate(set) var readerContext: XMLReaderContext?
     public fileprivate(set) var documentContext: DocumentContext
 
-    unowned private var docReader: XMLDocumentReader<DocumentContext>
+    unowned private var readers: XMLReaderStack<DocumentContext>
 
     var description: String {
         let padding = String(repeating: "  ", count: parentElements.count)
@@ -45,11 +45,11 @@ class XMLParserStream<DocumentContext: XMLDocumentContext>: CustomStringConverti
         return elements.joined(separator: "/")
     }
 
-    fileprivate init(_ docReader: XMLDocumentReader<DocumentContext>, documentContext: DocumentContext) {
+    fileprivate init(_ readers: XMLReaderStack<DocumentContext>, documentContext: DocumentContext) {
         self.event = .end
         self.name = ""
         self.value = nil
-        self.docReader = docReader
+        self.readers = readers
         self.documentContext = documentContext
     }
 
@@ -59,18 +59,62 @@ class XMLParserStream<DocumentContext: XMLDocumentContext>: CustomStringConverti
         repeatEvent: Bool = true
     ) throws {
         parentElements.append(name)
-        docReader.pushReader(reader, context: context)
+        readers.push(reader, context: context)
         if repeatEvent {
             try reader(self)
         }
     }
 
     func popReader() {
-        docReader.popReader()
+        readers.pop()
         _ = parentElements.popLast()
     }
 }
 
+final class XMLReaderStack<DocumentContext: XMLDocumentContext> {
+    private var readerStack: [XMLReader<DocumentContext>]
+    private var readerContextStack: [XMLReaderContext?]
+    private var currentStreamState: XMLParserStream<DocumentContext>!
+
+    var isEmpty: Bool { readerStack.isEmpty }
+
+    init(documentContext: DocumentContext) {
+        readerStack = []
+        readerContextStack = []
+        currentStreamState = XMLParserStream<DocumentContext>(self, documentContext: documentContext)
+    }
+
+    func push(_ reader: @escaping XMLReader<DocumentContext>, context: XMLReaderContext?) {
+        readerStack.append(reader)
+        readerContextStack.append(context)
+        currentStreamState.readerContext = context
+    }
+
+    func pop() {
+        _ = readerStack.popLast()
+        _ = readerContextStack.popLast()
+    }
+
+    func removeAll() {
+        readerStack.removeAll()
+        readerContextStack.removeAll()
+    }
+
+    func dispatch(
+        _ event: XMLParserStream<DocumentContext>.EventType,
+        _ name: String,
+        value: String?,
+        attributes: [String: String]
+    ) throws {
+        currentStreamState.event = event
+        currentStreamState.name = name
+        currentStreamState.value = value
+        currentStreamState.attributes = attributes
+        currentStreamState.readerContext = readerContextStack.last as? XMLReaderContext
+        try readerStack.last?(currentStreamState)
+    }
+}
+
 class XMLDocumentReader<DocumentContext: XMLDocumentContext>: NSObject, XMLParserDelegate {
     public private(set) var error: Error?
 
@@ -78,29 +122,24 @@ class XMLDocumentReader<DocumentContext: XMLDocumentContext>: NSObject, XMLParse
     private var startedElement: String?
     private var currentAttributes: [String: String]
     private var accumulatedString: String?
-    private var readerStack: [XMLReader<DocumentContext>]
-    private var readerContextStack: [XMLReaderContext?]
-    private var currentStreamState: XMLParserStream<DocumentContext>!
+    private let readers: XMLReaderStack<DocumentContext>
 
     init(xmlData: Data, documentContext: DocumentContext) {
         parser = XMLParser(data: xmlData)
-        readerStack = []
-        readerContextStack = []
+        readers = XMLReaderStack(documentContext: documentContext)
         currentAttributes = [:]
         super.init()
         parser.delegate = self
-        currentStreamState = XMLParserStream<DocumentContext>(self, documentContext: documentContext)
     }
     deinit {
         if error == nil {
-            assert(readerStack.isEmpty, "Some XML readers left in the stack: imbalanced pushReader/popReader calls?")
+            assert(readers.isEmpty, "Some XML readers left in the stack: imbalanced pushReader/popReader calls?")
         }
-        readerStack.removeAll()
-        readerContextStack.removeAll()
+        readers.removeAll()
     }
 
     public func parse() throws {
-        assert(!readerStack.isEmpty, "Push at least one reader before parsing.")
+        assert(!readers.isEmpty, "Push at least one reader before parsing.")
         parser.parse()
         if let error {
             throw error
@@ -108,14 +147,11 @@ class XMLDocumentReader<DocumentContext: XMLDocumentContext>: NSObject, XMLParse
     }
 
     public func pushReader(_ reader: @escaping XMLReader<DocumentContext>, context: XMLReaderContext?) {
-        readerStack.append(reader)
-        readerContextStack.append(context)
-        currentStreamState.readerContext = context
+        readers.push(reader, context: context)
     }
 
     public func popReader() {
-        _ = readerStack.popLast()
-        _ = readerContextStack.popLast()
+        readers.pop()
     }
 
     func parser(_ parser: XMLParser, parseErrorOccurred parseError: Error) {
@@ -136,13 +172,8 @@ class XMLDocumentReader<DocumentContext: XMLDocumentContext>: NSObject, XMLParse
         attributes: [String: String],
         from parser: XMLParser
     ) {
-        currentStreamState.event = event
-        currentStreamState.name = name
-        currentStreamState.value = value
-        currentStreamState.attributes = attributes
-        currentStreamState.readerContext = readerContextStack.last as? XMLReaderContext
         do {
-            try readerStack.last?(currentStreamState)
+            try readers.dispatch(event, name, value: value, attributes: attributes)
         } catch {
             self.error = error
             parser.abortParsing()
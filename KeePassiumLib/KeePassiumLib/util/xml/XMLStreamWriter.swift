@@ -0,0 +1,158 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+
+final class XMLStreamWriter {
+    typealias Output = (_ chunk: UnsafeRawBufferPointer) throws -> Void
+
+    private static let ampersand = Array("&amp;".utf8)
+    private static let lessThan = Array("&lt;".utf8)
+    private static let greaterThan = Array("&gt;".utf8)
+    private static let apostrophe = Array("&apos;".utf8)
+    private static let quote = Array("&quot;".utf8)
+
+    private let output: Output
+    private let chunkSize: Int
+    private var buffer: [UInt8]
+
+    init(chunkSize: Int = 64 * 1024, output: @escaping Output) {
+        self.chunkSize = chunkSize
+        self.output = output
+        buffer = []
+        buffer.reserveCapacity(chunkSize + 4 * 1024)
+    }
+
+    deinit {
+        buffer.erase()
+    }
+
+    /// Writes the XML declaration; must come before any element.
+    func writeDeclaration(_ header: AEXMLOptions.DocumentHeader) {
+        append(header.xmlString)
+        append("\n")
+    }
+
+    /// Writes a complete element, with all its children.
+    func write(element: AEXMLElement, depth: Int) throws {
+        try writeElement(element, depth: depth)
+        append("\n")
+    }
+
+    /// Opens an element whose other children are written separately, so that
+    /// large trees need not be built in memory. Writes the start tag and
+    /// the children the element already has.
+    func writeStart(element: AEXMLElement, depth: Int) throws {
+        appendIndent(depth)
+        appendStartTag(element)
+        append(">\n")
+        for child in element.children {
+            try write(element: child, depth: depth + 1)
+        }
+    }
+
+    /// Closes an element opened by `writeStart(element:depth:)`.
+    func writeEnd(element: AEXMLElement, depth: Int) throws {
+        appendIndent(depth)
+        append("</")
+        append(element.name)
+        append(">\n")
+        try flushIfFull()
+    }
+
+    /// Passes on the remaining buffered output.
+    func finish() throws {
+        try flush()
+    }
+
+    private func writeElement(_ element: AEXMLElement, depth: Int) throws {
+        appendIndent(depth)
+        appendStartTag(element)
+
+        if element.value == nil && element.children.isEmpty {
+            append(" />")
+        } else if element.children.isEmpty {
+            append(">")
+            appendEscaped(element.string)
+            append("</")
+            append(element.name)
+            append(">")
+        } else {
+            append(">\n")
+            for child in element.children {
+                try writeElement(child, depth: depth + 1)
+                append("\n")
+            }
+            appendIndent(depth)
+            append("</")
+            append(element.name)
+            append(">")
+        }
+        try flushIfFull()
+    }
+
+    private func appendStartTag(_ element: AEXMLElement) {
+        append("<")
+        append(element.name)
+        for (key, value) in element.attributes {
+            append(" ")
+            append(key)
+            append("=\"")
+            appendEscaped(value)
+            append("\"")
+        }
+    }
+
+    private func flushIfFull() throws {
+        if buffer.count >= chunkSize {
+            try flush()
+        }
+    }
+
+    private func flush() throws {
+        guard !buffer.isEmpty else { return }
+        try buffer.withUnsafeBytes { try output($0) }
+        buffer.withUnsafeMutableBytes { bytes in
+            memset_s(bytes.baseAddress, bytes.count, 0, bytes.count)
+        }
+        buffer.removeAll(keepingCapacity: true)
+    }
+
+    private func append(_ string: String) {
+        buffer.append(contentsOf: string.utf8)
+    }
+
+    private func appendIndent(_ depth: Int) {
+        for _ in 0..<depth {
+            buffer.append(0x09)
+        }
+    }
+
+    private func appendEscaped(_ string: String) {
+        for byte in string.utf8 {
+            switch byte {
+            case 0x26:
+                buffer.append(contentsOf: Self.ampersand)
+            case 0x3C:
+                buffer.append(contentsOf: Self.lessThan)
+            case 0x3E:
+                buffer.append(contentsOf: Self.greaterThan)
+            case 0x27:
+                buffer.append(contentsOf: Self.apostrophe)
+            case 0x22:
+                buffer.append(contentsOf: Self.quote)
+            case 0x09, 0x0A, 0x0D:
+                buffer.append(byte)
+            case 0x00..<0x20:
+                continue
+            default:
+                buffer.append(byte)
+            }
+        }
+    }
+}
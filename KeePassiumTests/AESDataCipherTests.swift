@@ -0,0 +1,47 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+@testable import KeePassiumLib
+import XCTest
+
+final class AESDataCipherTests: XCTestCase {
+    // NIST SP 800-38A, F.2.5 CBC-AES256.Encrypt
+    private let key = SecureBytes.from(ByteArray(hexString:
+        "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4")!)
+    private let iv = SecureBytes.from(ByteArray(hexString: "000102030405060708090a0b0c0d0e0f")!)
+    private let plainText = ByteArray(hexString:
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51" +
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710")!
+    private let cipherText = ByteArray(hexString:
+        "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d" +
+        "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b")!
+
+    func testNISTVector() throws {
+        let encrypted = try AESDataCipher().encrypt(plainText: plainText, key: key, iv: iv)
+        XCTAssertEqual(encrypted.count, plainText.count + 16, "Expected a full padding block")
+        XCTAssertEqual(encrypted.prefix(cipherText.count), cipherText)
+
+        let decrypted = try AESDataCipher().decrypt(cipherText: encrypted, key: key, iv: iv)
+        XCTAssertEqual(decrypted, plainText)
+    }
+
+    func testLargeRoundTrip() throws {
+        // large enough to be decrypted on several threads
+        let bytes = (0..<(9 * 1024 * 1024 + 5)).map { UInt8(truncatingIfNeeded: $0 &* 131) }
+        let data = ByteArray(bytes: bytes)
+        let encrypted = try AESDataCipher().encrypt(plainText: data, key: key, iv: iv)
+        let decrypted = try AESDataCipher().decrypt(cipherText: encrypted, key: key, iv: iv)
+        XCTAssertEqual(decrypted, data)
+    }
+
+    func testWrongKeyFails() throws {
+        let encrypted = try AESDataCipher().encrypt(plainText: plainText, key: key, iv: iv)
+        let wrongKey = SecureBytes.from([UInt8](repeating: 0x42, count: 32))
+        XCTAssertThrowsError(try AESDataCipher().decrypt(cipherText: encrypted, key: wrongKey, iv: iv))
+    }
+}
@@ -0,0 +1,53 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+@testable import KeePassiumLib
+import XCTest
+
+final class CustomIconIndexTests: XCTestCase {
+    private func makeIconData(_ seed: Int) -> ByteArray {
+        return ByteArray(bytes: [0x89, 0x50, 0x4E, 0x47] + withUnsafeBytes(of: seed) { Array($0) })
+    }
+
+    func testDigestMatchesSHA256() {
+        let data = makeIconData(1)
+        let icon = CustomIcon2(uuid: UUID(), data: data)
+        XCTAssertEqual(icon.dataSHA256, data.sha256)
+    }
+
+    func testAddDeduplicatesByData() {
+        let db = SyntheticDatabaseGenerator.make(SyntheticDatabaseSpec(entryCount: 10))
+        let icons = (0..<1000).map { db.addCustomIcon(pngData: makeIconData($0)) }
+        XCTAssertEqual(db.customIcons.count, 1000)
+
+        let duplicate = db.addCustomIcon(pngData: makeIconData(500))
+        XCTAssertTrue(duplicate === icons[500])
+        XCTAssertEqual(db.customIcons.count, 1000)
+        XCTAssertTrue(db.getCustomIcon(with: icons[42].uuid) === icons[42])
+    }
+
+    func testDeleteUpdatesLookupsAndReferences() {
+        let db = SyntheticDatabaseGenerator.make(SyntheticDatabaseSpec(entryCount: 10))
+        let icons = (0..<10).map { db.addCustomIcon(pngData: makeIconData($0)) }
+        var entries = [Entry]()
+        db.root?.collectAllEntries(to: &entries)
+        let entry = entries.first as! Entry2
+        entry.customIconUUID = icons[3].uuid
+
+        let deletedUUIDs: Set<UUID> = [icons[3].uuid, icons[4].uuid, UUID()]
+        XCTAssertEqual(db.deleteCustomIcons(uuids: deletedUUIDs), 2)
+        XCTAssertEqual(db.customIcons.count, 8)
+        XCTAssertNil(db.getCustomIcon(with: icons[3].uuid))
+        XCTAssertEqual(entry.customIconUUID, UUID.ZERO)
+
+        let readded = db.addCustomIcon(pngData: makeIconData(3))
+        XCTAssertNotEqual(readded.uuid, icons[3].uuid)
+        XCTAssertEqual(db.customIcons.count, 9)
+        XCTAssertFalse(db.deleteCustomIcon(uuid: icons[4].uuid))
+    }
+}
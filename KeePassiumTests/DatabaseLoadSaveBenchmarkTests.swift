@@ -0,0 +1,140 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+@testable import KeePassiumLib
+import XCTest
+
+/// Times each stage of `Database2.load`/`save` on synthetic databases.
+///
+/// The benchmark is slow, so it only runs when the `KEEPASSIUM_BENCHMARK`
+/// or `KEEPASSIUM_BENCHMARK_OUTPUT` environment variable is set.
+/// Stage medians are attached to the test results as "[benchmark]" lines.
+/// If `KEEPASSIUM_BENCHMARK_OUTPUT` is set, they are also written there as JSON,
+/// in the same format as `scripts/crypto-benchmark`.
+final class DatabaseLoadSaveBenchmarkTests: XCTestCase {
+    private static let repetitions = 3
+    private static let environment = ProcessInfo.processInfo.environment
+
+    private static let specs: [SyntheticDatabaseSpec] = {
+        var specs = [SyntheticDatabaseSpec]()
+        specs.append(SyntheticDatabaseSpec())
+        specs.append(SyntheticDatabaseSpec(cipher: .aes, kdf: .argon2d, entryCount: 5000, historyDepth: 5))
+        specs.append(SyntheticDatabaseSpec(
+            cipher: .twofish,
+            isCompressed: false,
+            protectedFieldRatio: 1.0,
+            attachmentSizes: [1 << 20, 256 << 10, 64 << 10, 4 << 10]))
+        specs.append(SyntheticDatabaseSpec(formatVersion: .v3, cipher: .aes, kdf: .aesKdf))
+        specs.append(SyntheticDatabaseSpec(
+            formatVersion: .v3,
+            cipher: .twofish,
+            kdf: .aesKdf,
+            entryCount: 5000,
+            attachmentSizes: [256 << 10]))
+        return specs
+    }()
+
+    private struct StageResult {
+        let id: String
+        let value: Double
+        var unit = "ms"
+    }
+
+    func testGeneratorIsDeterministic() throws {
+        let spec = SyntheticDatabaseSpec(entryCount: 50, attachmentSizes: [1000])
+        let first = SyntheticDatabaseGenerator.make(spec)
+        let second = SyntheticDatabaseGenerator.make(spec)
+        let firstEntries = allEntries(of: first)
+        let secondEntries = allEntries(of: second)
+        XCTAssertEqual(firstEntries.count, spec.entryCount)
+        XCTAssertEqual(firstEntries.map(\.uuid), secondEntries.map(\.uuid))
+        XCTAssertEqual(firstEntries.map(\.resolvedPassword), secondEntries.map(\.resolvedPassword))
+    }
+
+    func testLoadSaveStages() throws {
+        let outputPath = Self.environment["KEEPASSIUM_BENCHMARK_OUTPUT"]
+        try XCTSkipUnless(
+            Self.environment["KEEPASSIUM_BENCHMARK"] != nil || outputPath != nil,
+            "Set KEEPASSIUM_BENCHMARK to run the load/save benchmark")
+
+        var results = [StageResult]()
+        for spec in Self.specs {
+            results.append(contentsOf: try benchmark(spec))
+        }
+        let report = results
+            .map { String(format: "[benchmark] %@ %.2f %@", $0.id, $0.value, $0.unit) }
+            .joined(separator: "\n")
+        add(XCTAttachment(string: report))
+
+        if let outputPath {
+            try writeJSON(results, to: URL(fileURLWithPath: outputPath))
+        }
+    }
+
+    private func benchmark(_ spec: SyntheticDatabaseSpec) throws -> [StageResult] {
+        let db = SyntheticDatabaseGenerator.make(spec)
+        var fileData = ByteArray()
+        var saveRuns = [StageTimings]()
+        for _ in 0..<Self.repetitions {
+            _ = db.initProgress()
+            fileData = try db.save()
+            saveRuns.append(db.saveTimings)
+        }
+
+        var loadRuns = [StageTimings]()
+        for _ in 0..<Self.repetitions {
+            let loadedDB = Database2()
+            _ = loadedDB.initProgress()
+            try loadedDB.load(
+                dbFileName: "synthetic.kdbx",
+                dbFileData: fileData,
+                compositeKey: SyntheticDatabaseGenerator.makeCompositeKey(for: loadedDB),
+                warnings: DatabaseLoadingWarnings())
+            XCTAssertEqual(allEntries(of: loadedDB).count, spec.entryCount, "\(spec)")
+            loadRuns.append(loadedDB.loadTimings)
+        }
+
+        var results = [StageResult(id: "\(spec)/size", value: Double(fileData.count) / 1000, unit: "kB")]
+        results.append(contentsOf: medians(of: saveRuns, prefix: "\(spec)/save"))
+        results.append(contentsOf: medians(of: loadRuns, prefix: "\(spec)/load"))
+        return results
+    }
+
+    private func allEntries(of db: Database2) -> [Entry] {
+        var entries = [Entry]()
+        db.root?.collectAllEntries(to: &entries)
+        return entries
+    }
+
+    private func medians(of runs: [StageTimings], prefix: String) -> [StageResult] {
+        guard let firstRun = runs.first else { return [] }
+        var results = firstRun.stages.indices.map { stageIndex in
+            StageResult(
+                id: "\(prefix)/\(firstRun.stages[stageIndex].name)",
+                value: median(runs.map { $0.stages[stageIndex].duration }) * 1000)
+        }
+        results.append(StageResult(id: "\(prefix)/total", value: median(runs.map(\.total)) * 1000))
+        return results
+    }
+
+    private func median(_ values: [Double]) -> Double {
+        let sorted = values.sorted()
+        return sorted[sorted.count / 2]
+    }
+
+    private func writeJSON(_ results: [StageResult], to url: URL) throws {
+        let lines = results.map {
+            String(
+                format: "    {\"id\": \"%@\", \"score\": %.6g, \"higher_is_better\": false, \"unit\": \"%@\"}",
+                $0.id, $0.value, $0.unit)
+        }
+        let json = "{\n  \"schema\": 1,\n  \"results\": [\n" + lines.joined(separator: ",\n") + "\n  ]\n}\n"
+        try json.write(to: url, atomically: true, encoding: .utf8)
+    }
+}
@@ -0,0 +1,92 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+@testable import KeePassiumLib
+import XCTest
+
+final class KDBParserTests: XCTestCase {
+    private let date = DateComponents(
+        calendar: Calendar(identifier: .iso8601),
+        year: 2024, month: 3, day: 31,
+        hour: 2, minute: 30, second: 15).date!
+
+    private func makeContent() -> ByteArray {
+        let group = Group1(database: nil)
+        group.name = "Général"
+        group.creationTime = date
+        group.lastModificationTime = date
+        group.lastAccessTime = date
+
+        let entry = Entry1(database: nil)
+        entry.setField(name: EntryField.title, value: "Tïtle")
+        entry.setField(name: EntryField.password, value: "secret")
+        entry.creationTime = date
+        entry.attachments.append(
+            Attachment(name: "file.bin", isCompressed: false, data: ByteArray(bytes: [1, 2, 3])))
+
+        let stream = ByteArray.makeOutputStream()
+        stream.open()
+        group.write(to: stream)
+        entry.write(to: stream)
+        stream.close()
+        return stream.data!
+    }
+
+    private func parse(
+        _ content: ByteArray,
+        contentHash: ByteArray,
+        body: (kdb_group, kdb_entry) throws -> Void = { _, _ in }
+    ) rethrows -> Int32 {
+        return try content.withBytes { bytes in
+            try bytes.withUnsafeBufferPointer { buffer in
+                var group = kdb_group()
+                var entry = kdb_entry()
+                let result = contentHash.withBytes { hash in
+                    kdb_parse_content(buffer.baseAddress, buffer.count, hash, &group, 1, &entry, 1)
+                }
+                if result.status == KDB_PARSER_OK.rawValue {
+                    try body(group, entry)
+                }
+                return result.status
+            }
+        }
+    }
+
+    func testRoundTrip() throws {
+        let content = makeContent()
+        let status = try parse(content, contentHash: content.sha256) { groupRecord, entryRecord in
+            let group = Group1(database: nil)
+            try group.load(from: groupRecord)
+            XCTAssertEqual(group.name, "Général")
+            XCTAssertEqual(group.creationTime, date)
+            XCTAssertFalse(group.canExpire)
+
+            let entry = Entry1(database: nil)
+            try entry.load(from: entryRecord)
+            XCTAssertEqual(entry.rawTitle, "Tïtle")
+            XCTAssertEqual(entry.rawPassword, "secret")
+            XCTAssertEqual(entry.creationTime, date)
+            XCTAssertEqual(entry.attachments.first?.name, "file.bin")
+            XCTAssertEqual(entry.attachments.first?.data, ByteArray(bytes: [1, 2, 3]))
+            XCTAssertEqual(entryRecord.is_meta_stream, 0)
+        }
+        XCTAssertEqual(status, KDB_PARSER_OK.rawValue)
+    }
+
+    func testHashMismatch() {
+        let content = makeContent()
+        let wrongHash = ByteArray(count: 32)
+        XCTAssertEqual(parse(content, contentHash: wrongHash), KDB_PARSER_ERROR_HASH_MISMATCH.rawValue)
+    }
+
+    func testTruncatedContent() {
+        let content = makeContent()
+        let truncated = content.prefix(content.count - 1)
+        XCTAssertEqual(parse(truncated, contentHash: truncated.sha256), KDB_PARSER_ERROR_PREMATURE_END.rawValue)
+    }
+}
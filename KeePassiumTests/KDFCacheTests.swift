@@ -0,0 +1,98 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+@testable import KeePassiumLib
+import XCTest
+
+final class KDFCacheTests: XCTestCase {
+    private let params: [UInt8] = Array("argon2id/salt".utf8)
+
+    override func setUp() {
+        super.setUp()
+        kdfcache_clear()
+    }
+
+    override func tearDown() {
+        kdfcache_clear()
+        super.tearDown()
+    }
+
+    private func key(_ index: Int) -> [UInt8] {
+        return [UInt8](repeating: UInt8(truncatingIfNeeded: index), count: 32)
+    }
+
+    private func value(_ index: Int) -> [UInt8] {
+        return [UInt8](repeating: UInt8(truncatingIfNeeded: 0x80 + index), count: 32)
+    }
+
+    private func store(_ index: Int, ttl: UInt32 = 60) -> Int32 {
+        let key = key(index)
+        let value = value(index)
+        return kdfcache_store(key, key.count, params, params.count, value, value.count, ttl)
+    }
+
+    /// Returns the cached value for the key, or nil on a miss.
+    private func lookup(_ index: Int) -> [UInt8]? {
+        let key = key(index)
+        var out = [UInt8](repeating: 0, count: 32)
+        let status = kdfcache_lookup(key, key.count, params, params.count, &out, out.count)
+        return status == KDFCACHE_OK ? out : nil
+    }
+
+    func testStoreAndLookup() {
+        XCTAssertEqual(store(1), KDFCACHE_OK)
+        XCTAssertEqual(lookup(1), value(1))
+        XCTAssertNil(lookup(2))
+
+        let otherParams: [UInt8] = Array("argon2id/other-salt".utf8)
+        let key = key(1)
+        var out = [UInt8](repeating: 0, count: 32)
+        XCTAssertEqual(
+            kdfcache_lookup(key, key.count, otherParams, otherParams.count, &out, out.count),
+            KDFCACHE_MISS)
+    }
+
+    func testZeroTTLIsNotStored() {
+        XCTAssertEqual(store(1, ttl: 0), KDFCACHE_OK)
+        XCTAssertNil(lookup(1))
+    }
+
+    func testExpiry() {
+        XCTAssertEqual(store(1, ttl: 1), KDFCACHE_OK)
+        XCTAssertEqual(store(2, ttl: 60), KDFCACHE_OK)
+        Thread.sleep(forTimeInterval: 2.1)
+        XCTAssertNil(lookup(1))
+        XCTAssertEqual(lookup(2), value(2))
+    }
+
+    func testLeastRecentlyUsedIsEvicted() {
+        for index in 0..<Int(KDFCACHE_CAPACITY) {
+            XCTAssertEqual(store(index), KDFCACHE_OK)
+        }
+        XCTAssertNotNil(lookup(0)) // now entry 1 is the least recently used one
+        XCTAssertEqual(store(100), KDFCACHE_OK)
+
+        XCTAssertNil(lookup(1))
+        XCTAssertEqual(lookup(0), value(0))
+        XCTAssertEqual(lookup(100), value(100))
+    }
+
+    func testClear() {
+        XCTAssertEqual(store(1), KDFCACHE_OK)
+        XCTAssertEqual(store(2), KDFCACHE_OK)
+        KeyDerivationCache.removeAll()
+        XCTAssertNil(lookup(1))
+        XCTAssertNil(lookup(2))
+    }
+
+    func testOversizedValueIsRejected() {
+        let key = key(1)
+        let value = [UInt8](repeating: 1, count: Int(KDFCACHE_MAX_VALUE_SIZE) + 1)
+        XCTAssertEqual(kdfcache_store(key, key.count, params, params.count, value, value.count, 60), KDFCACHE_ERROR)
+    }
+}
@@ -0,0 +1,91 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+@testable import KeePassiumLib
+import XCTest
+
+final class SearchIndexTests: XCTestCase {
+    private func makeQuery(_ text: String) -> SearchQuery {
+        return SearchQuery(
+            fieldScope: [.fieldNames],
+            compareOptions: [.caseInsensitive, .diacriticInsensitive],
+            excludeGroupUUID: nil,
+            flattenGroups: false,
+            onlyAutoFillable: false,
+            text: text)
+    }
+
+    private func makeDatabase(entryCount: Int) -> (Database2, [Entry]) {
+        let db = SyntheticDatabaseGenerator.make(SyntheticDatabaseSpec(entryCount: entryCount, historyDepth: 0))
+        var entries = [Entry]()
+        db.root?.collectAllEntries(to: &entries)
+        return (db, entries)
+    }
+
+    func testCandidates() throws {
+        let (db, entries) = makeDatabase(entryCount: 100)
+        let index = try XCTUnwrap(SearchIndex(root: db.root!))
+
+        let entry = entries.first(where: { $0.rawUserName == "user42@example.com" })!
+        let candidates = try XCTUnwrap(index.candidates(for: makeQuery("USER42@example")))
+        XCTAssertEqual(candidates, [ObjectIdentifier(entry)])
+
+        XCTAssertEqual(index.candidates(for: makeQuery("no-such-text")), [])
+        XCTAssertNil(index.candidates(for: makeQuery("-user42")), "Negated words cannot narrow down")
+    }
+
+    func testShortWordsAndArenaGrowth() throws {
+        let (db, entries) = makeDatabase(entryCount: 3000)
+        let entry = entries[1234]
+        entry.setField(name: EntryField.notes, value: String(repeating: "filler ", count: 500) + "Qz")
+        let index = try XCTUnwrap(SearchIndex(root: db.root!))
+
+        XCTAssertEqual(index.candidates(for: makeQuery("qz")), [ObjectIdentifier(entry)])
+    }
+
+    func testChangedEntryIsReindexed() throws {
+        let (db, entries) = makeDatabase(entryCount: 100)
+        let index = try XCTUnwrap(SearchIndex(root: db.root!))
+        let entry = entries[7]
+
+        entry.setField(name: EntryField.notes, value: "Unique Marker")
+        index.markChanged(entry)
+        XCTAssertEqual(index.candidates(for: makeQuery("unique marker")), [ObjectIdentifier(entry)])
+
+        entry.setField(name: EntryField.notes, value: "")
+        index.markChanged(entry)
+        XCTAssertEqual(index.candidates(for: makeQuery("unique marker")), [])
+    }
+
+    func testRemovedEntryIsNotIndexed() throws {
+        let (db, entries) = makeDatabase(entryCount: 100)
+        let index = try XCTUnwrap(SearchIndex(root: db.root!))
+        let entry = entries.first(where: { $0.rawUserName == "user42@example.com" })!
+
+        entry.parent?.remove(entry: entry)
+        index.markChanged(entry)
+        XCTAssertEqual(index.candidates(for: makeQuery("user42@example")), [])
+    }
+
+    func testReferencesAreNotResolvedIntoIndex() throws {
+        let (db, entries) = makeDatabase(entryCount: 100)
+        let target = entries[1]
+        target.setField(name: EntryField.password, value: "SecretWord", isProtected: true)
+        let referrer = entries[2]
+        referrer.setField(name: EntryField.notes, value: "{REF:P@I:\(target.uuid.uuidString)}")
+        let index = try XCTUnwrap(SearchIndex(root: db.root!))
+
+        let candidates = try XCTUnwrap(index.candidates(for: makeQuery("secretword")))
+        XCTAssertFalse(candidates.contains(ObjectIdentifier(target)), "Protected values must not be indexed")
+        XCTAssertEqual(candidates, [ObjectIdentifier(referrer)], "Referring entries are always candidates")
+
+        referrer.setField(name: EntryField.notes, value: "")
+        index.markChanged(referrer)
+        XCTAssertEqual(index.candidates(for: makeQuery("secretword")), [])
+    }
+}
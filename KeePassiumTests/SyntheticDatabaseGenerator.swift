@@ -0,0 +1,209 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+import Foundation
+@testable import KeePassiumLib
+
+/// Shape of a generated database.
+struct SyntheticDatabaseSpec: CustomStringConvertible {
+    var formatVersion: Database2.FormatVersion = .v4
+    var cipher: EncryptionSettings.DataCipherType = .chaCha20
+    var kdf: EncryptionSettings.KDFType = .argon2id
+    var isCompressed = true
+    var groupCount = 10
+    var entryCount = 1000
+    var historyDepth = 2
+    var customFieldCount = 2
+    /// Share of custom fields marked as protected (the password is always protected).
+    var protectedFieldRatio = 0.25
+    /// Sizes of attachments, assigned to the first entries one per entry.
+    var attachmentSizes: [Int] = []
+    var seed: UInt64 = 1
+
+    var description: String {
+        let format: String
+        switch formatVersion {
+        case .v3: format = "kdbx3"
+        case .v4: format = "kdbx4"
+        case .v4_1: format = "kdbx4.1"
+        }
+        let attachmentBytes = attachmentSizes.reduce(0, +)
+        return "\(format)/\(cipher)/\(kdf)/\(isCompressed ? "gzip" : "raw")"
+            + "/entries=\(entryCount)/history=\(historyDepth)/protected=\(protectedFieldRatio)"
+            + "/attachments=\(attachmentSizes.count)x\(attachmentBytes)"
+    }
+
+    /// Deliberately cheap KDF parameters, so that the KDF does not dominate the timings.
+    var encryptionSettings: EncryptionSettings {
+        switch kdf {
+        case .argon2d, .argon2id:
+            return EncryptionSettings(
+                dataCipher: cipher,
+                kdf: kdf,
+                iterations: 1,
+                memory: 1024 * 1024,
+                parallelism: 1
+            )
+        case .aesKdf:
+            return EncryptionSettings(
+                dataCipher: cipher,
+                kdf: kdf,
+                iterations: 1000,
+                memory: 0,
+                parallelism: 0
+            )
+        }
+    }
+}
+
+/// Builds reproducible KDBX databases for load/save benchmarks.
+/// The same spec always yields the same content; only the random seeds
+/// of the file header differ between saves.
+enum SyntheticDatabaseGenerator {
+    static let password = "synthetic"
+
+    private static let baseDate = Date(timeIntervalSince1970: 1_600_000_000)
+    private static let words = [
+        "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+        "india", "juliett", "kilo", "lima", "mike", "november", "oscar", "papa",
+        "quebec", "romeo", "sierra", "tango", "uniform", "victor", "whiskey", "x-ray",
+        "yankee", "zulu", "пароль", "密码", "contraseña", "mot de passe"
+    ]
+
+    static func make(_ spec: SyntheticDatabaseSpec) -> Database2 {
+        precondition(
+            spec.formatVersion >= .v4 || (spec.kdf == .aesKdf && spec.cipher != .chaCha20),
+            "KDBX3 supports only AES-KDF with AES or Twofish")
+        var random = SplitMix64(seed: spec.seed)
+
+        let db: Database2
+        switch spec.formatVersion {
+        case .v3:
+            db = Database2.makeNewV3()
+        case .v4, .v4_1:
+            db = Database2.makeNewV4(spec.formatVersion)
+        }
+        db.applyEncryptionSettings(settings: spec.encryptionSettings)
+        if spec.formatVersion == .v3 {
+            db.header.innerStreamAlgorithm = .Salsa20
+        }
+        db.header.setCompression(spec.isCompressed ? .gzipCompression : .noCompression)
+        db.changeCompositeKey(to: makeCompositeKey(for: db))
+
+        guard let root = db.root else { fatalError("New database without root group") }
+        root.uuid = random.nextUUID()
+        var groups = [Group]()
+        for groupIndex in 0..<max(spec.groupCount, 1) {
+            let group = root.createGroup()
+            group.uuid = random.nextUUID()
+            group.name = "Group \(groupIndex) \(random.nextWords(2))"
+            groups.append(group)
+        }
+
+        for entryIndex in 0..<spec.entryCount {
+            let group = groups[entryIndex % groups.count]
+            let creationDate = baseDate.addingTimeInterval(Double(random.next() % 100_000_000))
+            let entry = group.createEntry(creationDate: creationDate, uuid: random.nextUUID()) as! Entry2
+            fillFields(of: entry, index: entryIndex, spec: spec, random: &random)
+
+            if entryIndex < spec.attachmentSizes.count {
+                let data = ByteArray(bytes: random.nextBytes(count: spec.attachmentSizes[entryIndex]))
+                entry.attachments.append(db.makeAttachment(name: "file\(entryIndex).bin", data: data))
+            }
+
+            for version in 0..<spec.historyDepth {
+                let historyEntry = entry.clone(makeNewUUID: false) as! Entry2
+                historyEntry.clearHistory()
+                historyEntry.setField(name: EntryField.password, value: random.nextPassword(), isProtected: true)
+                historyEntry.lastModificationTime = creationDate.addingTimeInterval(Double(version) * 86400)
+                entry.addToHistory(entry: historyEntry)
+            }
+            entry.lastModificationTime = creationDate.addingTimeInterval(Double(spec.historyDepth) * 86400)
+        }
+        return db
+    }
+
+    static func makeCompositeKey(for db: Database) -> CompositeKey {
+        let compositeKey = CompositeKey(password: password, keyFileRef: nil, challengeHandler: nil)
+        compositeKey.setProcessedComponents(
+            passwordData: db.keyHelper.getPasswordData(password: password),
+            keyFileData: SecureBytes.empty())
+        return compositeKey
+    }
+
+    private static func fillFields(
+        of entry: Entry2,
+        index: Int,
+        spec: SyntheticDatabaseSpec,
+        random: inout SplitMix64
+    ) {
+        entry.setField(name: EntryField.title, value: "\(random.nextWords(2)) \(index)")
+        entry.setField(name: EntryField.userName, value: "user\(index)@example.com")
+        entry.setField(name: EntryField.password, value: random.nextPassword(), isProtected: true)
+        entry.setField(name: EntryField.url, value: "https://site\(index % 500).example.com/login")
+        entry.setField(name: EntryField.notes, value: random.nextWords(Int(random.next() % 40)))
+        for fieldIndex in 0..<spec.customFieldCount {
+            let isProtected = random.nextUnit() < spec.protectedFieldRatio
+            entry.setField(
+                name: "Field \(fieldIndex)",
+                value: isProtected ? random.nextPassword() : random.nextWords(3),
+                isProtected: isProtected)
+        }
+    }
+
+    /// Small, fast and reproducible across platforms, unlike the system generator.
+    fileprivate struct SplitMix64 {
+        private var state: UInt64
+
+        init(seed: UInt64) {
+            state = seed
+        }
+
+        mutating func next() -> UInt64 {
+            state &+= 0x9E3779B97F4A7C15
+            var z = state
+            z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+            z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+            return z ^ (z >> 31)
+        }
+
+        mutating func nextUnit() -> Double {
+            return Double(next() >> 11) / Double(1 << 53)
+        }
+
+        mutating func nextUUID() -> UUID {
+            var bytes = [UInt8]()
+            bytes.reserveCapacity(16)
+            for _ in 0..<2 {
+                withUnsafeBytes(of: next().littleEndian) { bytes.append(contentsOf: $0) }
+            }
+            return UUID(data: ByteArray(bytes: bytes)) ?? UUID.ZERO
+        }
+
+        mutating func nextBytes(count: Int) -> [UInt8] {
+            var bytes = [UInt8]()
+            bytes.reserveCapacity(count + 8)
+            while bytes.count < count {
+                withUnsafeBytes(of: next().littleEndian) { bytes.append(contentsOf: $0) }
+            }
+            bytes.removeLast(bytes.count - count)
+            return bytes
+        }
+
+        mutating func nextPassword() -> String {
+            let alphabet = Array("ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz23456789!@#$%&*")
+            return String((0..<20).map { _ in alphabet[Int(next() % UInt64(alphabet.count))] })
+        }
+
+        mutating func nextWords(_ count: Int) -> String {
+            return (0..<count)
+                .map { _ in SyntheticDatabaseGenerator.words[Int(next() % UInt64(SyntheticDatabaseGenerator.words.count))] }
+                .joined(separator: " ")
+        }
+    }
+}
@@ -0,0 +1,52 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact us.
+
+@testable import KeePassiumLib
+import XCTest
+
+final class TOTPBatchGeneratorTests: XCTestCase {
+    private func makeRFC6238Generators() -> [TOTPGeneratorRFC6238] {
+        let sha1Seed = ByteArray(utf8String: "12345678901234567890")
+        let sha256Seed = ByteArray(utf8String: "12345678901234567890123456789012")
+        let sha512Seed = ByteArray(utf8String: "1234567890123456789012345678901234567890123456789012345678901234")
+        return [
+            TOTPGeneratorRFC6238(seed: sha1Seed, timeStep: 30, length: 8, hashAlgorithm: .sha1)!,
+            TOTPGeneratorRFC6238(seed: sha256Seed, timeStep: 30, length: 8, hashAlgorithm: .sha256)!,
+            TOTPGeneratorRFC6238(seed: sha512Seed, timeStep: 30, length: 8, hashAlgorithm: .sha512)!,
+        ]
+    }
+
+    func testRFC6238TestVectors() {
+        let generators = makeRFC6238Generators()
+        let expectedCodes: [(TimeInterval, [String])] = [
+            (59, ["94287082", "46119246", "90693936"]),
+            (1111111109, ["07081804", "68084774", "25091201"]),
+            (1234567890, ["89005924", "91819424", "93441116"]),
+            (20000000000, ["65353130", "77737706", "47863826"]),
+        ]
+        for (time, expected) in expectedCodes {
+            let codes = TOTPBatchGenerator.generate(generators, at: Date(timeIntervalSince1970: time))
+            XCTAssertEqual(codes, expected, "Mismatch at time \(time)")
+        }
+    }
+
+    func testBatchMatchesSingleGeneration() {
+        let steamGenerator = TOTPGeneratorSteam(seed: ByteArray(utf8String: "steam secret"), timeStep: 30)!
+        var generators: [BatchableTOTPGenerator] = makeRFC6238Generators()
+        generators.append(steamGenerator)
+        // Step boundaries and their neighbours, where a time mismatch would show
+        let times: [TimeInterval] = [0, 29, 30, 59, 60, 1111111109, 1234567890, 2000000000, 20000000000]
+        for time in times {
+            let date = Date(timeIntervalSince1970: time)
+            let batchCodes = TOTPBatchGenerator.generate(generators, at: date)
+            let singleCodes = generators.map { $0.generate(at: date) }
+            XCTAssertEqual(batchCodes, singleCodes, "Mismatch at time \(time)")
+            XCTAssertEqual(batchCodes.last?.count, 5, "Steam codes have 5 characters")
+        }
+    }
+}
@@ -0,0 +1,947 @@
+//  KeePassium Password Manager
+//  Copyright © 2018-2025 KeePassium Labs <info@keepassium.com>
+//
+//  This program is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License version 3 as published
+//  by the Free Software Foundation: https://www.gnu.org/licenses/).
+//  For commercial licensing, please contact the author.
+
+/*
+ * Benchmark of the native primitives in KeePassiumLib/crypto.
+ *
+ * Stream and block primitives are measured over a grid of buffer sizes and thread counts
+ * (each thread processes its own buffer), KDFs over a grid of their cost parameters.
+ * Results are written as JSON, one result per line, so that they can be diffed and
+ * compared with a saved baseline (--baseline). See the Makefile for typical invocations.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_HAVE_TSC 1
+#endif
+
+#include "aes/aes_cbc.h"
+#include "argon2/argon2.h"
+#include "argon2/argon2_batch.h"
+#include "argon2/blake2/blake2.h"
+#include "chacha20/chacha20.h"
+#include "drbg/drbg.h"
+#include "instrumentation/crypto_stats.h"
+#include "memprotect/memprotect.h"
+#include "salsa20/salsa20.h"
+#include "sha256/sha256.h"
+#include "twofish/twofish.h"
+#if BENCHMARK_AESKDF
+#include "aeskdf/aeskdf.h"
+#endif
+
+#define MAX_GRID 16
+#define MAX_RESULTS 1024
+#define REPETITIONS 5
+
+/***************Options*****************/
+
+typedef struct {
+    int quick;
+    const char *filter;
+    const char *output;
+    const char *baseline;
+    double threshold;       // percent
+    double min_time;        // seconds per measurement
+    double cpu_ghz;         // for cycle estimates without a TSC
+    size_t sizes[MAX_GRID];
+    int size_count;
+    unsigned threads[MAX_GRID];
+    int thread_count;
+} options_t;
+
+static options_t options = {
+    .output = "-",
+    .threshold = 5.0,
+    .min_time = 0.2,
+};
+
+static unsigned cpu_count(void) {
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned)n : 1;
+}
+
+static int parse_list(const char *text, size_t *values, int max_count) {
+    int count = 0;
+    char *end;
+    while (*text && count < max_count) {
+        errno = 0;
+        const unsigned long long value = strtoull(text, &end, 10);
+        if (errno || end == text || value == 0) {
+            return -1;
+        }
+        size_t multiplier = 1;
+        if (*end == 'k' || *end == 'K') {
+            multiplier = 1024;
+            end++;
+        } else if (*end == 'm' || *end == 'M') {
+            multiplier = 1024 * 1024;
+            end++;
+        }
+        values[count++] = (size_t)value * multiplier;
+        if (*end == ',') {
+            end++;
+        } else if (*end) {
+            return -1;
+        }
+        text = end;
+    }
+    return count;
+}
+
+static void print_usage(const char *program) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --quick              reduced parameter grid\n"
+        "  --filter TEXT        run only benchmarks whose id contains TEXT\n"
+        "  --sizes LIST         buffer sizes, e.g. 64,1k,1m\n"
+        "  --threads LIST       thread counts, e.g. 1,2,4\n"
+        "  --min-time SECONDS   minimal duration of one measurement (default 0.2)\n"
+        "  --cpu-ghz GHZ        clock used for cycles/byte where no TSC is available\n"
+        "  --output FILE        JSON output, '-' for stdout (default)\n"
+        "  --baseline FILE      compare with results saved earlier\n"
+        "  --threshold PERCENT  regression that fails the comparison (default 5)\n",
+        program);
+}
+
+static int parse_options(int argc, char **argv) {
+    size_t list[MAX_GRID];
+    int has_sizes = 0, has_threads = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--quick") == 0) {
+            options.quick = 1;
+            continue;
+        }
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        }
+        if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return -1;
+        }
+        i++;
+        if (strcmp(arg, "--filter") == 0) {
+            options.filter = value;
+        } else if (strcmp(arg, "--output") == 0) {
+            options.output = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            options.baseline = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            options.threshold = atof(value);
+        } else if (strcmp(arg, "--min-time") == 0) {
+            options.min_time = atof(value);
+        } else if (strcmp(arg, "--cpu-ghz") == 0) {
+            options.cpu_ghz = atof(value);
+        } else if (strcmp(arg, "--sizes") == 0) {
+            options.size_count = parse_list(value, options.sizes, MAX_GRID);
+            if (options.size_count <= 0) {
+                fprintf(stderr, "Invalid --sizes: %s\n", value);
+                return -1;
+            }
+            has_sizes = 1;
+        } else if (strcmp(arg, "--threads") == 0) {
+            const int count = parse_list(value, list, MAX_GRID);
+            if (count <= 0) {
+                fprintf(stderr, "Invalid --threads: %s\n", value);
+                return -1;
+            }
+            for (int j = 0; j < count; j++) {
+                options.threads[j] = (unsigned)list[j];
+            }
+            options.thread_count = count;
+            has_threads = 1;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            return -1;
+        }
+    }
+
+    if (!has_sizes) {
+        static const size_t full_sizes[] = { 64, 1024, 16 * 1024, 1024 * 1024 };
+        static const size_t quick_sizes[] = { 1024, 64 * 1024 };
+        const size_t *sizes = options.quick ? quick_sizes : full_sizes;
+        options.size_count = options.quick ? 2 : 4;
+        memcpy(options.sizes, sizes, options.size_count * sizeof(size_t));
+    }
+    if (!has_threads) {
+        const unsigned cpus = cpu_count();
+        options.thread_count = 0;
+        options.threads[options.thread_count++] = 1;
+        for (unsigned t = 2; t <= cpus && !options.quick; t *= 2) {
+            options.threads[options.thread_count++] = t;
+        }
+        if (cpus > 1 && options.threads[options.thread_count - 1] != cpus) {
+            options.threads[options.thread_count++] = cpus;
+        }
+    }
+    if (options.quick && options.min_time > 0.05) {
+        options.min_time = 0.05;
+    }
+    return 0;
+}
+
+/***************Timing*****************/
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t now_cycles(void) {
+#if BENCHMARK_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    const double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *values, int count) {
+    qsort(values, count, sizeof(double), compare_doubles);
+    return (count % 2) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+/***************Results*****************/
+
+typedef struct {
+    char id[128];
+    char fields[512];       // JSON members, without braces
+    double score;
+    int higher_is_better;
+} result_t;
+
+static result_t results[MAX_RESULTS];
+static int result_count = 0;
+
+static int is_selected(const char *id) {
+    return !options.filter || strstr(id, options.filter);
+}
+
+static result_t *add_result(const char *id, double score, int higher_is_better) {
+    if (result_count == MAX_RESULTS) {
+        fprintf(stderr, "Too many results, ignoring %s\n", id);
+        return NULL;
+    }
+    result_t *result = &results[result_count++];
+    snprintf(result->id, sizeof(result->id), "%s", id);
+    result->score = score;
+    result->higher_is_better = higher_is_better;
+    result->fields[0] = '\0';
+    return result;
+}
+
+static void print_system_info(FILE *out) {
+    char cpu[128] = "unknown";
+    FILE *cpuinfo = fopen("/proc/cpuinfo", "r");
+    if (cpuinfo) {
+        char line[256];
+        while (fgets(line, sizeof(line), cpuinfo)) {
+            char *colon = strchr(line, ':');
+            if (colon && strncmp(line, "model name", 10) == 0) {
+                colon += 2;
+                colon[strcspn(colon, "\n")] = '\0';
+                snprintf(cpu, sizeof(cpu), "%s", colon);
+                break;
+            }
+        }
+        fclose(cpuinfo);
+    }
+    for (char *c = cpu; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            *c = '\'';
+        }
+    }
+
+    char timestamp[32];
+    const time_t t = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+
+#if defined(__clang__)
+    const char *compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const char *compiler = "gcc " __VERSION__;
+#else
+    const char *compiler = "unknown";
+#endif
+    fprintf(out,
+        "  \"system\": {\"cpu\": \"%s\", \"cores\": %u, \"compiler\": \"%s\", "
+        "\"timestamp\": \"%s\", \"quick\": %s, \"cycle_source\": \"%s\"},\n",
+        cpu, cpu_count(), compiler, timestamp, options.quick ? "true" : "false",
+#if BENCHMARK_HAVE_TSC
+        "tsc"
+#else
+        options.cpu_ghz > 0 ? "cpu-ghz" : "none"
+#endif
+    );
+}
+
+static int write_results(void) {
+    FILE *out = stdout;
+    if (strcmp(options.output, "-") != 0) {
+        out = fopen(options.output, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s: %s\n", options.output, strerror(errno));
+            return -1;
+        }
+    }
+    fprintf(out, "{\n  \"schema\": 1,\n");
+    print_system_info(out);
+    fprintf(out, "  \"results\": [\n");
+    for (int i = 0; i < result_count; i++) {
+        const result_t *r = &results[i];
+        fprintf(out, "    {\"id\": \"%s\", \"score\": %.6g, \"higher_is_better\": %s%s%s}%s\n",
+            r->id, r->score, r->higher_is_better ? "true" : "false",
+            r->fields[0] ? ", " : "", r->fields,
+            (i + 1 < result_count) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
+
+/***************Baseline comparison*****************/
+
+/// Reads the id and score of a result line written by write_results().
+static int parse_result_line(const char *line, char *id, size_t id_size, double *score) {
+    const char *p = strstr(line, "\"id\": \"");
+    if (!p) {
+        return 0;
+    }
+    p += 7;
+    const char *end = strchr(p, '"');
+    if (!end || (size_t)(end - p) >= id_size) {
+        return 0;
+    }
+    memcpy(id, p, end - p);
+    id[end - p] = '\0';
+    const char *s = strstr(end, "\"score\": ");
+    if (!s) {
+        return 0;
+    }
+    *score = atof(s + 9);
+    return 1;
+}
+
+static int compare_with_baseline(void) {
+    FILE *in = fopen(options.baseline, "r");
+    if (!in) {
+        fprintf(stderr, "Cannot read baseline %s: %s\n", options.baseline, strerror(errno));
+        return -1;
+    }
+    fprintf(stderr, "\n%-56s %14s %14s %9s\n", "benchmark", "baseline", "current", "change");
+
+    int regressions = 0, matched = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), in)) {
+        char id[128];
+        double baseline_score;
+        if (!parse_result_line(line, id, sizeof(id), &baseline_score)) {
+            continue;
+        }
+        const result_t *current = NULL;
+        for (int i = 0; i < result_count; i++) {
+            if (strcmp(results[i].id, id) == 0) {
+                current = &results[i];
+                break;
+            }
+        }
+        if (!current || baseline_score <= 0) {
+            continue;
+        }
+        matched++;
+        // positive change is always an improvement
+        double change = (current->score - baseline_score) / baseline_score * 100.0;
+        if (!current->higher_is_better) {
+            change = -change;
+        }
+        const int is_regression = change < -options.threshold;
+        regressions += is_regression;
+        fprintf(stderr, "%-56s %14.6g %14.6g %+8.1f%%%s\n",
+            id, baseline_score, current->score, change, is_regression ? "  REGRESSION" : "");
+    }
+    fclose(in);
+    fprintf(stderr, "\n%d benchmarks compared, %d regressed by more than %.1f%%\n",
+        matched, regressions, options.threshold);
+    return regressions ? 1 : 0;
+}
+
+/***************Throughput benchmarks*****************/
+
+typedef struct throughput_kernel {
+    const char *name;
+    size_t block_size;      // bytes per primitive call, for ns/block
+    /// Processes `length` bytes of `buffer`, `context` is per-thread scratch memory.
+    void (*process)(void *context, uint8_t *buffer, size_t length);
+    size_t context_size;
+    void (*setup)(void *context);
+} throughput_kernel_t;
+
+typedef struct {
+    const throughput_kernel_t *kernel;
+    size_t size;
+    uint64_t iterations;
+    uint8_t *buffer;
+    void *context;
+} worker_t;
+
+static void *throughput_worker(void *arg) {
+    worker_t *worker = arg;
+    for (uint64_t i = 0; i < worker->iterations; i++) {
+        worker->kernel->process(worker->context, worker->buffer, worker->size);
+    }
+    return NULL;
+}
+
+static double run_workers(worker_t *workers, unsigned thread_count, uint64_t *cycles) {
+    pthread_t threads[MAX_GRID * 64];
+    const uint64_t start_cycles = now_cycles();
+    const double start = now_seconds();
+    if (thread_count == 1) {
+        throughput_worker(&workers[0]);
+    } else {
+        for (unsigned t = 0; t < thread_count; t++) {
+            pthread_create(&threads[t], NULL, throughput_worker, &workers[t]);
+        }
+        for (unsigned t = 0; t < thread_count; t++) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    const double elapsed = now_seconds() - start;
+    *cycles = now_cycles() - start_cycles;
+    return elapsed;
+}
+
+static void benchmark_throughput(const throughput_kernel_t *kernel, size_t size, unsigned thread_count) {
+    char id[128];
+    snprintf(id, sizeof(id), "%s/size=%zu/threads=%u", kernel->name, size, thread_count);
+    if (!is_selected(id)) {
+        return;
+    }
+    if (thread_count > MAX_GRID * 64) {
+        return;
+    }
+
+    worker_t workers[MAX_GRID * 64];
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers[t].kernel = kernel;
+        workers[t].size = size;
+        workers[t].iterations = 1;
+        workers[t].buffer = malloc(size + 64);
+        workers[t].context = kernel->context_size ? calloc(1, kernel->context_size) : NULL;
+        for (size_t i = 0; i < size + 64; i++) {
+            workers[t].buffer[i] = (uint8_t)(i * 131 + t);
+        }
+        if (kernel->setup) {
+            kernel->setup(workers[t].context);
+        }
+    }
+
+    // calibrate the number of iterations to fill min_time
+    uint64_t cycles;
+    uint64_t iterations = 1;
+    for (;;) {
+        for (unsigned t = 0; t < thread_count; t++) {
+            workers[t].iterations = iterations;
+        }
+        const double elapsed = run_workers(workers, thread_count, &cycles);
+        if (elapsed >= options.min_time / 4 || iterations >= (1ULL << 40)) {
+            const double factor = options.min_time / (elapsed > 1e-9 ? elapsed : 1e-9);
+            iterations = (uint64_t)(iterations * factor) + 1;
+            break;
+        }
+        iterations *= 8;
+    }
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers[t].iterations = iterations;
+    }
+
+    double seconds[REPETITIONS], cycle_counts[REPETITIONS];
+    for (int r = 0; r < REPETITIONS; r++) {
+        seconds[r] = run_workers(workers, thread_count, &cycles);
+        cycle_counts[r] = (double)cycles;
+    }
+    const double elapsed = median(seconds, REPETITIONS);
+    const double elapsed_cycles = median(cycle_counts, REPETITIONS);
+
+    const double total_bytes = (double)size * (double)iterations * thread_count;
+    const double blocks_per_call = (double)((size + kernel->block_size - 1) / kernel->block_size);
+    const double total_blocks = blocks_per_call * (double)iterations * thread_count;
+    const double mb_per_s = total_bytes / elapsed / 1e6;
+    // per-core figures: the threads run in parallel over the same wall time
+    const double ns_per_block = elapsed * 1e9 * thread_count / total_blocks;
+    double cycles_per_byte = -1;
+#if BENCHMARK_HAVE_TSC
+    cycles_per_byte = elapsed_cycles * thread_count / total_bytes;
+#else
+    (void)elapsed_cycles;
+    if (options.cpu_ghz > 0) {
+        cycles_per_byte = elapsed * options.cpu_ghz * 1e9 * thread_count / total_bytes;
+    }
+#endif
+
+    result_t *result = add_result(id, mb_per_s, 1);
+    if (result) {
+        char cycles_text[32] = "null";
+        if (cycles_per_byte >= 0) {
+            snprintf(cycles_text, sizeof(cycles_text), "%.3f", cycles_per_byte);
+        }
+        snprintf(result->fields, sizeof(result->fields),
+            "\"primitive\": \"%s\", \"size\": %zu, \"threads\": %u, \"mb_per_s\": %.2f, "
+            "\"cycles_per_byte\": %s, \"ns_per_block\": %.2f, \"block_size\": %zu",
+            kernel->name, size, thread_count, mb_per_s, cycles_text, ns_per_block, kernel->block_size);
+    }
+    fprintf(stderr, "%-48s %10.2f MB/s %10.2f ns/block\n", id, mb_per_s, ns_per_block);
+
+    for (unsigned t = 0; t < thread_count; t++) {
+        free(workers[t].buffer);
+        free(workers[t].context);
+    }
+}
+
+static const uint8_t bench_key[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+static const uint8_t bench_iv[12] = { 0 };
+
+/* AES-256-CBC with PKCS7 padding, in place; buffers have room for the padding block. */
+static void aes_cbc_encrypt_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    size_t out_length;
+    aes_cbc_encrypt(bench_key, bench_key + 16, buffer, length, buffer, length + AES_CBC_BLOCK_SIZE, &out_length,
+                    NULL, NULL, NULL);
+}
+
+/* ChaCha20, the way ChaCha20.swift uses it: one keystream block per 64 bytes, XOR-ed in. */
+static void chacha20_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    uint8_t block[64];
+    uint32_t counter = 0;
+    for (size_t pos = 0; pos < length; pos += 64) {
+        chacha20_make_block(bench_key, bench_iv, (const uint8_t *)&counter, block);
+        counter++;
+        const size_t n = (length - pos) < 64 ? (length - pos) : 64;
+        for (size_t i = 0; i < n; i++) {
+            buffer[pos + i] ^= block[i];
+        }
+    }
+}
+
+static void salsa20_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    static const uint8_t sigma[16] = "expand 32-byte k";
+    uint8_t block[64];
+    uint8_t counter[8] = { 0 };
+    for (size_t pos = 0; pos < length; pos += 64) {
+        salsa20_core(block, bench_iv, counter, bench_key, sigma);
+        counter[0]++;
+        const size_t n = (length - pos) < 64 ? (length - pos) : 64;
+        for (size_t i = 0; i < n; i++) {
+            buffer[pos + i] ^= block[i];
+        }
+    }
+}
+
+static void twofish_setup(void *context) {
+    Twofish_prepare_key((Twofish_Byte *)bench_key, sizeof(bench_key), context);
+}
+
+static void twofish_encrypt_process(void *context, uint8_t *buffer, size_t length) {
+    for (size_t pos = 0; pos + 16 <= length; pos += 16) {
+        Twofish_encrypt(context, buffer + pos, buffer + pos);
+    }
+}
+
+static void twofish_decrypt_process(void *context, uint8_t *buffer, size_t length) {
+    for (size_t pos = 0; pos + 16 <= length; pos += 16) {
+        Twofish_decrypt(context, buffer + pos, buffer + pos);
+    }
+}
+
+static void blake2b_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    uint8_t hash[64];
+    blake2b(hash, sizeof(hash), buffer, length, NULL, 0);
+    buffer[0] ^= hash[0];
+}
+
+static void sha256_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    uint8_t hash[SHA256_DIGEST_SIZE];
+    sha256(buffer, length, hash);
+    buffer[0] ^= hash[0];
+}
+
+/* Sealing writes nonce + ciphertext, so the context holds the output buffer. */
+#define MEMPROTECT_BENCH_MAX (4 * 1024 * 1024)
+static void memprotect_seal_process(void *context, uint8_t *buffer, size_t length) {
+    if (length > MEMPROTECT_BENCH_MAX) {
+        return;
+    }
+    memprotect_seal(buffer, length, context);
+}
+
+static void memprotect_open_process(void *context, uint8_t *buffer, size_t length) {
+    if (length > MEMPROTECT_BENCH_MAX) {
+        return;
+    }
+    memprotect_open(context, length + MEMPROTECT_NONCE_SIZE, buffer);
+}
+
+/* The shared generator, as used by SecureRandomNumberGenerator and CryptoManager.getRandomBytes. */
+static void drbg_fill_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    drbg_shared_fill(buffer, length);
+}
+
+/* Password-generator-like draws: one index below 62 per 4 bytes of the buffer. */
+static void drbg_uniform_process(void *context, uint8_t *buffer, size_t length) {
+    (void)context;
+    drbg_shared_uniform(62, (uint32_t *)buffer, length / sizeof(uint32_t));
+}
+
+static const throughput_kernel_t throughput_kernels[] = {
+    { "aes256-cbc-encrypt", 16, aes_cbc_encrypt_process, 0, NULL },
+    { "chacha20", 64, chacha20_process, 0, NULL },
+    { "salsa20", 64, salsa20_process, 0, NULL },
+    { "twofish-encrypt", 16, twofish_encrypt_process, sizeof(Twofish_key), twofish_setup },
+    { "twofish-decrypt", 16, twofish_decrypt_process, sizeof(Twofish_key), twofish_setup },
+    { "blake2b", 128, blake2b_process, 0, NULL },
+    { "sha256", 64, sha256_process, 0, NULL },
+    { "memprotect-seal", 64, memprotect_seal_process, MEMPROTECT_BENCH_MAX + MEMPROTECT_NONCE_SIZE, NULL },
+    { "memprotect-open", 64, memprotect_open_process, MEMPROTECT_BENCH_MAX + MEMPROTECT_NONCE_SIZE, NULL },
+    { "drbg-fill", 64, drbg_fill_process, 0, NULL },
+    { "drbg-uniform", 4, drbg_uniform_process, 0, NULL },
+};
+
+/***************Latency benchmarks*****************/
+
+static void benchmark_twofish_key_setup(void) {
+    const char *id = "twofish-key-setup";
+    if (!is_selected(id)) {
+        return;
+    }
+    Twofish_key key;
+    uint64_t iterations = 1000;
+    double elapsed;
+    for (;;) {
+        const double start = now_seconds();
+        for (uint64_t i = 0; i < iterations; i++) {
+            Twofish_prepare_key((Twofish_Byte *)bench_key, sizeof(bench_key), &key);
+        }
+        elapsed = now_seconds() - start;
+        if (elapsed >= options.min_time) {
+            break;
+        }
+        iterations *= 4;
+    }
+    Twofish_clear_key(&key);
+    const double ns_per_op = elapsed * 1e9 / (double)iterations;
+    result_t *result = add_result(id, ns_per_op, 0);
+    if (result) {
+        snprintf(result->fields, sizeof(result->fields),
+            "\"primitive\": \"twofish\", \"ns_per_op\": %.1f", ns_per_op);
+    }
+    fprintf(stderr, "%-48s %10.1f ns/op\n", id, ns_per_op);
+}
+
+/***************KDF benchmarks*****************/
+
+static void benchmark_argon2(argon2_type type, uint32_t m_kib, uint32_t t_cost, uint32_t parallelism) {
+    char id[128];
+    snprintf(id, sizeof(id), "argon2%s/m=%u/t=%u/p=%u",
+        argon2_type2string(type, 0) + 6, m_kib, t_cost, parallelism);
+    if (!is_selected(id)) {
+        return;
+    }
+    const uint8_t password[] = "password";
+    const uint8_t salt[32] = { 1 };
+    uint8_t hash[32];
+    const uint8_t flag_abort = 0; // required by this Argon2 build
+    const int repetitions = options.quick ? 1 : 3;
+    double times[REPETITIONS];
+    crypto_stats stats;
+    for (int r = 0; r < repetitions; r++) {
+        memset(&stats, 0, sizeof(stats));
+        const double start = now_seconds();
+        const int status = argon2_hash(t_cost, m_kib, parallelism, password, sizeof(password) - 1,
+            salt, sizeof(salt), hash, sizeof(hash), NULL, 0, type, ARGON2_VERSION_13, NULL, NULL,
+            &flag_abort, &stats);
+        times[r] = now_seconds() - start;
+        if (status != ARGON2_OK) {
+            fprintf(stderr, "%s failed: %s\n", id, argon2_error_message(status));
+            return;
+        }
+    }
+    const double wall_ms = median(times, repetitions) * 1000.0;
+    // memory bandwidth of the fill phase: each pass reads and writes the whole matrix
+    const double mb_per_s = (double)m_kib * 1024.0 * t_cost / (wall_ms / 1000.0) / 1e6;
+    result_t *result = add_result(id, wall_ms, 0);
+    if (result) {
+        snprintf(result->fields, sizeof(result->fields),
+            "\"primitive\": \"argon2%s\", \"m_kib\": %u, \"t_cost\": %u, \"parallelism\": %u, "
+            "\"wall_ms\": %.2f, \"fill_mb_per_s\": %.1f, "
+            "\"allocate_ms\": %.3f, \"fill_ms\": %.3f, \"wipe_ms\": %.3f, \"minor_faults\": %llu",
+            argon2_type2string(type, 0) + 6, m_kib, t_cost, parallelism, wall_ms, mb_per_s,
+            stats.phase_ns[CRYPTO_PHASE_ALLOCATE] / 1e6, stats.phase_ns[CRYPTO_PHASE_FILL] / 1e6,
+            stats.phase_ns[CRYPTO_PHASE_WIPE] / 1e6, (unsigned long long)stats.minor_faults);
+    }
+    fprintf(stderr, "%-48s %10.2f ms\n", id, wall_ms);
+}
+
+static void benchmark_argon2_grid(void) {
+    static const uint32_t full_memory[] = { 1024, 16 * 1024, 64 * 1024, 256 * 1024 };
+    static const uint32_t quick_memory[] = { 1024, 16 * 1024 };
+    static const uint32_t full_iterations[] = { 1, 3 };
+    static const uint32_t quick_iterations[] = { 2 };
+    static const argon2_type types[] = { Argon2_d, Argon2_id };
+
+    const uint32_t *memory = options.quick ? quick_memory : full_memory;
+    const int memory_count = options.quick ? 2 : 4;
+    const uint32_t *iterations = options.quick ? quick_iterations : full_iterations;
+    const int iteration_count = options.quick ? 1 : 2;
+
+    for (int type = 0; type < 2; type++) {
+        for (int m = 0; m < memory_count; m++) {
+            for (int t = 0; t < iteration_count; t++) {
+                for (int p = 0; p < options.thread_count; p++) {
+                    benchmark_argon2(types[type], memory[m], iterations[t], options.threads[p]);
+                }
+            }
+        }
+    }
+}
+
+/// Many independent hashes with a low parallelism, as when checking one key against many files:
+/// one argon2_hash() after another, or all of them on one shared pool.
+static void benchmark_argon2_batch(uint32_t job_count, uint32_t m_kib, uint32_t t_cost, uint32_t parallelism,
+                                   unsigned thread_count)
+{
+    char id[128];
+    snprintf(id, sizeof(id), "argon2id-batch/jobs=%u/m=%u/t=%u/p=%u/threads=%u",
+        job_count, m_kib, t_cost, parallelism, thread_count);
+    if (!is_selected(id)) {
+        return;
+    }
+    argon2_batch_item *items = calloc(job_count, sizeof(argon2_batch_item));
+    uint8_t *hashes = calloc(job_count, 32);
+    if (items == NULL || hashes == NULL) {
+        free(items);
+        free(hashes);
+        return;
+    }
+    const uint8_t password[] = "password";
+    uint8_t salts[64][32] = { { 0 } };
+    for (uint32_t i = 0; i < job_count; i++) {
+        salts[i % 64][0] = (uint8_t)i;
+        items[i] = (argon2_batch_item){
+            .t_cost = t_cost, .m_cost = m_kib, .parallelism = parallelism,
+            .type = Argon2_id, .version = ARGON2_VERSION_13,
+            .pwd = password, .pwdlen = sizeof(password) - 1,
+            .salt = salts[i % 64], .saltlen = sizeof(salts[0]),
+            .hash = hashes + 32 * i, .hashlen = 32,
+        };
+    }
+    const argon2_batch_options batch_options = { .threads = thread_count, .memory_budget = 0 };
+    const int repetitions = options.quick ? 1 : 3;
+    double times[REPETITIONS];
+    for (int r = 0; r < repetitions; r++) {
+        const double start = now_seconds();
+        argon2_batch_hash(items, job_count, &batch_options, NULL);
+        times[r] = now_seconds() - start;
+        for (uint32_t i = 0; i < job_count; i++) {
+            if (items[i].status != ARGON2_OK) {
+                fprintf(stderr, "%s failed: %s\n", id, argon2_error_message(items[i].status));
+                free(items);
+                free(hashes);
+                return;
+            }
+        }
+    }
+    free(items);
+    free(hashes);
+    const double wall_ms = median(times, repetitions) * 1000.0;
+    const double hashes_per_s = job_count / (wall_ms / 1000.0);
+    result_t *result = add_result(id, hashes_per_s, 1);
+    if (result) {
+        snprintf(result->fields, sizeof(result->fields),
+            "\"primitive\": \"argon2id-batch\", \"jobs\": %u, \"m_kib\": %u, \"t_cost\": %u, "
+            "\"parallelism\": %u, \"threads\": %u, \"wall_ms\": %.2f, \"hashes_per_s\": %.2f",
+            job_count, m_kib, t_cost, parallelism, thread_count, wall_ms, hashes_per_s);
+    }
+    fprintf(stderr, "%-48s %10.2f hashes/s\n", id, hashes_per_s);
+}
+
+static void benchmark_argon2_batch_grid(void) {
+    const uint32_t job_count = options.quick ? 8 : 64;
+    const uint32_t m_kib = options.quick ? 1024 : 16 * 1024;
+    for (int p = 0; p < options.thread_count; p++) {
+        benchmark_argon2_batch(job_count, m_kib, 2, 2, options.threads[p]);
+    }
+}
+
+/// Decryption of one buffer, as when loading an AES-encrypted database:
+/// unlike in the throughput grid, the threads share the buffer.
+static void benchmark_aes_cbc_decrypt(size_t size, unsigned thread_count) {
+    char id[128];
+    snprintf(id, sizeof(id), "aes256-cbc-decrypt/size=%zu/threads=%u", size, thread_count);
+    if (!is_selected(id)) {
+        return;
+    }
+    uint8_t *plaintext = malloc(size);
+    uint8_t *ciphertext = malloc(size + AES_CBC_BLOCK_SIZE);
+    uint8_t *output = malloc(size + AES_CBC_BLOCK_SIZE);
+    if (plaintext == NULL || ciphertext == NULL || output == NULL) {
+        free(plaintext);
+        free(ciphertext);
+        free(output);
+        return;
+    }
+    for (size_t i = 0; i < size; i++) {
+        plaintext[i] = (uint8_t)(i * 131);
+    }
+    size_t ciphertext_length = 0;
+    size_t output_length = 0;
+    aes_cbc_encrypt(bench_key, bench_key + 16, plaintext, size, ciphertext, size + AES_CBC_BLOCK_SIZE,
+                    &ciphertext_length, NULL, NULL, NULL);
+
+    double seconds[REPETITIONS];
+    int status = AES_CBC_OK;
+    for (int r = -1; r < REPETITIONS && status == AES_CBC_OK; r++) { // the first run warms up
+        const double start = now_seconds();
+        status = aes_cbc_decrypt(bench_key, bench_key + 16, ciphertext, ciphertext_length,
+                                 output, size + AES_CBC_BLOCK_SIZE, &output_length,
+                                 thread_count, NULL, NULL, NULL);
+        if (r >= 0) {
+            seconds[r] = now_seconds() - start;
+        }
+    }
+    if (status != AES_CBC_OK || output_length != size || memcmp(output, plaintext, size) != 0) {
+        fprintf(stderr, "%s failed: %d\n", id, status);
+    } else {
+        const double elapsed = median(seconds, REPETITIONS);
+        const double mb_per_s = (double)size / elapsed / 1e6;
+        result_t *result = add_result(id, mb_per_s, 1);
+        if (result) {
+            snprintf(result->fields, sizeof(result->fields),
+                "\"primitive\": \"aes256-cbc-decrypt\", \"implementation\": \"%s\", \"size\": %zu, "
+                "\"threads\": %u, \"mb_per_s\": %.2f, \"wall_ms\": %.3f",
+                aes_cbc_implementation(), size, thread_count, mb_per_s, elapsed * 1000.0);
+        }
+        fprintf(stderr, "%-48s %10.2f MB/s\n", id, mb_per_s);
+    }
+    free(plaintext);
+    free(ciphertext);
+    free(output);
+}
+
+static void benchmark_aes_cbc_decrypt_grid(void) {
+    static const size_t full_sizes[] = { 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024 };
+    static const size_t quick_sizes[] = { 1024 * 1024, 8 * 1024 * 1024 };
+    const size_t *sizes = options.quick ? quick_sizes : full_sizes;
+    const int size_count = options.quick ? 2 : 4;
+    for (int s = 0; s < size_count; s++) {
+        for (int t = 0; t < options.thread_count; t++) {
+            benchmark_aes_cbc_decrypt(sizes[s], options.threads[t]);
+        }
+    }
+}
+
+#if BENCHMARK_AESKDF
+static void benchmark_aeskdf(uint64_t rounds) {
+    char id[128];
+    snprintf(id, sizeof(id), "aeskdf/rounds=%llu", (unsigned long long)rounds);
+    if (!is_selected(id)) {
+        return;
+    }
+    uint8_t key[32] = { 0 };
+    const double start = now_seconds();
+    const int32_t status = aeskdf_rounds(bench_key, key, rounds, NULL, NULL, NULL);
+    const double elapsed = now_seconds() - start;
+    if (status != 0) {
+        fprintf(stderr, "%s failed: %d\n", id, status);
+        return;
+    }
+    const double wall_ms = elapsed * 1000.0;
+    const double ns_per_round = elapsed * 1e9 / (double)rounds;
+    result_t *result = add_result(id, wall_ms, 0);
+    if (result) {
+        snprintf(result->fields, sizeof(result->fields),
+            "\"primitive\": \"aeskdf\", \"rounds\": %llu, \"wall_ms\": %.2f, \"ns_per_round\": %.2f",
+            (unsigned long long)rounds, wall_ms, ns_per_round);
+    }
+    fprintf(stderr, "%-48s %10.2f ms\n", id, wall_ms);
+}
+#endif
+
+/***************Main*****************/
+
+int main(int argc, char **argv) {
+    if (parse_options(argc, argv) != 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (Twofish_initialise() != TWOFISH_SUCCESS) {
+        fprintf(stderr, "Twofish self-test failed\n");
+        return 2;
+    }
+    if (memprotect_init() != MEMPROTECT_OK) {
+        fprintf(stderr, "Memory protection is not available\n");
+        return 2;
+    }
+
+    const size_t kernel_count = sizeof(throughput_kernels) / sizeof(throughput_kernels[0]);
+    for (size_t k = 0; k < kernel_count; k++) {
+        for (int s = 0; s < options.size_count; s++) {
+            for (int t = 0; t < options.thread_count; t++) {
+                benchmark_throughput(&throughput_kernels[k], options.sizes[s], options.threads[t]);
+            }
+        }
+    }
+    benchmark_twofish_key_setup();
+    benchmark_argon2_grid();
+    benchmark_argon2_batch_grid();
+    benchmark_aes_cbc_decrypt_grid();
+#if BENCHMARK_AESKDF
+    static const uint64_t aeskdf_full_rounds[] = { 100000, 1000000, 6000000 };
+    static const uint64_t aeskdf_quick_rounds[] = { 100000 };
+    const uint64_t *rounds = options.quick ? aeskdf_quick_rounds : aeskdf_full_rounds;
+    for (int i = 0; i < (options.quick ? 1 : 3); i++) {
+        benchmark_aeskdf(rounds[i]);
+    }
+#else
+    fprintf(stderr, "aeskdf: skipped, CommonCrypto is not available\n");
+#endif
+
+    if (write_results() != 0) {
+        return 2;
+    }
+    if (options.baseline) {
+        const int status = compare_with_baseline();
+        return status < 0 ? 2 : status;
+    }
+    return 0;
+}